@@ -0,0 +1,353 @@
+/** @file hud.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the head up display on the PmodOLEDrgb.  HUD_update() is called from a
+* periodic task.  It draws the widgets of the current page whose variable has changed into
+* the framebuffer, then queues the changed pixels on the asynchronous SPI queue and returns.
+* The framebuffer is not drawn to while the queue is still sending the previous frame, so
+* the display never shows half of a widget.
+*
+* HUD_update() is given an execution time budget.  It keeps the worst case time to draw a
+* widget and only starts a widget that fits in what is left of the budget, so the HUD task
+* stays inside its budget and its share of the CPU is at most budget / period.  Widgets that
+* do not fit are drawn first at the next call.  A widget that takes longer than the whole
+* budget is still drawn on its own so the display can not freeze; the scheduler counts that
+* run as an overrun.
+*
+* A page change clears the display with the display's own rectangle fill, 13 SPI bytes
+* instead of 12 KB of pixels, and the widgets are drawn from the next call on, after the
+* display has finished the fill.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     17-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "hud.h"
+
+/************************** Constant Definitions ****************************/
+#define HUD_BACKGROUND		0x0000		// black
+#define HUD_TRACK			0x2104		// dark grey, the empty part of a bar
+#define HUD_MARKER			0xFFFF		// white, the aircraft symbol of the horizon
+#define HUD_ROLL_EDGE		45			// roll, in degrees, at which the horizon meets a corner
+
+/******************** Static variable declarations **************************/
+static PmodOLEDrgb	*HudOled = NULL;
+static OLEDrgb_FB	HudFb;						// back buffer
+static p_HUD_Page	HudPages = NULL;
+static u32			HudNumPages = 0;
+static u32			HudPage = 0;				// page shown
+static u32			HudNext = 0;				// widget to look at first
+static bool			HudClearPending = false;	// the display must be cleared for the page
+static u32			HudWidgetMaxUs = 0;			// worst case time to draw a widget
+static u32			HudDrawn = 0;				// widgets drawn
+static u32			HudFlips = 0;				// frames queued for the display
+static u32			HudDeferred = 0;			// calls that ran out of budget
+
+/************************** Local functions ********************************/
+
+static inline int hud_abs(int v)
+{
+	return (v < 0) ? -v : v;
+}
+
+static inline int hud_clamp(int v, int lo, int hi)
+{
+	return (v < lo) ? lo : ((v > hi) ? hi : v);
+}
+
+// true if the widget has to be drawn again
+static bool hud_changed(p_HUD_Widget p_w)
+{
+	if (!p_w->valid)
+		return true;
+	if (hud_abs(*p_w->p_value - p_w->shown) >= p_w->threshold)
+		return true;
+	if ((p_w->p_value2 != NULL) && (hud_abs(*p_w->p_value2 - p_w->shown2) >= p_w->threshold))
+		return true;
+	return false;
+}
+
+// label padded to HUD_LABEL_CHARS, then the value right aligned in the rest of the width
+static void hud_draw_number(p_HUD_Widget p_w, int value)
+{
+	char	text[OLEDRGB_WIDTH / OLEDRGB_CHARBYTES + 1];
+	int		width, pos, i;
+	u32		mag;
+
+	width = (p_w->c2 - p_w->c1 + 1) / OLEDRGB_CHARBYTES;
+	for (i = 0; i < width; i++)
+		text[i] = ' ';
+	text[width] = '\0';
+
+	if (p_w->label != NULL)
+	{
+		for (i = 0; (i < HUD_LABEL_CHARS) && (i < width) && (p_w->label[i] != '\0'); i++)
+			text[i] = p_w->label[i];
+	}
+
+	pos = width - 1;
+	mag = (value < 0) ? -(u32) value : (u32) value;
+	do
+	{
+		text[pos--] = '0' + (mag % 10);
+		mag /= 10;
+	} while ((mag != 0) && (pos >= 0));
+	if ((value < 0) && (pos >= 0))
+		text[pos] = '-';
+
+	OLEDrgb_SetFontColor(HudOled, p_w->color);
+	OLEDrgb_SetFontBkColor(HudOled, HUD_BACKGROUND);
+	OLEDrgb_SetCursor(HudOled, p_w->c1 / OLEDRGB_CHARBYTES, p_w->r1 / 8);
+	OLEDrgb_FB_PutString(&HudFb, text);
+}
+
+// filled from the left edge in proportion to the value
+static void hud_draw_bar(p_HUD_Widget p_w, int value)
+{
+	int		width, fill;
+
+	width = p_w->c2 - p_w->c1 + 1;
+	fill = (hud_clamp(value, p_w->min, p_w->max) - p_w->min) * width / (p_w->max - p_w->min);
+
+	if (fill > 0)
+		OLEDrgb_FB_FillRect(&HudFb, p_w->c1, p_w->r1, p_w->c1 + fill - 1, p_w->r2, p_w->color);
+	if (fill < width)
+		OLEDrgb_FB_FillRect(&HudFb, p_w->c1 + fill, p_w->r1, p_w->c2, p_w->r2, HUD_TRACK);
+}
+
+// the horizon line moves down as the nose goes up and tilts with the roll
+static void hud_draw_horizon(p_HUD_Widget p_w, int pitch, int roll)
+{
+	int		cx, cy, hw, hh, dy, droll;
+
+	cx = (p_w->c1 + p_w->c2) / 2;
+	cy = (p_w->r1 + p_w->r2) / 2;
+	hw = (p_w->c2 - p_w->c1) / 2;
+	hh = (p_w->r2 - p_w->r1) / 2;
+
+	// the slope is linear in the roll, close enough to tan() for a small display
+	dy = hud_clamp(pitch, -p_w->max, p_w->max) * hh / p_w->max;
+	droll = hud_clamp(roll, -HUD_ROLL_EDGE, HUD_ROLL_EDGE) * hw / HUD_ROLL_EDGE;
+
+	// only the pixels that end up different are sent
+	OLEDrgb_FB_FillRect(&HudFb, p_w->c1, p_w->r1, p_w->c2, p_w->r2, HUD_BACKGROUND);
+	OLEDrgb_FB_DrawLine(&HudFb,
+		p_w->c1, hud_clamp(cy + dy + droll, p_w->r1, p_w->r2),
+		p_w->c2, hud_clamp(cy + dy - droll, p_w->r1, p_w->r2), p_w->color);
+	OLEDrgb_FB_DrawLine(&HudFb, cx - hw / 2, cy, cx - 2, cy, HUD_MARKER);
+	OLEDrgb_FB_DrawLine(&HudFb, cx + 2, cy, cx + hw / 2, cy, HUD_MARKER);
+	OLEDrgb_FB_DrawPixel(&HudFb, cx, cy, HUD_MARKER);
+}
+
+static void hud_draw(p_HUD_Widget p_w)
+{
+	int		value, value2;
+
+	// read each variable once, an interrupt handler may change it while drawing
+	value = *p_w->p_value;
+	value2 = (p_w->p_value2 != NULL) ? *p_w->p_value2 : 0;
+
+	switch (p_w->type)
+	{
+	case HUD_NUMBER:
+		hud_draw_number(p_w, value);
+		break;
+	case HUD_BAR:
+		hud_draw_bar(p_w, value);
+		break;
+	case HUD_HORIZON:
+		hud_draw_horizon(p_w, value, value2);
+		break;
+	}
+
+	p_w->shown = value;
+	p_w->shown2 = value2;
+	p_w->valid = true;
+}
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the HUD
+*
+* Checks the page tables and shows the first page.  The display must already be running
+* with the asynchronous SPI queue (OLEDrgb_AsyncInit()).
+*
+* @param	p_oled is the display
+* @param	p_pages is the page table
+* @param	num_pages is the number of pages in the table
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+* 		- XST_INVALID_PARAM	A widget has no variable, a zero threshold or range, is off
+* 			the display, or is a number that is not on the character grid
+*****************************************************************************/
+uint32_t HUD_initialize(PmodOLEDrgb *p_oled, p_HUD_Page p_pages, u32 num_pages)
+{
+	p_HUD_Widget p_w;
+
+	if ((p_oled == NULL) || (p_pages == NULL) || (num_pages == 0))
+		return XST_INVALID_PARAM;
+
+	for (u32 i = 0; i < num_pages; i++)
+	{
+		if ((p_pages[i].p_widgets == NULL) || (p_pages[i].num_widgets == 0))
+			return XST_INVALID_PARAM;
+		for (u32 j = 0; j < p_pages[i].num_widgets; j++)
+		{
+			p_w = &p_pages[i].p_widgets[j];
+			if ((p_w->p_value == NULL) || (p_w->threshold < 1))
+				return XST_INVALID_PARAM;
+			if ((p_w->c1 > p_w->c2) || (p_w->r1 > p_w->r2) ||
+				(p_w->c2 >= OLEDRGB_WIDTH) || (p_w->r2 >= OLEDRGB_HEIGHT))
+				return XST_INVALID_PARAM;
+			if ((p_w->type == HUD_NUMBER) &&
+				(((p_w->c1 % OLEDRGB_CHARBYTES) != 0) || ((p_w->r1 % 8) != 0) ||
+				 (p_w->c2 - p_w->c1 + 1 < OLEDRGB_CHARBYTES)))
+				return XST_INVALID_PARAM;
+			if ((p_w->type != HUD_NUMBER) && (p_w->max <= p_w->min))
+				return XST_INVALID_PARAM;
+			if ((p_w->type == HUD_HORIZON) && (p_w->max <= 0))
+				return XST_INVALID_PARAM;
+		}
+	}
+
+	HudOled = p_oled;
+	HudPages = p_pages;
+	HudNumPages = num_pages;
+	OLEDrgb_FB_Init(&HudFb, p_oled);
+	HUD_set_page(0);
+
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Show a page
+*
+* The display is cleared and the widgets of the page drawn by the next calls of HUD_update().
+*
+* @param	page is the index of the page in the table, out of range pages are ignored
+*
+* @return	*NONE*
+*****************************************************************************/
+void HUD_set_page(u32 page)
+{
+	if (page >= HudNumPages)
+		return;
+
+	HudPage = page;
+	HudNext = 0;
+	for (u32 i = 0; i < HudPages[page].num_widgets; i++)
+		HudPages[page].p_widgets[i].valid = false;
+	HudClearPending = true;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Show the next page, after the last one comes the first
+*
+* @return	*NONE*
+*****************************************************************************/
+void HUD_next_page(void)
+{
+	if (HudNumPages != 0)
+		HUD_set_page((HudPage + 1) % HudNumPages);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Draw the widgets that changed and send them to the display
+*
+* @param	budget_us is the execution time budget, in microseconds
+*
+* @return	the number of widgets drawn
+*
+* @note		Call it periodically; the SPI queue runs from OLEDrgb_AsyncPoll() or the SPI
+* 			interrupt in between
+*****************************************************************************/
+u32 HUD_update(u32 budget_us)
+{
+	p_HUD_Page	p_page;
+	p_HUD_Widget p_w;
+	u32			start, begin, exec, drawn = 0;
+
+	if (HudPages == NULL)
+		return 0;
+
+	// the previous frame is still being sent from the back buffer
+	if (OLEDrgb_AsyncBusy(HudOled))
+		return 0;
+
+	if (HudClearPending)
+	{
+		if (OLEDrgb_FB_FillRectHw(&HudFb, 0, 0, OLEDRGB_WIDTH - 1, OLEDRGB_HEIGHT - 1,
+				HUD_BACKGROUND) == XST_SUCCESS)
+		{
+			HudClearPending = false;
+		}
+		return 0;
+	}
+
+	start = TB_now_us();
+	p_page = &HudPages[HudPage];
+	for (u32 i = 0; i < p_page->num_widgets; i++)
+	{
+		p_w = &p_page->p_widgets[HudNext];
+		if (hud_changed(p_w))
+		{
+			begin = TB_now_us();
+			if ((drawn != 0) && ((begin - start) + HudWidgetMaxUs > budget_us))
+			{
+				HudDeferred++;
+				break;
+			}
+
+			hud_draw(p_w);
+			drawn++;
+
+			exec = TB_now_us() - begin;
+			if (exec > HudWidgetMaxUs)
+				HudWidgetMaxUs = exec;
+		}
+		HudNext = (HudNext + 1) % p_page->num_widgets;
+	}
+
+	// a frame the queue had no room for is sent with the next one
+	if ((HudFb.cDirty != 0) && (OLEDrgb_FB_FlushAsync(&HudFb, NULL, NULL) == XST_SUCCESS))
+		HudFlips++;
+	HudDrawn += drawn;
+
+	return drawn;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the HUD statistics
+*
+* @param	p_drawn is set to the number of widgets drawn
+* @param	p_flips is set to the number of frames queued for the display
+* @param	p_deferred is set to the number of calls that ran out of budget
+*
+* @return	*NONE*
+*****************************************************************************/
+void HUD_get_stats(u32 *p_drawn, u32 *p_flips, u32 *p_deferred)
+{
+	*p_drawn = HudDrawn;
+	*p_flips = HudFlips;
+	*p_deferred = HudDeferred;
+}
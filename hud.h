@@ -0,0 +1,85 @@
+/** @file hud.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants, types and function prototypes for the head up
+* display on the PmodOLEDrgb.  The display is described as a static table of pages, each a
+* table of widgets bound to application variables.  A widget is drawn again only when its
+* variable has moved by at least the widget's threshold since it was last drawn.  Widgets
+* are drawn into a framebuffer (the back buffer) and the changed pixels are sent to the
+* display (the front buffer) by the asynchronous SPI queue as a few small windows.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     17-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef HUD_H
+#define HUD_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+#include "timebase.h"
+#include "PmodOLEDrgb.h"
+#include "PmodOLEDrgb_fb.h"
+
+/************* Constant Declarations *****************/
+#define HUD_LABEL_CHARS		4			// label characters shown by a number widget
+
+// widget types
+#define HUD_NUMBER			0			// label and right aligned value, on the character grid
+#define HUD_BAR				1			// horizontal gauge from min to max
+#define HUD_HORIZON			2			// artificial horizon, value is pitch and value2 roll
+
+
+/**************************** Type Definitions *****************************/
+
+typedef struct
+{
+	// set by the application in the page table
+	u8					type;			// HUD_NUMBER, HUD_BAR or HUD_HORIZON
+	const char			*label;			// HUD_NUMBER label, NULL for none
+	const volatile int	*p_value;		// bound variable
+	const volatile int	*p_value2;		// HUD_HORIZON roll
+	int					min, max;		// HUD_BAR range, HUD_HORIZON degrees at the edge
+	int					threshold;		// change that makes the widget draw again, 1 or more
+	u8					c1, r1, c2, r2;	// placement in pixels, corners included
+	u16					color;			// RGB565 foreground
+
+	// kept by the HUD
+	int					shown, shown2;	// values last drawn
+	bool				valid;			// the widget has been drawn since the page was shown
+} HUD_Widget, *p_HUD_Widget;
+
+typedef struct
+{
+	const char			*name;
+	p_HUD_Widget		p_widgets;
+	u32					num_widgets;
+} HUD_Page, *p_HUD_Page;
+
+
+/************************** Function Prototypes ****************************/
+
+// initialization
+uint32_t HUD_initialize(PmodOLEDrgb *p_oled, p_HUD_Page p_pages, u32 num_pages);
+void HUD_set_page(u32 page);
+void HUD_next_page(void);
+
+// drawing
+u32 HUD_update(u32 budget_us);
+
+// statistics
+void HUD_get_stats(u32 *p_drawn, u32 *p_flips, u32 *p_deferred);
+
+#endif // HUD_H
@@ -0,0 +1,230 @@
+/** @file input.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the input service.  INPUT_sample() is called at a fixed rate, from a
+* scheduler task.  Each sample is one read of the Nexys4IO buttons and switches register and,
+* when there is an encoder, reads of its count and status.  A button or switch takes its new
+* state when two samples in a row agree, so a sample period of 10 ms or more rides out the
+* contact bounce.  The encoder count is debounced by the PmodENC hardware.
+*
+* The queue has one writer, INPUT_sample(), and one reader, INPUT_get_event().  The writer
+* only moves the tail and the reader only the head, so the sampling may also be done from an
+* interrupt handler.  When the queue is full new events are dropped and counted.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "input.h"
+
+/******************** Static variable declarations **************************/
+static p_pmodENC	InputEnc = NULL;
+static u32			InputBtnState = 0;			// debounced buttons, bit n is button code n
+static u32			InputBtnLast = 0;			// buttons in the previous sample
+static u32			InputSwState = 0;			// debounced switches, bit n is switch code n
+static u32			InputSwLast = 0;			// switches in the previous sample
+static u16			InputEncCount = 0;			// encoder count of the previous sample
+
+static INPUT_Event	InputQueue[INPUT_QUEUE_SIZE];
+static volatile u32	InputHead = 0;				// next event to read
+static volatile u32	InputTail = 0;				// next free slot
+static u32			InputEvents = 0;			// events queued
+static u32			InputDropped = 0;			// events dropped because the queue was full
+
+/************************** Static functions ********************************/
+
+// reads the raw buttons and switches, one bit per code
+static void InputRead(u32 *p_btns, u32 *p_sw)
+{
+	u32 btnsw;
+
+	btnsw = NX4IO_getBTNSW_IN();
+	*p_btns = (btnsw & NEXYS4IO_ALLBTNS_MASK) >> 16;
+	*p_sw = btnsw & NEXYS4IO_ALLSWITCHES_MASK;
+
+	if (InputEnc != NULL)
+	{
+		if (pmodENC_is_button_pressed(InputEnc))
+			*p_btns |= 1 << INPUT_ENC_BTN;
+		if (pmodENC_is_switch_on(InputEnc))
+			*p_sw |= 1 << INPUT_ENC_SW;
+	}
+}
+
+static void InputPut(u8 type, u8 code, s16 value, u32 now)
+{
+	p_INPUT_Event p_event;
+
+	if (InputTail - InputHead >= INPUT_QUEUE_SIZE)
+	{
+		InputDropped++;
+		return;
+	}
+
+	p_event = &InputQueue[InputTail % INPUT_QUEUE_SIZE];
+	p_event->type = type;
+	p_event->code = code;
+	p_event->value = value;
+	p_event->time_us = now;
+	InputTail++;
+	InputEvents++;
+}
+
+// debounces one set of inputs and queues an event for every bit that changed
+static u32 InputDebounce(u32 raw, u32 *p_last, u32 state, bool is_switch, u32 now)
+{
+	u32 changed;
+
+	// a bit changes state when it differs from the state in two samples in a row
+	changed = (raw ^ state) & ~(raw ^ *p_last);
+	*p_last = raw;
+
+	for (u8 code = 0; changed != 0; code++, changed >>= 1)
+	{
+		if ((changed & 1) == 0)
+			continue;
+
+		state ^= 1 << code;
+		if (is_switch)
+			InputPut(INPUT_SWITCH, code, (state >> code) & 1, now);
+		else
+			InputPut(((state >> code) & 1) ? INPUT_PRESS : INPUT_RELEASE, code, 0, now);
+	}
+	return state;
+}
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the input service
+*
+* Takes the current state of every input as its debounced state, so inputs that
+* are already pressed or on do not make events, and empties the queue.
+*
+* @param	p_enc is the initialized PmodENC instance, or NULL if there is no encoder
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+*
+* @note		The Nexys4IO driver must be initialized first
+*****************************************************************************/
+uint32_t INPUT_initialize(p_pmodENC p_enc)
+{
+	InputEnc = p_enc;
+	InputRead(&InputBtnState, &InputSwState);
+	InputBtnLast = InputBtnState;
+	InputSwLast = InputSwState;
+	if (InputEnc != NULL)
+		pmodENC_read_count(InputEnc, &InputEncCount);
+
+	InputHead = 0;
+	InputTail = 0;
+	InputEvents = 0;
+	InputDropped = 0;
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Sample the inputs
+*
+* Reads every input once and queues the presses, releases, switch changes and
+* encoder turns since the last sample.
+*
+* @return	None
+*
+* @note		Call at a fixed rate, 10 ms or more apart for the debouncing
+*****************************************************************************/
+void INPUT_sample(void)
+{
+	u32 btns, sw, now;
+	u16 count;
+
+	now = TB_now_us();
+	InputRead(&btns, &sw);
+	InputBtnState = InputDebounce(btns, &InputBtnLast, InputBtnState, false, now);
+	InputSwState = InputDebounce(sw, &InputSwLast, InputSwState, true, now);
+
+	if (InputEnc != NULL)
+	{
+		pmodENC_read_count(InputEnc, &count);
+		if (count != InputEncCount)
+		{
+			// the count wraps at 16 bits, the difference is right across the wrap
+			InputPut(INPUT_ROTATE, INPUT_ENC, (s16) (count - InputEncCount), now);
+			InputEncCount = count;
+		}
+	}
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the oldest event
+*
+* @param	p_event is where the event is returned
+*
+* @return	true if an event was returned, false if the queue is empty
+*****************************************************************************/
+bool INPUT_get_event(p_INPUT_Event p_event)
+{
+	if (InputHead == InputTail)
+		return false;
+
+	*p_event = InputQueue[InputHead % INPUT_QUEUE_SIZE];
+	InputHead++;
+	return true;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the debounced buttons
+*
+* @return	the buttons that are down, bit n is button code n
+*****************************************************************************/
+u32 INPUT_buttons(void)
+{
+	return InputBtnState;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the debounced switches
+*
+* @return	the switches that are on, bit n is switch code n
+*****************************************************************************/
+u32 INPUT_switches(void)
+{
+	return InputSwState;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the event counters
+*
+* @param	p_events is where the number of events queued is returned, may be NULL
+* @param	p_dropped is where the number of events dropped is returned, may be NULL
+*
+* @return	None
+*****************************************************************************/
+void INPUT_get_stats(u32 *p_events, u32 *p_dropped)
+{
+	if (p_events != NULL)
+		*p_events = InputEvents;
+	if (p_dropped != NULL)
+		*p_dropped = InputDropped;
+}
@@ -0,0 +1,86 @@
+/** @file input.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants, types and function prototypes for the input
+* service.  The service samples the Nexys4 pushbuttons and slide switches and the PmodENC
+* rotary encoder, pushbutton and switch at a fixed rate, debounces them and turns every
+* change into a typed event in a fixed size queue.  The application reads the events instead
+* of polling the peripherals, and the debounced state without touching the bus.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef INPUT_H
+#define INPUT_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+#include "timebase.h"
+#include "nexys4IO.h"
+#include "PmodENC.h"
+
+/************* Constant Declarations *****************/
+#define INPUT_QUEUE_SIZE	16			// events waiting to be read, a power of 2
+
+// event types
+#define INPUT_PRESS			0			// a button was pressed, code is the button
+#define INPUT_RELEASE		1			// a button was released, code is the button
+#define INPUT_SWITCH		2			// a switch moved, code is the switch, value the new position
+#define INPUT_ROTATE		3			// the encoder turned, value is the signed count change
+
+// button codes, the Nexys4 buttons keep their enum _NX4IO_btns values
+#define INPUT_BTNR			BTNR
+#define INPUT_BTNL			BTNL
+#define INPUT_BTND			BTND
+#define INPUT_BTNU			BTNU
+#define INPUT_BTNC			BTNC
+#define INPUT_ENC_BTN		5			// encoder shaft button
+
+// switch codes, the Nexys4 switches are 0 to 15
+#define INPUT_ENC_SW		16			// PmodENC slide switch
+
+// rotate code
+#define INPUT_ENC			0
+
+
+/**************************** Type Definitions *****************************/
+
+typedef struct
+{
+	u8					type;			// INPUT_PRESS, INPUT_RELEASE, INPUT_SWITCH or INPUT_ROTATE
+	u8					code;			// which button, switch or encoder
+	s16					value;			// switch position or count change
+	u32					time_us;		// time of the sample that saw the change
+} INPUT_Event, *p_INPUT_Event;
+
+
+/************************** Function Prototypes ****************************/
+
+// initialization
+uint32_t INPUT_initialize(p_pmodENC p_enc);
+
+// sampling, at a fixed rate
+void INPUT_sample(void);
+
+// events and state
+bool INPUT_get_event(p_INPUT_Event p_event);
+u32 INPUT_buttons(void);
+u32 INPUT_switches(void);
+
+// statistics
+void INPUT_get_stats(u32 *p_events, u32 *p_dropped);
+
+#endif // INPUT_H
@@ -0,0 +1,380 @@
+/** @file param.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the parameter store.  The table of parameters belongs to the
+* application and is sorted by ID, so a parameter is found by a binary search and an image,
+* whose entries are in ascending ID order too, is matched to the table in a single merge
+* walk.  Loading an image is one pass for the CRC, one to check every entry and one to apply
+* them, so it takes time in proportion to the image size.  An image is applied whole or not
+* at all: a bad header, length or CRC, or any value out of its range, leaves every parameter
+* as it was.  Entries for IDs that are not in the table are skipped and parameters that are
+* not in the image keep their values, so an image survives parameters being added or removed.
+*
+* The CRC is the CRC-32 of IEEE 802.3 (reflected, polynomial 0xEDB88320), computed a nibble
+* at a time from a 16 entry table, which is small and needs only shifts by 4.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "param.h"
+#include "string.h"
+
+/******************** Static variable declarations **************************/
+static const PARAM_Def	*ParamDefs = NULL;
+static u32				ParamNum = 0;
+static u32				ParamDefaults[PARAM_MAX_PARAMS];	// values at initialization
+
+static const u32		ParamCrcTable[16] =
+{
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+/************************** Static functions ********************************/
+
+static u32 ParamGet16(const u8 *p)
+{
+	return p[0] | ((u32) p[1] << 8);
+}
+
+static u32 ParamGet32(const u8 *p)
+{
+	return p[0] | ((u32) p[1] << 8) | ((u32) p[2] << 16) | ((u32) p[3] << 24);
+}
+
+static void ParamPut16(u8 *p, u32 data)
+{
+	p[0] = data;
+	p[1] = data >> 8;
+}
+
+static void ParamPut32(u8 *p, u32 data)
+{
+	p[0] = data;
+	p[1] = data >> 8;
+	p[2] = data >> 16;
+	p[3] = data >> 24;
+}
+
+// the value of a raw int or float as a float
+static float ParamToFloat(const PARAM_Def *p_def, u32 raw)
+{
+	float value;
+
+	if (p_def->type == PARAM_INT)
+		return (float) (s32) raw;
+	memcpy(&value, &raw, sizeof(value));
+	return value;
+}
+
+// true if a raw value is in the range of the parameter, NaN never is
+static bool ParamInRange(const PARAM_Def *p_def, u32 raw)
+{
+	float value = ParamToFloat(p_def, raw);
+
+	return (value >= p_def->min) && (value <= p_def->max);
+}
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the parameter store
+*
+* Takes the table of parameters and keeps the values the variables have now as
+* the defaults restored by PARAM_reset().
+*
+* @param	p_defs is the table of parameters, in strictly ascending ID order
+* @param	num_defs is the number of parameters in the table
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+* 		- XST_INVALID_PARAM	There are too many parameters, the IDs are out of
+* 							order or a parameter has no variable or an unknown type
+*
+* @note		The table must stay in place, the store does not copy it
+*****************************************************************************/
+uint32_t PARAM_initialize(const PARAM_Def *p_defs, u32 num_defs)
+{
+	if ((p_defs == NULL) || (num_defs > PARAM_MAX_PARAMS))
+		return XST_INVALID_PARAM;
+
+	for (u32 i = 0; i < num_defs; i++)
+	{
+		if ((p_defs[i].p_value == NULL) || (p_defs[i].type > PARAM_FLOAT))
+			return XST_INVALID_PARAM;
+		if ((i > 0) && (p_defs[i].id <= p_defs[i - 1].id))
+			return XST_INVALID_PARAM;
+	}
+
+	ParamDefs = p_defs;
+	ParamNum = num_defs;
+	for (u32 i = 0; i < num_defs; i++)
+	{
+		memcpy(&ParamDefaults[i], p_defs[i].p_value, sizeof(u32));
+	}
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Find a parameter
+*
+* @param	id is the ID of the parameter
+*
+* @return	the parameter, or NULL if there is no parameter with that ID
+*****************************************************************************/
+const PARAM_Def *PARAM_find(u16 id)
+{
+	u32 lo = 0, hi = ParamNum, mid;
+
+	while (lo < hi)
+	{
+		mid = (lo + hi) >> 1;
+		if (ParamDefs[mid].id == id)
+			return &ParamDefs[mid];
+		if (ParamDefs[mid].id < id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return NULL;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the number of parameters
+*
+* @return	the number of parameters in the table
+*****************************************************************************/
+u32 PARAM_count(void)
+{
+	return ParamNum;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get a parameter by its index
+*
+* @param	index is the index in the table, 0 is the lowest ID
+*
+* @return	the parameter, or NULL if the index is past the end of the table
+*****************************************************************************/
+const PARAM_Def *PARAM_get_def(u32 index)
+{
+	return (index < ParamNum) ? &ParamDefs[index] : NULL;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the value of a parameter
+*
+* @param	id is the ID of the parameter
+* @param	p_value is where the value is returned, an int parameter is converted
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if there is no parameter with that ID
+*****************************************************************************/
+uint32_t PARAM_get(u16 id, float *p_value)
+{
+	const PARAM_Def *p_def = PARAM_find(id);
+	u32 raw;
+
+	if (p_def == NULL)
+		return XST_INVALID_PARAM;
+
+	memcpy(&raw, p_def->p_value, sizeof(raw));
+	*p_value = ParamToFloat(p_def, raw);
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Set the value of a parameter
+*
+* @param	id is the ID of the parameter
+* @param	value is the new value, rounded to the nearest integer for an int parameter
+*
+* @return
+* 		- XST_SUCCESS	The parameter was set.
+* 		- XST_INVALID_PARAM	There is no parameter with that ID or the value is out
+* 							of its range, the parameter is not changed
+*****************************************************************************/
+uint32_t PARAM_set(u16 id, float value)
+{
+	const PARAM_Def *p_def = PARAM_find(id);
+	u32 raw;
+
+	if (p_def == NULL)
+		return XST_INVALID_PARAM;
+
+	if (p_def->type == PARAM_INT)
+	{
+		// the range check first, a large float does not convert to an s32
+		if (!((value >= p_def->min) && (value <= p_def->max)))
+			return XST_INVALID_PARAM;
+		raw = (s32) ((value >= 0) ? value + 0.5f : value - 0.5f);
+	}
+	else
+	{
+		memcpy(&raw, &value, sizeof(raw));
+	}
+
+	if (!ParamInRange(p_def, raw))
+		return XST_INVALID_PARAM;
+	memcpy(p_def->p_value, &raw, sizeof(raw));
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Set every parameter back to its default
+*
+* @return	None
+*****************************************************************************/
+void PARAM_reset(void)
+{
+	for (u32 i = 0; i < ParamNum; i++)
+	{
+		memcpy(ParamDefs[i].p_value, &ParamDefaults[i], sizeof(u32));
+	}
+}
+
+
+/****************************************************************************/
+/**
+* @brief Save the parameters to an image
+*
+* @param	p_image is where the image is written
+* @param	size is the size of the buffer at p_image, in bytes
+*
+* @return	the length of the image, PARAM_IMAGE_SIZE() of the number of
+* 			parameters, or 0 if the buffer is too small
+*****************************************************************************/
+u32 PARAM_save(u8 *p_image, u32 size)
+{
+	u32 len = PARAM_IMAGE_SIZE(ParamNum);
+	u32 raw;
+	u8 *p;
+
+	if (size < len)
+		return 0;
+
+	ParamPut16(p_image, PARAM_IMAGE_MAGIC);
+	p_image[2] = PARAM_IMAGE_VERSION;
+	p_image[3] = ParamNum;
+
+	p = p_image + PARAM_HEADER_SIZE;
+	for (u32 i = 0; i < ParamNum; i++, p += PARAM_ENTRY_SIZE)
+	{
+		memcpy(&raw, ParamDefs[i].p_value, sizeof(raw));
+		ParamPut16(p, ParamDefs[i].id);
+		ParamPut32(p + 2, raw);
+	}
+
+	ParamPut32(p, PARAM_crc32(0, p_image, len - PARAM_CRC_SIZE));
+	return len;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Load the parameters from an image
+*
+* Checks the whole image, then sets the parameters in it.  Entries for IDs
+* that are not in the table are skipped.
+*
+* @param	p_image is the image
+* @param	len is the length of the image, in bytes
+*
+* @return
+* 		- XST_SUCCESS	The parameters in the image were set.
+* 		- XST_FAILURE	The magic number, version, length or CRC is wrong, the
+* 						entries are out of order or a value is out of its range.
+* 						No parameter is changed
+*****************************************************************************/
+uint32_t PARAM_load(const u8 *p_image, u32 len)
+{
+	const u8 *p;
+	u32 count, id, raw, def, last_id;
+
+	if ((len < PARAM_IMAGE_SIZE(0)) || (ParamGet16(p_image) != PARAM_IMAGE_MAGIC)
+			|| (p_image[2] != PARAM_IMAGE_VERSION))
+		return XST_FAILURE;
+	count = p_image[3];
+	if (len != PARAM_IMAGE_SIZE(count))
+		return XST_FAILURE;
+	if (PARAM_crc32(0, p_image, len - PARAM_CRC_SIZE) != ParamGet32(p_image + len - PARAM_CRC_SIZE))
+		return XST_FAILURE;
+
+	// check the order and the ranges, walking the table alongside the entries
+	p = p_image + PARAM_HEADER_SIZE;
+	def = 0;
+	last_id = 0;
+	for (u32 i = 0; i < count; i++, p += PARAM_ENTRY_SIZE)
+	{
+		id = ParamGet16(p);
+		if ((i > 0) && (id <= last_id))
+			return XST_FAILURE;
+		last_id = id;
+
+		while ((def < ParamNum) && (ParamDefs[def].id < id))
+			def++;
+		if ((def < ParamNum) && (ParamDefs[def].id == id) && !ParamInRange(&ParamDefs[def], ParamGet32(p + 2)))
+			return XST_FAILURE;
+	}
+
+	// and set them
+	p = p_image + PARAM_HEADER_SIZE;
+	def = 0;
+	for (u32 i = 0; i < count; i++, p += PARAM_ENTRY_SIZE)
+	{
+		id = ParamGet16(p);
+		while ((def < ParamNum) && (ParamDefs[def].id < id))
+			def++;
+		if ((def < ParamNum) && (ParamDefs[def].id == id))
+		{
+			raw = ParamGet32(p + 2);
+			memcpy(ParamDefs[def].p_value, &raw, sizeof(raw));
+		}
+	}
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Compute a CRC-32
+*
+* @param	crc is 0 to start, or the CRC of the data before, to continue
+* @param	p_data is the data
+* @param	len is the length of the data, in bytes
+*
+* @return	the CRC-32 of the data
+*****************************************************************************/
+u32 PARAM_crc32(u32 crc, const u8 *p_data, u32 len)
+{
+	crc = ~crc;
+	while (len-- > 0)
+	{
+		crc ^= *p_data++;
+		crc = (crc >> 4) ^ ParamCrcTable[crc & 0x0F];
+		crc = (crc >> 4) ^ ParamCrcTable[crc & 0x0F];
+	}
+	return ~crc;
+}
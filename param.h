@@ -0,0 +1,89 @@
+/** @file param.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants, types and function prototypes for the parameter
+* store.  The application registers its tuning variables in a table of typed parameters,
+* each with a fixed ID and a range.  The parameters can be read and written by ID, and the
+* whole set saved to and loaded from a compact binary image:
+*
+*	offset	size	contents
+*	0		2		PARAM_IMAGE_MAGIC
+*	2		1		PARAM_IMAGE_VERSION
+*	3		1		number of entries
+*	4		6 * n	entries, a 2 byte ID and the 4 byte value, in ascending ID order
+*	4 + 6n	4		CRC-32 of everything before it
+*
+* All fields are little endian.  A value is the s32 or the IEEE 754 float of the parameter.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef PARAM_H
+#define PARAM_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+
+/************* Constant Declarations *****************/
+#define PARAM_MAX_PARAMS		32			// parameters in the table
+
+// parameter types
+#define PARAM_INT				0			// the variable is an int (s32)
+#define PARAM_FLOAT				1			// the variable is a float
+
+// image layout
+#define PARAM_IMAGE_MAGIC		0x5250		// "PR"
+#define PARAM_IMAGE_VERSION		1			// changes when the meaning or type of an ID changes
+#define PARAM_HEADER_SIZE		4
+#define PARAM_ENTRY_SIZE		6
+#define PARAM_CRC_SIZE			4
+
+// bytes in the image of num parameters
+#define PARAM_IMAGE_SIZE(num)	(PARAM_HEADER_SIZE + (num) * PARAM_ENTRY_SIZE + PARAM_CRC_SIZE)
+
+
+/**************************** Type Definitions *****************************/
+
+typedef struct
+{
+	u16					id;				// fixed ID, used in the image and over the link
+	u8					type;			// PARAM_INT or PARAM_FLOAT
+	const char			*name;			// short name, for listings
+	void				*p_value;		// the int or float variable
+	float				min;			// smallest value accepted
+	float				max;			// largest value accepted
+} PARAM_Def, *p_PARAM_Def;
+
+
+/************************** Function Prototypes ****************************/
+
+// initialization
+uint32_t PARAM_initialize(const PARAM_Def *p_defs, u32 num_defs);
+
+// access by ID, or by index in ID order
+const PARAM_Def *PARAM_find(u16 id);
+u32 PARAM_count(void);
+const PARAM_Def *PARAM_get_def(u32 index);
+uint32_t PARAM_get(u16 id, float *p_value);
+uint32_t PARAM_set(u16 id, float value);
+void PARAM_reset(void);
+
+// binary image
+u32 PARAM_save(u8 *p_image, u32 size);
+uint32_t PARAM_load(const u8 *p_image, u32 len);
+u32 PARAM_crc32(u32 crc, const u8 *p_data, u32 len);
+
+#endif // PARAM_H
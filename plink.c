@@ -0,0 +1,445 @@
+/** @file plink.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the parameter link.  PLINK_receive() is given the bytes read from the
+* link, finds the frames in them with a byte at a time state machine, and moves the bytes
+* that are not part of a frame to the front of the buffer for the remote control parser.
+* Every good frame is handled as soon as its CRC is in, and its reply queued by the send
+* function of the application.  A frame that stops arriving for PLINK_RX_TIMEOUT_US is
+* dropped, so a lost byte costs one frame.
+*
+* PLINK_poll() moves the dump along: it sends the frames in the window and goes back to the
+* first frame not acknowledged when the acknowledgment times out.  A dump frame is packed
+* with as many whole entries as fit, so the frame boundaries depend only on the table, and
+* the parameter each frame starts at is kept to build the same frame again.  The values are
+* read when a frame is built.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "plink.h"
+#include "string.h"
+
+/************************** Constant Definitions ****************************/
+
+// receive states
+#define PLINK_RX_SOF			0			// waiting for the start of a frame
+#define PLINK_RX_LEN			1			// waiting for the length
+#define PLINK_RX_BODY			2			// in the type, sequence number and payload
+#define PLINK_RX_CRC			3			// in the CRC
+
+/******************** Static variable declarations **************************/
+static PLINK_Send		PlinkSend = NULL;
+static PLINK_Changed	PlinkChanged = NULL;
+
+static u8				PlinkRxState = PLINK_RX_SOF;
+static u8				PlinkRxBody[PLINK_MAX_BODY];
+static u8				PlinkRxCrc[4];
+static u32				PlinkRxLen = 0;				// length of the frame being received
+static u32				PlinkRxCount = 0;			// bytes of the body or CRC received
+static u32				PlinkRxTime = 0;			// time of the last byte of the frame
+
+static u8				PlinkTx[PLINK_MAX_BODY + 6];
+
+static bool				PlinkDumping = false;		// a dump is in progress
+static u32				PlinkDumpWindow = 1;		// frames sent ahead of the acknowledgment
+static u32				PlinkDumpBase = 0;			// first frame not acknowledged
+static u32				PlinkDumpNext = 0;			// next frame to send
+static u32				PlinkDumpFrames = 0;		// frames in the dump, 0 until the last is built
+static u32				PlinkDumpTime = 0;			// time the acknowledgment last advanced
+static u32				PlinkDumpRetries = 0;		// timeouts since the acknowledgment advanced
+static u8				PlinkDumpStart[PARAM_MAX_PARAMS + 2];	// first parameter of each frame
+
+static u32				PlinkFrames = 0;			// good frames received
+static u32				PlinkErrors = 0;			// frames with a bad CRC or length, or timed out
+static u32				PlinkResent = 0;			// dump frames sent again
+
+/************************** Static functions ********************************/
+
+static u32 PlinkGet16(const u8 *p)
+{
+	return p[0] | ((u32) p[1] << 8);
+}
+
+static u32 PlinkGet32(const u8 *p)
+{
+	return p[0] | ((u32) p[1] << 8) | ((u32) p[2] << 16) | ((u32) p[3] << 24);
+}
+
+static u8 *PlinkPut16(u8 *p, u32 data)
+{
+	*p++ = data;
+	*p++ = data >> 8;
+	return p;
+}
+
+static u8 *PlinkPut32(u8 *p, u32 data)
+{
+	*p++ = data;
+	*p++ = data >> 8;
+	*p++ = data >> 16;
+	*p++ = data >> 24;
+	return p;
+}
+
+// the frame in PlinkTx, whose payload is already in place, completed and queued
+static bool PlinkSendFrame(u8 type, u8 seq, u32 payload_len)
+{
+	u32 len = payload_len + 2;
+
+	PlinkTx[0] = PLINK_SOF;
+	PlinkTx[1] = len;
+	PlinkTx[2] = type;
+	PlinkTx[3] = seq;
+	PlinkPut32(&PlinkTx[2 + len], PARAM_crc32(0, &PlinkTx[1], len + 1));
+	return PlinkSend(PlinkTx, len + 6);
+}
+
+static void PlinkSendNak(u8 seq, u8 type, u8 error)
+{
+	PlinkTx[4] = type;
+	PlinkTx[5] = error;
+	PlinkSendFrame(PLINK_NAK, seq, 2);
+}
+
+static void PlinkSendValue(u8 seq, const PARAM_Def *p_def)
+{
+	u32 raw;
+	u8 *p;
+
+	memcpy(&raw, p_def->p_value, sizeof(raw));
+	p = PlinkPut16(&PlinkTx[4], p_def->id);
+	*p++ = p_def->type;
+	PlinkPut32(p, raw);
+	PlinkSendFrame(PLINK_VALUE, seq, 7);
+}
+
+// builds dump frame n in PlinkTx and queues it
+static bool PlinkSendDumpFrame(u32 n)
+{
+	const PARAM_Def *p_def;
+	u32 index, name_len, raw, min, max;
+	u8 *p, *p_end;
+
+	index = PlinkDumpStart[n];
+	p = &PlinkTx[5];
+	p_end = &PlinkTx[4 + PLINK_DUMP_PAYLOAD];
+	while ((p_def = PARAM_get_def(index)) != NULL)
+	{
+		name_len = strlen(p_def->name);
+		if (name_len > PLINK_NAME_MAX)
+			name_len = PLINK_NAME_MAX;
+		if (p + PLINK_ENTRY_SIZE + name_len > p_end)
+			break;
+
+		memcpy(&raw, p_def->p_value, sizeof(raw));
+		memcpy(&min, &p_def->min, sizeof(min));
+		memcpy(&max, &p_def->max, sizeof(max));
+		p = PlinkPut16(p, p_def->id);
+		*p++ = p_def->type;
+		p = PlinkPut32(p, raw);
+		p = PlinkPut32(p, min);
+		p = PlinkPut32(p, max);
+		*p++ = name_len;
+		memcpy(p, p_def->name, name_len);
+		p += name_len;
+		index++;
+	}
+
+	PlinkDumpStart[n + 1] = index;
+	PlinkTx[4] = 0;
+	if (index >= PARAM_count())
+	{
+		PlinkTx[4] = PLINK_DUMP_LAST;
+		PlinkDumpFrames = n + 1;
+	}
+	return PlinkSendFrame(PLINK_DUMP_DATA, n, p - &PlinkTx[4]);
+}
+
+// handles a good frame in PlinkRxBody
+static void PlinkHandle(u32 now_us)
+{
+	const PARAM_Def *p_def;
+	const u8 *p_payload = &PlinkRxBody[2];
+	u32 payload_len = PlinkRxLen - 2;
+	u8 type = PlinkRxBody[0];
+	u8 seq = PlinkRxBody[1];
+	u32 raw, next;
+	float value;
+
+	switch (type)
+	{
+		case PLINK_GET:
+		case PLINK_SET:
+			if (payload_len != ((type == PLINK_GET) ? 2 : 6))
+			{
+				PlinkSendNak(seq, type, PLINK_ERR_FORMAT);
+				break;
+			}
+			p_def = PARAM_find(PlinkGet16(p_payload));
+			if (p_def == NULL)
+			{
+				PlinkSendNak(seq, type, PLINK_ERR_ID);
+				break;
+			}
+			if (type == PLINK_SET)
+			{
+				raw = PlinkGet32(p_payload + 2);
+				if (p_def->type == PARAM_INT)
+					value = (s32) raw;
+				else
+					memcpy(&value, &raw, sizeof(value));
+				if (PARAM_set(p_def->id, value) != XST_SUCCESS)
+				{
+					PlinkSendNak(seq, type, PLINK_ERR_RANGE);
+					break;
+				}
+				if (PlinkChanged != NULL)
+					PlinkChanged();
+			}
+			PlinkSendValue(seq, p_def);
+			break;
+
+		case PLINK_DUMP:
+			if (payload_len != 1)
+			{
+				PlinkSendNak(seq, type, PLINK_ERR_FORMAT);
+				break;
+			}
+			PlinkDumpWindow = p_payload[0];
+			if (PlinkDumpWindow < 1)
+				PlinkDumpWindow = 1;
+			else if (PlinkDumpWindow > PLINK_MAX_WINDOW)
+				PlinkDumpWindow = PLINK_MAX_WINDOW;
+			PlinkDumpBase = 0;
+			PlinkDumpNext = 0;
+			PlinkDumpFrames = 0;
+			PlinkDumpStart[0] = 0;
+			PlinkDumpTime = now_us;
+			PlinkDumpRetries = 0;
+			PlinkDumping = true;
+			break;
+
+		case PLINK_ACK:
+			if (!PlinkDumping || (payload_len != 1))
+				break;
+			next = p_payload[0];
+			if ((next > PlinkDumpBase) && (next <= PlinkDumpNext))
+			{
+				PlinkDumpBase = next;
+				PlinkDumpTime = now_us;
+				PlinkDumpRetries = 0;
+				if ((PlinkDumpFrames != 0) && (PlinkDumpBase >= PlinkDumpFrames))
+					PlinkDumping = false;
+			}
+			break;
+
+		case PLINK_LOAD:
+			if (PARAM_load(p_payload, payload_len) != XST_SUCCESS)
+			{
+				PlinkSendNak(seq, type, PLINK_ERR_IMAGE);
+				break;
+			}
+			if (PlinkChanged != NULL)
+				PlinkChanged();
+			PlinkTx[4] = type;
+			PlinkSendFrame(PLINK_OK, seq, 1);
+			break;
+
+		case PLINK_RESET:
+			PARAM_reset();
+			if (PlinkChanged != NULL)
+				PlinkChanged();
+			PlinkTx[4] = type;
+			PlinkSendFrame(PLINK_OK, seq, 1);
+			break;
+
+		default:
+			PlinkSendNak(seq, type, PLINK_ERR_TYPE);
+			break;
+	}
+}
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the parameter link
+*
+* @param	send is the function that queues frames for the link
+* @param	changed is called after a message changed parameters, may be NULL
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+* 		- XST_INVALID_PARAM	There is no send function
+*
+* @note		The parameter store must be initialized first
+*****************************************************************************/
+uint32_t PLINK_initialize(PLINK_Send send, PLINK_Changed changed)
+{
+	if (send == NULL)
+		return XST_INVALID_PARAM;
+
+	PlinkSend = send;
+	PlinkChanged = changed;
+	PlinkRxState = PLINK_RX_SOF;
+	PlinkDumping = false;
+	PlinkFrames = 0;
+	PlinkErrors = 0;
+	PlinkResent = 0;
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Take the frames out of data received from the link
+*
+* Handles every frame that is completed in the data.  A frame may be split
+* over any number of calls.
+*
+* @param	p_data is the data received, the bytes that are not in a frame are
+* 			moved to the front
+* @param	len is the number of bytes received
+* @param	now_us is the time the data was read
+*
+* @return	the number of bytes that are not in a frame
+*****************************************************************************/
+u32 PLINK_receive(u8 *p_data, u32 len, u32 now_us)
+{
+	u32 text = 0;
+	u8 byte, len_byte;
+
+	if ((PlinkRxState != PLINK_RX_SOF) && (len > 0) && (now_us - PlinkRxTime > PLINK_RX_TIMEOUT_US))
+	{
+		PlinkRxState = PLINK_RX_SOF;
+		PlinkErrors++;
+	}
+
+	for (u32 i = 0; i < len; i++)
+	{
+		byte = p_data[i];
+		switch (PlinkRxState)
+		{
+			case PLINK_RX_SOF:
+				if (byte == PLINK_SOF)
+					PlinkRxState = PLINK_RX_LEN;
+				else
+					p_data[text++] = byte;
+				break;
+
+			case PLINK_RX_LEN:
+				if (byte < 2)
+				{
+					PlinkRxState = PLINK_RX_SOF;
+					PlinkErrors++;
+					break;
+				}
+				PlinkRxLen = byte;
+				PlinkRxCount = 0;
+				PlinkRxState = PLINK_RX_BODY;
+				break;
+
+			case PLINK_RX_BODY:
+				PlinkRxBody[PlinkRxCount++] = byte;
+				if (PlinkRxCount == PlinkRxLen)
+				{
+					PlinkRxCount = 0;
+					PlinkRxState = PLINK_RX_CRC;
+				}
+				break;
+
+			case PLINK_RX_CRC:
+				PlinkRxCrc[PlinkRxCount++] = byte;
+				if (PlinkRxCount < 4)
+					break;
+				PlinkRxState = PLINK_RX_SOF;
+
+				len_byte = PlinkRxLen;
+				if (PARAM_crc32(PARAM_crc32(0, &len_byte, 1), PlinkRxBody, PlinkRxLen) != PlinkGet32(PlinkRxCrc))
+				{
+					PlinkErrors++;
+					break;
+				}
+				PlinkFrames++;
+				PlinkHandle(now_us);
+				break;
+		}
+	}
+
+	if (len > 0)
+		PlinkRxTime = now_us;
+	return text;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Move the dump along
+*
+* Sends the dump frames the window allows, and the frames from the first one
+* not acknowledged again when the acknowledgment times out.  A dump that times
+* out PLINK_MAX_RETRIES times in a row is dropped.
+*
+* @param	now_us is the time now
+*
+* @return	None
+*
+* @note		Call at least as often as the link can send a dump frame
+*****************************************************************************/
+void PLINK_poll(u32 now_us)
+{
+	if (!PlinkDumping)
+		return;
+
+	if (now_us - PlinkDumpTime > PLINK_RETRY_US)
+	{
+		if (++PlinkDumpRetries > PLINK_MAX_RETRIES)
+		{
+			PlinkDumping = false;
+			return;
+		}
+		PlinkResent += PlinkDumpNext - PlinkDumpBase;
+		PlinkDumpNext = PlinkDumpBase;
+		PlinkDumpTime = now_us;
+	}
+
+	while ((PlinkDumpNext < PlinkDumpBase + PlinkDumpWindow)
+			&& ((PlinkDumpFrames == 0) || (PlinkDumpNext < PlinkDumpFrames)))
+	{
+		if (!PlinkSendDumpFrame(PlinkDumpNext))
+			break;
+		PlinkDumpNext++;
+	}
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the link counters
+*
+* @param	p_frames is where the number of good frames received is returned, may be NULL
+* @param	p_errors is where the number of frames dropped is returned, may be NULL
+* @param	p_resent is where the number of dump frames sent again is returned, may be NULL
+*
+* @return	None
+*****************************************************************************/
+void PLINK_get_stats(u32 *p_frames, u32 *p_errors, u32 *p_resent)
+{
+	if (p_frames != NULL)
+		*p_frames = PlinkFrames;
+	if (p_errors != NULL)
+		*p_errors = PlinkErrors;
+	if (p_resent != NULL)
+		*p_resent = PlinkResent;
+}
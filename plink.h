@@ -0,0 +1,122 @@
+/** @file plink.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants, types and function prototypes for the parameter
+* link.  The link carries parameter messages over the Bluetooth command channel, next to the
+* ASCII remote control commands.  A message is a binary frame that starts with PLINK_SOF, a
+* byte that is never in the ASCII commands, so the frames are taken out of the received data
+* and the rest is left for the remote control parser:
+*
+*	offset	size	contents
+*	0		1		PLINK_SOF
+*	1		1		length n of the type, sequence number and payload, 2 to PLINK_MAX_BODY
+*	2		1		message type
+*	3		1		sequence number, returned in the reply
+*	4		n - 2	payload, little endian
+*	n + 2	4		CRC-32 of the length, type, sequence number and payload (PARAM_crc32())
+*
+* The messages from the ground station are:
+*
+*	PLINK_GET		id(2)							read a parameter, PLINK_VALUE or PLINK_NAK
+*	PLINK_SET		id(2) value(4)					write a parameter, PLINK_VALUE or PLINK_NAK
+*	PLINK_DUMP		window(1)						stream the table in PLINK_DUMP_DATA frames
+*	PLINK_ACK		next(1)							the dump frames before next were received
+*	PLINK_LOAD		image							set the parameters in a PARAM_load() image
+*	PLINK_RESET										set every parameter to its default
+*
+* and the replies:
+*
+*	PLINK_OK		type(1)							PLINK_LOAD or PLINK_RESET was done
+*	PLINK_VALUE		id(2) type(1) value(4)
+*	PLINK_NAK		type(1) error(1)				the request was not done, and why
+*	PLINK_DUMP_DATA	flags(1) entries				sequence number is the frame number
+*
+* A value is the s32 or the float of the parameter.  A dump entry is id(2) type(1) value(4)
+* min(4) max(4) name length(1) name.  The dump is a go-back-N transfer: up to window frames
+* are sent ahead of the acknowledgment, and when the acknowledgment stops advancing for
+* PLINK_RETRY_US the frames from the first one not acknowledged are sent again.  The frame
+* with PLINK_DUMP_LAST in its flags is the last.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef PLINK_H
+#define PLINK_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+#include "param.h"
+
+/************* Constant Declarations *****************/
+#define PLINK_SOF				0xA5		// start of frame
+#define PLINK_MAX_BODY			255			// type, sequence number and payload
+#define PLINK_MAX_PAYLOAD		(PLINK_MAX_BODY - 2)
+#define PLINK_OVERHEAD			8			// start, length, type, sequence number and CRC
+#define PLINK_DUMP_PAYLOAD		96			// largest dump frame payload
+#define PLINK_NAME_MAX			32			// longest name in a dump entry, longer names are cut
+#define PLINK_ENTRY_SIZE		16			// dump entry without its name
+#define PLINK_MAX_WINDOW		4			// dump frames sent ahead of the acknowledgment
+#define PLINK_RETRY_US			250000		// dump acknowledgment timeout
+#define PLINK_MAX_RETRIES		4			// timeouts in a row before a dump is dropped
+#define PLINK_RX_TIMEOUT_US		100000		// longest gap in a frame
+
+// message types, from the ground station
+#define PLINK_GET				0x01
+#define PLINK_SET				0x02
+#define PLINK_DUMP				0x03
+#define PLINK_ACK				0x04
+#define PLINK_LOAD				0x05
+#define PLINK_RESET				0x06
+
+// message types, from the aircraft
+#define PLINK_OK				0x80
+#define PLINK_VALUE				0x81
+#define PLINK_NAK				0x82
+#define PLINK_DUMP_DATA			0x83
+
+// PLINK_NAK errors
+#define PLINK_ERR_ID			1			// no parameter with that ID
+#define PLINK_ERR_RANGE			2			// the value is out of range
+#define PLINK_ERR_IMAGE			3			// PARAM_load() refused the image
+#define PLINK_ERR_FORMAT		4			// the payload is the wrong length
+#define PLINK_ERR_TYPE			5			// unknown message type
+
+// PLINK_DUMP_DATA flags
+#define PLINK_DUMP_LAST			0x01		// the last frame of the dump
+
+
+/**************************** Type Definitions *****************************/
+
+// queues a frame for the link, returns false if there is no room for all of it
+typedef bool (*PLINK_Send)(const u8 *p_frame, u32 len);
+
+// called after a message from the ground station changed parameters
+typedef void (*PLINK_Changed)(void);
+
+
+/************************** Function Prototypes ****************************/
+
+// initialization
+uint32_t PLINK_initialize(PLINK_Send send, PLINK_Changed changed);
+
+// received data and the dump
+u32 PLINK_receive(u8 *p_data, u32 len, u32 now_us);
+void PLINK_poll(u32 now_us);
+
+// statistics
+void PLINK_get_stats(u32 *p_frames, u32 *p_errors, u32 *p_resent);
+
+#endif // PLINK_H
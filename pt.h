@@ -0,0 +1,112 @@
+/** @file pt.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains stackless coroutines (protothreads) for multi-step peripheral
+* sequences.  A protothread is a function that can wait in the middle of its body: it returns
+* to its caller at every wait and continues after the wait the next time it is called.  The
+* place to continue from is kept in a struct pt as a source line number, so a protothread
+* costs two words of RAM and no stack of its own.
+*
+* Local variables are not kept across a wait, keep them in static or global variables.
+* A switch statement can not be used around a wait because the protothread body is itself
+* a switch, and there can only be one wait on a source line.  Call the protothread again
+* (ex: from a scheduler task) until it returns PT_ENDED.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     12-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef PT_H
+#define PT_H
+
+
+/****************** Include Files ********************/
+#include "xil_types.h"
+#include "timebase.h"
+
+/************* Constant Declarations *****************/
+// protothread return values
+#define PT_WAITING		0			// blocked in a wait
+#define PT_YIELDED		1			// gave up the CPU, more work to do
+#define PT_EXITED		2			// left with PT_EXIT()
+#define PT_ENDED		3			// reached PT_END()
+
+
+/**************************** Type Definitions *****************************/
+struct pt
+{
+	u16		lc;						// local continuation, line to continue from
+	u32		wake_us;				// deadline of PT_SLEEP_US()
+};
+
+
+/***************** Macros (Inline function) Definitions *********************/
+
+// declare a protothread, ex: PT_THREAD(mpu_bringup(struct pt *pt))
+#define PT_THREAD(name_args)	char name_args
+
+// start a protothread from the top
+#define PT_INIT(pt)				((pt)->lc = 0)
+
+// first and last statements of a protothread body
+#define PT_BEGIN(pt)			{ char pt_yield_flag = 1; (void) pt_yield_flag; switch ((pt)->lc) { case 0:
+#define PT_END(pt)				} pt_yield_flag = 0; PT_INIT(pt); return PT_ENDED; }
+
+// return until the condition is true, the condition is checked at every call
+#define PT_WAIT_UNTIL(pt, condition)		\
+	do {									\
+		(pt)->lc = __LINE__; case __LINE__:	\
+		if (!(condition))					\
+			return PT_WAITING;				\
+	} while (0)
+
+#define PT_WAIT_WHILE(pt, condition)	PT_WAIT_UNTIL((pt), !(condition))
+
+// return until the time base has passed usec microseconds from now
+#define PT_SLEEP_US(pt, usec)								\
+	do {													\
+		(pt)->wake_us = TB_now_us() + (usec);				\
+		PT_WAIT_UNTIL((pt), (int32_t) (TB_now_us() - (pt)->wake_us) >= 0);	\
+	} while (0)
+
+// run a child protothread until it ends
+#define PT_WAIT_THREAD(pt, thread)		PT_WAIT_WHILE((pt), (thread) < PT_EXITED)
+
+#define PT_SPAWN(pt, child, thread)		\
+	do {								\
+		PT_INIT((child));				\
+		PT_WAIT_THREAD((pt), (thread));	\
+	} while (0)
+
+// return once, continue at the next call
+#define PT_YIELD(pt)						\
+	do {									\
+		pt_yield_flag = 0;					\
+		(pt)->lc = __LINE__; case __LINE__:	\
+		if (pt_yield_flag == 0)				\
+			return PT_YIELDED;				\
+	} while (0)
+
+// leave the protothread, the next call starts it from the top
+#define PT_EXIT(pt)							\
+	do {									\
+		PT_INIT(pt);						\
+		return PT_EXITED;					\
+	} while (0)
+
+// restart the protothread from the top at the next call
+#define PT_RESTART(pt)						\
+	do {									\
+		PT_INIT(pt);						\
+		return PT_WAITING;					\
+	} while (0)
+
+#endif // PT_H
@@ -22,11 +22,22 @@
 #include "xil_types.h"
 #include "xil_assert.h"
 #include "xuartlite.h"
+#include "xuartlite_l.h"
 #include "xil_cache.h"
-#include "xgpio.h"
 #include "math.h"							//includes trigonometric functions
 #include "PmodBT2.h"						//driver for Bluetooth communication
 #include "PWM.h"							//driver for PWM control
+#include "ADXL362_AXI.h"					//driver for the accelerometer
+#include "timebase.h"						//common time base, delays and deadline callbacks
+#include "scheduler.h"						//cooperative rate monotonic scheduler
+#include "PmodENC.h"						//driver for the rotary encoder
+#include "input.h"							//debounced button, switch and encoder events
+#include "param.h"							//tuning parameters, by ID and as a binary image
+#include "plink.h"							//parameter messages over the Bluetooth link
+#ifdef XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR
+#include "PmodOLEDrgb.h"					//driver for the OLED display
+#include "hud.h"							//head up display on the OLED display
+#endif
 
 
 /************************** Constant Definitions ****************************/
@@ -36,39 +47,35 @@
 
 // AXI timers parameters
 #define AXI_TIMER_FREQ_HZ		XPAR_AXI_TIMER_0_CLOCK_FREQ_HZ
+#define AXI_TIMER_BASEADDR		XPAR_AXI_TIMER_0_BASEADDR
 
 // Definitions for peripheral NEXYS4IO
 #define NX4IO_DEVICE_ID			XPAR_NEXYS4IO_0_DEVICE_ID
 #define NX4IO_BASEADDR			XPAR_NEXYS4IO_0_S00_AXI_BASEADDR
 #define NX4IO_HIGHADDR			XPAR_NEXYS4IO_0_S00_AXI_HIGHADDR
 
+// Definitions for the PmodENC rotary encoder
+#define PMODENC_BASEADDR		XPAR_PMODENC_0_S00_AXI_BASEADDR
 
-// Fixed Interval timer - 100 MHz input clock, 40KHz output clock
-#define FIT_IN_CLOCK_FREQ_HZ	CPU_CLOCK_FREQ_HZ
-#define FIT_CLOCK_FREQ_HZ		40000
-#define FIT_COUNT				(FIT_IN_CLOCK_FREQ_HZ / FIT_CLOCK_FREQ_HZ)
-#define FIT_COUNT_1MSEC			40
+// Definitions for the USB UART, telemetry is written to it
+#define UART_BASEADDR			XPAR_AXI_UARTLITE_0_BASEADDR
+
+// Definitions for the PmodOLEDrgb, only built when the hardware has one
+#ifdef XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR
+#define OLED_PRESENT
+#define RGBDSPLY_GPIO_BASEADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR
+#define RGBDSPLY_SPI_BASEADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_BASEADDR
+#endif
 
 // Interrupt Controller parameters
 #define INTC_DEVICE_ID			XPAR_INTC_0_DEVICE_ID
-#define FIT_INTERRUPT_ID		XPAR_MICROBLAZE_0_AXI_INTC_FIT_TIMER_1_INTERRUPT_INTR
-
-// GPIO 0 parameters
-#define GPIO_0_DEVICE_ID		 	0
-#define GPIO_0_INPUT_0_CHANNEL		1
-#define GPIO_0_INPUT2_0_CHANNEL		2
-#define GPIO_0_BASEADDR				0x40000000
+#define ADXL362_INTERRUPT_ID	XPAR_MICROBLAZE_0_AXI_INTC_ADXL362_AXI_0_ACCEL_IRQ_INTR
+#define TIMER_INTERRUPT_ID		XPAR_MICROBLAZE_0_AXI_INTC_AXI_TIMER_0_INTERRUPT_INTR
 
-// GPIO 1 parameters
-#define GPIO_1_DEVICE_ID		 	1
-#define GPIO_1_INPUT_0_CHANNEL		1
-#define GPIO_1_INPUT2_0_CHANNEL		2
-#define GPIO_1_BASEADDR				0x40010000
+// ADXL362 accelerometer parameters
+#define ADXL362_BASEADDR			XPAR_ADXL362_AXI_0_S00_AXI_BASEADDR
 
 // Control macros for quadcopter
-#define ROLL_SENSITIVITY 		8					//defines the impact of change in roll value on motor speed
-#define PITCH_SENSITIVITY 		8					//defines the impact of change in pitch value on motor speed
-#define THROTTLE_SENSITIVITY 	70					//defines the impact of change in throttle value on motor speed
 #define CALIBRATION_MODE		0					//set to 1 when the motors need to be calibrated
 
 #define MOTOR_1					0					//represents first brushless motor
@@ -76,29 +83,106 @@
 #define MOTOR_3					2					//represents third brushless motor
 #define MOTOR_4					3					//represents fourth brushless motor
 
+// Task table, in rate monotonic order.  Periods and budgets are in microseconds
+#define TASK_ATTITUDE			0					//attitude estimation and PID control, 1 kHz
+#define TASK_RC					1					//Bluetooth remote control parsing, 200 Hz
+#define TASK_INPUT				2					//button, switch and encoder sampling, 100 Hz
+#define TASK_TELEMETRY			3					//telemetry to the USB UART, 20 Hz
+#define TASK_DISPLAY			4					//seven segment display, LEDs and input events, 10 Hz
+#ifdef OLED_PRESENT
+#define TASK_HUD				5					//head up display on the OLED, 10 Hz
+#define NUM_TASKS				6
+#else
+#define NUM_TASKS				5
+#endif
+
+#define HUD_BUDGET_US			1500				//time the HUD may spend drawing per run, 1.5% of the CPU
+#define HUD_STATS_PERIOD		10					//HUD runs between link and loop rate updates, 1 s
+
+#define TELEMETRY_BUF_SIZE		128					//telemetry bytes waiting for the UART
+#define REPORT_PERIOD			20					//telemetry periods between scheduler reports
+
+#define BT_MAX_BAUD				230400				//fastest Bluetooth UART rate, the receive is interrupt
+													//driven so the idle hook no longer has to keep up
+
+#define TUNE_NUM_GAINS			3					//gains the encoder can tune, kp, ki and kd
+#define TUNE_MAX_GAIN			999.999				//largest gain the seven segment display can show
+#define TUNE_LED_SHIFT			13					//LEDs 13 to 15 show the gain selected for tuning
+#define TUNE_LED_STAGED			0x1000				//LED 12 is lit while staged gains are not committed
+
+// Parameter IDs.  An ID keeps its meaning, a parameter that changes type or
+// units gets a new ID or PARAM_IMAGE_VERSION changes
+#define PARAM_ID_KP				1					//proportional gain
+#define PARAM_ID_KI				2					//integral gain
+#define PARAM_ID_KD				3					//derivative gain
+#define PARAM_ID_ERR_SUM_MAX	4					//integral limit, high
+#define PARAM_ID_ERR_SUM_MIN	5					//integral limit, low
+#define PARAM_ID_ROLL_SENS		16					//roll sensitivity
+#define PARAM_ID_PITCH_SENS		17					//pitch sensitivity
+#define PARAM_ID_THROTTLE_SENS	18					//throttle sensitivity
+#define PARAM_ID_IDLE_DC		19					//motor idle duty cycle
+#define PARAM_ID_ALPHA			32					//accelerometer low pass filter
+#define PARAM_ID_PITCH_TRIM		33					//pitch angle trim
+#define PARAM_ID_ROLL_TRIM		34					//roll angle trim
+
+
+/**************************** Type Definitions ******************************/
+
+//PID gains, the same gains are used for pitch and roll
+typedef struct
+{
+	float				kp;
+	float				ki;
+	float				kd;
+} PID_Gains;
 
 /************************** Function Prototypes *****************************/
 
-void 		FIT_Handler(void);
+void 		ADXL362_Handler(void);
+void 		attitude_task(void);
+void 		rc_task(void);
+void 		input_task(void);
+void 		telemetry_task(void);
+void 		display_task(void);
+void 		handle_input_events(void);
+void 		hud_task(void);
+void 		idle_hook(void);
+void 		telemetry_pump(void);
+bool 		bt_send(const u8 *p_frame, u32 len);
+void 		params_changed(void);
+void 		parse_rc_command(void);
 int 		do_init_nx4io(u32 BaseAddress);
 int 		do_init();
 int 		char2int (char *array, size_t n);
 void 		set_control_dc();
-int 		convert_from_two_complement(int num);
 double 		normalize_angle(double angle);
 
 /************************** Instance declarations *****************************/
 XIntc 		IntrptCtlrInst;						// Interrupt Controller instance
 PmodBT2 	myDevice;							// represents the bluetooth device
-XGpio		GPIOInst0;							// GPIO instance, gets the X,Y values from accelerometer
-XGpio		GPIOInst1;							// GPIO instance, gets the Z values from accelerometer
+PmodENC		pmodENC_inst;						// rotary encoder instance
+ADXL362_AXI	ADXL362Inst;						// accelerometer instance
+ADXL362_Snapshot	accel_snap;					// latest averaged sample read from the accelerometer
+ADXL362_Snapshot	ctrl_snap;					// sample used by the control system
 
+SCHED_Task	tasks[NUM_TASKS] =
+{
+	// name			body				period	budget
+	{"attitude",	attitude_task,		1000,	500},
+	{"rc",			rc_task,			5000,	1000},
+	{"input",		input_task,			10000,	300},
+	{"telemetry",	telemetry_task,		50000,	500},
+	{"display",		display_task,		100000,	1000},
+#ifdef OLED_PRESENT
+	{"hud",			hud_task,			100000,	2000},
+#endif
+};
+
+
+volatile int			x = 0;					//holds the X acceleration (ADXL362 Z axis)
+volatile int			y = 0;					//holds the Y acceleration (ADXL362 Y axis)
+volatile int			z = 0;					//holds the Z acceleration (ADXL362 X axis)
 
-volatile int			x = 0;					//holds the bits read from gpio 0 input port 1
-volatile int			y = 0;					//holds the bits read from gpio 0 input port 2
-volatile int			z = 0;					//holds the bits read from gpio 1 input port 1
-
-volatile int 			fit_count=0;			//used to fine tune the sampling rate of fit handler
 volatile char * 		data=0;					//data buffer for the data received through Bluetooth
 
 volatile u32			Period = 100000;		//defines number of clock cycles required for one cycle of PWM signal
@@ -109,6 +193,11 @@ volatile int 		   	set_pitch = 0;			//the pitch value received from android
 int 					err_sum_max = 200;		//max possible error for integral control
 int 					err_sum_min = -200;		//min possible error for integral control
 
+int						roll_sensitivity = 8;		//defines the impact of change in roll value on motor speed
+int						pitch_sensitivity = 8;		//defines the impact of change in pitch value on motor speed
+int						throttle_sensitivity = 70;	//defines the impact of change in throttle value on motor speed
+int						motor_idle_dc = 14000;		//duty cycle of a motor at zero throttle
+
 int						motor1_control_dc=0;	//duty cycle for brushless motor 1
 int						motor2_control_dc=0;	//duty cycle for brushless motor 2
 int						motor3_control_dc=0;	//duty cycle for brushless motor 3
@@ -123,6 +212,8 @@ float 					prev_fYg = 0;			//previous acceleration in Y axis, for filtering
 float 					prev_fZg = 0;			//previous acceleration in Z axis, for filtering
 
 float 					alpha = 0.5;			//alpha value for low pass filtering
+float					pitch_trim = 1.0;		//added to the calculated pitch, in degrees
+float					roll_trim = -93.0;		//added to the calculated roll, in degrees
 float 					calculated_pitch = 0.0;	//pitch value calculated based on acceleration given by accelerometer
 float 					calculated_roll = 0.0;	//pitch value calculated based on acceleration given by accelerometer
 
@@ -130,10 +221,113 @@ float 					corrected_pitch = 0.0;	//corrected pitch value given from PID control
 float 					corrected_roll = 0.0;	//corrected roll value given from PID control system
 float 					corrected_throttle = 0.0;//corrected throttle value given from PID control system
 
-//Control system parameters
-float 					kp=3.0;
-float 					ki=0.2;
-float 					kd =1.5;
+//Control system parameters.  The attitude task uses pid_gains.  The encoder edits
+//pid_staged and the encoder switch asks the attitude task to take them at the
+//start of its next run, so one control iteration never mixes old and new gains
+PID_Gains				pid_gains = {3.0, 0.2, 1.5};	//gains in use
+PID_Gains				pid_staged = {3.0, 0.2, 1.5};	//gains being tuned
+volatile bool			pid_commit = false;		//pid_staged is waiting to be taken
+u32						pid_commits = 0;		//staged gain sets taken
+
+//Gain tuning with the encoder.  BTNC enters and leaves the tuning mode, the
+//encoder button selects the next gain and turning the encoder adjusts it
+bool					tune_mode = false;		//the display shows the selected gain
+u32						tune_sel = 0;			//gain selected, index into tune_gain
+float * const			tune_gain[TUNE_NUM_GAINS] = {&pid_staged.kp, &pid_staged.ki, &pid_staged.kd};
+const float				tune_step[TUNE_NUM_GAINS] = {0.1, 0.01, 0.1};	//change per encoder detent
+
+//Tuning parameters, in ID order.  The gains are staged like the encoder's, and
+//the image of the parameters is kept in a section that is not cleared at start
+//up, so a processor reset that does not reload the program keeps the tuning
+const PARAM_Def			params[] =
+{
+	// id						type			name			variable				min			max
+	{PARAM_ID_KP,				PARAM_FLOAT,	"kp",			&pid_staged.kp,			0.0,		TUNE_MAX_GAIN},
+	{PARAM_ID_KI,				PARAM_FLOAT,	"ki",			&pid_staged.ki,			0.0,		TUNE_MAX_GAIN},
+	{PARAM_ID_KD,				PARAM_FLOAT,	"kd",			&pid_staged.kd,			0.0,		TUNE_MAX_GAIN},
+	{PARAM_ID_ERR_SUM_MAX,		PARAM_INT,		"err_sum_max",	&err_sum_max,			0,			10000},
+	{PARAM_ID_ERR_SUM_MIN,		PARAM_INT,		"err_sum_min",	&err_sum_min,			-10000,		0},
+	{PARAM_ID_ROLL_SENS,		PARAM_INT,		"roll_sens",	&roll_sensitivity,		0,			50},
+	{PARAM_ID_PITCH_SENS,		PARAM_INT,		"pitch_sens",	&pitch_sensitivity,		0,			50},
+	{PARAM_ID_THROTTLE_SENS,	PARAM_INT,		"thr_sens",		&throttle_sensitivity,	0,			100},
+	{PARAM_ID_IDLE_DC,			PARAM_INT,		"idle_dc",		&motor_idle_dc,			10000,		20000},
+	{PARAM_ID_ALPHA,			PARAM_FLOAT,	"alpha",		&alpha,					0.0,		1.0},
+	{PARAM_ID_PITCH_TRIM,		PARAM_FLOAT,	"pitch_trim",	&pitch_trim,			-180.0,		180.0},
+	{PARAM_ID_ROLL_TRIM,		PARAM_FLOAT,	"roll_trim",	&roll_trim,				-180.0,		180.0},
+};
+//there is no flash controller in embsys, so the image lives in RAM.  The linker
+//script must place .noinit as a NOLOAD section outside .bss, or the start up
+//code clears it; an ELF download reloads it too.  At power up the CRC always
+//fails and PARAM falls back to the defaults
+u8						param_image[PARAM_IMAGE_SIZE(PARAM_MAX_PARAMS)] __attribute__((section(".noinit")));
+u32						param_image_len;		//length of the image in param_image
+
+//Control system state, kept between accelerometer samples
+float 					err_old_pitch = 0.0;	//pitch error of the previous sample, for derivative control
+float 					err_sum_pitch = 0.0;	//accumulated pitch error, for integral control
+float 					err_old_roll = 0.0;		//roll error of the previous sample, for derivative control
+float 					err_sum_roll = 0.0;		//accumulated roll error, for integral control
+
+//Data ready latency measurement, in microseconds from the sample becoming available
+volatile u32			drdy_isr_latency_us = 0;		//to the start of the data ready handler
+volatile u32			drdy_motor_latency_us = 0;		//to the motor duty cycles being written
+volatile u32			drdy_motor_latency_max_us = 0;	//worst case of drdy_motor_latency_us
+volatile u32			drdy_samples = 0;				//number of samples processed
+volatile u32			drdy_missed = 0;				//number of samples the handler did not see
+
+//Telemetry queued for the USB UART, written by the telemetry task and sent while idle
+char					tele_buf[TELEMETRY_BUF_SIZE];
+u32						tele_head = 0;			//next byte to send
+u32						tele_tail = 0;			//next free byte
+u32						tele_dropped = 0;		//lines dropped because the buffer was full
+u32						tele_count = 0;			//telemetry periods since the last report
+
+//Bluetooth data is moved by the PmodBT2 driver's interrupt driven rings.  The
+//remote control task takes the parameter link frames out of the received data
+//and parses the rest
+int						bt_baud = BT2_DEFAULT_BAUD;	//rate of the Bluetooth UART
+
+//Head up display, the widgets are bound to these integer copies of the flight state
+volatile u32			rc_packets = 0;			//remote control packets received
+#ifdef OLED_PRESENT
+PmodOLEDrgb				oled;					//OLED display instance
+int						hud_pitch = 0;			//calculated pitch, in degrees
+int						hud_roll = 0;			//calculated roll, in degrees
+int						hud_link = 0;			//remote control packets per second
+int						hud_loop_hz = 0;		//accelerometer samples processed per second
+u32						hud_count = 0;			//HUD runs since the last rate update
+u32						hud_last_packets = 0;	//rc_packets at the last rate update
+u32						hud_last_samples = 0;	//drdy_samples at the last rate update
+
+HUD_Widget				hud_flight_widgets[] =
+{
+	// type			label	value				value2		min		max		thr	c1	r1	c2	r2	color
+	{HUD_HORIZON,	NULL,	&hud_pitch,			&hud_roll,	0,		30,		1,	0,	0,	95,	39,	0x07E0},
+	{HUD_NUMBER,	"THR",	&set_throttle,		NULL,		0,		0,		1,	0,	40,	47,	47,	0xFFE0},
+	{HUD_NUMBER,	"Hz",	&hud_loop_hz,		NULL,		0,		0,		5,	48,	40,	95,	47,	0x07FF},
+	{HUD_BAR,		NULL,	&set_throttle,		NULL,		0,		100,	1,	0,	50,	95,	53,	0xFFE0},
+	{HUD_NUMBER,	"LNK",	&hud_link,			NULL,		0,		0,		1,	0,	56,	95,	63,	0x07FF},
+};
+
+HUD_Widget				hud_motor_widgets[] =
+{
+	// type			label	value				value2		min		max		thr	c1	r1	c2	r2	color
+	{HUD_NUMBER,	"M1",	&motor1_control_dc,	NULL,		0,		0,		10,	0,	0,	95,	7,	0xFFFF},
+	{HUD_BAR,		NULL,	&motor1_control_dc,	NULL,		14000,	22000,	50,	0,	9,	95,	13,	0xF800},
+	{HUD_NUMBER,	"M2",	&motor2_control_dc,	NULL,		0,		0,		10,	0,	16,	95,	23,	0xFFFF},
+	{HUD_BAR,		NULL,	&motor2_control_dc,	NULL,		14000,	22000,	50,	0,	25,	95,	29,	0xF800},
+	{HUD_NUMBER,	"M3",	&motor3_control_dc,	NULL,		0,		0,		10,	0,	32,	95,	39,	0xFFFF},
+	{HUD_BAR,		NULL,	&motor3_control_dc,	NULL,		14000,	22000,	50,	0,	41,	95,	45,	0xF800},
+	{HUD_NUMBER,	"M4",	&motor4_control_dc,	NULL,		0,		0,		10,	0,	48,	95,	55,	0xFFFF},
+	{HUD_BAR,		NULL,	&motor4_control_dc,	NULL,		14000,	22000,	50,	0,	57,	95,	61,	0xF800},
+};
+
+HUD_Page				hud_pages[] =
+{
+	{"flight",	hud_flight_widgets,	sizeof(hud_flight_widgets) / sizeof(hud_flight_widgets[0])},
+	{"motors",	hud_motor_widgets,	sizeof(hud_motor_widgets) / sizeof(hud_motor_widgets[0])},
+};
+#endif
 
 /************************** MAIN PROGRAM ************************************/
 int main()
@@ -143,14 +337,6 @@ int main()
 	Xil_ICacheEnable();
 	Xil_DCacheEnable();
 
-	//variables for generating pitch control signals
-	float 		err_pitch, err_old_pitch, err_sum_pitch, err_chg_pitch;
-	float 		p_delta_pitch, i_delta_pitch, d_delta_pitch, delta_pitch;
-
-	//variables for generating roll control signals
-	float 		err_roll, err_old_roll, err_sum_roll, err_chg_roll;
-	float 		p_delta_roll, i_delta_roll, d_delta_roll, delta_roll;
-
 	init_platform();
 	sts = do_init();
 	if (XST_SUCCESS != sts)
@@ -159,194 +345,125 @@ int main()
 	}
 	microblaze_enable_interrupts();
 
-	while(1)
+	// run the tasks, the telemetry and the display are sent while no task is due
+	sts = SCHED_initialize(tasks, NUM_TASKS);
+	if (XST_SUCCESS != sts)
 	{
+		exit(1);
+	}
+	SCHED_set_idle_hook(idle_hook);
+	SCHED_run();
 
-		// Process only if there is any data received present in the bluetooth buffer
-		if(strlen(myDevice.recv) > 0)
+	return 0;
+}
+
+/*
+ * Parses the throttle, pitch and roll set points received through Bluetooth
+ * */
+void parse_rc_command()
+{
+	// Process only if there is any data received present in the bluetooth buffer
+	if(strlen(myDevice.recv) > 0)
+	{
+		int 	counter_throttle = 0;		//count variable for array that stores the parsed throtte values
+		int 	counter_pitch = 0;			//count variable for array that stores the parsed pitch values
+		int 	counter_roll = 0;			//count variable for array that stores the roll pitch
+		char 	Throttle[100];				//holds the parsed throttle values from bluetooth
+		char 	Pitch[100];					//holds the parsed pitch values from bluetooth
+		char 	Roll[100];					//holds the parsed roll values from bluetooth
+		int 	flag = 0;					//flag to parse throttle value
+		int 	control_flag =0;			//flag to parse roll and pitch value
+		int 	pitch_flag=0;				//flag to parse pitch value
+		int 	roll_flag=0;				//flag to parse roll value
+		int 	set_roll_temp, set_pitch_temp,set_throttle_temp;
+
+		for(int i=0; i<strlen(myDevice.recv); i++)
 		{
-			int 	counter_throttle = 0;		//count variable for array that stores the parsed throtte values
-			int 	counter_pitch = 0;			//count variable for array that stores the parsed pitch values
-			int 	counter_roll = 0;			//count variable for array that stores the roll pitch
-			char 	Throttle[100];				//holds the parsed throttle values from bluetooth
-			char 	Pitch[100];					//holds the parsed pitch values from bluetooth
-			char 	Roll[100];					//holds the parsed roll values from bluetooth
-			int 	flag = 0;					//flag to parse throttle value
-			int 	control_flag =0;			//flag to parse roll and pitch value
-			int 	pitch_flag=0;				//flag to parse pitch value
-			int 	roll_flag=0;				//flag to parse roll value
-			int 	set_roll_temp, set_pitch_temp,set_throttle_temp;
-
-			for(int i=0; i<strlen(myDevice.recv); i++)
+			//The throttle value is sent from the bluetooth enclosed between two 'A' eg A50A
+			//setting the flags to parse the throttle value
+			if((flag == 0) && (myDevice.recv[i] == 'A'))
 			{
-				//The throttle value is sent from the bluetooth enclosed between two 'A' eg A50A
-				//setting the flags to parse the throttle value
-				if((flag == 0) && (myDevice.recv[i] == 'A'))
-				{
-					flag = 1;
-				}
-				else if((flag == 1) && (myDevice.recv[i] == 'A'))
-				{
-					//clearing the flag after the end of throttle value
-					flag = 0;
-				}
-
-				//The roll and pitch values are sent from the bluetooth enclosed between two 'P'
-				//Eg: PX50Y50P
-				//setting the flags to parse the roll and pitch values
-				if((control_flag == 0) && (myDevice.recv[i] == 'P'))
-				{
-					control_flag = 1;
-				}
-				else if((control_flag == 1) && (myDevice.recv[i] == 'P'))
-				{
-					//clearing the flag at the end of after detecting final 'P'
-					control_flag = 0;
-				}
-
-				//setting the flag to parse pitch
-				//pitch value starts with an 'X' , eg: X50
-				if(control_flag ==1 && pitch_flag ==0 && (myDevice.recv[i] == 'X') )
-				{
-					pitch_flag = 1;
-				}
-				else if(control_flag ==1 && pitch_flag ==1  &&  (myDevice.recv[i] == 'Y'))
-				{
-					pitch_flag = 0;
-				}
-
-				//setting the flag to parse roll
-				//pitch value starts with an 'Y' , eg: Y50
-				if(control_flag ==1 && roll_flag==0 && (myDevice.recv[i] == 'Y') )
-				{
-					roll_flag = 1;
-				}
-				else if(control_flag ==0 && roll_flag==1 && (myDevice.recv[i] == 'P'))
-				{
-					roll_flag = 0;
-				}
-
-				//parsing throttle as long as the throttle flag is set
-				if((flag == 1) && (myDevice.recv[i] != 'A')){
-					Throttle[counter_throttle] = myDevice.recv[i];
-					Throttle[counter_throttle+1] = '\0';
-					Throttle[counter_throttle+2] = '\0';
-					counter_throttle++;
-				}
-
-				//parsing pitch as long as the pitch flag is set
-				if((pitch_flag == 1) && (myDevice.recv[i] != 'X')){
-					Pitch[counter_pitch] = myDevice.recv[i];
-					Pitch[counter_pitch+1] = '\0';
-					Pitch[counter_pitch+2] = '\0';
-					counter_pitch++;
-				}
-
-				//parsing roll as long as the roll flag is set
-				if((roll_flag == 1) && (myDevice.recv[i] != 'Y')){
-					Roll[counter_roll] = myDevice.recv[i];
-					Roll[counter_roll+1] = '\0';
-					Roll[counter_roll+2] = '\0';
-					counter_roll++;
-				}
+				flag = 1;
 			}
-
-			//converting parsed values to integers
-			set_throttle_temp = char2int(Throttle, 3);
-			set_pitch_temp = char2int(Pitch, 3)-30;
-			set_roll_temp = char2int(Roll, 3)-30;
-
-			//Normalizing the values
-			if(roll_flag == 0 && pitch_flag ==0 && flag== 0 && control_flag==0)
+			else if((flag == 1) && (myDevice.recv[i] == 'A'))
 			{
-				set_throttle = set_throttle_temp > 100? set_throttle: set_throttle_temp;
-				set_pitch = set_pitch_temp;
-				set_roll = set_roll_temp;
+				//clearing the flag after the end of throttle value
+				flag = 0;
 			}
 
+			//The roll and pitch values are sent from the bluetooth enclosed between two 'P'
+			//Eg: PX50Y50P
+			//setting the flags to parse the roll and pitch values
+			if((control_flag == 0) && (myDevice.recv[i] == 'P'))
+			{
+				control_flag = 1;
+			}
+			else if((control_flag == 1) && (myDevice.recv[i] == 'P'))
+			{
+				//clearing the flag at the end of after detecting final 'P'
+				control_flag = 0;
+			}
 
-		}
-
-		//reading the X,Y,Z values of acceleration from GPIO
-		x = XGpio_DiscreteRead(&GPIOInst0, GPIO_0_INPUT_0_CHANNEL);
-		z = XGpio_DiscreteRead(&GPIOInst0, GPIO_0_INPUT2_0_CHANNEL);
-		y = XGpio_DiscreteRead(&GPIOInst1, GPIO_1_INPUT_0_CHANNEL);
-
-		//converting acceleration which is in 2s complement format to normal form
-		x = convert_from_two_complement(x);
-		y = convert_from_two_complement(y);
-		z = convert_from_two_complement(z);
-
-		// applying Low Pass filter on the signals
-		fXg = (x) * alpha + (prev_fXg * (1.0 - alpha));
-		fYg = (y) * alpha + (prev_fYg * (1.0 - alpha));
-		fZg = (z) * alpha + (prev_fZg * (1.0 - alpha));
-
-		//saving the previous state for filtering operation
-		prev_fXg = fXg;
-		prev_fYg = fYg;
-		prev_fZg = fZg;
-
-		//converting the values to proper range
-		fXg = x*((2)/(pow(2,11)));
-		fYg = y*((2)/(pow(2,11)));
-		fZg = z*((2)/(pow(2,11)));
-
-
-		//Pitch and roll Equation
-		calculated_pitch = ((atan2(fYg, sqrt(fXg * fXg + fZg * fZg)) * 180.0) / M_PI )+1;
-		calculated_roll  = normalize_angle(((atan2(-fXg, fZg)*180.0)/M_PI)-93);
-
-		// Proportional control for pitch
-		err_pitch = set_pitch - calculated_pitch;
-		p_delta_pitch = err_pitch * kp;
-
-		// Integral Control for pitch
-		err_sum_pitch += err_pitch;
-		if (err_sum_pitch > err_sum_max) err_sum_pitch = err_sum_max;
-		else if (err_sum_pitch < err_sum_min) err_sum_pitch =err_sum_min;
-		i_delta_pitch = err_sum_pitch * ki;
-
-		// Derivative Control for pitch
-		err_chg_pitch = err_pitch - err_old_pitch;
-		d_delta_pitch = err_chg_pitch * kd;
-		err_old_pitch=err_pitch;
-
-		// Delta with PID Control
-		delta_pitch = p_delta_pitch + i_delta_pitch + d_delta_pitch;
-		corrected_pitch = set_pitch + delta_pitch;
+			//setting the flag to parse pitch
+			//pitch value starts with an 'X' , eg: X50
+			if(control_flag ==1 && pitch_flag ==0 && (myDevice.recv[i] == 'X') )
+			{
+				pitch_flag = 1;
+			}
+			else if(control_flag ==1 && pitch_flag ==1  &&  (myDevice.recv[i] == 'Y'))
+			{
+				pitch_flag = 0;
+			}
 
-		// Proportional control for roll
-		err_roll = set_roll - calculated_roll;
-		p_delta_roll = err_roll * kp;
+			//setting the flag to parse roll
+			//pitch value starts with an 'Y' , eg: Y50
+			if(control_flag ==1 && roll_flag==0 && (myDevice.recv[i] == 'Y') )
+			{
+				roll_flag = 1;
+			}
+			else if(control_flag ==0 && roll_flag==1 && (myDevice.recv[i] == 'P'))
+			{
+				roll_flag = 0;
+			}
 
-		// Integral Control for roll
-		err_sum_roll += err_roll;
-		if (err_sum_roll > err_sum_max) err_sum_roll = err_sum_max;
-		else if (err_sum_roll < err_sum_min) err_sum_roll =err_sum_min;
-		i_delta_roll = err_sum_roll * ki;
+			//parsing throttle as long as the throttle flag is set
+			if((flag == 1) && (myDevice.recv[i] != 'A')){
+				Throttle[counter_throttle] = myDevice.recv[i];
+				Throttle[counter_throttle+1] = '\0';
+				Throttle[counter_throttle+2] = '\0';
+				counter_throttle++;
+			}
 
-		// Derivative Control for roll
-		err_chg_roll = err_roll - err_old_roll;
-		d_delta_roll = err_chg_roll * kd;
-		err_old_roll=err_roll;
+			//parsing pitch as long as the pitch flag is set
+			if((pitch_flag == 1) && (myDevice.recv[i] != 'X')){
+				Pitch[counter_pitch] = myDevice.recv[i];
+				Pitch[counter_pitch+1] = '\0';
+				Pitch[counter_pitch+2] = '\0';
+				counter_pitch++;
+			}
 
-		// Delta with PID Control
-		delta_roll = p_delta_roll + i_delta_roll + d_delta_roll;
-		corrected_roll = set_roll + delta_roll;
+			//parsing roll as long as the roll flag is set
+			if((roll_flag == 1) && (myDevice.recv[i] != 'Y')){
+				Roll[counter_roll] = myDevice.recv[i];
+				Roll[counter_roll+1] = '\0';
+				Roll[counter_roll+2] = '\0';
+				counter_roll++;
+			}
+		}
 
-		//compensation for throttle value, when quadcopter performs roll or pitch movements
-		//the additional throttle required is proportional to the cosine of roll and pitch angle
-		corrected_throttle /= cos(calculated_pitch)*cos(calculated_roll);
+		//converting parsed values to integers
+		set_throttle_temp = char2int(Throttle, 3);
+		set_pitch_temp = char2int(Pitch, 3)-30;
+		set_roll_temp = char2int(Roll, 3)-30;
 
-		//calculating the duty cycle values for 4 motors
-		set_control_dc();
+		//Normalizing the values
+		if(roll_flag == 0 && pitch_flag ==0 && flag== 0 && control_flag==0)
+		{
+			set_throttle = set_throttle_temp > 100? set_throttle: set_throttle_temp;
+			set_pitch = set_pitch_temp;
+			set_roll = set_roll_temp;
+		}
 
-		//writing the controlled duty cycle values to 4 motors
-		PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor1_control_dc, MOTOR_1);
-		PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor2_control_dc, MOTOR_2);
-		PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor3_control_dc, MOTOR_3);
-		PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor4_control_dc, MOTOR_4);
 
 	}
 }
@@ -371,23 +488,6 @@ double normalize_angle(double angle)
 	return  normalized;
 }
 
-/*
- * Converts a number in 2s complement to normal form
- * */
-int convert_from_two_complement(int num)
-{
-	const int negative = (num & (1 << 11)) != 0;
-	int nativeInt;
-
-	if (negative)
-		nativeInt = num | ~((1 << 12) - 1);
-	else
-		nativeInt = num;
-
-	return nativeInt;
-
-}
-
 /*
  * Sets the control duty cycle for 4 motors
  *
@@ -404,28 +504,28 @@ void set_control_dc()
 	if(CALIBRATION_MODE == 1)
 	{
 		//for calibration
-		motor1_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle);
-		motor2_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle);
-		motor3_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle);
-		motor4_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle) ;
+		motor1_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle);
+		motor2_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle);
+		motor3_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle);
+		motor4_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle) ;
 	}
 	else
 	{
 		if(set_throttle >= 5)
 		{
 			//calculating the control signals for 4 motors
-			motor1_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle) + (PITCH_SENSITIVITY * corrected_pitch) -(ROLL_SENSITIVITY * corrected_roll);
-			motor2_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle) + (PITCH_SENSITIVITY * corrected_pitch) +(ROLL_SENSITIVITY * corrected_roll);
-			motor3_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle) - (PITCH_SENSITIVITY * corrected_pitch) +(ROLL_SENSITIVITY * corrected_roll);
-			motor4_control_dc = (14000 + THROTTLE_SENSITIVITY * set_throttle) - (PITCH_SENSITIVITY * corrected_pitch) -(ROLL_SENSITIVITY * corrected_roll);
+			motor1_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle) + (pitch_sensitivity * corrected_pitch) -(roll_sensitivity * corrected_roll);
+			motor2_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle) + (pitch_sensitivity * corrected_pitch) +(roll_sensitivity * corrected_roll);
+			motor3_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle) - (pitch_sensitivity * corrected_pitch) +(roll_sensitivity * corrected_roll);
+			motor4_control_dc = (motor_idle_dc + throttle_sensitivity * set_throttle) - (pitch_sensitivity * corrected_pitch) -(roll_sensitivity * corrected_roll);
 		}
 		else
 		{
 			//stopping motors if throttle is less than the threshold
-			motor1_control_dc = 14000;
-			motor2_control_dc = 14000;
-			motor3_control_dc = 14000;
-			motor4_control_dc = 14000;
+			motor1_control_dc = motor_idle_dc;
+			motor2_control_dc = motor_idle_dc;
+			motor3_control_dc = motor_idle_dc;
+			motor4_control_dc = motor_idle_dc;
 
 		}
 	}
@@ -486,35 +586,84 @@ int do_init()
 
 	NX4IO_setLEDs(0x0000);
 
+	// start the time base
+	status = TB_initialize(AXI_TIMER_BASEADDR, AXI_TIMER_FREQ_HZ);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	// initialize the rotary encoder, then the input service that samples it,
+	// the buttons and the switches
+	status = pmodENC_initialize(&pmodENC_inst, PMODENC_BASEADDR);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+	pmodENC_init(&pmodENC_inst, 1, false);
+	INPUT_initialize(&pmodENC_inst);
+
+	// register the tuning parameters and take the image left by the last run,
+	// if there is one.  After power up the image always fails its CRC and the
+	// defaults stand
+	status = PARAM_initialize(params, sizeof(params) / sizeof(params[0]));
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+	param_image_len = PARAM_IMAGE_SIZE(param_image[3]);
+	if (param_image_len <= sizeof(param_image))
+	{
+		PARAM_load(param_image, param_image_len);
+	}
+	param_image_len = PARAM_save(param_image, sizeof(param_image));
+	pid_gains = pid_staged;
+
 	// Adding BT2 Module
 	BT2_begin(&myDevice, XPAR_PMODBT2_0_AXI_LITE_GPIO_BASEADDR, XPAR_PMODBT2_0_AXI_LITE_UART_BASEADDR);
 
+	// move the RN42 and the UART to the fastest rate that works, the RN42
+	// goes back to 9600 baud when it is powered off.  If it is lost the UART
+	// stays at the rate it had
+	BT2_SetDelay(TB_delay_us);
+	bt_baud = BT2_negotiateBaud(&myDevice, BT_MAX_BAUD);
+	if (bt_baud == 0)
+	{
+		bt_baud = myDevice.baud;
+	}
+
+	// the parameter messages share the link with the remote control commands
+	status = PLINK_initialize(bt_send, params_changed);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
 	// PWM Enable
 	PWM_Enable(XPAR_PWM_0_PWM_AXI_BASEADDR);
 	PWM_Set_Period(XPAR_PWM_0_PWM_AXI_BASEADDR, Period);
 
 
-	// initialize the GPIO instances
-	status = XGpio_Initialize(&GPIOInst0, GPIO_0_DEVICE_ID);
+#ifdef OLED_PRESENT
+	// initialize the OLED display and the head up display, the display is
+	// written from the idle hook by the asynchronous SPI queue
+	OLEDrgb_SetDelay(TB_delay_us);
+	OLEDrgb_begin(&oled, RGBDSPLY_GPIO_BASEADDR, RGBDSPLY_SPI_BASEADDR);
+	OLEDrgb_AsyncInit(&oled);
+	status = HUD_initialize(&oled, hud_pages, sizeof(hud_pages) / sizeof(hud_pages[0]));
 	if (status != XST_SUCCESS)
 	{
 		return XST_FAILURE;
 	}
-	xil_printf("Debug GPIO");
+#endif
 
-	// initialize the GPIO instances
-	status = XGpio_Initialize(&GPIOInst1, GPIO_1_DEVICE_ID);
+	// initialize the accelerometer
+	status = ADXL362_initialize(&ADXL362Inst, ADXL362_BASEADDR);
 	if (status != XST_SUCCESS)
 	{
 		return XST_FAILURE;
 	}
 
-	XGpio_SetDataDirection(&GPIOInst0, GPIO_0_INPUT_0_CHANNEL, 0xFFF);
-	XGpio_SetDataDirection(&GPIOInst0, GPIO_0_INPUT2_0_CHANNEL, 0xFFF);
-
-	XGpio_SetDataDirection(&GPIOInst1, GPIO_1_INPUT_0_CHANNEL, 0xFFF);
-	XGpio_SetDataDirection(&GPIOInst1, GPIO_1_INPUT2_0_CHANNEL, 0xFFF);
-
 	// initialize the interrupt controller
 	status = XIntc_Initialize(&IntrptCtlrInst, INTC_DEVICE_ID);
 	if (status != XST_SUCCESS)
@@ -522,14 +671,34 @@ int do_init()
 		return XST_FAILURE;
 	}
 
-	// connect the fixed interval timer (FIT) handler to the interrupt
-	status = XIntc_Connect(&IntrptCtlrInst, FIT_INTERRUPT_ID,
-			(XInterruptHandler)FIT_Handler,
+	// connect the accelerometer data ready handler to the interrupt, it releases
+	// the attitude task for every new accelerometer sample
+	status = XIntc_Connect(&IntrptCtlrInst, ADXL362_INTERRUPT_ID,
+			(XInterruptHandler)ADXL362_Handler,
 			(void *)0);
 	if (status != XST_SUCCESS)
 	{
 		return XST_FAILURE;
+	}
 
+	// connect the time base handler to the AXI timer interrupt, it runs the
+	// deadline callbacks
+	status = XIntc_Connect(&IntrptCtlrInst, TIMER_INTERRUPT_ID,
+			(XInterruptHandler)TB_InterruptHandler,
+			(void *)0);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	// connect the Bluetooth UART handler to its interrupt, it fills the
+	// driver's receive ring and empties its transmit ring
+	status = XIntc_Connect(&IntrptCtlrInst, XPAR_MICROBLAZE_0_AXI_INTC_PMODBT2_0_BT2_UART_INTERRUPT_INTR,
+			(XInterruptHandler)XUartNs550_InterruptHandler,
+			(void *)&myDevice.BT2Uart);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
 	}
 
 	// start the interrupt controller such that interrupts are enabled for
@@ -541,8 +710,18 @@ int do_init()
 	}
 
 	// enable individual interrupts
-	XIntc_Enable(&IntrptCtlrInst, FIT_INTERRUPT_ID);
 	XIntc_Enable(&IntrptCtlrInst, XPAR_MICROBLAZE_0_AXI_INTC_PMODBT2_0_BT2_UART_INTERRUPT_INTR);
+	XIntc_Enable(&IntrptCtlrInst, ADXL362_INTERRUPT_ID);
+	XIntc_Enable(&IntrptCtlrInst, TIMER_INTERRUPT_ID);
+	ADXL362_enable_interrupt(&ADXL362Inst, true);
+
+	// the rate was negotiated polled, from here the UART is interrupt driven
+	// and its receive FIFO trigger level follows the traffic
+	status = BT2_startInterrupts(&myDevice);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
 	return XST_SUCCESS;
 }
 
@@ -600,26 +779,480 @@ int do_init_nx4io(u32 BaseAddress)
 
 
 /*******************************************************************************
- * Fixed interval timer interrupt handler
+ * Accelerometer data ready interrupt handler
+ *
+ * Reads the new accelerometer sample and releases the attitude task to process
+ * it.  Reading the snapshot clears the interrupt.  The time from the sample
+ * becoming available to the start of the handler is measured with the
+ * accelerometer peripheral timestamp counter
+ *
+ *****************************************************************************/
+
+void ADXL362_Handler(void)
+{
+	u32 	now, last_seq;
+
+	now = ADXL362_get_timestamp(&ADXL362Inst);
+
+	//reading the X,Y,Z values of acceleration as one snapshot
+	last_seq = accel_snap.seq;
+	if (ADXL362_read_snapshot(&ADXL362Inst, &accel_snap) != XST_SUCCESS)
+	{
+		return;
+	}
+	if (drdy_samples != 0)
+	{
+		drdy_missed += accel_snap.seq - last_seq - 1;
+	}
+	drdy_samples++;
+	drdy_isr_latency_us = now - accel_snap.timestamp;
+
+	SCHED_release(TASK_ATTITUDE);
+}
+
+
+/****************************** TASKS *****************************************/
+
+
+/*******************************************************************************
+ * Attitude task
+ *
+ * Runs the attitude estimation and the PID control system for every new
+ * accelerometer sample and writes the motor duty cycles.  The task is released
+ * by the data ready handler, the 1 kHz period only catches a lost interrupt.
+ * The time from the sample becoming available to the motor update is
+ * measured with the accelerometer peripheral timestamp counter
+ *
+ *****************************************************************************/
+
+void attitude_task(void)
+{
+	u32 	now;
+
+	//variables for generating pitch control signals
+	float 		err_pitch, err_chg_pitch;
+	float 		p_delta_pitch, i_delta_pitch, d_delta_pitch, delta_pitch;
+
+	//variables for generating roll control signals
+	float 		err_roll, err_chg_roll;
+	float 		p_delta_roll, i_delta_roll, d_delta_roll, delta_roll;
+
+	//copy the sample the handler read, with the interrupts off so it is not torn
+	microblaze_disable_interrupts();
+	if (accel_snap.seq == ctrl_snap.seq)
+	{
+		microblaze_enable_interrupts();
+		return;
+	}
+	ctrl_snap = accel_snap;
+	microblaze_enable_interrupts();
+
+	//the driver returns sign extended values, the axes are mapped as the
+	//accelerometer is mounted on the frame
+	x = ctrl_snap.z;
+	y = ctrl_snap.y;
+	z = ctrl_snap.x;
+
+	// applying Low Pass filter on the signals
+	fXg = (x) * alpha + (prev_fXg * (1.0 - alpha));
+	fYg = (y) * alpha + (prev_fYg * (1.0 - alpha));
+	fZg = (z) * alpha + (prev_fZg * (1.0 - alpha));
+
+	//saving the previous state for filtering operation
+	prev_fXg = fXg;
+	prev_fYg = fYg;
+	prev_fZg = fZg;
+
+	//converting the values to proper range
+	fXg = x*((2)/(pow(2,11)));
+	fYg = y*((2)/(pow(2,11)));
+	fZg = z*((2)/(pow(2,11)));
+
+
+	//Pitch and roll Equation
+	calculated_pitch = ((atan2(fYg, sqrt(fXg * fXg + fZg * fZg)) * 180.0) / M_PI ) + pitch_trim;
+	calculated_roll  = normalize_angle(((atan2(-fXg, fZg)*180.0)/M_PI) + roll_trim);
+
+	//take the committed gains before this iteration uses any of them
+	if (pid_commit)
+	{
+		pid_gains = pid_staged;
+		pid_commit = false;
+		pid_commits++;
+	}
+
+	// Proportional control for pitch
+	err_pitch = set_pitch - calculated_pitch;
+	p_delta_pitch = err_pitch * pid_gains.kp;
+
+	// Integral Control for pitch
+	err_sum_pitch += err_pitch;
+	if (err_sum_pitch > err_sum_max) err_sum_pitch = err_sum_max;
+	else if (err_sum_pitch < err_sum_min) err_sum_pitch =err_sum_min;
+	i_delta_pitch = err_sum_pitch * pid_gains.ki;
+
+	// Derivative Control for pitch
+	err_chg_pitch = err_pitch - err_old_pitch;
+	d_delta_pitch = err_chg_pitch * pid_gains.kd;
+	err_old_pitch=err_pitch;
+
+	// Delta with PID Control
+	delta_pitch = p_delta_pitch + i_delta_pitch + d_delta_pitch;
+	corrected_pitch = set_pitch + delta_pitch;
+
+	// Proportional control for roll
+	err_roll = set_roll - calculated_roll;
+	p_delta_roll = err_roll * pid_gains.kp;
+
+	// Integral Control for roll
+	err_sum_roll += err_roll;
+	if (err_sum_roll > err_sum_max) err_sum_roll = err_sum_max;
+	else if (err_sum_roll < err_sum_min) err_sum_roll =err_sum_min;
+	i_delta_roll = err_sum_roll * pid_gains.ki;
+
+	// Derivative Control for roll
+	err_chg_roll = err_roll - err_old_roll;
+	d_delta_roll = err_chg_roll * pid_gains.kd;
+	err_old_roll=err_roll;
+
+	// Delta with PID Control
+	delta_roll = p_delta_roll + i_delta_roll + d_delta_roll;
+	corrected_roll = set_roll + delta_roll;
+
+	//compensation for throttle value, when quadcopter performs roll or pitch movements
+	//the additional throttle required is proportional to the cosine of roll and pitch angle
+	corrected_throttle /= cos(calculated_pitch)*cos(calculated_roll);
+
+	//calculating the duty cycle values for 4 motors
+	set_control_dc();
+
+	//writing the controlled duty cycle values to 4 motors
+	PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor1_control_dc, MOTOR_1);
+	PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor2_control_dc, MOTOR_2);
+	PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor3_control_dc, MOTOR_3);
+	PWM_Set_Duty(XPAR_PWM_0_PWM_AXI_BASEADDR,motor4_control_dc, MOTOR_4);
+
+	now = ADXL362_get_timestamp(&ADXL362Inst);
+	drdy_motor_latency_us = now - ctrl_snap.timestamp;
+	if (drdy_motor_latency_us > drdy_motor_latency_max_us)
+	{
+		drdy_motor_latency_max_us = drdy_motor_latency_us;
+	}
+}
+
+
+/*******************************************************************************
+ * Remote control task
+ *
+ * Takes the bytes the Bluetooth UART received, handles the parameter link frames in
+ * them and parses the set points from the rest.  Then moves the parameter
+ * dump along
+ *
+ *****************************************************************************/
+
+void rc_task(void)
+{
+	u8		rx[BT2_RX_RING_SIZE];
+	u32		len, now;
+
+	len = BT2_readData(&myDevice, rx, sizeof(rx));
+
+	now = TB_now_us();
+	len = PLINK_receive(rx, len, now);
+	if (len >= sizeof(myDevice.recv))
+	{
+		len = sizeof(myDevice.recv) - 1;
+	}
+	memcpy(myDevice.recv, rx, len);
+	myDevice.recv[len] = '\0';
+	if(len > 0){
+		data = myDevice.recv;
+		rc_packets++;
+	}
+	parse_rc_command();
+
+	PLINK_poll(now);
+}
+
+/*******************************************************************************
+ * Input task
+ *
+ * Samples the buttons, switches and encoder.  The changes are queued as events
+ * for handle_input_events()
+ *
+ *****************************************************************************/
+
+void input_task(void)
+{
+	INPUT_sample();
+}
+
+/*******************************************************************************
+ * Telemetry task
  *
- * Reads the bluetooth signals
+ * Queues the attitude, the set points and the CPU load for the USB UART, and
+ * once every REPORT_PERIOD runs (1 s) the scheduler statistics and the Nexys4IO
+ * register writes sent and saved since the last report, and half a period
+ * later the Bluetooth receive interrupts and FIFO waits.  The line is only
+ * queued, telemetry_pump() sends it while no task is due
  *
  *****************************************************************************/
 
-void FIT_Handler(void)
+void telemetry_task(void)
 {
-	int len = 0;
+	char	line[96];
+	int		len, i;
+	u32		load, io_writes, io_saved;
+	BT2_Stats bt_stats;
 
-	// reads the bluetooth values at every 5 milli seconds
-	while(fit_count >= (FIT_COUNT_1MSEC * 5))
+	if (++tele_count >= REPORT_PERIOD)
 	{
+		tele_count = 0;
+		load = SCHED_cpu_load();
+		NX4IO_getBusStats(&io_writes, &io_saved);
+		NX4IO_resetBusStats();
+		len = sprintf(line, "load %lu.%lu%% overruns %lu dropped %lu io %lu saved %lu\r\n",
+				(unsigned long) (load / 10), (unsigned long) (load % 10),
+				(unsigned long) SCHED_total_overruns(), (unsigned long) tele_dropped,
+				(unsigned long) io_writes, (unsigned long) io_saved);
+	}
+	else if (tele_count == REPORT_PERIOD / 2)
+	{
+		//the waits are counted in character times of the Bluetooth UART
+		BT2_getStats(&myDevice, &bt_stats);
+		BT2_resetStats(&myDevice);
+		len = sprintf(line, "bt irq %lu tmo %lu trig %d wait %lu/%lu us drop %lu\r\n",
+				(unsigned long) bt_stats.rxInterrupts, (unsigned long) bt_stats.rxTimeouts,
+				myDevice.trigger,
+				(unsigned long) (bt_stats.rxInterrupts ? bt_stats.latencySum * (10000000 / bt_baud) / bt_stats.rxInterrupts : 0),
+				(unsigned long) (bt_stats.latencyMax * (10000000 / bt_baud)),
+				(unsigned long) bt_stats.rxDropped);
+	}
+	else
+	{
+		len = sprintf(line, "P%d R%d T%d SP%d SR%d\r\n", (int) calculated_pitch,
+				(int) calculated_roll, set_throttle, set_pitch, set_roll);
+	}
 
-		len = BT2_getData(&myDevice, 20);
-		if(len > 0){
-			XUartNs550_Recv(&myDevice.BT2Uart, (u8*)&myDevice.recv, 20);
-			data = myDevice.recv;
+	//drop the whole line if it does not fit so the receiver never sees half of one
+	if (len > (int) ((TELEMETRY_BUF_SIZE - 1) - ((tele_tail + TELEMETRY_BUF_SIZE - tele_head) % TELEMETRY_BUF_SIZE)))
+	{
+		tele_dropped++;
+		return;
+	}
+	for (i = 0; i < len; i++)
+	{
+		tele_buf[tele_tail] = line[i];
+		tele_tail = (tele_tail + 1) % TELEMETRY_BUF_SIZE;
+	}
+}
+
+/*******************************************************************************
+ * Display task
+ *
+ * Shows the throttle on the left seven segment digits and the CPU load, in
+ * tenths of a percent, on the right digits.  In the tuning mode it shows the
+ * selected staged gain instead.  The LEDs show which tasks have overrun their
+ * budget, and in the tuning mode the gain selected and whether the staged
+ * gains are committed.  Then handles the input events queued since the last run
+ *
+ *****************************************************************************/
+
+void display_task(void)
+{
+	u32 	load, leds = 0;
+
+	handle_input_events();
+
+	//the number formatter in Nexys4IO converts the number, the format is only
+	//written when it changes since the driver drops unchanged writes
+	if (tune_mode)
+	{
+		NX4IO_SSEG_setFormat(FMT_UDEC, 3, true);
+		NX4IO_SSEG_putValue((u32) (*tune_gain[tune_sel] * 1000.0 + 0.5));
+		leds = 1 << (TUNE_LED_SHIFT + tune_sel);
+		if (pid_commit || memcmp(&pid_gains, &pid_staged, sizeof(PID_Gains)) != 0)
+		{
+			leds |= TUNE_LED_STAGED;
 		}
-		fit_count=0;
 	}
-	fit_count++;
+	else
+	{
+		load = SCHED_cpu_load();
+		if (load > 9999)
+		{
+			load = 9999;
+		}
+		NX4IO_SSEG_setFormat(FMT_UDEC, 0, true);
+		NX4IO_SSEG_putValue((u32) set_throttle * 10000 + load);
+	}
+
+	for (int i = 0; i < NUM_TASKS; i++)
+	{
+		if (tasks[i].overruns != 0)
+		{
+			leds |= 1 << i;
+		}
+	}
+	NX4IO_setLEDs(leds);
+}
+
+/*******************************************************************************
+ * Input event handler, called from the display task
+ *
+ * Reads the events the input task queued since the last display update.
+ * BTNR shows the next head up display page.  BTNC enters or leaves the gain
+ * tuning mode, leaving it drops gains that were not committed.  In the tuning
+ * mode the encoder button selects the next gain, turning the encoder adjusts
+ * the staged gain and flipping the encoder switch commits the staged gains
+ *
+ *****************************************************************************/
+
+void handle_input_events(void)
+{
+	INPUT_Event		event;
+	float			gain;
+
+	while (INPUT_get_event(&event))
+	{
+		switch (event.type)
+		{
+			case INPUT_PRESS:
+#ifdef OLED_PRESENT
+				if (event.code == INPUT_BTNR)
+				{
+					HUD_next_page();
+				}
+#endif
+				if (event.code == INPUT_BTNC)
+				{
+					tune_mode = !tune_mode;
+					if (!pid_commit)
+					{
+						pid_staged = pid_gains;
+					}
+				}
+				else if (tune_mode && (event.code == INPUT_ENC_BTN))
+				{
+					tune_sel = (tune_sel + 1) % TUNE_NUM_GAINS;
+				}
+				break;
+			case INPUT_ROTATE:
+				if (tune_mode && !pid_commit)
+				{
+					gain = *tune_gain[tune_sel] + event.value * tune_step[tune_sel];
+					if (gain < 0.0)
+					{
+						gain = 0.0;
+					}
+					else if (gain > TUNE_MAX_GAIN)
+					{
+						gain = TUNE_MAX_GAIN;
+					}
+					*tune_gain[tune_sel] = gain;
+				}
+				break;
+			case INPUT_SWITCH:
+				if (tune_mode && (event.code == INPUT_ENC_SW))
+				{
+					pid_commit = true;
+					param_image_len = PARAM_save(param_image, sizeof(param_image));
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+#ifdef OLED_PRESENT
+/*******************************************************************************
+ * Head up display task
+ *
+ * Copies the flight state to the integers the widgets are bound to, updates
+ * the link and loop rates once a second and lets the HUD draw what changed
+ * within HUD_BUDGET_US
+ *
+ *****************************************************************************/
+
+void hud_task(void)
+{
+	u32		packets, samples;
+
+	hud_pitch = (int) calculated_pitch;
+	hud_roll = (int) calculated_roll;
+
+	if (++hud_count >= HUD_STATS_PERIOD)
+	{
+		hud_count = 0;
+		packets = rc_packets;
+		samples = drdy_samples;
+		hud_link = packets - hud_last_packets;
+		hud_loop_hz = samples - hud_last_samples;
+		hud_last_packets = packets;
+		hud_last_samples = samples;
+	}
+
+	HUD_update(HUD_BUDGET_US);
+}
+#endif
+
+/*******************************************************************************
+ * Idle hook
+ *
+ * Runs while no task is due: sends the queued telemetry and, when there is
+ * an OLED display, keeps its SPI queue moving
+ *
+ *****************************************************************************/
+
+void idle_hook(void)
+{
+	telemetry_pump();
+#ifdef OLED_PRESENT
+	OLEDrgb_AsyncPoll(&oled);
+#endif
+}
+
+/*******************************************************************************
+ * Telemetry pump, called from the idle hook
+ *
+ * Moves queued telemetry bytes to the USB UART transmit FIFO without waiting
+ * for it, so the telemetry never delays a task
+ *
+ *****************************************************************************/
+
+void telemetry_pump(void)
+{
+	while ((tele_head != tele_tail) && !XUartLite_IsTransmitFull(UART_BASEADDR))
+	{
+		XUartLite_WriteReg(UART_BASEADDR, XUL_TX_FIFO_OFFSET, tele_buf[tele_head]);
+		tele_head = (tele_head + 1) % TELEMETRY_BUF_SIZE;
+	}
+}
+
+/*******************************************************************************
+ * Queues a parameter link frame for the Bluetooth UART
+ *
+ * The frame is queued whole or not at all, so the receiver never sees part of
+ * one.  Returns false if there is no room for it
+ *
+ *****************************************************************************/
+
+bool bt_send(const u8 *p_frame, u32 len)
+{
+	return BT2_queueData(&myDevice, p_frame, len) == XST_SUCCESS;
+}
+
+/*******************************************************************************
+ * Called when the parameter link changed parameters
+ *
+ * The gains are set in pid_staged, so they are committed like the encoder's.
+ * The image is saved so a reset keeps the new values
+ *
+ *****************************************************************************/
+
+void params_changed(void)
+{
+	pid_commit = true;
+	param_image_len = PARAM_save(param_image, sizeof(param_image));
 }
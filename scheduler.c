@@ -0,0 +1,278 @@
+/** @file scheduler.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the cooperative rate monotonic scheduler.  Tasks are not preempted by
+* each other, only by interrupts, so a task never needs to lock data shared with another
+* task.  The price is that a task that runs past its budget delays every other task; the
+* overrun counters and the worst case execution times show which task to split.
+*
+* A task is released every period.  An interrupt handler can also release it early with
+* SCHED_release(), the period then restarts from that run, so an event driven task still
+* runs at least once per period.  A periodic release that comes more than a period late is
+* skipped and counted as a miss instead of running the task several times back to back.
+*
+* The CPU load is the time spent in tasks over the time since the statistics were reset,
+* the time spent in interrupt handlers is counted in the task they interrupted.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     11-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "scheduler.h"
+#include "xil_printf.h"
+
+/******************** Static variable declarations **************************/
+static p_SCHED_Task	SchedTasks = NULL;
+static u32			SchedNumTasks = 0;
+static TB_IdleHook	SchedIdleHook = NULL;
+static u32			SchedBusyUs = 0;			// time spent in tasks since the reset
+static u32			SchedWindowStart = 0;		// time of the statistics reset
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the scheduler
+*
+* Checks the task table, clears the statistics and releases every task now.
+*
+* @param	p_tasks is the task table, ordered by period from shortest to longest
+* @param	num_tasks is the number of tasks in the table
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+* 		- XST_INVALID_PARAM	The table is too large, a task has no body or period, or
+* 			the table is not in rate monotonic order
+*
+* @note		The time base must be initialized first
+*****************************************************************************/
+uint32_t SCHED_initialize(p_SCHED_Task p_tasks, u32 num_tasks)
+{
+	u32 now;
+
+	if ((p_tasks == NULL) || (num_tasks == 0) || (num_tasks > SCHED_MAX_TASKS))
+		return XST_INVALID_PARAM;
+
+	for (u32 i = 0; i < num_tasks; i++)
+	{
+		if ((p_tasks[i].run == NULL) || (p_tasks[i].period_us == 0))
+			return XST_INVALID_PARAM;
+		if ((i > 0) && (p_tasks[i].period_us < p_tasks[i - 1].period_us))
+			return XST_INVALID_PARAM;
+	}
+
+	SchedTasks = p_tasks;
+	SchedNumTasks = num_tasks;
+
+	now = TB_now_us();
+	for (u32 i = 0; i < num_tasks; i++)
+	{
+		SchedTasks[i].release_us = now;
+		SchedTasks[i].pending = false;
+	}
+	SCHED_reset_stats();
+
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Set the idle hook
+*
+* @param	hook is called whenever no task is due, NULL to poll
+*
+* @return	*NONE*
+*****************************************************************************/
+void SCHED_set_idle_hook(TB_IdleHook hook)
+{
+	SchedIdleHook = hook;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Release a task now
+*
+* Makes the task due at the next dispatch.  Safe to call from an interrupt handler.
+*
+* @param	task_id is the index of the task in the table
+*
+* @return	*NONE*
+*****************************************************************************/
+void SCHED_release(u32 task_id)
+{
+	if (task_id < SchedNumTasks)
+		SchedTasks[task_id].pending = true;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Run the highest priority task that is due
+*
+* @return	true if a task ran, false if no task was due
+*****************************************************************************/
+bool SCHED_dispatch(void)
+{
+	p_SCHED_Task p_task = NULL;
+	bool released;
+	u32 start, end, exec, late, skipped;
+
+	start = TB_now_us();
+	for (u32 i = 0; i < SchedNumTasks; i++)
+	{
+		if (SchedTasks[i].pending || ((int32_t) (start - SchedTasks[i].release_us) >= 0))
+		{
+			p_task = &SchedTasks[i];
+			break;
+		}
+	}
+	if (p_task == NULL)
+		return false;
+
+	released = p_task->pending;
+	p_task->pending = false;
+
+	p_task->run();
+
+	end = TB_now_us();
+	exec = end - start;
+	SchedBusyUs += exec;
+	p_task->runs++;
+	p_task->last_exec_us = exec;
+	if (exec > p_task->max_exec_us)
+		p_task->max_exec_us = exec;
+	if ((p_task->budget_us != 0) && (exec > p_task->budget_us))
+		p_task->overruns++;
+
+	if (released)
+	{
+		// an early release restarts the period
+		p_task->release_us = start + p_task->period_us;
+	}
+	else
+	{
+		late = start - p_task->release_us;
+		if (late > p_task->max_late_us)
+			p_task->max_late_us = late;
+
+		// skip the releases that have already passed
+		p_task->release_us += p_task->period_us;
+		if ((int32_t) (end - p_task->release_us) >= 0)
+		{
+			skipped = (end - p_task->release_us) / p_task->period_us + 1;
+			p_task->misses += skipped;
+			p_task->release_us += skipped * p_task->period_us;
+		}
+	}
+
+	return true;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Run the tasks forever
+*
+* Dispatches tasks and calls the idle hook when none is due.
+*
+* @return	never returns
+*****************************************************************************/
+void SCHED_run(void)
+{
+	while (1)
+	{
+		if (!SCHED_dispatch() && (SchedIdleHook != NULL))
+			SchedIdleHook();
+	}
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the CPU load
+*
+* @return	the time spent in tasks since the statistics were reset, in tenths of a percent
+*****************************************************************************/
+u32 SCHED_cpu_load(void)
+{
+	u32 window = TB_now_us() - SchedWindowStart;
+
+	if (window == 0)
+		return 0;
+	return (u32) (((u64) SchedBusyUs * 1000) / window);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the number of budget overruns of all of the tasks
+*
+* @return	the sum of the task overrun counters
+*****************************************************************************/
+u32 SCHED_total_overruns(void)
+{
+	u32 total = 0;
+
+	for (u32 i = 0; i < SchedNumTasks; i++)
+		total += SchedTasks[i].overruns;
+	return total;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Reset the statistics
+*
+* Clears the task statistics and starts a new CPU load window.  The releases are not changed.
+*
+* @return	*NONE*
+*****************************************************************************/
+void SCHED_reset_stats(void)
+{
+	for (u32 i = 0; i < SchedNumTasks; i++)
+	{
+		SchedTasks[i].runs = 0;
+		SchedTasks[i].overruns = 0;
+		SchedTasks[i].misses = 0;
+		SchedTasks[i].last_exec_us = 0;
+		SchedTasks[i].max_exec_us = 0;
+		SchedTasks[i].max_late_us = 0;
+	}
+	SchedBusyUs = 0;
+	SchedWindowStart = TB_now_us();
+}
+
+
+/****************************************************************************/
+/**
+* @brief Print the task statistics and the CPU load
+*
+* @return	*NONE*
+*
+* @note		xil_printf() waits for the UART, call it from a task with a generous budget
+*****************************************************************************/
+void SCHED_report(void)
+{
+	u32 load = SCHED_cpu_load();
+
+	xil_printf("CPU load %d.%d%%\r\n", load / 10, load % 10);
+	xil_printf("task        period budget  runs  max_exec max_late overruns misses\r\n");
+	for (u32 i = 0; i < SchedNumTasks; i++)
+	{
+		xil_printf("%-10s %7d %6d %6d %8d %8d %8d %6d\r\n", SchedTasks[i].name,
+			SchedTasks[i].period_us, SchedTasks[i].budget_us, SchedTasks[i].runs,
+			SchedTasks[i].max_exec_us, SchedTasks[i].max_late_us,
+			SchedTasks[i].overruns, SchedTasks[i].misses);
+	}
+}
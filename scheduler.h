@@ -0,0 +1,81 @@
+/** @file scheduler.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants, types and function prototypes for the cooperative
+* rate monotonic scheduler.  The application describes its work as a static table of tasks,
+* each with a release period and an execution time budget.  The table is ordered by period,
+* shortest first, which makes it the rate monotonic priority order.  The scheduler runs the
+* highest priority task that is due, to completion, then looks again.  It keeps the execution
+* time, budget overruns and missed releases of every task and the CPU load.  Time comes from
+* the common time base (timebase.h).
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     11-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+#include "timebase.h"
+
+/************* Constant Declarations *****************/
+#define SCHED_MAX_TASKS		8			// maximum number of tasks in the table
+
+
+/**************************** Type Definitions *****************************/
+
+// task body, runs to completion every time the task is released
+typedef void (*SCHED_TaskFunc)(void);
+
+typedef struct
+{
+	// set by the application in the task table
+	const char		*name;				// task name used in the report
+	SCHED_TaskFunc	run;				// task body
+	u32				period_us;			// release period, in microseconds
+	u32				budget_us;			// execution time budget, in microseconds
+
+	// kept by the scheduler
+	u32				release_us;			// time of the next periodic release
+	volatile bool	pending;			// released early by SCHED_release()
+	u32				runs;				// number of times the task ran
+	u32				overruns;			// runs that took longer than the budget
+	u32				misses;				// periodic releases skipped because the task was late
+	u32				last_exec_us;		// execution time of the last run
+	u32				max_exec_us;		// worst case execution time
+	u32				max_late_us;		// worst case start time after a periodic release
+} SCHED_Task, *p_SCHED_Task;
+
+
+/************************** Function Prototypes ****************************/
+
+// initialization
+uint32_t SCHED_initialize(p_SCHED_Task p_tasks, u32 num_tasks);
+void SCHED_set_idle_hook(TB_IdleHook hook);
+
+// dispatching
+void SCHED_release(u32 task_id);
+bool SCHED_dispatch(void);
+void SCHED_run(void);
+
+// statistics
+u32 SCHED_cpu_load(void);
+u32 SCHED_total_overruns(void);
+void SCHED_reset_stats(void);
+void SCHED_report(void);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,1109 @@
+/*
+ * dmp.c
+ *
+ *  Created on: Mar 17, 2017
+ *      Author: Francisco
+ */
+/**
+ *  @addtogroup  DRIVERS FOR DMP
+ *  @brief       Hardware drivers to communicate with sensors via I2C.
+ *
+ */
+
+#include "dmp.h"
+#include "sensor.h"
+#include "timebase.h"
+#include "dmpKey.h"
+#include "dmpmap.h"
+#include "dmp_image.h"
+
+#define min(a,b) ((a<b)?a:b)
+
+/* Hardware registers needed by driver. */
+struct gyro_reg_s {
+    unsigned char who_am_i;
+    unsigned char rate_div;
+    unsigned char lpf;
+    unsigned char prod_id;
+    unsigned char user_ctrl;
+    unsigned char fifo_en;
+    unsigned char gyro_cfg;
+    unsigned char accel_cfg;
+    unsigned char accel_cfg2;
+    unsigned char lp_accel_odr;
+    unsigned char motion_thr;
+    unsigned char motion_dur;
+    unsigned char fifo_count_h;
+    unsigned char fifo_r_w;
+    unsigned char raw_gyro;
+    unsigned char raw_accel;
+    unsigned char temp;
+    unsigned char int_enable;
+    unsigned char dmp_int_status;
+    unsigned char int_status;
+    unsigned char accel_intel;
+    unsigned char pwr_mgmt_1;
+    unsigned char pwr_mgmt_2;
+    unsigned char int_pin_cfg;
+    unsigned char mem_r_w;
+    unsigned char accel_offs;
+    unsigned char i2c_mst;
+    unsigned char bank_sel;
+    unsigned char mem_start_addr;
+    unsigned char prgm_start_h;
+};
+
+/* Information specific to a particular device. */
+struct hw_s {
+    unsigned char addr;
+    unsigned short max_fifo;
+    unsigned char num_reg;
+    unsigned short temp_sens;
+    short temp_offset;
+    unsigned short bank_size;
+};
+
+/* When entering motion interrupt mode, the driver keeps track of the
+ * previous state so that it can be restored at a later time.
+ * TODO: This is tacky. Fix it.
+ */
+struct motion_int_cache_s {
+    unsigned short gyro_fsr;
+    unsigned char accel_fsr;
+    unsigned short lpf;
+    unsigned short sample_rate;
+    unsigned char sensors_on;
+    unsigned char fifo_sensors;
+    unsigned char dmp_on;
+};
+
+/* Cached chip configuration data.
+ * TODO: A lot of these can be handled with a bitmask.
+ */
+struct chip_cfg_s {
+    /* Matches gyro_cfg >> 3 & 0x03 */
+    unsigned char gyro_fsr;
+    /* Matches accel_cfg >> 3 & 0x03 */
+    unsigned char accel_fsr;
+    /* Enabled sensors. Uses same masks as fifo_en, NOT pwr_mgmt_2. */
+    unsigned char sensors;
+    /* Matches config register. */
+    unsigned char lpf;
+    unsigned char clk_src;
+    /* Sample rate, NOT rate divider. */
+    unsigned short sample_rate;
+    /* Matches fifo_en register. */
+    unsigned char fifo_enable;
+    /* Matches int enable register. */
+    unsigned char int_enable;
+    /* 1 if devices on auxiliary I2C bus appear on the primary. */
+    unsigned char bypass_mode;
+    /* 1 if half-sensitivity.
+     * NOTE: This doesn't belong here, but everything else in hw_s is const,
+     * and this allows us to save some precious RAM.
+     */
+    unsigned char accel_half;
+    /* 1 if device in low-power accel-only mode. */
+    unsigned char lp_accel_mode;
+    /* 1 if interrupts are only triggered on motion events. */
+    unsigned char int_motion_only;
+    struct motion_int_cache_s cache;
+    /* 1 for active low interrupts. */
+    unsigned char active_low_int;
+    /* 1 for latched interrupts. */
+    unsigned char latched_int;
+    /* 1 if DMP is enabled. */
+    unsigned char dmp_on;
+    /* Ensures that DMP will only be loaded once. */
+    unsigned char dmp_loaded;
+    /* Sampling rate used when DMP is enabled. */
+    unsigned short dmp_sample_rate;
+};
+
+/* Information for self-test. */
+struct test_s {
+    unsigned long gyro_sens;
+    unsigned long accel_sens;
+    unsigned char reg_rate_div;
+    unsigned char reg_lpf;
+    unsigned char reg_gyro_fsr;
+    unsigned char reg_accel_fsr;
+    unsigned short wait_ms;
+    unsigned char packet_thresh;
+    float min_dps;
+    float max_dps;
+    float max_gyro_var;
+    float min_g;
+    float max_g;
+    float max_accel_var;
+};
+
+/* Gyro driver state variables. */
+struct gyro_state_s {
+    const struct gyro_reg_s *reg;
+    const struct hw_s *hw;
+    struct chip_cfg_s chip_cfg;
+    const struct test_s *test;
+};
+
+/* Filter configurations. */
+enum lpf_e {
+    INV_FILTER_256HZ_NOLPF2 = 0,
+    INV_FILTER_188HZ,
+    INV_FILTER_98HZ,
+    INV_FILTER_42HZ,
+    INV_FILTER_20HZ,
+    INV_FILTER_10HZ,
+    INV_FILTER_5HZ,
+    INV_FILTER_2100HZ_NOLPF,
+    NUM_FILTER
+};
+
+/* Full scale ranges. */
+enum gyro_fsr_e {
+    INV_FSR_250DPS = 0,
+    INV_FSR_500DPS,
+    INV_FSR_1000DPS,
+    INV_FSR_2000DPS,
+    NUM_GYRO_FSR
+};
+
+/* Full scale ranges. */
+enum accel_fsr_e {
+    INV_FSR_2G = 0,
+    INV_FSR_4G,
+    INV_FSR_8G,
+    INV_FSR_16G,
+    NUM_ACCEL_FSR
+};
+
+/* Clock sources. */
+enum clock_sel_e {
+    INV_CLK_INTERNAL = 0,
+    INV_CLK_PLL,
+    NUM_CLK
+};
+
+/* Low-power accel wakeup rates. */
+enum lp_accel_rate_e {
+    INV_LPA_1_25HZ,
+    INV_LPA_5HZ,
+    INV_LPA_20HZ,
+    INV_LPA_40HZ
+};
+
+#define BIT_I2C_MST_VDDIO   (0x80)
+#define BIT_FIFO_EN         (0x40)
+#define BIT_DMP_EN          (0x80)
+#define BIT_FIFO_RST        (0x04)
+#define BIT_DMP_RST         (0x08)
+#define BIT_FIFO_OVERFLOW   (0x10)
+#define BIT_DATA_RDY_EN     (0x01)
+#define BIT_DMP_INT_EN      (0x02)
+#define BIT_MOT_INT_EN      (0x40)
+#define BITS_FSR            (0x18)
+#define BITS_LPF            (0x07)
+#define BITS_HPF            (0x07)
+#define BITS_CLK            (0x07)
+#define BIT_FIFO_SIZE_1024  (0x40)
+#define BIT_FIFO_SIZE_2048  (0x80)
+#define BIT_FIFO_SIZE_4096  (0xC0)
+#define BIT_RESET           (0x80)
+#define BIT_SLEEP           (0x40)
+#define BIT_S0_DELAY_EN     (0x01)
+#define BIT_S2_DELAY_EN     (0x04)
+#define BITS_SLAVE_LENGTH   (0x0F)
+#define BIT_SLAVE_BYTE_SW   (0x40)
+#define BIT_SLAVE_GROUP     (0x10)
+#define BIT_SLAVE_EN        (0x80)
+#define BIT_I2C_READ        (0x80)
+#define BITS_I2C_MASTER_DLY (0x1F)
+#define BIT_AUX_IF_EN       (0x20)
+#define BIT_ACTL            (0x80)
+#define BIT_LATCH_EN        (0x20)
+#define BIT_ANY_RD_CLR      (0x10)
+#define BIT_BYPASS_EN       (0x02)
+#define BITS_WOM_EN         (0xC0)
+#define BIT_LPA_CYCLE       (0x20)
+#define BIT_STBY_XA         (0x20)
+#define BIT_STBY_YA         (0x10)
+#define BIT_STBY_ZA         (0x08)
+#define BIT_STBY_XG         (0x04)
+#define BIT_STBY_YG         (0x02)
+#define BIT_STBY_ZG         (0x01)
+#define BIT_STBY_XYZA       (BIT_STBY_XA | BIT_STBY_YA | BIT_STBY_ZA)
+#define BIT_STBY_XYZG       (BIT_STBY_XG | BIT_STBY_YG | BIT_STBY_ZG)
+#define BIT_ACCL_FC_B       (0x08)
+
+const struct gyro_reg_s reg = {
+    .who_am_i       = 0x75,
+    .rate_div       = 0x19,
+    .lpf            = 0x1A,
+    .prod_id        = 0x0C,
+    .user_ctrl      = 0x6A,
+    .fifo_en        = 0x23,
+    .gyro_cfg       = 0x1B,
+    .accel_cfg      = 0x1C,
+    .motion_thr     = 0x1F,
+    .motion_dur     = 0x20,
+    .fifo_count_h   = 0x72,
+    .fifo_r_w       = 0x74,
+    .raw_gyro       = 0x43,
+    .raw_accel      = 0x3B,
+    .temp           = 0x41,
+    .int_enable     = 0x38,
+    .dmp_int_status = 0x39,
+    .int_status     = 0x3A,
+    .pwr_mgmt_1     = 0x6B,
+    .pwr_mgmt_2     = 0x6C,
+    .int_pin_cfg    = 0x37,
+    .mem_r_w        = 0x6F,
+    .accel_offs     = 0x06,
+    .i2c_mst        = 0x24,
+    .bank_sel       = 0x6D,
+    .mem_start_addr = 0x6E,
+    .prgm_start_h   = 0x70
+};
+const struct hw_s hw = {
+    .addr           = 0x68,
+    .max_fifo       = 1024,
+    .num_reg        = 118,
+    .temp_sens      = 340,
+    .temp_offset    = -521,
+    .bank_size      = 256
+};
+
+const struct test_s test = {
+    .gyro_sens      = 32768/250,
+    .accel_sens     = 32768/16,
+    .reg_rate_div   = 0,    /* 1kHz. */
+    .reg_lpf        = 1,    /* 188Hz. */
+    .reg_gyro_fsr   = 0,    /* 250dps. */
+    .reg_accel_fsr  = 0x18, /* 16g. */
+    .wait_ms        = 50,
+    .packet_thresh  = 5,    /* 5% */
+    .min_dps        = 10.f,
+    .max_dps        = 105.f,
+    .max_gyro_var   = 0.14f,
+    .min_g          = 0.3f,
+    .max_g          = 0.95f,
+    .max_accel_var  = 0.14f
+};
+
+static struct gyro_state_s st = {
+    .reg = &reg,
+    .hw = &hw,
+    .test = &test
+};
+
+#define DMP_FEATURE_SEND_ANY_GYRO   (DMP_FEATURE_SEND_RAW_GYRO | \
+                                     DMP_FEATURE_SEND_CAL_GYRO)
+
+#define MAX_PACKET_LENGTH   (32)
+
+#define DMP_SAMPLE_RATE     (200)
+#define GYRO_SF             (46850825LL * 200 / DMP_SAMPLE_RATE)
+
+#define FIFO_CORRUPTION_CHECK
+#ifdef  FIFO_CORRUPTION_CHECK
+#define QUAT_ERROR_THRESH       (1L<<24)
+#define QUAT_MAG_SQ_NORMALIZED  (1L<<28)
+#define QUAT_MAG_SQ_MIN         (QUAT_MAG_SQ_NORMALIZED - QUAT_ERROR_THRESH)
+#define QUAT_MAG_SQ_MAX         (QUAT_MAG_SQ_NORMALIZED + QUAT_ERROR_THRESH)
+#endif
+
+struct dmp_s {
+    void (*tap_cb)(unsigned char count, unsigned char direction);
+    void (*android_orient_cb)(unsigned char orientation);
+    unsigned short orient;
+    unsigned short feature_mask;
+    unsigned short fifo_rate;
+    unsigned char packet_length;
+};
+
+static struct dmp_s dmp = {
+    .tap_cb = NULL,
+    .android_orient_cb = NULL,
+    .orient = 0,
+    .feature_mask = 0,
+    .fifo_rate = 0,
+    .packet_length = 0
+};
+
+/**
+ *  @brief      Enable DMP features.
+ *  The following \#define's are used in the input mask:
+ *  \n DMP_FEATURE_TAP
+ *  \n DMP_FEATURE_ANDROID_ORIENT
+ *  \n DMP_FEATURE_LP_QUAT
+ *  \n DMP_FEATURE_6X_LP_QUAT
+ *  \n DMP_FEATURE_GYRO_CAL
+ *  \n DMP_FEATURE_SEND_RAW_ACCEL
+ *  \n DMP_FEATURE_SEND_RAW_GYRO
+ *  \n NOTE: DMP_FEATURE_LP_QUAT and DMP_FEATURE_6X_LP_QUAT are mutually
+ *  exclusive.
+ *  \n NOTE: DMP_FEATURE_SEND_RAW_GYRO and DMP_FEATURE_SEND_CAL_GYRO are also
+ *  mutually exclusive.
+ *  @param[in]  mask    Mask of features to enable.
+ *  @return     0 if successful.
+ */
+/**
+ *  @brief      Calibrate the gyro data in the DMP.
+ *  After eight seconds of no motion, the DMP will compute gyro biases and
+ *  subtract them from the quaternion output. If @e dmp_enable_feature is
+ *  called with @e DMP_FEATURE_SEND_CAL_GYRO, the biases will also be
+ *  subtracted from the gyro output.
+ *  @param[in]  enable  1 to enable gyro calibration.
+ *  @return     0 if successful.
+ */
+int dmp_enable_gyro_cal(unsigned char enable)
+{
+    if (enable) {
+        unsigned char regs[9] = {0xb8, 0xaa, 0xb3, 0x8d, 0xb4, 0x98, 0x0d, 0x35, 0x5d};
+        return mpu_write_mem(CFG_MOTION_BIAS, 9, regs);
+    } else {
+        unsigned char regs[9] = {0xb8, 0xaa, 0xaa, 0xaa, 0xb0, 0x88, 0xc3, 0xc5, 0xc7};
+        return mpu_write_mem(CFG_MOTION_BIAS, 9, regs);
+    }
+}
+
+int dmp_enable_feature(unsigned short mask)
+{
+    unsigned char tmp[10];
+
+    /* TODO: All of these settings can probably be integrated into the default
+     * DMP image.
+     */
+    /* Set integration scale factor. */
+    tmp[0] = (unsigned char)((GYRO_SF >> 24) & 0xFF);
+    tmp[1] = (unsigned char)((GYRO_SF >> 16) & 0xFF);
+    tmp[2] = (unsigned char)((GYRO_SF >> 8) & 0xFF);
+    tmp[3] = (unsigned char)(GYRO_SF & 0xFF);
+    mpu_write_mem(D_0_104, 4, tmp);
+
+    /* Send sensor data to the FIFO. */
+    tmp[0] = 0xA3;
+    if (mask & DMP_FEATURE_SEND_RAW_ACCEL) {
+        tmp[1] = 0xC0;
+        tmp[2] = 0xC8;
+        tmp[3] = 0xC2;
+    } else {
+        tmp[1] = 0xA3;
+        tmp[2] = 0xA3;
+        tmp[3] = 0xA3;
+    }
+    if (mask & DMP_FEATURE_SEND_ANY_GYRO) {
+        tmp[4] = 0xC4;
+        tmp[5] = 0xCC;
+        tmp[6] = 0xC6;
+    } else {
+        tmp[4] = 0xA3;
+        tmp[5] = 0xA3;
+        tmp[6] = 0xA3;
+    }
+    tmp[7] = 0xA3;
+    tmp[8] = 0xA3;
+    tmp[9] = 0xA3;
+    mpu_write_mem(CFG_15,10,tmp);
+
+    /* Send gesture data to the FIFO. */
+    if (mask & (DMP_FEATURE_TAP | DMP_FEATURE_ANDROID_ORIENT))
+        tmp[0] = DINA20;
+    else
+        tmp[0] = 0xD8;
+    mpu_write_mem(CFG_27,1,tmp);
+
+    if (mask & DMP_FEATURE_GYRO_CAL)
+        dmp_enable_gyro_cal(1);
+    else
+        dmp_enable_gyro_cal(0);
+
+    if (mask & DMP_FEATURE_SEND_ANY_GYRO) {
+        if (mask & DMP_FEATURE_SEND_CAL_GYRO) {
+            tmp[0] = 0xB2;
+            tmp[1] = 0x8B;
+            tmp[2] = 0xB6;
+            tmp[3] = 0x9B;
+        } else {
+            tmp[0] = DINAC0;
+            tmp[1] = DINA80;
+            tmp[2] = DINAC2;
+            tmp[3] = DINA90;
+        }
+        mpu_write_mem(CFG_GYRO_RAW_DATA, 4, tmp);
+    }
+
+    if (mask & DMP_FEATURE_TAP) {
+        /* Enable tap. */
+        tmp[0] = 0xF8;
+        mpu_write_mem(CFG_20, 1, tmp);
+        //dmp_set_tap_thresh(TAP_XYZ, 250);
+//        dmp_set_tap_axes(TAP_XYZ);
+//        dmp_set_tap_count(1);
+//        dmp_set_tap_time(100);
+//        dmp_set_tap_time_multi(500);
+//
+//        dmp_set_shake_reject_thresh(GYRO_SF, 200);
+//        dmp_set_shake_reject_time(40);
+//        dmp_set_shake_reject_timeout(10);
+    } else {
+        tmp[0] = 0xD8;
+        mpu_write_mem(CFG_20, 1, tmp);
+    }
+
+    if (mask & DMP_FEATURE_ANDROID_ORIENT) {
+        tmp[0] = 0xD9;
+    } else
+        tmp[0] = 0xD8;
+    mpu_write_mem(CFG_ANDROID_ORIENT_INT, 1, tmp);
+
+    if (mask & DMP_FEATURE_LP_QUAT)
+        dmp_enable_lp_quat(1);
+    else
+        dmp_enable_lp_quat(0);
+
+    if (mask & DMP_FEATURE_6X_LP_QUAT)
+        dmp_enable_6x_lp_quat(1);
+    else
+        dmp_enable_6x_lp_quat(0);
+
+    /* Pedometer is always enabled. */
+    dmp.feature_mask = mask | DMP_FEATURE_PEDOMETER;
+    mpu_reset_fifo();
+
+    dmp.packet_length = 0;
+    if (mask & DMP_FEATURE_SEND_RAW_ACCEL)
+        dmp.packet_length += 6;
+    if (mask & DMP_FEATURE_SEND_ANY_GYRO)
+        dmp.packet_length += 6;
+    if (mask & (DMP_FEATURE_LP_QUAT | DMP_FEATURE_6X_LP_QUAT))
+        dmp.packet_length += 16;
+    if (mask & (DMP_FEATURE_TAP | DMP_FEATURE_ANDROID_ORIENT))
+        dmp.packet_length += 4;
+
+    return 0;
+}
+
+/**
+ *  @brief  Load the DMP with this image.
+ *  @return 0 if successful.
+ */
+int dmp_load_motion_driver_firmware(void)
+{
+    return mpu_load_firmware(DMP_CODE_SIZE, dmp_memory, sStartAddress,
+        DMP_SAMPLE_RATE);
+}
+
+/**
+ *  @brief      Push gyro and accel orientation to the DMP.
+ *  The orientation is represented here as the output of
+ *  @e inv_orientation_matrix_to_scalar.
+ *  @param[in]  orient  Gyro and accel orientation in body frame.
+ *  @return     0 if successful.
+ */
+int dmp_set_orientation(unsigned short orient)
+{
+    unsigned char gyro_regs[3], accel_regs[3];
+    const unsigned char gyro_axes[3] = {DINA4C, DINACD, DINA6C};
+    const unsigned char accel_axes[3] = {DINA0C, DINAC9, DINA2C};
+    const unsigned char gyro_sign[3] = {DINA36, DINA56, DINA76};
+    const unsigned char accel_sign[3] = {DINA26, DINA46, DINA66};
+
+    gyro_regs[0] = gyro_axes[orient & 3];
+    gyro_regs[1] = gyro_axes[(orient >> 3) & 3];
+    gyro_regs[2] = gyro_axes[(orient >> 6) & 3];
+    accel_regs[0] = accel_axes[orient & 3];
+    accel_regs[1] = accel_axes[(orient >> 3) & 3];
+    accel_regs[2] = accel_axes[(orient >> 6) & 3];
+
+    /* Chip-to-body, axes only. */
+    if (mpu_write_mem(FCFG_1, 3, gyro_regs))
+        return -1;
+    if (mpu_write_mem(FCFG_2, 3, accel_regs))
+        return -1;
+
+    memcpy(gyro_regs, gyro_sign, 3);
+    memcpy(accel_regs, accel_sign, 3);
+    if (orient & 4) {
+        gyro_regs[0] |= 1;
+        accel_regs[0] |= 1;
+    }
+    if (orient & 0x20) {
+        gyro_regs[1] |= 1;
+        accel_regs[1] |= 1;
+    }
+    if (orient & 0x100) {
+        gyro_regs[2] |= 1;
+        accel_regs[2] |= 1;
+    }
+
+    /* Chip-to-body, sign only. */
+    if (mpu_write_mem(FCFG_3, 3, gyro_regs))
+        return -1;
+    if (mpu_write_mem(FCFG_7, 3, accel_regs))
+        return -1;
+    dmp.orient = orient;
+    return 0;
+}
+
+/**
+ *  @brief      Push gyro biases to the DMP.
+ *  Because the gyro integration is handled in the DMP, any gyro biases
+ *  calculated by the MPL should be pushed down to DMP memory to remove
+ *  3-axis quaternion drift.
+ *  \n NOTE: If the DMP-based gyro calibration is enabled, the DMP will
+ *  overwrite the biases written to this location once a new one is computed.
+ *  @param[in]  bias    Gyro biases in q16.
+ *  @return     0 if successful.
+ */
+int dmp_set_gyro_bias(long *bias)
+{
+    long gyro_bias_body[3];
+    unsigned char regs[4];
+
+    gyro_bias_body[0] = bias[dmp.orient & 3];
+    if (dmp.orient & 4)
+        gyro_bias_body[0] *= -1;
+    gyro_bias_body[1] = bias[(dmp.orient >> 3) & 3];
+    if (dmp.orient & 0x20)
+        gyro_bias_body[1] *= -1;
+    gyro_bias_body[2] = bias[(dmp.orient >> 6) & 3];
+    if (dmp.orient & 0x100)
+        gyro_bias_body[2] *= -1;
+
+#ifdef EMPL_NO_64BIT
+    gyro_bias_body[0] = (long)(((float)gyro_bias_body[0] * GYRO_SF) / 1073741824.f);
+    gyro_bias_body[1] = (long)(((float)gyro_bias_body[1] * GYRO_SF) / 1073741824.f);
+    gyro_bias_body[2] = (long)(((float)gyro_bias_body[2] * GYRO_SF) / 1073741824.f);
+#else
+    gyro_bias_body[0] = (long)(((long long)gyro_bias_body[0] * GYRO_SF) >> 30);
+    gyro_bias_body[1] = (long)(((long long)gyro_bias_body[1] * GYRO_SF) >> 30);
+    gyro_bias_body[2] = (long)(((long long)gyro_bias_body[2] * GYRO_SF) >> 30);
+#endif
+
+    regs[0] = (unsigned char)((gyro_bias_body[0] >> 24) & 0xFF);
+    regs[1] = (unsigned char)((gyro_bias_body[0] >> 16) & 0xFF);
+    regs[2] = (unsigned char)((gyro_bias_body[0] >> 8) & 0xFF);
+    regs[3] = (unsigned char)(gyro_bias_body[0] & 0xFF);
+    if (mpu_write_mem(D_EXT_GYRO_BIAS_X, 4, regs))
+        return -1;
+
+    regs[0] = (unsigned char)((gyro_bias_body[1] >> 24) & 0xFF);
+    regs[1] = (unsigned char)((gyro_bias_body[1] >> 16) & 0xFF);
+    regs[2] = (unsigned char)((gyro_bias_body[1] >> 8) & 0xFF);
+    regs[3] = (unsigned char)(gyro_bias_body[1] & 0xFF);
+    if (mpu_write_mem(D_EXT_GYRO_BIAS_Y, 4, regs))
+        return -1;
+
+    regs[0] = (unsigned char)((gyro_bias_body[2] >> 24) & 0xFF);
+    regs[1] = (unsigned char)((gyro_bias_body[2] >> 16) & 0xFF);
+    regs[2] = (unsigned char)((gyro_bias_body[2] >> 8) & 0xFF);
+    regs[3] = (unsigned char)(gyro_bias_body[2] & 0xFF);
+    return mpu_write_mem(D_EXT_GYRO_BIAS_Z, 4, regs);
+}
+
+/**
+ *  @brief      Push accel biases to the DMP.
+ *  These biases will be removed from the DMP 6-axis quaternion.
+ *  @param[in]  bias    Accel biases in q16.
+ *  @return     0 if successful.
+ */
+//int dmp_set_accel_bias(long *bias)
+//{
+//    long accel_bias_body[3];
+//    unsigned char regs[12];
+//    long long accel_sf;
+//    unsigned short accel_sens;
+//
+//    mpu_get_accel_sens(&accel_sens);
+//    accel_sf = (long long)accel_sens << 15;
+//    __no_operation();
+//
+//    accel_bias_body[0] = bias[dmp.orient & 3];
+//    if (dmp.orient & 4)
+//        accel_bias_body[0] *= -1;
+//    accel_bias_body[1] = bias[(dmp.orient >> 3) & 3];
+//    if (dmp.orient & 0x20)
+//        accel_bias_body[1] *= -1;
+//    accel_bias_body[2] = bias[(dmp.orient >> 6) & 3];
+//    if (dmp.orient & 0x100)
+//        accel_bias_body[2] *= -1;
+//
+//#ifdef EMPL_NO_64BIT
+//    accel_bias_body[0] = (long)(((float)accel_bias_body[0] * accel_sf) / 1073741824.f);
+//    accel_bias_body[1] = (long)(((float)accel_bias_body[1] * accel_sf) / 1073741824.f);
+//    accel_bias_body[2] = (long)(((float)accel_bias_body[2] * accel_sf) / 1073741824.f);
+//#else
+//    accel_bias_body[0] = (long)(((long long)accel_bias_body[0] * accel_sf) >> 30);
+//    accel_bias_body[1] = (long)(((long long)accel_bias_body[1] * accel_sf) >> 30);
+//    accel_bias_body[2] = (long)(((long long)accel_bias_body[2] * accel_sf) >> 30);
+//#endif
+//
+//    regs[0] = (unsigned char)((accel_bias_body[0] >> 24) & 0xFF);
+//    regs[1] = (unsigned char)((accel_bias_body[0] >> 16) & 0xFF);
+//    regs[2] = (unsigned char)((accel_bias_body[0] >> 8) & 0xFF);
+//    regs[3] = (unsigned char)(accel_bias_body[0] & 0xFF);
+//    regs[4] = (unsigned char)((accel_bias_body[1] >> 24) & 0xFF);
+//    regs[5] = (unsigned char)((accel_bias_body[1] >> 16) & 0xFF);
+//    regs[6] = (unsigned char)((accel_bias_body[1] >> 8) & 0xFF);
+//    regs[7] = (unsigned char)(accel_bias_body[1] & 0xFF);
+//    regs[8] = (unsigned char)((accel_bias_body[2] >> 24) & 0xFF);
+//    regs[9] = (unsigned char)((accel_bias_body[2] >> 16) & 0xFF);
+//    regs[10] = (unsigned char)((accel_bias_body[2] >> 8) & 0xFF);
+//    regs[11] = (unsigned char)(accel_bias_body[2] & 0xFF);
+//    return mpu_write_mem(D_ACCEL_BIAS, 12, regs);
+//}
+
+/**
+ *  @brief      Set DMP output rate.
+ *  Only used when DMP is on.
+ *  @param[in]  rate    Desired fifo rate (Hz).
+ *  @return     0 if successful.
+ */
+int dmp_set_fifo_rate(unsigned short rate)
+{
+    const unsigned char regs_end[12] = {DINAFE, DINAF2, DINAAB,
+        0xc4, DINAAA, DINAF1, DINADF, DINADF, 0xBB, 0xAF, DINADF, DINADF};
+    unsigned short div;
+    unsigned char tmp[8];
+
+    if (rate > DMP_SAMPLE_RATE)
+        return -1;
+    div = DMP_SAMPLE_RATE / rate - 1;
+    tmp[0] = (unsigned char)((div >> 8) & 0xFF);
+    tmp[1] = (unsigned char)(div & 0xFF);
+    if (mpu_write_mem(D_0_22, 2, tmp))
+        return -1;
+    if (mpu_write_mem(CFG_6, 12, (unsigned char*)regs_end))
+        return -1;
+
+    dmp.fifo_rate = rate;
+    return 0;
+}
+
+/**
+ *  @brief      Get DMP output rate.
+ *  @param[out] rate    Current fifo rate (Hz).
+ *  @return     0 if successful.
+ */
+int dmp_get_fifo_rate(unsigned short *rate)
+{
+    rate[0] = dmp.fifo_rate;
+    return 0;
+}
+
+/**
+ *  @brief      Generate 3-axis quaternions from the DMP.
+ *  In this driver, the 3-axis and 6-axis DMP quaternion features are mutually
+ *  exclusive.
+ *  @param[in]  enable  1 to enable 3-axis quaternion.
+ *  @return     0 if successful.
+ */
+int dmp_enable_lp_quat(unsigned char enable)
+{
+    unsigned char regs[4];
+    if (enable) {
+        regs[0] = DINBC0;
+        regs[1] = DINBC2;
+        regs[2] = DINBC4;
+        regs[3] = DINBC6;
+    }
+    else
+        memset(regs, 0x8B, 4);
+
+    mpu_write_mem(CFG_LP_QUAT, 4, regs);
+
+    return mpu_reset_fifo();
+}
+
+/**
+ *  @brief       Generate 6-axis quaternions from the DMP.
+ *  In this driver, the 3-axis and 6-axis DMP quaternion features are mutually
+ *  exclusive.
+ *  @param[in]   enable  1 to enable 6-axis quaternion.
+ *  @return      0 if successful.
+ */
+int dmp_enable_6x_lp_quat(unsigned char enable)
+{
+    unsigned char regs[4];
+    if (enable) {
+        regs[0] = DINA20;
+        regs[1] = DINA28;
+        regs[2] = DINA30;
+        regs[3] = DINA38;
+    } else
+        memset(regs, 0xA3, 4);
+
+    mpu_write_mem(CFG_8, 4, regs);
+
+    return mpu_reset_fifo();
+}
+
+/**
+ *  @brief      Specify when a DMP interrupt should occur.
+ *  A DMP interrupt can be configured to trigger on either of the two
+ *  conditions below:
+ *  \n a. One FIFO period has elapsed (set by @e mpu_set_sample_rate).
+ *  \n b. A tap event has been detected.
+ *  @param[in]  mode    DMP_INT_GESTURE or DMP_INT_CONTINUOUS.
+ *  @return     0 if successful.
+ */
+//int dmp_set_interrupt_mode(unsigned char mode)
+//{
+//    const unsigned char regs_continuous[11] =
+//        {0xd8, 0xb1, 0xb9, 0xf3, 0x8b, 0xa3, 0x91, 0xb6, 0x09, 0xb4, 0xd9};
+//    const unsigned char regs_gesture[11] =
+//        {0xda, 0xb1, 0xb9, 0xf3, 0x8b, 0xa3, 0x91, 0xb6, 0xda, 0xb4, 0xda};
+//
+//    switch (mode) {
+//    case DMP_INT_CONTINUOUS:
+//        return mpu_write_mem(CFG_FIFO_ON_EVENT, 11,
+//            (unsigned char*)regs_continuous);
+//    default:
+//        return -1;
+//    }
+//}
+
+/**
+ *  @brief      Write to the DMP memory.
+ *  This function prevents I2C writes past the bank boundaries. The DMP memory
+ *  is only accessible when the chip is awake.
+ *  @param[in]  mem_addr    Memory location (bank << 8 | start address)
+ *  @param[in]  length      Number of bytes to write.
+ *  @param[in]  data        Bytes to write to memory.
+ *  @return     0 if successful.
+ */
+int mpu_write_mem(unsigned short mem_addr, unsigned short length,
+        unsigned char *data)
+{
+    unsigned char tmp[2];
+
+    if (!data)
+        return -1;
+
+    tmp[0] = (unsigned char)(mem_addr >> 8);
+    tmp[1] = (unsigned char)(mem_addr & 0xFF);
+
+    /* Check bank boundaries. */
+    if (tmp[1] + length > st.hw->bank_size)
+        return -1;
+
+    if (i2c_write(st.hw->addr, st.reg->bank_sel, 2, tmp))
+        return -1;
+    if (i2c_write(st.hw->addr, st.reg->mem_r_w, length, data))
+        return -1;
+    return 0;
+}
+
+/**
+ *  @brief      Read from the DMP memory.
+ *  This function prevents I2C reads past the bank boundaries. The DMP memory
+ *  is only accessible when the chip is awake.
+ *  @param[in]  mem_addr    Memory location (bank << 8 | start address)
+ *  @param[in]  length      Number of bytes to read.
+ *  @param[out] data        Bytes read from memory.
+ *  @return     0 if successful.
+ */
+int mpu_read_mem(unsigned short mem_addr, unsigned short length,
+        unsigned char *data)
+{
+    unsigned char tmp[2];
+
+    if (!data)
+        return -1;
+
+    tmp[0] = (unsigned char)(mem_addr >> 8);
+    tmp[1] = (unsigned char)(mem_addr & 0xFF);
+
+    /* Check bank boundaries. */
+    if (tmp[1] + length > st.hw->bank_size)
+        return -1;
+
+    if (i2c_write(st.hw->addr, st.reg->bank_sel, 2, tmp))
+        return -1;
+    if (i2c_read(st.hw->addr, st.reg->mem_r_w, length, data))
+        return -1;
+    return 0;
+}
+
+/**
+ *  @brief  Reset FIFO read/write pointers.
+ *  @return 0 if successful.
+ */
+int mpu_reset_fifo(void)
+{
+    unsigned char data;
+
+    if (!(st.chip_cfg.sensors))
+        return -1;
+
+    data = 0;
+    if (i2c_write(st.hw->addr, st.reg->int_enable, 1, &data))
+        return -1;
+    if (i2c_write(st.hw->addr, st.reg->fifo_en, 1, &data))
+        return -1;
+    if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+        return -1;
+
+    if (st.chip_cfg.dmp_on) {
+        data = BIT_FIFO_RST | BIT_DMP_RST;
+        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+            return -1;
+        isleep(50e3);
+        data = BIT_DMP_EN | BIT_FIFO_EN;
+        if (st.chip_cfg.sensors & INV_XYZ_COMPASS)
+            data |= BIT_AUX_IF_EN;
+        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+            return -1;
+        if (st.chip_cfg.int_enable)
+            data = BIT_DMP_INT_EN;
+        else
+            data = 0;
+        if (i2c_write(st.hw->addr, st.reg->int_enable, 1, &data))
+            return -1;
+        data = 0;
+        if (i2c_write(st.hw->addr, st.reg->fifo_en, 1, &data))
+            return -1;
+    } else {
+        data = BIT_FIFO_RST;
+        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+            return -1;
+        if (st.chip_cfg.bypass_mode || !(st.chip_cfg.sensors & INV_XYZ_COMPASS))
+            data = BIT_FIFO_EN;
+        else
+            data = BIT_FIFO_EN | BIT_AUX_IF_EN;
+        if (i2c_write(st.hw->addr, st.reg->user_ctrl, 1, &data))
+            return -1;
+        isleep(50e3);
+        if (st.chip_cfg.int_enable)
+            data = BIT_DATA_RDY_EN;
+        else
+            data = 0;
+        if (i2c_write(st.hw->addr, st.reg->int_enable, 1, &data))
+            return -1;
+        if (i2c_write(st.hw->addr, st.reg->fifo_en, 1, &st.chip_cfg.fifo_enable))
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ *  @brief      Load and verify DMP image.
+ *  @param[in]  length      Length of DMP image.
+ *  @param[in]  firmware    DMP code.
+ *  @param[in]  start_addr  Starting address of DMP code memory.
+ *  @param[in]  sample_rate Fixed sampling rate used when DMP is enabled.
+ *  @return     0 if successful.
+ */
+int mpu_load_firmware(unsigned short length, const unsigned char *firmware,
+    unsigned short start_addr, unsigned short sample_rate)
+{
+    unsigned short ii;
+    unsigned short this_write;
+    /* Must divide evenly into st.hw->bank_size to avoid bank crossings. */
+#define LOAD_CHUNK  (16)
+    unsigned char cur[LOAD_CHUNK], tmp[2];
+
+    if (st.chip_cfg.dmp_loaded)
+        /* DMP should only be loaded once. */
+        return -1;
+
+    if (!firmware)
+        return -1;
+    for (ii = 0; ii < length; ii += this_write) {
+        this_write = min(LOAD_CHUNK, length - ii);
+        if (mpu_write_mem(ii, this_write, (unsigned char*)&firmware[ii]))
+            return -1;
+        if (mpu_read_mem(ii, this_write, cur))
+            return -1;
+        if (memcmp(firmware+ii, cur, this_write))
+            return -2;
+    }
+
+    /* Set program start address. */
+    tmp[0] = start_addr >> 8;
+    tmp[1] = start_addr & 0xFF;
+    if (i2c_write(st.hw->addr, st.reg->prgm_start_h, 2, tmp))
+        return -1;
+
+    st.chip_cfg.dmp_loaded = 1;
+    st.chip_cfg.dmp_sample_rate = sample_rate;
+    return 0;
+}
+
+/* FIFO drain statistics. */
+static struct dmp_fifo_stats_s fifo_stats;
+
+/**
+ *  @brief      Reset and re-enable the FIFO after an overflow.
+ */
+static void mpu_restart_fifo(void)
+{
+    unsigned char data;
+
+    data = 0x04; //Reset FIFO
+    i2c_write(0, st.reg->user_ctrl, 1, &data);
+    data = 0x40; // Enable FIFO
+    i2c_write(0, st.reg->user_ctrl, 1, &data);
+}
+
+/**
+ *  @brief      Get one unparsed packet from the FIFO.
+ *  This function should be used if the packet is to be parsed elsewhere.
+ *  @param[in]  length  Length of one FIFO packet.
+ *  @param[in]  data    FIFO packet.
+ *  @param[in]  more    Number of remaining packets.
+ */
+int mpu_read_fifo_stream(unsigned short length, unsigned char *data)
+{
+    unsigned char tmp[2];
+    u16 fifo_count;
+
+    if (i2c_read(st.hw->addr, st.reg->fifo_count_h, 2, tmp))
+        return -1;
+    fifo_count = (tmp[0] << 8) | tmp[1];
+    if (fifo_count < length) {
+        return -1;
+    }
+    if (fifo_count == st.hw->max_fifo) {
+        fifo_stats.overflows++;
+        fifo_stats.lost += fifo_count / length;
+        mpu_restart_fifo();
+        return -1;
+    }
+
+    if (i2c_read(st.hw->addr, st.reg->fifo_r_w, length, data))
+        return -1;
+    return 0;
+}
+
+/***************************************************************************
+ *  @brief      Get one packet from the FIFO.
+ *  If @e sensors does not contain a particular sensor, disregard the data
+ *  returned to that pointer.
+ *  \n @e sensors can contain a combination of the following flags:
+ *  \n INV_X_GYRO, INV_Y_GYRO, INV_Z_GYRO
+ *  \n INV_XYZ_GYRO
+ *  \n INV_XYZ_ACCEL
+ *  \n INV_WXYZ_QUAT
+ *  \n If the FIFO has no new data, @e sensors will be zero.
+ *  \n If the FIFO is disabled, @e sensors will be zero and this function will
+ *  return a non-zero error code.
+ *
+ *  @param[out] quat        6-axis quaternion data in hardware units.
+ *  @param[out] more        Number of remaining packets.
+ *  @return     0 if successful.
+ */
+int dmp_read_fifo( s32 *quat)
+{
+    unsigned char fifo_data[16];
+
+    /* Get a packet. */
+    if (mpu_read_fifo_stream(16, fifo_data))
+        return -1;
+
+    /* Parse DMP packet. */
+        quat[0] = ((s32)fifo_data[0] << 24) | ((s32)fifo_data[1] << 16) |
+            ((s32)fifo_data[2] << 8) | fifo_data[3];
+        quat[1] = ((s32)fifo_data[4] << 24) | ((s32)fifo_data[5] << 16) |
+            ((s32)fifo_data[6] << 8) | fifo_data[7];
+        quat[2] = ((s32)fifo_data[8] << 24) | ((s32)fifo_data[9] << 16) |
+            ((s32)fifo_data[10] << 8) | fifo_data[11];
+        quat[3] = ((s32)fifo_data[12] << 24) | ((s32)fifo_data[13] << 16) |
+            ((s32)fifo_data[14] << 8) | fifo_data[15];
+    return 0;
+}
+
+/**
+ *  @brief      Read every whole packet in the FIFO in one I2C burst.
+ *  Up to DMP_BATCH_MAX packets are read, any left over are counted in
+ *  @e remaining and are read by the next call.  Each packet is timestamped
+ *  from the time the FIFO count was read and the DMP FIFO rate, the newest
+ *  packet is taken to have been written just before the count was read.
+ *  If the FIFO overflowed its contents are discarded, the FIFO is reset and
+ *  @e overflow is set.
+ *  @param[out] batch       Packets read, oldest first.
+ *  @return     0 if successful.
+ */
+int dmp_drain_fifo(struct dmp_batch_s *batch)
+{
+    unsigned char tmp[2];
+    unsigned char fifo_data[DMP_BATCH_MAX * DMP_QUAT_PACKET_LEN];
+    unsigned char *p;
+    u16 fifo_count;
+    u32 available, now, period, age;
+    unsigned char i;
+
+    batch->count = 0;
+    batch->remaining = 0;
+    batch->overflow = 0;
+
+    if (i2c_read(st.hw->addr, st.reg->fifo_count_h, 2, tmp))
+        return -1;
+    now = i2c_get_time();
+    fifo_count = (tmp[0] << 8) | tmp[1];
+
+    if (fifo_count >= st.hw->max_fifo) {
+        /* Samples were dropped and the FIFO may be out of packet alignment. */
+        fifo_stats.overflows++;
+        fifo_stats.lost += fifo_count / DMP_QUAT_PACKET_LEN;
+        mpu_restart_fifo();
+        batch->overflow = 1;
+        return 0;
+    }
+
+    available = fifo_count / DMP_QUAT_PACKET_LEN;
+    if (available > fifo_stats.max_backlog)
+        fifo_stats.max_backlog = available;
+    if (available == 0)
+        return 0;
+    batch->count = min(available, DMP_BATCH_MAX);
+    batch->remaining = available - batch->count;
+
+    if (i2c_read(st.hw->addr, st.reg->fifo_r_w,
+            batch->count * DMP_QUAT_PACKET_LEN, fifo_data)) {
+        batch->count = 0;
+        return -1;
+    }
+    fifo_stats.bursts++;
+    fifo_stats.packets += batch->count;
+
+    period = i2c_get_ticks_per_us() *
+        (1000000 / (dmp.fifo_rate ? dmp.fifo_rate : DMP_SAMPLE_RATE));
+    p = fifo_data;
+    for (i = 0; i < batch->count; i++) {
+        /* Parse DMP packet. */
+        batch->packet[i].quat[0] = ((s32)p[0] << 24) | ((s32)p[1] << 16) |
+            ((s32)p[2] << 8) | p[3];
+        batch->packet[i].quat[1] = ((s32)p[4] << 24) | ((s32)p[5] << 16) |
+            ((s32)p[6] << 8) | p[7];
+        batch->packet[i].quat[2] = ((s32)p[8] << 24) | ((s32)p[9] << 16) |
+            ((s32)p[10] << 8) | p[11];
+        batch->packet[i].quat[3] = ((s32)p[12] << 24) | ((s32)p[13] << 16) |
+            ((s32)p[14] << 8) | p[15];
+        age = available - 1 - i;
+        batch->packet[i].timestamp = now - age * period;
+        p += DMP_QUAT_PACKET_LEN;
+    }
+    return 0;
+}
+
+/**
+ *  @brief      Get the FIFO drain statistics.
+ *  @param[out] stats       Statistics since power on.
+ */
+void dmp_get_fifo_stats(struct dmp_fifo_stats_s *stats)
+{
+    *stats = fifo_stats;
+}
+
+/* @note
+* The delay is timed by the AXI timer time base (TB_delay_us()).
+*
+*****************************************************************************/
+
+void isleep(u32 usec)
+{
+	TB_delay_us(usec);
+}
+
@@ -0,0 +1,92 @@
+/*
+ * dmp.h
+ *
+ *  Created on: Mar 17, 2017
+ *      Author: Francisco
+ */
+
+#ifndef SRC_DMP_H_
+#define SRC_DMP_H_
+
+#include "xil_types.h"
+#define DMP_INT_CONTINUOUS  (0x02)
+#define DMP_FEATURE_TAP             (0x001)
+#define DMP_FEATURE_ANDROID_ORIENT  (0x002)
+#define DMP_FEATURE_LP_QUAT         (0x004)
+#define DMP_FEATURE_PEDOMETER       (0x008)
+#define DMP_FEATURE_6X_LP_QUAT      (0x010)
+#define DMP_FEATURE_GYRO_CAL        (0x020)
+#define DMP_FEATURE_SEND_RAW_ACCEL  (0x040)
+#define DMP_FEATURE_SEND_RAW_GYRO   (0x080)
+#define DMP_FEATURE_SEND_CAL_GYRO   (0x100)
+#define INV_WXYZ_QUAT       		(0x100)
+
+#define INV_X_GYRO      (0x40)
+#define INV_Y_GYRO      (0x20)
+#define INV_Z_GYRO      (0x10)
+#define INV_XYZ_GYRO    (INV_X_GYRO | INV_Y_GYRO | INV_Z_GYRO)
+#define INV_XYZ_ACCEL   (0x08)
+#define INV_XYZ_COMPASS (0x01)
+
+/* DMP FIFO packet and burst sizes. */
+#define DMP_QUAT_PACKET_LEN (16)
+#define DMP_BATCH_MAX       (15)    /* packets per burst, i2c_read() length is 8 bits */
+
+/* One quaternion packet and the time it was written to the FIFO, in
+ * i2c_get_time() counts. */
+struct dmp_packet_s {
+    s32 quat[4];
+    u32 timestamp;
+};
+
+/* Packets read by one dmp_drain_fifo() call, oldest first. */
+struct dmp_batch_s {
+    unsigned char count;
+    unsigned short remaining;       /* whole packets left in the FIFO */
+    unsigned char overflow;         /* 1 if the FIFO overflowed and was reset */
+    struct dmp_packet_s packet[DMP_BATCH_MAX];
+};
+
+/* FIFO drain statistics since power on. */
+struct dmp_fifo_stats_s {
+    u32 packets;                    /* packets read */
+    u32 bursts;                     /* FIFO data reads */
+    u32 overflows;                  /* FIFO overflows */
+    u32 lost;                       /* packets discarded by FIFO resets */
+    u32 max_backlog;                /* most packets found in the FIFO */
+};
+
+void isleep(u32 usec);
+
+int mpu_load_firmware(unsigned short length, const unsigned char *firmware,
+    unsigned short start_addr, unsigned short sample_rate);
+int mpu_write_mem(unsigned short mem_addr, unsigned short length,
+        unsigned char *data);
+int mpu_reset_fifo(void);
+int mpu_read_fifo_stream(unsigned short length, unsigned char *data);
+
+/* Set up functions. */
+int dmp_load_motion_driver_firmware(void);
+int dmp_set_fifo_rate(unsigned short rate);
+int dmp_get_fifo_rate(unsigned short *rate);
+int dmp_enable_feature(unsigned short mask);
+int dmp_get_enabled_features(unsigned short *mask);
+int dmp_set_interrupt_mode(unsigned char mode);
+int dmp_set_orientation(unsigned short orient);
+int dmp_set_gyro_bias(long *bias);
+int dmp_set_accel_bias(long *bias);
+
+/* LP quaternion functions. */
+int dmp_enable_lp_quat(unsigned char enable);
+int dmp_enable_6x_lp_quat(unsigned char enable);
+
+/* DMP gyro calibration functions. */
+int dmp_enable_gyro_cal(unsigned char enable);
+
+/* Read function. This function should be called whenever the MPU interrupt is
+ * detected. */
+int dmp_read_fifo( s32 *quat);
+int dmp_drain_fifo(struct dmp_batch_s *batch);
+void dmp_get_fifo_stats(struct dmp_fifo_stats_s *stats);
+
+#endif /* SRC_DMP_H_ */
@@ -0,0 +1,21 @@
+/************************************************************************/
+/*																		*/
+/* xstatus.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The status codes that filter.c returns, with the values of the		*/
+/*	BSP.																*/
+/*																		*/
+/************************************************************************/
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+#define XST_INVALID_PARAM			15L
+
+#endif // XSTATUS_H
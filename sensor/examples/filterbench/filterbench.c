@@ -0,0 +1,317 @@
+/************************************************************************/
+/*																		*/
+/*	filterbench.c	--	filter.c checked and timed on the host			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Checks median_update() and trimmed_mean_update() against a			*/
+/*	reference that sorts a copy of the window for every sample, then	*/
+/*	times the two.  The check runs every window from 1 to				*/
+/*	FILTER_MAX_WINDOW, and for the trimmed mean every trim, on four		*/
+/*	streams: uniform over the full s32 range, a narrow range with many	*/
+/*	equal samples, quaternion-like noise with spikes and a sawtooth.	*/
+/*	The reference splits a part full window at the same rank as the	*/
+/*	filters, so the outputs must match for every sample, including		*/
+/*	the first window - 1 of them.										*/
+/*																		*/
+/*	The timing runs the noise stream through windows around ARY_S, the	*/
+/*	window of 10 the main programs use, and prints the host CPU cycles	*/
+/*	for each sample of the heap median and of the sort-based one.		*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -O2 -Ibsp -I../.. -o filterbench filterbench.c		*/
+/*		../../filter.c													*/
+/*	./filterbench														*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "filter.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/************************** Constant Definitions ***************************/
+#define CHECK_SAMPLES	20000		// samples of each stream for each window
+#define BENCH_SAMPLES	1000000		// samples of each timed run
+#define BENCH_RUNS		5			// runs of each filter, the fastest counts
+
+/************************** Type Definitions *******************************/
+
+// a part full window of a reference filter
+typedef struct {
+	s32 rgval[FILTER_MAX_WINDOW];
+	int window;
+	int count;
+	int head;
+} RefWindow;
+
+typedef s32 (*Stream)(u32 i);
+
+/************************** Variable Definitions ***************************/
+static u32 seed;
+static s32 *rgsample;
+static const int rgwindowBench[] = { 5, 10, 15, 16, 25, 32 };
+
+/************************** Function Definitions ***************************/
+
+static u32 Rand(void)
+{
+	seed = seed * 1664525 + 1013904223;
+	return seed;
+}
+
+static s32 StreamUniform(u32 i)
+{
+	(void) i;
+	return (s32) Rand();
+}
+
+static s32 StreamNarrow(u32 i)
+{
+	(void) i;
+	return (s32) (Rand() >> 28) - 8;
+}
+
+// a quaternion component in q30 around 0.7, with noise and a spike
+// every 50 samples or so
+static s32 StreamNoise(u32 i)
+{
+	s32 v = 0x2D413CCC + (s32) (Rand() >> 20) - 2048;
+
+	(void) i;
+	if ((Rand() >> 26) == 0) {
+		v = (s32) Rand();
+	}
+	return v;
+}
+
+static s32 StreamSawtooth(u32 i)
+{
+	return (s32) (i % 37) * 1000 - 18000;
+}
+
+static const Stream rgstream[] = { StreamUniform, StreamNarrow, StreamNoise, StreamSawtooth };
+static const char *rgszStream[] = { "uniform", "narrow", "noise", "sawtooth" };
+
+static u64 Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/*
+** The reference filters.  A sample replaces the oldest one and the
+** window is copied and insertion sorted.
+*/
+static void RefInit(RefWindow *pw, int window)
+{
+	memset(pw, 0, sizeof(*pw));
+	pw->window = window;
+}
+
+static int RefAdd(RefWindow *pw, s32 sample, s32 *rgsorted)
+{
+	int i, j;
+	s32 v;
+
+	pw->rgval[pw->head] = sample;
+	pw->head = (pw->head + 1) % pw->window;
+	if (pw->count < pw->window) {
+		pw->count++;
+	}
+
+	for (i = 0; i < pw->count; i++) {
+		v = pw->rgval[i];
+		for (j = i; j > 0 && rgsorted[j - 1] > v; j--) {
+			rgsorted[j] = rgsorted[j - 1];
+		}
+		rgsorted[j] = v;
+	}
+	return pw->count;
+}
+
+// the rank the filters split a part full window at, rounded up
+static int RefRank(int num, int den, int count)
+{
+	return (num * count + den - 1) / den;
+}
+
+static s32 RefMedian(RefWindow *pw, s32 sample)
+{
+	s32 rgsorted[FILTER_MAX_WINDOW];
+	int n = RefAdd(pw, sample, rgsorted);
+
+	if (n & 1) {
+		return rgsorted[n / 2];
+	}
+	return (s32) (((s64) rgsorted[n / 2 - 1] + rgsorted[n / 2]) / 2);
+}
+
+static s32 RefTrimmedMean(RefWindow *pw, int trim, s32 sample)
+{
+	s32 rgsorted[FILTER_MAX_WINDOW];
+	int n = RefAdd(pw, sample, rgsorted);
+	int lo = RefRank(trim, pw->window, n);
+	int hi = RefRank(pw->window - trim, pw->window, n);
+	s64 sum = 0;
+	int i;
+
+	if (hi == lo) {
+		return sample;
+	}
+	for (i = lo; i < hi; i++) {
+		sum += rgsorted[i];
+	}
+	return (s32) (sum / (hi - lo));
+}
+
+/*
+** Runs CHECK_SAMPLES samples of each stream through the filter and the
+** reference for one window and trim, trim < 0 for the median.  Returns
+** the number of samples where they differ and prints the first.
+*/
+static int Check(int window, int trim)
+{
+	MedianFilter med;
+	TrimmedMeanFilter tm;
+	RefWindow ref;
+	s32 sample, out, outRef;
+	int istream, cdiff = 0;
+	u32 i;
+
+	for (istream = 0; istream < (int) (sizeof(rgstream) / sizeof(rgstream[0])); istream++) {
+		seed = 12345 + window * 100 + trim;
+		if (trim < 0) {
+			median_init(&med, (u8) window);
+		}
+		else {
+			trimmed_mean_init(&tm, (u8) window, (u8) trim);
+		}
+		RefInit(&ref, window);
+
+		for (i = 0; i < CHECK_SAMPLES; i++) {
+			sample = rgstream[istream](i);
+			if (trim < 0) {
+				out = median_update(&med, sample);
+				outRef = RefMedian(&ref, sample);
+			}
+			else {
+				out = trimmed_mean_update(&tm, sample);
+				outRef = RefTrimmedMean(&ref, trim, sample);
+			}
+			if (out != outRef) {
+				if (cdiff == 0) {
+					printf("%s window %d trim %d stream %s sample %u: %d, expected %d\n",
+						(trim < 0) ? "median" : "trimmed mean", window, trim,
+						rgszStream[istream], (unsigned) i, (int) out, (int) outRef);
+				}
+				cdiff++;
+			}
+		}
+	}
+	return cdiff;
+}
+
+static u64 BenchHeap(int window, u32 *psum)
+{
+	MedianFilter med;
+	u32 sum = 0;
+	u64 start;
+	u32 i;
+
+	median_init(&med, (u8) window);
+	start = Cycles();
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		sum += median_update(&med, rgsample[i]);
+	}
+	*psum = sum;
+	return Cycles() - start;
+}
+
+static u64 BenchSort(int window, u32 *psum)
+{
+	RefWindow ref;
+	u32 sum = 0;
+	u64 start;
+	u32 i;
+
+	RefInit(&ref, window);
+	start = Cycles();
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		sum += RefMedian(&ref, rgsample[i]);
+	}
+	*psum = sum;
+	return Cycles() - start;
+}
+
+int main(void)
+{
+	u64 rgcycles[2], cycles;
+	u32 rgsum[2];
+	int window, trim, cdiff, ctrim = 0, cdiffMed = 0, cdiffTm = 0;
+	int iwindow, irun;
+	u32 i;
+
+	for (window = 1; window <= FILTER_MAX_WINDOW; window++) {
+		cdiffMed += Check(window, -1);
+		for (trim = 0; 2 * trim < window; trim++, ctrim++) {
+			cdiffTm += Check(window, trim);
+		}
+	}
+	printf("median:       %d windows, %d samples differ\n", FILTER_MAX_WINDOW, cdiffMed);
+	printf("trimmed mean: %d windows and trims, %d samples differ\n\n", ctrim, cdiffTm);
+	cdiff = cdiffMed + cdiffTm;
+
+	rgsample = malloc(BENCH_SAMPLES * sizeof(s32));
+	if (rgsample == NULL) {
+		return 2;
+	}
+	seed = 1;
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		rgsample[i] = StreamNoise(i);
+	}
+
+	printf("%-7s %13s %13s %8s\n", "window", "cycles/sample", "cycles/sample", "speedup");
+	printf("%-7s %13s %13s\n", "", "sort", "heap");
+	for (iwindow = 0; iwindow < (int) (sizeof(rgwindowBench) / sizeof(rgwindowBench[0])); iwindow++) {
+		window = rgwindowBench[iwindow];
+		// the filters take turns and the fastest run of each counts
+		rgcycles[0] = rgcycles[1] = ~(u64) 0;
+		for (irun = 0; irun < BENCH_RUNS; irun++) {
+			cycles = BenchSort(window, &rgsum[0]);
+			if (cycles < rgcycles[0]) {
+				rgcycles[0] = cycles;
+			}
+			cycles = BenchHeap(window, &rgsum[1]);
+			if (cycles < rgcycles[1]) {
+				rgcycles[1] = cycles;
+			}
+		}
+		if (rgsum[0] != rgsum[1]) {
+			cdiff++;
+		}
+		printf("%-7d %13.1f %13.1f %7.1fx  %s\n", window,
+			(double) rgcycles[0] / BENCH_SAMPLES, (double) rgcycles[1] / BENCH_SAMPLES,
+			(double) rgcycles[0] / rgcycles[1], (rgsum[0] == rgsum[1]) ? "same" : "DIFFERENT");
+	}
+	free(rgsample);
+	return (cdiff == 0) ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+/************************************************************************/
+/*																		*/
+/* mb_interface.h	--	Host stand-in for the MicroBlaze BSP header		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The interrupt enable of the MicroBlaze, kept by the bus model so	*/
+/*	it can check that the queue is only changed with interrupts off.	*/
+/*																		*/
+/************************************************************************/
+#ifndef MB_INTERFACE_H
+#define MB_INTERFACE_H
+
+#include "xil_types.h"
+
+u32 mfmsr(void);
+void microblaze_enable_interrupts(void);
+void microblaze_disable_interrupts(void);
+
+#endif // MB_INTERFACE_H
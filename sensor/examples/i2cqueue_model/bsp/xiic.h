@@ -0,0 +1,32 @@
+/************************************************************************/
+/*																		*/
+/* xiic.h	--	Host stand-in for the XIic driver header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The part of the XIic driver interface that sensor.c uses.  The		*/
+/*	functions are implemented by the bus model in i2cq_model.c.			*/
+/*																		*/
+/************************************************************************/
+#ifndef XIIC_H
+#define XIIC_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#define XII_REPEATED_START_OPTION	0x00000002
+
+#define XII_BUS_NOT_BUSY_EVENT		0x00000001
+#define XII_ARB_LOST_EVENT			0x00000002
+#define XII_SLAVE_NO_ACK_EVENT		0x00000004
+
+typedef struct {
+	u32 Options;
+} XIic;
+
+int XIic_Start(XIic *InstancePtr);
+int XIic_MasterSend(XIic *InstancePtr, u8 *TxMsgPtr, int ByteCount);
+int XIic_MasterRecv(XIic *InstancePtr, u8 *RxMsgPtr, int ByteCount);
+
+#endif // XIIC_H
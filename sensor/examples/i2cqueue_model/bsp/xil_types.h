@@ -0,0 +1,29 @@
+/************************************************************************/
+/*																		*/
+/* xil_types.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The types of the standalone BSP that sensor.c and mpu_bringup.c		*/
+/*	use, for building them on the host with the I2C queue model.		*/
+/*																		*/
+/************************************************************************/
+#ifndef XIL_TYPES_H
+#define XIL_TYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t		u8;
+typedef uint16_t	u16;
+typedef uint32_t	u32;
+typedef uint64_t	u64;
+typedef int8_t		s8;
+typedef int16_t		s16;
+typedef int32_t		s32;
+typedef int64_t		s64;
+
+typedef uintptr_t	UINTPTR;
+
+#endif // XIL_TYPES_H
@@ -0,0 +1,23 @@
+/************************************************************************/
+/*																		*/
+/* xstatus.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The status codes that sensor.c and the XIic model return.			*/
+/*																		*/
+/************************************************************************/
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+#define XST_INVALID_PARAM			15L
+#define XST_DEVICE_BUSY				21L
+
+#define XST_IIC_BUS_BUSY			1052L
+
+#endif // XSTATUS_H
@@ -0,0 +1,360 @@
+/************************************************************************/
+/*																		*/
+/*	i2cq_model.c	--	Host model of the I2C queue environment			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	This module runs sensor.c on the host.  It provides the XIic		*/
+/*	driver calls, the time base of timebase.h and the MicroBlaze		*/
+/*	interrupt enable, on a clock counted in AXI clocks:					*/
+/*																		*/
+/*	- XIic_MasterSend() and XIic_MasterRecv() start a transfer that		*/
+/*	  ends 9 SCL periods per byte, address byte included, later.  The	*/
+/*	  end is an interrupt: SendHandler() or ReceiveHandler(), or		*/
+/*	  StatusHandler() with XII_SLAVE_NO_ACK_EVENT for a write that		*/
+/*	  I2CQModel_NackWrite() picked.  I2CQModel_BusBusy() makes one		*/
+/*	  send find the bus busy, with or without the bus not busy event	*/
+/*	  that the driver reports when the bus is free again.				*/
+/*	- the MPU-6050 keeps its registers and logs every transaction, and	*/
+/*	  the shortest time from the end of a write to the start of the		*/
+/*	  next transaction.													*/
+/*	- TB_call_at() callbacks run as timer interrupts at their			*/
+/*	  deadline.  I2CQModel_TbSlots() limits the free callbacks, as		*/
+/*	  if other callbacks were pending.									*/
+/*																		*/
+/*	I2CQModel_Run() moves the clock from one event to the next and		*/
+/*	calls the task at every release, like the scheduler.  Interrupts	*/
+/*	only happen between task calls, and are counted as lock errors if	*/
+/*	they come while the task code has them disabled.					*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "i2cq_model.h"
+#include "sensor.h"
+#include "timebase.h"
+#include "mb_interface.h"
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+#define MDL_TICKS_PER_US	(I2CQ_MODEL_CLK_HZ / 1000000)
+#define MDL_BYTE_TICKS		(9ull * I2CQ_MODEL_CLK_HZ / I2CQ_MODEL_IIC_HZ)
+#define MDL_NEVER			(~0ull)
+#define MDL_MSR_IE			0x02
+
+/************************** Type Definitions *******************************/
+typedef struct {
+	int			fActive;
+	u32			deadlineUs;
+	TB_Callback	callback;
+	void		*context;
+} MDL_Callback;
+
+/************************** Variable Definitions ***************************/
+static u64			clk;
+static int			fIe;
+static int			cLockErr;
+
+static XIic			iic;
+static u64			tickXferEnd;
+static int			fXferSend;
+static int			fXferNack;
+static u8			*pbRecv;
+static int			cbRecv;
+static u64			tickBusFree;
+static int			isendBusy, fBusyNotify, csend;
+static int			iwriteNack, cwrite;
+
+static u8			rgbReg[128];
+static I2CQ_Xfer	rgxfer[I2CQ_MODEL_MAX_LOG];
+static int			cxfer;
+static u32			usWriteEnd;
+static int			fWriteEnd;
+static u32			usMinGuard;
+
+static MDL_Callback	rgcb[TB_MAX_CALLBACKS];
+static int			cslotTb;
+
+/************************** Function Definitions ***************************/
+
+XIic *I2CQModel_Reset(void)
+{
+	clk = 0;
+	fIe = 1;
+	cLockErr = 0;
+	memset(&iic, 0, sizeof(iic));
+	tickXferEnd = MDL_NEVER;
+	tickBusFree = MDL_NEVER;
+	isendBusy = iwriteNack = -1;
+	csend = cwrite = 0;
+	memset(rgbReg, 0, sizeof(rgbReg));
+	cxfer = 0;
+	fWriteEnd = 0;
+	usMinGuard = ~0u;
+	memset(rgcb, 0, sizeof(rgcb));
+	cslotTb = TB_MAX_CALLBACKS;
+	return &iic;
+}
+
+void I2CQModel_NackWrite(int iwrite)
+{
+	iwriteNack = iwrite;
+}
+
+void I2CQModel_BusBusy(int isend, int fNotify)
+{
+	isendBusy = isend;
+	fBusyNotify = fNotify;
+}
+
+void I2CQModel_TbSlots(int cslot)
+{
+	cslotTb = cslot;
+}
+
+u32 I2CQModel_NowUs(void)
+{
+	return (u32) (clk / MDL_TICKS_PER_US);
+}
+
+int I2CQModel_LogCount(void)
+{
+	return cxfer;
+}
+
+const I2CQ_Xfer *I2CQModel_Log(int ixfer)
+{
+	return &rgxfer[ixfer];
+}
+
+u32 I2CQModel_MinGuardUs(void)
+{
+	return usMinGuard;
+}
+
+int I2CQModel_LockErrors(void)
+{
+	return cLockErr;
+}
+
+/*
+** MicroBlaze interrupt enable
+*/
+u32 mfmsr(void)
+{
+	return fIe ? MDL_MSR_IE : 0;
+}
+
+void microblaze_enable_interrupts(void)
+{
+	fIe = 1;
+}
+
+void microblaze_disable_interrupts(void)
+{
+	fIe = 0;
+}
+
+/*
+** XIic driver and the MPU-6050
+*/
+static I2CQ_Xfer *MDL_Begin(int fWrite, u8 reg)
+{
+	I2CQ_Xfer *pxfer = &rgxfer[cxfer < I2CQ_MODEL_MAX_LOG ? cxfer++ : I2CQ_MODEL_MAX_LOG - 1];
+	u32 us = I2CQModel_NowUs();
+
+	if (fIe) {
+		cLockErr++;			// sensor.c starts transfers with interrupts off
+	}
+	if (fWriteEnd && (us - usWriteEnd) < usMinGuard) {
+		usMinGuard = us - usWriteEnd;
+	}
+	memset(pxfer, 0, sizeof(*pxfer));
+	pxfer->fWrite = fWrite;
+	pxfer->reg = reg;
+	pxfer->startUs = us;
+	return pxfer;
+}
+
+int XIic_Start(XIic *InstancePtr)
+{
+	(void) InstancePtr;
+	return XST_SUCCESS;
+}
+
+int XIic_MasterSend(XIic *InstancePtr, u8 *TxMsgPtr, int ByteCount)
+{
+	I2CQ_Xfer *pxfer;
+
+	if (csend++ == isendBusy) {
+		tickBusFree = fBusyNotify ? clk + 4 * MDL_BYTE_TICKS : MDL_NEVER;
+		return XST_IIC_BUS_BUSY;
+	}
+
+	fXferSend = 1;
+	fXferNack = 0;
+	tickXferEnd = clk + (u64) (ByteCount + 1) * MDL_BYTE_TICKS;
+	if (InstancePtr->Options & XII_REPEATED_START_OPTION) {
+		// register address of a read, the data is logged by XIic_MasterRecv()
+		MDL_Begin(0, TxMsgPtr[0]);
+		return XST_SUCCESS;
+	}
+
+	pxfer = MDL_Begin(1, TxMsgPtr[0]);
+	pxfer->len = (u8) (ByteCount - 1);
+	memcpy(pxfer->data, &TxMsgPtr[1], ByteCount - 1);
+	fXferNack = (cwrite++ == iwriteNack);
+	pxfer->fAck = !fXferNack;
+	if (!fXferNack) {
+		memcpy(&rgbReg[TxMsgPtr[0] & 0x7F], &TxMsgPtr[1], ByteCount - 1);
+	}
+	return XST_SUCCESS;
+}
+
+int XIic_MasterRecv(XIic *InstancePtr, u8 *RxMsgPtr, int ByteCount)
+{
+	I2CQ_Xfer *pxfer = &rgxfer[cxfer - 1];
+
+	(void) InstancePtr;
+	pxfer->len = (u8) ByteCount;
+	pxfer->fAck = 1;
+	fXferSend = 0;
+	pbRecv = RxMsgPtr;
+	cbRecv = ByteCount;
+	tickXferEnd = clk + (u64) (ByteCount + 1) * MDL_BYTE_TICKS;
+	return XST_SUCCESS;
+}
+
+// the end of a transfer, in interrupt context
+static void MDL_XferEnd(void)
+{
+	I2CQ_Xfer *pxfer = &rgxfer[cxfer - 1];
+	int fWrite = fXferSend && !(iic.Options & XII_REPEATED_START_OPTION);
+
+	tickXferEnd = MDL_NEVER;
+	if (fWrite) {
+		pxfer->endUs = I2CQModel_NowUs();
+		usWriteEnd = pxfer->endUs;
+		fWriteEnd = 1;
+		if (fXferNack) {
+			StatusHandler(&iic, XII_SLAVE_NO_ACK_EVENT);
+			return;
+		}
+		SendHandler(&iic);
+	}
+	else if (fXferSend) {
+		SendHandler(&iic);				// address of a read sent
+	}
+	else {
+		memcpy(pbRecv, &rgbReg[pxfer->reg & 0x7F], cbRecv);
+		memcpy(pxfer->data, pbRecv, cbRecv < 33 ? cbRecv : 33);
+		pxfer->endUs = I2CQModel_NowUs();
+		ReceiveHandler(&iic);
+	}
+}
+
+/*
+** Time base
+*/
+u32 TB_get_ticks(void)
+{
+	return (u32) clk;
+}
+
+u32 TB_ticks_per_us(void)
+{
+	return MDL_TICKS_PER_US;
+}
+
+u32 TB_now_us(void)
+{
+	return I2CQModel_NowUs();
+}
+
+int TB_call_at(u32 deadline_us, TB_Callback callback, void *context)
+{
+	int i;
+
+	if (callback == NULL) {
+		return -XST_INVALID_PARAM;
+	}
+	for (i = 0; i < cslotTb; i++) {
+		if (!rgcb[i].fActive) {
+			rgcb[i].fActive = 1;
+			rgcb[i].deadlineUs = deadline_us;
+			rgcb[i].callback = callback;
+			rgcb[i].context = context;
+			return i;
+		}
+	}
+	return -XST_DEVICE_BUSY;
+}
+
+void TB_cancel(int handle)
+{
+	if ((handle >= 0) && (handle < TB_MAX_CALLBACKS)) {
+		rgcb[handle].fActive = 0;
+	}
+}
+
+/*
+** The event loop.  Returns 1 when pfnDone() is true after a task call,
+** 0 if limitUs passes first.
+*/
+int I2CQModel_Run(I2CQ_Task pfnTask, u32 periodUs, I2CQ_Done pfnDone, u32 limitUs)
+{
+	u64 tickRelease = clk, tickNext, tick;
+	int i;
+
+	while (clk < (u64) limitUs * MDL_TICKS_PER_US) {
+		tickNext = tickRelease;
+		if (tickXferEnd < tickNext) {
+			tickNext = tickXferEnd;
+		}
+		if (tickBusFree < tickNext) {
+			tickNext = tickBusFree;
+		}
+		for (i = 0; i < TB_MAX_CALLBACKS; i++) {
+			tick = (u64) rgcb[i].deadlineUs * MDL_TICKS_PER_US;
+			if (rgcb[i].fActive && tick < tickNext) {
+				tickNext = (tick > clk) ? tick : clk;
+			}
+		}
+		clk = tickNext;
+
+		// interrupts, the handlers run with interrupts off
+		if (!fIe) {
+			cLockErr++;
+		}
+		fIe = 0;
+		if (clk >= tickXferEnd) {
+			MDL_XferEnd();
+		}
+		if (clk >= tickBusFree) {
+			tickBusFree = MDL_NEVER;
+			StatusHandler(&iic, XII_BUS_NOT_BUSY_EVENT);
+		}
+		for (i = 0; i < TB_MAX_CALLBACKS; i++) {
+			if (rgcb[i].fActive && (s32) (TB_now_us() - rgcb[i].deadlineUs) >= 0) {
+				rgcb[i].fActive = 0;
+				rgcb[i].callback(rgcb[i].context);
+			}
+		}
+		fIe = 1;
+
+		if (clk >= tickRelease) {
+			tickRelease += (u64) periodUs * MDL_TICKS_PER_US;
+			pfnTask();
+			if (pfnDone()) {
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
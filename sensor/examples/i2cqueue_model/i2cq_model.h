@@ -0,0 +1,65 @@
+/************************************************************************/
+/*																		*/
+/* i2cq_model.h	--	Interface Declarations for i2cq_model.c				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	This header file contains the declarations of the host model that	*/
+/*	runs the I2C transaction queue of sensor.c: the XIic driver and		*/
+/*	the bus to the MPU-6050, the time base of timebase.h and the		*/
+/*	interrupts and task releases between them, on a simulated clock.	*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+#ifndef I2CQ_MODEL_H
+#define I2CQ_MODEL_H
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+#include "xil_types.h"
+#include "xiic.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+#define I2CQ_MODEL_CLK_HZ		100000000	// AXI clock, the time base count rate
+#define I2CQ_MODEL_IIC_HZ		100000		// SCL of axi_iic_0 in embsys
+#define I2CQ_MODEL_MAX_LOG		256			// transactions kept in the log
+
+// one transaction seen by the MPU-6050
+typedef struct {
+	int		fWrite;
+	u8		reg;
+	u8		len;
+	u8		data[33];
+	int		fAck;
+	u32		startUs;
+	u32		endUs;
+} I2CQ_Xfer;
+
+typedef void (*I2CQ_Task)(void);
+typedef int (*I2CQ_Done)(void);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+XIic *I2CQModel_Reset(void);
+void I2CQModel_NackWrite(int iwrite);
+void I2CQModel_BusBusy(int isend, int fNotify);
+void I2CQModel_TbSlots(int cslot);
+
+int I2CQModel_Run(I2CQ_Task pfnTask, u32 periodUs, I2CQ_Done pfnDone, u32 limitUs);
+u32 I2CQModel_NowUs(void);
+
+int I2CQModel_LogCount(void);
+const I2CQ_Xfer *I2CQModel_Log(int ixfer);
+u32 I2CQModel_MinGuardUs(void);
+int I2CQModel_LockErrors(void);
+
+#endif // I2CQ_MODEL_H
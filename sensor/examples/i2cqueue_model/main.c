@@ -0,0 +1,202 @@
+/************************************************************************/
+/*																		*/
+/*	main.c	--	MPU-6050 bring-up run on the host model of the I2C queue	*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Runs mpu_bringup() from a 1 ms task, as bringup_task() in			*/
+/*	main_fusion.c does, against sensor.c and the bus model in			*/
+/*	i2cq_model.c.  Every scenario runs until the bring-up ends or one	*/
+/*	simulated second passes, then checks that:							*/
+/*																		*/
+/*	- the last successful writes are the reset and mpu_config[], in		*/
+/*	  order, with at least MPU_RESET_US after the reset					*/
+/*	- no transaction started within I2C_WRITE_GUARD_US of the end of	*/
+/*	  a write															*/
+/*	- the queue never refused a submission and never held more than		*/
+/*	  I2C_QUEUE_DEPTH transactions										*/
+/*	- the queue was only changed with interrupts off					*/
+/*																		*/
+/*	The scenarios are a clean bus, a write that is not acknowledged,	*/
+/*	a time base with no free callback and a busy bus that is never		*/
+/*	reported free.  The last two rely on the i2c_service() call of		*/
+/*	bringup_task(); the time base one is also run without it, which		*/
+/*	is expected to stall.												*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -O2 -Wall -Ibsp -I../.. -I../../.. -o i2cqueue_model	*/
+/*		main.c i2cq_model.c ../../sensor.c ../../mpu_bringup.c			*/
+/*	./i2cqueue_model													*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "i2cq_model.h"
+#include "sensor.h"
+#include "timebase.h"
+#include "pt.h"
+#include "mpu_bringup.h"
+#include <stdio.h>
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+#define BRINGUP_PERIOD_US	1000		// period of bringup_task() in main_fusion.c
+#define SCENARIO_LIMIT_US	1000000		// simulated time a scenario may take
+
+/************************** Type Definitions *******************************/
+typedef struct {
+	const char	*szName;
+	int			fService;		// bringup_task() calls i2c_service()
+	int			iwriteNack;		// write that is not acknowledged, -1 for none
+	int			isendBusy;		// send that finds the bus busy, -1 for none
+	int			cslotTb;		// free time base callbacks
+	int			fExpectDone;
+} Scenario;
+
+/************************** Variable Definitions ***************************/
+static const Scenario rgscen[] = {
+	// name						service	nack	busy	slots				done
+	{ "clean bus",				0,		-1,		-1,		TB_MAX_CALLBACKS,	1 },
+	{ "write 5 not acked",		0,		5,		-1,		TB_MAX_CALLBACKS,	1 },
+	{ "no time base callback",	1,		-1,		-1,		0,					1 },
+	{ "  without i2c_service",	0,		-1,		-1,		0,					0 },
+	{ "bus busy, no event",		1,		-1,		4,		TB_MAX_CALLBACKS,	1 },
+};
+
+static struct pt	mpu_pt;
+static int			fMpuReady;
+static int			fService;
+
+/************************** Function Definitions ***************************/
+
+static void bringup_task(void)
+{
+	if (fService) {
+		i2c_service();
+	}
+	if (!fMpuReady && (mpu_bringup(&mpu_pt) == PT_ENDED)) {
+		fMpuReady = 1;
+	}
+}
+
+static int BringupDone(void)
+{
+	return fMpuReady;
+}
+
+/*
+** Checks the write log against the reset and mpu_config[].  Returns the
+** number of problems and prints them.
+*/
+static int CheckWrites(void)
+{
+	const I2CQ_Xfer *rgpxfer[I2CQ_MODEL_MAX_LOG];
+	const I2CQ_Xfer *pxfer;
+	int cxfer = I2CQModel_LogCount();
+	int cwrite = 0, cerr = 0;
+	int i, iconfig;
+
+	// the successful writes, the last mpu_config_len + 1 are the ones checked
+	for (i = 0; i < cxfer; i++) {
+		pxfer = I2CQModel_Log(i);
+		if (pxfer->fWrite && pxfer->fAck) {
+			rgpxfer[cwrite++] = pxfer;
+		}
+	}
+	if (cwrite < (int) mpu_config_len + 1) {
+		printf("    %d writes, expected %u\n", cwrite, (unsigned) mpu_config_len + 1);
+		return 1;
+	}
+	i = cwrite - (int) mpu_config_len - 1;
+
+	pxfer = rgpxfer[i];
+	if ((pxfer->reg != 0x6B) || (pxfer->len != 1) || (pxfer->data[0] != 0x80)) {
+		printf("    write %d is not the reset\n", i);
+		cerr++;
+	}
+	if ((rgpxfer[i + 1]->startUs - pxfer->endUs) < MPU_RESET_US) {
+		printf("    %u us after the reset\n", (unsigned) (rgpxfer[i + 1]->startUs - pxfer->endUs));
+		cerr++;
+	}
+	for (iconfig = 0; iconfig < (int) mpu_config_len; iconfig++) {
+		pxfer = rgpxfer[i + 1 + iconfig];
+		if ((pxfer->reg != mpu_config[iconfig].reg) || (pxfer->len != mpu_config[iconfig].len) ||
+				(memcmp(pxfer->data, mpu_config[iconfig].data, pxfer->len) != 0)) {
+			printf("    write of mpu_config[%d] is wrong\n", iconfig);
+			cerr++;
+		}
+	}
+	return cerr;
+}
+
+static int RunScenario(const Scenario *pscen)
+{
+	I2C_Stats stats;
+	XIic *piic;
+	u32 restarts = mpu_bringup_restarts();
+	u32 guard;
+	int fDone, cerr = 0;
+
+	piic = I2CQModel_Reset();
+	I2CQModel_NackWrite(pscen->iwriteNack);
+	I2CQModel_BusBusy(pscen->isendBusy, 0);
+	I2CQModel_TbSlots(pscen->cslotTb);
+	i2c_queue_init(piic, TB_get_ticks, TB_ticks_per_us());
+	PT_INIT(&mpu_pt);
+	fMpuReady = 0;
+	fService = pscen->fService;
+
+	fDone = I2CQModel_Run(bringup_task, BRINGUP_PERIOD_US, BringupDone, SCENARIO_LIMIT_US);
+	i2c_get_stats(&stats, false);
+	guard = I2CQModel_MinGuardUs();
+
+	printf("%-24s %-8s %7u us  %2d xfers  %u restarts  guard %5u us  queued %u/%d  "
+			"rejected %u  bus %u/%u us\n",
+			pscen->szName, fDone ? "done" : "stalled", (unsigned) I2CQModel_NowUs(),
+			I2CQModel_LogCount(), (unsigned) (mpu_bringup_restarts() - restarts),
+			(unsigned) guard, (unsigned) stats.max_queued, I2C_QUEUE_DEPTH,
+			(unsigned) stats.rejected, (unsigned) stats.busy_us, (unsigned) stats.window_us);
+
+	if (fDone != pscen->fExpectDone) {
+		printf("    expected it to %s\n", pscen->fExpectDone ? "end" : "stall");
+		cerr++;
+	}
+	if (fDone) {
+		cerr += CheckWrites();
+	}
+	if (guard < I2C_WRITE_GUARD_US) {
+		printf("    transaction %u us after a write\n", (unsigned) guard);
+		cerr++;
+	}
+	if ((stats.rejected != 0) || (stats.max_queued > I2C_QUEUE_DEPTH)) {
+		printf("    queue overfilled\n");
+		cerr++;
+	}
+	if ((pscen->iwriteNack >= 0) && fDone && (mpu_bringup_restarts() == restarts)) {
+		printf("    no restart after the failed write\n");
+		cerr++;
+	}
+	if (I2CQModel_LockErrors() != 0) {
+		printf("    %d changes with interrupts on\n", I2CQModel_LockErrors());
+		cerr++;
+	}
+	return cerr;
+}
+
+int main(void)
+{
+	int iscen, cerr = 0;
+
+	for (iscen = 0; iscen < (int) (sizeof(rgscen) / sizeof(rgscen[0])); iscen++) {
+		cerr += RunScenario(&rgscen[iscen]);
+	}
+	printf("\n%d problems\n", cerr);
+	return (cerr == 0) ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/*
+ * filter.c
+ *
+ *  Created on: Jun 9, 2017
+ *
+ * Sliding median and trimmed mean.  Each filter is built on a window split
+ * at a rank by a max-heap and a min-heap (see RankWindow in filter.h).  A
+ * new sample replaces the oldest one in the ring buffer: the oldest is
+ * deleted from its heap, the new one is pushed on the heap it belongs to
+ * and one sample is moved across if the lower heap has the wrong size.
+ * Every step is a heap sift, so a sample costs O(log n).
+ */
+#include <string.h>
+#include "filter.h"
+
+#define SIDE_LO		0
+#define SIDE_HI		1
+
+/*****************************************************************/
+//	Heap helpers.  The lower heap is ordered largest first, the upper
+//	heap smallest first; both store ring buffer slot numbers.
+/****************************************************************************/
+static u8 *heap_of(p_RankWindow p, u8 side)
+{
+	return (side == SIDE_LO) ? p->lo : p->hi;
+}
+
+// true if slot a belongs above slot b in the heap
+static int heap_before(p_RankWindow p, u8 side, u8 a, u8 b)
+{
+	return (side == SIDE_LO) ? (p->val[a] > p->val[b]) : (p->val[a] < p->val[b]);
+}
+
+static void heap_swap(p_RankWindow p, u8 side, u8 i, u8 j)
+{
+	u8 *h = heap_of(p, side);
+	u8 t = h[i];
+
+	h[i] = h[j];
+	h[j] = t;
+	p->idx[h[i]] = i;
+	p->idx[h[j]] = j;
+}
+
+static void heap_sift_up(p_RankWindow p, u8 side, u8 i)
+{
+	u8 *h = heap_of(p, side);
+
+	while ((i > 0) && heap_before(p, side, h[i], h[(i - 1) / 2])) {
+		heap_swap(p, side, i, (i - 1) / 2);
+		i = (i - 1) / 2;
+	}
+}
+
+static void heap_sift_down(p_RankWindow p, u8 side, u8 i)
+{
+	u8 *h = heap_of(p, side);
+	u8 n = (side == SIDE_LO) ? p->nlo : p->nhi;
+	u8 c;
+
+	for (;;) {
+		c = 2 * i + 1;
+		if (c >= n)
+			break;
+		if ((c + 1 < n) && heap_before(p, side, h[c + 1], h[c]))
+			c++;
+		if (!heap_before(p, side, h[c], h[i]))
+			break;
+		heap_swap(p, side, i, c);
+		i = c;
+	}
+}
+
+static void heap_push(p_RankWindow p, u8 side, u8 slot)
+{
+	u8 *h = heap_of(p, side);
+	u8 i = (side == SIDE_LO) ? p->nlo++ : p->nhi++;
+
+	h[i] = slot;
+	p->side[slot] = side;
+	p->idx[slot] = i;
+	if (side == SIDE_LO)
+		p->lo_sum += p->val[slot];
+	heap_sift_up(p, side, i);
+}
+
+static void heap_delete(p_RankWindow p, u8 slot)
+{
+	u8 side = p->side[slot];
+	u8 *h = heap_of(p, side);
+	u8 i = p->idx[slot];
+	u8 last = (side == SIDE_LO) ? --p->nlo : --p->nhi;
+	u8 moved;
+
+	if (side == SIDE_LO)
+		p->lo_sum -= p->val[slot];
+	if (i != last) {
+		// fill the hole with the last entry and restore the heap order
+		moved = h[last];
+		h[i] = moved;
+		p->idx[moved] = i;
+		heap_sift_up(p, side, i);
+		heap_sift_down(p, side, p->idx[moved]);
+	}
+}
+
+/*****************************************************************/
+//	Rank window
+/****************************************************************************/
+static void rank_init(p_RankWindow p, u8 window, u8 rank_num, u8 rank_den)
+{
+	memset(p, 0, sizeof(*p));
+	p->window = window;
+	p->rank_num = rank_num;
+	p->rank_den = rank_den;
+}
+
+// lower heap size for the current number of samples, a part full window
+// is split at the same fraction as a full one
+static u8 rank_target(p_RankWindow p)
+{
+	return (u8)(((u32)p->rank_num * p->count + p->rank_den - 1) / p->rank_den);
+}
+
+static void rank_add(p_RankWindow p, s32 sample)
+{
+	u8 slot = p->head;
+	u8 target;
+
+	if (p->count == p->window)
+		heap_delete(p, slot);			// oldest sample leaves the window
+	else
+		p->count++;
+	p->val[slot] = sample;
+	p->head = (p->head + 1) % p->window;
+
+	// every lower sample stays <= every upper sample
+	if ((p->nlo > 0) && (sample <= p->val[p->lo[0]]))
+		heap_push(p, SIDE_LO, slot);
+	else
+		heap_push(p, SIDE_HI, slot);
+
+	target = rank_target(p);
+	while (p->nlo > target) {
+		slot = p->lo[0];
+		heap_delete(p, slot);
+		heap_push(p, SIDE_HI, slot);
+	}
+	while ((p->nlo < target) && (p->nhi > 0)) {
+		slot = p->hi[0];
+		heap_delete(p, slot);
+		heap_push(p, SIDE_LO, slot);
+	}
+}
+
+/*****************************************************************/
+//	Sliding median
+//
+// Parameters
+// p_filt - filter instance
+// window - number of samples in the window, 1 to FILTER_MAX_WINDOW
+//
+// Returns XST_SUCCESS or XST_INVALID_PARAM
+/****************************************************************************/
+int median_init(p_MedianFilter p_filt, u8 window)
+{
+	if ((p_filt == NULL) || (window == 0) || (window > FILTER_MAX_WINDOW))
+		return XST_INVALID_PARAM;
+
+	rank_init(&p_filt->w, window, 1, 2);
+	return XST_SUCCESS;
+}
+
+/*****************************************************************/
+//	Add a sample and return the median of the window.  For an even
+//	number of samples the two middle samples are averaged.
+/****************************************************************************/
+s32 median_update(p_MedianFilter p_filt, s32 sample)
+{
+	p_RankWindow p = &p_filt->w;
+
+	rank_add(p, sample);
+	if (p->nlo > p->nhi)
+		return p->val[p->lo[0]];
+	return (s32)(((s64)p->val[p->lo[0]] + p->val[p->hi[0]]) / 2);
+}
+
+/*****************************************************************/
+//	Sliding trimmed mean
+//
+// Parameters
+// p_filt - filter instance
+// window - number of samples in the window, 1 to FILTER_MAX_WINDOW
+// trim   - samples discarded from each end of a full window, 2 * trim
+//          must be less than window
+//
+// Returns XST_SUCCESS or XST_INVALID_PARAM
+/****************************************************************************/
+int trimmed_mean_init(p_TrimmedMeanFilter p_filt, u8 window, u8 trim)
+{
+	if ((p_filt == NULL) || (window == 0) || (window > FILTER_MAX_WINDOW) ||
+			(2 * trim >= window))
+		return XST_INVALID_PARAM;
+
+	rank_init(&p_filt->low, window, trim, window);
+	rank_init(&p_filt->high, window, window - trim, window);
+	p_filt->trim = trim;
+	return XST_SUCCESS;
+}
+
+/*****************************************************************/
+//	Add a sample and return the mean of the window without its trim
+//	smallest and trim largest samples.  The kept samples are the
+//	lower heap of "high" less the lower heap of "low".
+/****************************************************************************/
+s32 trimmed_mean_update(p_TrimmedMeanFilter p_filt, s32 sample)
+{
+	u8 kept;
+
+	rank_add(&p_filt->low, sample);
+	rank_add(&p_filt->high, sample);
+	kept = p_filt->high.nlo - p_filt->low.nlo;
+	if (kept == 0)
+		return sample;
+	return (s32)((p_filt->high.lo_sum - p_filt->low.lo_sum) / kept);
+}
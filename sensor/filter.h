@@ -0,0 +1,61 @@
+/*
+ * filter.h
+ *
+ *  Created on: Jun 9, 2017
+ *
+ * Streaming robust filters for sensor samples.  Both filters keep a sliding
+ * window of the last n samples and cost O(log n) per sample.
+ */
+
+#ifndef SRC_FILTER_H_
+#define SRC_FILTER_H_
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+#define FILTER_MAX_WINDOW	32		// largest window supported
+
+/*
+ * Sliding window split at a rank: the lowest rank_num/rank_den of the samples
+ * (rounded up) are kept in a max-heap, the rest in a min-heap.  Both heaps hold slot numbers of the
+ * ring buffer so the oldest sample can be found and removed when a new one
+ * arrives.  The sum of the lower heap is kept up to date.
+ */
+typedef struct
+{
+	s32		val[FILTER_MAX_WINDOW];		// ring buffer of samples
+	u8		side[FILTER_MAX_WINDOW];	// heap holding each slot, 0 lower 1 upper
+	u8		idx[FILTER_MAX_WINDOW];		// position of each slot in its heap
+	u8		lo[FILTER_MAX_WINDOW];		// max-heap of the lower samples
+	u8		hi[FILTER_MAX_WINDOW];		// min-heap of the upper samples
+	u8		nlo;
+	u8		nhi;
+	u8		window;						// window length n
+	u8		rank_num;					// lower heap holds rank_num/rank_den of the samples
+	u8		rank_den;
+	u8		count;						// samples in the window
+	u8		head;						// slot of the oldest sample
+	s64		lo_sum;						// sum of the lower samples
+} RankWindow, *p_RankWindow;
+
+typedef struct
+{
+	RankWindow	w;
+} MedianFilter, *p_MedianFilter;
+
+typedef struct
+{
+	RankWindow	low;					// split above the samples trimmed from the bottom
+	RankWindow	high;					// split below the samples trimmed from the top
+	u8			trim;					// samples discarded from each end of a full window
+} TrimmedMeanFilter, *p_TrimmedMeanFilter;
+
+// sliding median
+int median_init(p_MedianFilter p_filt, u8 window);
+s32 median_update(p_MedianFilter p_filt, s32 sample);
+
+// sliding trimmed mean, trim samples are discarded from each end of the window
+int trimmed_mean_init(p_TrimmedMeanFilter p_filt, u8 window, u8 trim);
+s32 trimmed_mean_update(p_TrimmedMeanFilter p_filt, s32 sample);
+
+#endif /* SRC_FILTER_H_ */
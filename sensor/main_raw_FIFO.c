@@ -0,0 +1,845 @@
+/*
+ * main_raw_FIFO.c
+ *
+ *  Created on: Mar 21, 2017
+ *      Author: Francisco
+ */
+
+
+/**
+*
+* @author Francisco Lopez (fjl@pdx.edu)
+* @copyright Portland State University, 2014-2015, 2016-2017
+*
+*
+*
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "xparameters.h"
+#include "xstatus.h"
+#include "nexys4IO.h"
+#include "pmodENC.h"
+#include "xintc.h"
+#include "xtmrctr.h"
+#include "PmodOLEDrgb.h"
+#include "xtmrctr_l.h"
+#include "xbasic_types.h"
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "DC_motor_AXI.h"
+#include "xiic.h"
+#include "sensor.h"
+#include "dmp.h"
+#include "timebase.h"
+#include "scheduler.h"
+/************************** Constant Definitions ****************************/
+// Clock frequencies
+#define CPU_CLOCK_FREQ_HZ		XPAR_CPU_CORE_CLOCK_FREQ_HZ
+#define AXI_CLOCK_FREQ_HZ		XPAR_CPU_M_AXI_DP_FREQ_HZ
+
+// Definition for peripheral IIC controller
+#define IIC_DEVICE_ID 			XPAR_IIC_0_DEVICE_ID
+#define IIC_BASEADDR			XPAR_IIC_0_BASEADDR
+
+// Definition for the AXI timer, it is the time base for delays
+#define AXI_TIMER_BASEADDR		XPAR_TMRCTR_0_BASEADDR
+
+// Definitions for peripheral NEXYS4IO
+#define NX4IO_DEVICE_ID		XPAR_NEXYS4IO_0_DEVICE_ID
+#define NX4IO_BASEADDR		XPAR_NEXYS4IO_0_S00_AXI_BASEADDR
+
+// Definitions for peripheral PMODOLEDRGB
+#define RGBDSPLY_DEVICE_ID		XPAR_PMODOLEDRGB_0_DEVICE_ID
+#define RGBDSPLY_GPIO_BASEADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR
+#define RGBDSPLY_SPI_BASEADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_BASEADDR
+#define RGBDSPLY_SPI_HIGHADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_HIGHADDR
+
+// Definitions for peripheral PMODENC
+#define PMODENC_DEVICE_ID		XPAR_PMODENC_0_DEVICE_ID
+#define PMODENC_BASEADDR		XPAR_PMODENC_0_S00_AXI_BASEADDR
+
+// Interrupt Controller parameters
+#define INTC_DEVICE_ID			XPAR_INTC_0_DEVICE_ID
+#define FIT_INTERRUPT_ID		XPAR_MICROBLAZE_0_AXI_INTC_FIT_TIMER_1_INTERRUPT_INTR // FIT_1 200 Hz, FIT_2 500Hz
+#define BTNC_INTERRUPT_ID		XPAR_MICROBLAZE_0_AXI_INTC_XLSLICE_0_DOUT_INTR
+#define IIC_INTERRUPT_ID		XPAR_MICROBLAZE_0_AXI_INTC_AXI_IIC_0_IIC2INTC_IRPT_INTR
+#define TIMER_INTERRUPT_ID		XPAR_MICROBLAZE_0_AXI_INTC_AXI_TIMER_0_INTERRUPT_INTR
+
+// Frequency averaging array size
+#define ARY_S	10
+
+// time the motor is held off after BtnC so it stops completely
+#define MOTOR_STOP_HOLD_US	100000
+
+// Task table, in rate monotonic order.  Periods and budgets are in microseconds
+#define TASK_FIFO		0		// reads a raw sample from the FIFO and prints it, released by the FIT
+#define TASK_DISPLAY	1		// prints the FIFO count, 10 Hz
+#define NUM_TASKS		2
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Variable Definitions ****************************/
+
+/************************** Function Prototypes *****************************/
+//u8 mode(u8 a[],int n);
+void usleep(u32 usecs);
+void FIT_Handler(void);
+void BtnC_Handler(void);
+void fifo_task(void);
+void display_task(void);
+void motor_hold_expired(void *p_unused);
+
+//int do_init_nx4io(u32 BaseAddress);
+//int do_init_pmdio(u32 BaseAddress);
+//int AXI_Timer_initialize(void);
+int do_init();
+
+PmodENC 	pmodENC_inst;				// PmodENC instance ref
+PmodOLEDrgb	pmodOLEDrgb_inst;			// PmodOLED instance ref
+XIntc 		IntrptCtlrInst;				// Interrupt Controller instance
+XIic		IIC_inst;					// IIC instance
+
+SCHED_Task	tasks[NUM_TASKS] =
+{
+	// name		body			period	budget
+	{"fifo",	fifo_task,		5000,	2000},
+	{"display",	display_task,	100000,	5000},
+};
+//XIic 		*IicPtr;					// argument for IIC interrupt handler
+
+// The following variables are shared between non-interrupt processing and
+// interrupt processing such that they must be global(and declared volatile)
+// These variables are controlled by the FIT timer interrupt handler
+// "clkfit" toggles each time the FIT interrupt handler is called so its frequency will
+// be 1/2 FIT_CLOCK_FREQ_HZ.  timestamp increments every 1msec and is used in delay_msecs()
+volatile u8 			col = 0;
+volatile u8				freq;			// measured motor frequency, from Hall sensor
+volatile u8				freq_ary[ARY_S];
+volatile u8				update_freq;
+volatile s32			fit_cnt;
+volatile u8				read_fifo;
+u16 					sw = 0;
+u16  					RotaryCnt;				// read from hardware, range: 0x0 to 0xFFFF
+u16						RotaryCntOld=0;			// previous value of RotaryCnt
+int						RotaryDelta;			// Delta = RotaryCnt - RotaryCntOld
+volatile u16			duty;			// duty cycle motor command
+u16						duty_f;
+volatile u8				freq_s;			// motor frequency set point
+volatile u8 			freq_sa;
+u8						avg_freq;
+u8 						avg_freq_old;
+s16						freq_chg;
+u8						oldset;
+u8 						oldseta;
+u8						oldavg;
+s16						err;
+s16						err_old;
+s16						err_chg;
+volatile u8				kp;
+volatile u8				ki;
+volatile u8				kd;
+u8 						k_select;
+s32						duty_delta;
+s32						p_delta; // proportional correction
+s32						i_delta; // integral correction
+s32						d_delta; // derivative correction
+s32						err_sum;
+s32						err_sum_max;
+s32						err_sum_min;
+u8 						dir;
+u16						rpm;
+u16						print_data;
+//s32 					sum_freq;
+//u8					prev_freq;
+//u8					prev_avg;
+//u8 					final_freq
+volatile s32			quat[4];
+s32						avg_quat[4];
+volatile u8				update_quat;
+volatile u8				motor_hold;		// motor is held off until it stops after BtnC
+u16						fifo_count;		// bytes in the MPU-6050 FIFO at the last read
+/************************** MAIN PROGRAM ************************************/
+int main()
+{
+	int sts;
+	u16 sw;							// board switches[15:0]
+	int  StepIncr=1;				// 1 to 15, increment of Hue, Sat, Val
+	u8 RotaryNoNeg=FALSE;
+
+	init_platform();
+    sts = do_init();		// initialize the peripherals
+    if (XST_SUCCESS != sts)
+    {
+    	exit(1);
+    }
+
+    microblaze_enable_interrupts();		// enable the interrupts
+    // Initialize the rotary encoder
+	// clear the counter of the encoder if initialized to garbage value on power on
+	pmodENC_init(&pmodENC_inst, StepIncr, RotaryNoNeg);
+	pmodENC_clear_count(&pmodENC_inst);
+
+	// Set up the display output
+	OLEDrgb_Clear(&pmodOLEDrgb_inst);
+	OLEDrgb_EnableBackLight(&pmodOLEDrgb_inst, true);
+
+	read_fifo=0;
+	freq_s=0;
+	freq_sa=0;
+	duty_f=0;
+	duty=0;
+	k_select=0;
+	kp=0;
+	ki=0;
+	kd=0;  // 15-25 kp, >> 8  with FIT 2 (100 MHz)/200,000= 500 Hz  and ARY_S=25
+		// 30 -40 kp, >>6 with FIT 2 (100 MHz)/200,000= 500 Hz  and ARY_S=20
+	avg_freq=0;
+	avg_freq_old=0;
+	freq_chg=0;
+	duty_delta=0;
+	p_delta=0;
+	i_delta=0;
+	d_delta=0;
+	err_sum=0;
+	err_sum_max= 500;
+	err_sum_min= -err_sum_max;
+	dir =0;
+	oldset = 0;
+	oldseta=0;
+	oldavg = 0;
+	StepIncr = 1;
+	int i_max=1e6; // for wait loop
+	//unsigned char data[16]; //data buffer
+	for (int i=0;i<4;i++)
+		avg_quat[i]=0;
+	u8 data[16]; //data buffer
+
+	data[0]=0x80; //reset device
+	i2c_write(0,0x6B,1,data);
+	usleep(100e3); // wait 100 ms for reset to complete
+	//i2c_read(0,0x6B,2,data);
+	data[0]=0x00; // wake up
+	data[1]=0x00;
+	i2c_write(0,0x6B,2,data);// don't read immediately after write?
+	//i2c_read(0,0x6B,2,data); // Make sure 0x6B is 0x00 and not 0x40 (sleep mode)
+
+	// test communication by reading a register
+	//i2c_read(0,0x75,2,data); // read Who_I_Am ID register expect 0x68
+	data[0]=0x03;
+	data[1]=0x18;
+	data[2]=0x00;
+	i2c_write(0,0x1A,3,data); // write to 1A,1B,1C
+	data[0]=0x00;
+	i2c_write(0,0x23,1,data);
+	i2c_write(0,0x38,1,data);
+	data[0]=0x04;
+	i2c_write(0,0x6A,1,data);
+	data[0]=19; // Sampling rate 200 Hz = 1kHz/ (1 + data[0])
+	i2c_write(0,0x19,1,data);
+	data[0]=0x00;
+	//i2c_read(0,0x19,2,data);
+	//dmp_load_motion_driver_firmware(); // load DMP firmware image
+
+	//Enable FIFO output accel and gyro
+	data[0]=0x77;
+	i2c_write(0,0x23,1,data);
+
+//	// Enable 6-axis quat output to FIFO
+//	data[0]=0x0A;
+//	data[1]=0xA3;
+//	data[2]=0x20;
+//	data[3]=0x28;
+//	data[4]=0x30;
+//	data[5]=0x30;
+//	i2c_write(0,0x6D,6,data);
+	//Reset and Enable FIFO & DMP
+	data[0]=0x04;
+	i2c_write(0,0x6A,1,data);
+	data[0]=0x40;
+	i2c_write(0,0x6A,1,data);
+//	data[0]=0x08;
+//	i2c_write(0,0x6A,1,data);
+//	data[0]=0x80;
+//	i2c_write(0,0x6A,1,data);
+	//data[0]=0x02; // Enable DMP interrupt
+	//i2c_write(0,0x38,1,data);
+	XIntc_Enable(&IntrptCtlrInst, FIT_INTERRUPT_ID); // Reads sensor data
+	// the FIT releases the FIFO task, which reads the raw samples
+
+	// run the tasks
+	sts = SCHED_initialize(tasks, NUM_TASKS);
+	if (XST_SUCCESS != sts)
+	{
+		exit(1);
+	}
+	SCHED_run();
+} // END Main
+
+/**
+ * Function Name: do_init()
+ *
+ * Return: XST_FAILURE or XST_SUCCESS
+ *
+ * Description: Initialize the AXI timer, interrupt, FIT timer, Encoder,
+ * 				OLED display
+ */
+int do_init()
+{
+	int status;
+
+	// initialize IIC controller
+	status =  XIic_Initialize(&IIC_inst, IIC_DEVICE_ID );
+	if (status == XST_FAILURE)
+		{
+			exit(1);
+		}
+	// Set IIC the Transmit, Receive and Status handlers.
+
+		XIic_SetSendHandler(&IIC_inst, &IIC_inst,
+					(XIic_Handler) SendHandler);
+		XIic_SetRecvHandler(&IIC_inst, &IIC_inst,
+					(XIic_Handler) ReceiveHandler);
+		XIic_SetStatusHandler(&IIC_inst, &IIC_inst,
+					  (XIic_StatusHandler) StatusHandler);
+
+	// Set the address of slave device in I2C bus (MPU-6050 sensor)
+	status = XIic_SetAddress(&IIC_inst, XII_ADDR_TO_SEND_TYPE , 0x68);
+	if (status != XST_SUCCESS)
+				{
+					exit(1);
+				}
+
+	// initialize the Nexys4 driver and (some of)the devices
+	status = (uint32_t) NX4IO_initialize(NX4IO_BASEADDR);
+	if (status == XST_FAILURE)
+	{
+		exit(1);
+	}
+	NX4IO_setLEDs(0x0000);
+	// initialize the PMod544IO driver and the PmodENC and PmodCLP
+	status = pmodENC_initialize(&pmodENC_inst, PMODENC_BASEADDR);
+	if (status == XST_FAILURE)
+	{
+		exit(1);
+	}
+
+	// Initialize the AXI Timer, it is the time base for usleep() and the display delays
+	status = TB_initialize(AXI_TIMER_BASEADDR, AXI_CLOCK_FREQ_HZ);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+	OLEDrgb_SetDelay(TB_delay_us);
+
+	// Start the I2C transaction queue, this starts the IIC controller device
+	status = i2c_queue_init(&IIC_inst, TB_get_ticks, TB_ticks_per_us());
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	// set all of the display digits to blanks and turn off
+	// the decimal points using the "raw" set functions.
+	// These registers are formatted according to the spec
+	// and should remain unchanged when written to Nexys4IO...
+	// something else to check w/ the debugger when we bring the
+	// drivers up for the first time
+	NX4IO_SSEG_setSSEG_DATA(SSEGHI, 0x0058E30E);
+	NX4IO_SSEG_setSSEG_DATA(SSEGLO, 0x00144116);
+
+	// Initialize the OLED display
+	OLEDrgb_begin(&pmodOLEDrgb_inst, RGBDSPLY_GPIO_BASEADDR, RGBDSPLY_SPI_BASEADDR);
+
+	// initialize the interrupt controller
+	status = XIntc_Initialize(&IntrptCtlrInst, INTC_DEVICE_ID);
+	if (status != XST_SUCCESS)
+	{
+	   return XST_FAILURE;
+	}
+
+	// connect the fixed interval timer (FIT) handler to the interrupt
+	status = XIntc_Connect(&IntrptCtlrInst, FIT_INTERRUPT_ID,
+						   (XInterruptHandler)FIT_Handler,
+						   (void *)0);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+
+	}
+
+	// connect the Center Button (BTNC) handler to the interrupt
+	status = XIntc_Connect(&IntrptCtlrInst, BTNC_INTERRUPT_ID,
+						   (XInterruptHandler)BtnC_Handler,
+						   (void *)0);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+
+	}
+	// Connect the IIC controller interrupt handler (int director)
+	status = XIntc_Connect(&IntrptCtlrInst, IIC_INTERRUPT_ID,
+			(XInterruptHandler)XIic_InterruptHandler, &IIC_inst);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	// Connect the time base interrupt handler
+	status = XIntc_Connect(&IntrptCtlrInst, TIMER_INTERRUPT_ID,
+			(XInterruptHandler)TB_InterruptHandler, (void *)0);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	// start the interrupt controller such that interrupts are enabled for
+	// all devices that cause interrupts.
+	status = XIntc_Start(&IntrptCtlrInst, XIN_REAL_MODE);
+	if (status != XST_SUCCESS)
+	{
+		return XST_FAILURE;
+	}
+
+	// enable individual interrupts
+//	XIntc_Enable(&IntrptCtlrInst, FIT_INTERRUPT_ID); // Don't enable until after config MPU6050
+	XIntc_Enable(&IntrptCtlrInst, BTNC_INTERRUPT_ID);
+	XIntc_Enable(&IntrptCtlrInst, IIC_INTERRUPT_ID);
+	XIntc_Enable(&IntrptCtlrInst, TIMER_INTERRUPT_ID);
+	return XST_SUCCESS;
+}
+
+/*********************** HELPER FUNCTIONS ***********************************/
+
+/****************************************************************************/
+/**
+* insert delay (in microseconds) between instructions.
+*
+* This function should be in libc but it seems to be missing.  The delay is timed by
+* the AXI timer time base so it does not depend on the CPU clock or the compiler.
+*
+* @param	usec is the requested delay in microseconds
+*
+* @return	*NONE*
+*
+*****************************************************************************/
+
+void usleep(u32 usec)
+{
+	TB_delay_us(usec);
+}
+
+
+/****************************************************************************/
+/**
+* initialize the Nexys4 LEDs and seven segment display digits
+*
+* Initializes the NX4IO driver, turns off all of the LEDs and blanks the seven segment display
+*
+* @param	BaseAddress is the memory mapped address of the start of the Nexys4 registers
+*
+* @return	XST_SUCCESS if initialization succeeds.  XST_FAILURE otherwise
+*
+* @note
+* The NX4IO_initialize() function calls the NX4IO self-test.  This could
+* cause the program to hang if the hardware was not configured properly
+*
+*****************************************************************************/
+int do_init_nx4io(u32 BaseAddress)
+{
+	int sts;
+
+	// initialize the NX4IO driver
+	sts = NX4IO_initialize(BaseAddress);
+	if (sts == XST_FAILURE)
+		return XST_FAILURE;
+
+	// turn all of the LEDs off using the "raw" set functions
+	// functions should mask out the unused bits..something to check w/
+	// the debugger when we bring the drivers up for the first time
+	NX4IO_setLEDs(0x0000);
+	NX4IO_RGBLED_setRGB_DATA(RGB1, 0xFF000000);
+	NX4IO_RGBLED_setRGB_DATA(RGB2, 0xFF000000);
+	NX4IO_RGBLED_setRGB_CNTRL(RGB1, 0xFFFFFFF0);
+	NX4IO_RGBLED_setRGB_CNTRL(RGB2, 0xFFFFFFFC);
+
+	// set all of the display digits to blanks and turn off
+	// the decimal points using the "raw" set functions.
+	// These registers are formatted according to the spec
+	// and should remain unchanged when written to Nexys4IO...
+	// something else to check w/ the debugger when we bring the
+	// drivers up for the first time
+	NX4IO_SSEG_setSSEG_DATA(SSEGHI, 0x0058E30E);
+	NX4IO_SSEG_setSSEG_DATA(SSEGLO, 0x00144116);
+
+	return XST_SUCCESS;
+
+}
+
+
+/*********************** DISPLAY-RELATED FUNCTIONS ***********************************/
+
+/****************************************************************************/
+/**
+* Converts an integer to ASCII characters
+*
+* algorithm borrowed from ReactOS system libraries
+*
+* Converts an integer to ASCII in the specified base.  Assumes string[] is
+* long enough to hold the result plus the terminating null
+*
+* @param 	value is the integer to convert
+* @param 	*string is a pointer to a buffer large enough to hold the converted number plus
+*  			the terminating null
+* @param	radix is the base to use in conversion,
+*
+* @return  *NONE*
+*
+* @note
+* No size check is done on the return string size.  Make sure you leave room
+* for the full string plus the terminating null in string
+*****************************************************************************/
+void PMDIO_itoa(int32_t value, char *string, int32_t radix)
+{
+	char tmp[33];
+	char *tp = tmp;
+	int32_t i;
+	uint32_t v;
+	int32_t  sign;
+	char *sp;
+
+	if (radix > 36 || radix <= 1)
+	{
+		return;
+	}
+
+	sign = ((10 == radix) && (value < 0));
+	if (sign)
+	{
+		v = -value;
+	}
+	else
+	{
+		v = (uint32_t) value;
+	}
+
+  	while (v || tp == tmp)
+  	{
+		i = v % radix;
+		v = v / radix;
+		if (i < 10)
+		{
+			*tp++ = i+'0';
+		}
+		else
+		{
+			*tp++ = i + 'a' - 10;
+		}
+	}
+	sp = string;
+
+	if (sign)
+		*sp++ = '-';
+
+	while (tp > tmp)
+		*sp++ = *--tp;
+	*sp = 0;
+
+  	return;
+}
+
+
+/****************************************************************************/
+/**
+* Write a 32-bit unsigned hex number to PmodOLEDrgb in Hex
+*
+* Writes  32-bit unsigned number to the pmodOLEDrgb display starting at the current
+* cursor position.
+*
+* @param num is the number to display as a hex value
+*
+* @return  *NONE*
+*
+* @note
+* No size checking is done to make sure the string will fit into a single line,
+* or the entire display, for that matter.  Watch your string sizes.
+*****************************************************************************/
+void PMDIO_puthex(PmodOLEDrgb* InstancePtr, uint32_t num)
+{
+  char  buf[9];
+  int32_t   cnt;
+  char  *ptr;
+  int32_t  digit;
+
+  ptr = buf;
+  for (cnt = 7; cnt >= 0; cnt--) {
+    digit = (num >> (cnt * 4)) & 0xF;
+
+    if (digit <= 9)
+	{
+      *ptr++ = (char) ('0' + digit);
+	}
+    else
+	{
+      *ptr++ = (char) ('a' - 10 + digit);
+	}
+  }
+
+  *ptr = (char) 0;
+  OLEDrgb_PutString(InstancePtr,buf);
+
+  return;
+}
+
+
+/****************************************************************************/
+/**
+* Write a 32-bit number in Radix "radix" to LCD display
+*
+* Writes a 32-bit number to the LCD display starting at the current
+* cursor position. "radix" is the base to output the number in.
+*
+* @param num is the number to display
+*
+* @param radix is the radix to display number in
+*
+* @return *NONE*
+*
+* @note
+* No size checking is done to make sure the string will fit into a single line,
+* or the entire display, for that matter.  Watch your string sizes.
+*****************************************************************************/
+void PMDIO_putnum(PmodOLEDrgb* InstancePtr, int32_t num, int32_t radix, u16 field)
+{
+  char  buf[16];
+  u16	zeroes;
+
+  PMDIO_itoa(num, buf, radix);
+  zeroes = field - strlen(buf);
+  for (int i=zeroes; i>0; i--)
+	  OLEDrgb_PutChar(InstancePtr, '0');
+  OLEDrgb_PutString(InstancePtr, buf) ;
+
+  return;
+}
+
+/****************************************************************************/
+/**
+* writes a 16-bit unsigned hex number to the selected display bank
+*
+* Breaks a 16-bit binary number (u16) into individual digits and displays
+* them on the selected seven segment display bank.
+*
+* The Nexys4 board has two 4-digit seven segment display banks.  SSEGLO
+* includes digits 3-0 (rightmost digits).  SSEGHI includes digits 7-4
+* (leftmost digits)
+*
+* @param	bank is used to select which of the SSEG_DATA data registers to write
+*
+* @param	data is the 16-bit unsigned number that will be displayed in hex
+*
+*
+* @return	XST_SUCCESS if the number was displayed correctly.  XST_FAILURE if the operation
+*			failed (i.e. one of the parameters was invalid)
+*
+* @note		See the NEXYS4IO Datasheet for the character code table and the
+*			format of the SSEG_DATA registers
+* @note		No checking is done on the bank select. Doesn't write
+*			invalid registers.
+*
+*****************************************************************************/
+int myNX4IO_SSEG_putU16Hex(enum _NX4IO_ssegbanks bank, u16 data)
+{
+	u8 cc[8];		// character codes for each of the nibbles in data
+	u8 dp;			// current decimal points.  We don't want to change them
+
+	// convert data to hex and display it on all the selected bank of digits
+	bin2hex((u32) data, cc);
+	switch (bank)
+	{
+		case SSEGLO:
+			dp = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGLO)  >> 24);
+			NX410_SSEG_setAllDigits(SSEGLO, cc[3], cc[2], cc[1], cc[0], dp);
+			break;
+		case SSEGHI:
+			dp = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGHI)  >> 24);
+			NX410_SSEG_setAllDigits(SSEGHI, cc[3], cc[2], cc[1], cc[0], dp);
+			break;
+		default:
+			// Invalid bank.  Operation failed
+			return XST_FAILURE;
+	}
+
+	// we made it!!
+	return XST_SUCCESS;
+}
+
+///**********************************************************/
+////		Support function to calculate Mode of an array  //
+//// Mode defined as value occurring with highest frequency
+//
+//u8 mode(u8 a[],int n) {
+//   u8 maxValue = 0;
+//   int maxCount = 0;
+//   int i, j;
+//
+//   for (i = 0; i < n; ++i) {
+//      int count = 0;
+//
+//      for (j = 0; j < n; ++j) {
+//         if (a[j] == a[i])
+//         ++count;
+//      }
+//
+//      if (count > maxCount) {
+//         maxCount = count;
+//         maxValue = a[i];
+//      }
+//   }
+//
+//   return maxValue;
+//}
+
+/******************************** TASKS ***************************************/
+
+/****************************************************************************/
+/**
+* FIFO task
+*
+* Reads one raw sample from the MPU-6050 FIFO, if it holds one, and prints the scaled
+* X, Y and Z values for the serial plotter.  Released by the FIT handler
+*
+ *****************************************************************************/
+void fifo_task(void)
+{
+	u8 temporas[2];
+	u8 data[6]; //data buffer
+	s16 accX, accY,accZ;
+
+	if (read_fifo){
+		read_fifo=0; // clear semaphore
+		i2c_read(0,0x72, 2, temporas);
+		fifo_count = (temporas[0] << 8) | temporas[1];
+
+		if (fifo_count >= 6)
+		{
+			i2c_read(0,0x74, 6, data); // Read FIFO
+			accX = (data[0] << 8) | data[1];
+			accY = (data[2] << 8) | data[3];
+			accZ = (data[4] << 8) | data[5];
+			accX/=25;
+			accY/=25;
+			accZ/=25;
+			xil_printf("$%d %d %d;", accX,accY,accZ);
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+* Display task
+*
+* Prints the FIFO count, it should stay below one sample if the FIFO task keeps up
+*
+ *****************************************************************************/
+void display_task(void)
+{
+	xil_printf("FIFO count = %u \r\n", fifo_count);
+}
+
+/**************************** INTERRUPT HANDLERS ******************************/
+
+/****************************************************************************/
+/**
+* Center Button Interrupt Handler
+*
+* Stops the motor turning off PWM signal
+*
+ *****************************************************************************/
+
+void BtnC_Handler(void)
+{
+
+	//xil_printf("Stopping motor... set PWM to zero \r\n ");
+	DC_MOTOR_AXI_mWriteReg(0x44A40000, 4, 0);
+	freq_s=0;
+	freq_sa=0;
+	duty=0;
+	pmodENC_clear_count(&pmodENC_inst);
+	kp = 1;
+	ki = 1;
+	kd =1;
+	// Give time for motor to turn off completely.  The hold bypasses the hard limit imposed
+	// on min duty=121 by waiting until the motor stops, then even if the duty goes back to 121,
+	// motor will not start.  The time base ends the hold so the handler does not spin
+	motor_hold = 1;
+	if (TB_call_at(TB_now_us() + MOTOR_STOP_HOLD_US, motor_hold_expired, NULL) < 0)
+	{
+		motor_hold = 0;
+	}
+}
+
+/****************************************************************************/
+/**
+* Motor stop hold callback
+*
+* Called from the time base interrupt when the motor has had time to stop after BtnC
+*
+ *****************************************************************************/
+void motor_hold_expired(void *p_unused)
+{
+	motor_hold = 0;
+}
+
+/*******************************************************************************
+* Fixed interval timer interrupt handler
+*
+* Releases the FIFO task to read the next raw sample
+*
+ *****************************************************************************/
+void FIT_Handler(void)
+{
+	read_fifo=1;
+	SCHED_release(TASK_FIFO);
+}
+
+//void FIT_Handler(void)
+//{
+//	//read_fifo=1;
+//	dmp_read_fifo(quat);
+//	for (int i=0;i<4;i++)
+//		quat_ary[i][ fit_cnt ]= quat[i];
+//	if ( fit_cnt == ARY_S-1 ){
+//			update_quat=1; // set semaphore for main loop
+//			fit_cnt = -1;
+//	}
+//	fit_cnt++;
+//}
+
+///*******************************************************************************
+//* Fixed interval timer interrupt handler
+//*
+//* Reads the GPIO port which reads back the hardware generated PWM wave for the RGB Leds
+//*
+//* @note
+//* ECE 544 students - When you implement your software solution for pulse width detection in
+//* Project 1 this could be a reasonable place to do that processing.
+// *****************************************************************************/
+//
+//void FIT_Handler(void)
+//{
+//	freq = DC_MOTOR_AXI_mReadReg(0x44A40000, 8); // measured
+//	freq_ary[ fit_cnt ]= freq;
+//	if ( fit_cnt == ARY_S-1 ){
+//			update_freq=1; // set semaphore for main loop
+//			fit_cnt = -1;
+//}
+//	fit_cnt++;
+//}
+
+
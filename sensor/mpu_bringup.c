@@ -0,0 +1,89 @@
+/*
+ * mpu_bringup.c
+ *
+ *  Created on: Jun 12, 2017
+ *
+ * The bring-up queues one write at a time and waits for a free slot before
+ * each one, so the queue never refuses a write.  The writes complete from
+ * the IIC interrupt handlers; the queue restarts itself after the write
+ * guard, so the protothread only has to be called until it ends.
+ */
+#include "sensor.h"
+#include "mpu_bringup.h"
+
+const MPU_Write	mpu_config[] =
+{
+	{0x6B, 2, {0x00, 0x00}},			// wake up
+	{0x1A, 3, {0x03, 0x18, 0x00}},		// write to 1A,1B,1C
+	{0x23, 1, {0x00}},
+	{0x38, 1, {0x00}},
+	{0x6A, 1, {0x04}},
+	{0x19, 1, {19}},					// Sampling rate 200 Hz = 1kHz/ (1 + data[0])
+	{0x6D, 6, {0x0A, 0xA3, 0x20, 0x28, 0x30, 0x30}},	// Enable 6-axis quat output to FIFO
+	{0x6A, 1, {0x04}},					// Reset and Enable FIFO & DMP
+	{0x6A, 1, {0x40}},
+	{0x6A, 1, {0x08}},
+	{0x6A, 1, {0x80}},
+	{0x38, 1, {0x02}},					// Enable DMP interrupt
+};
+const u32		mpu_config_len = sizeof(mpu_config) / sizeof(mpu_config[0]);
+
+static u32				mpu_next;		// next mpu_config[] write to submit
+static volatile u32		mpu_done;		// writes completed
+static volatile u32		mpu_errors;		// writes that failed
+static u32				mpu_restarts;	// times the sequence was restarted
+
+/*****************************************************************/
+//	Completion callback of the bring-up writes, called from the IIC
+//	interrupt handler
+/****************************************************************************/
+static void mpu_write_done(int status, void *p_unused)
+{
+	if (status != XST_SUCCESS)
+		mpu_errors++;
+	mpu_done++;
+}
+
+/*****************************************************************/
+//	Reset the MPU-6050, wait for the reset to complete, then write the
+//	DMP configuration.  The whole sequence restarts if a write fails.
+//	Returns PT_ENDED when the configuration has been written.
+/****************************************************************************/
+PT_THREAD(mpu_bringup(struct pt *pt))
+{
+	static const u8 reset = 0x80;
+
+	PT_BEGIN(pt);
+
+	mpu_done = 0;
+	mpu_errors = 0;
+	PT_WAIT_UNTIL(pt, (i2c_queue_depth() < I2C_QUEUE_DEPTH) &&
+			(i2c_submit_write(0x6B, 1, &reset, mpu_write_done, NULL) == XST_SUCCESS)); //reset device
+	PT_WAIT_UNTIL(pt, mpu_done == 1);
+	PT_SLEEP_US(pt, MPU_RESET_US); // wait 100 ms for reset to complete
+
+	// queue the configuration, a write is submitted when there is a free slot
+	for (mpu_next = 0; mpu_next < mpu_config_len; mpu_next++)
+	{
+		PT_WAIT_UNTIL(pt, (i2c_queue_depth() < I2C_QUEUE_DEPTH) &&
+				(i2c_submit_write(mpu_config[mpu_next].reg, mpu_config[mpu_next].len,
+				mpu_config[mpu_next].data, mpu_write_done, NULL) == XST_SUCCESS));
+	}
+	PT_WAIT_UNTIL(pt, mpu_done == mpu_config_len + 1);
+
+	if (mpu_errors != 0)
+	{
+		mpu_restarts++;
+		PT_RESTART(pt);
+	}
+	PT_END(pt);
+}
+
+/*****************************************************************/
+//	Returns the number of times the sequence was restarted after a
+//	failed write
+/****************************************************************************/
+u32 mpu_bringup_restarts(void)
+{
+	return mpu_restarts;
+}
@@ -0,0 +1,35 @@
+/*
+ * mpu_bringup.h
+ *
+ *  Created on: Jun 12, 2017
+ *
+ * MPU-6050 bring-up sequence, run as a protothread (pt.h) from a scheduler
+ * task.  The reset and the DMP configuration are written through the I2C
+ * transaction queue (sensor.h), so the task never waits for the bus.
+ */
+
+#ifndef SRC_MPU_BRINGUP_H_
+#define SRC_MPU_BRINGUP_H_
+
+#include "xil_types.h"
+#include "pt.h"
+
+// MPU-6050 reset time
+#define MPU_RESET_US	100000
+
+// one register write of the bring-up sequence
+typedef struct
+{
+	u8		reg;
+	u8		len;
+	u8		data[6];
+} MPU_Write;
+
+// configuration written after the reset, in order
+extern const MPU_Write	mpu_config[];
+extern const u32		mpu_config_len;
+
+PT_THREAD(mpu_bringup(struct pt *pt));
+u32 mpu_bringup_restarts(void);
+
+#endif /* SRC_MPU_BRINGUP_H_ */
@@ -0,0 +1,562 @@
+/*
+ * sensor.c
+ *
+ *  Created on: Mar 17, 2017
+ *      Author: Francisco
+ *
+ * I2C transfers to the MPU-6050 are queued and run from the IIC interrupt
+ * handlers so the caller does not wait for the bus.  A transaction is started
+ * when the one ahead of it completes.  A transaction held off by the write
+ * guard is restarted by a time base callback at the end of the guard, one
+ * held off by a busy bus by the IIC bus-not-busy event.
+ */
+#include <string.h>
+#include "xil_types.h"
+#include "xiic.h"
+#include "mb_interface.h"
+#include "sensor.h"
+#include "timebase.h"
+#include "dmp.h"
+
+// transaction phases
+#define I2C_PHASE_IDLE		0
+#define I2C_PHASE_ADDR		1		// sending the register address of a read
+#define I2C_PHASE_READ		2		// receiving the data of a read
+#define I2C_PHASE_WRITE		3		// sending the register address and data of a write
+
+#define MSR_IE_MASK			0x02	// MicroBlaze interrupt enable bit
+
+typedef struct
+{
+	I2C_Dir			dir;
+	unsigned char	length;
+	unsigned char	*rd_data;							// destination of a read
+	unsigned char	wr_data[I2C_MAX_WRITE_LEN + 1];		// register address plus data of a write
+	I2C_Callback	callback;
+	void			*context;
+} I2C_Xfer;
+
+static XIic				*IicPtr = NULL;
+static I2C_TimeFunc		GetTime = NULL;
+static u32				TicksPerUs = 1;
+
+static I2C_Xfer			XferQueue[I2C_QUEUE_DEPTH];
+static volatile u32		QueueHead;						// transaction in flight or next to start
+static volatile u32		QueueTail;						// next free slot
+static volatile u32		QueueCount;
+static volatile u8		Phase = I2C_PHASE_IDLE;
+static u8				ReadTmp[2];						// a 1 byte read is done as 2 bytes
+
+static u32				XferStart;								// timer counts
+static u32				LastWriteEnd;
+static bool				WriteGuardActive = false;
+static volatile int		GuardTimer = -1;						// time base callback at the end of the guard
+static I2C_Stats		Stats;
+static u32				StatsStart;
+
+static void i2c_start_next(void);
+static void i2c_complete(int status);
+static void i2c_guard_expired(void *context);
+
+/*****************************************************************/
+//	Critical section helpers.  The queue is shared with the IIC
+//	interrupt handlers and transactions may be submitted from other
+//	interrupt handlers, so the previous interrupt state is restored
+/****************************************************************************/
+static u32 i2c_lock(void)
+{
+	u32 msr = mfmsr();
+	microblaze_disable_interrupts();
+	return msr;
+}
+
+static void i2c_unlock(u32 msr)
+{
+	if (msr & MSR_IE_MASK)
+		microblaze_enable_interrupts();
+}
+
+/*****************************************************************/
+//	Initialize the transaction queue and start the IIC controller
+//
+// Parameters
+// p_iic       - IIC instance, initialized and with SendHandler, ReceiveHandler
+//               and StatusHandler installed
+// get_time     - free running timer count
+// ticks_per_us - timer counts per microsecond
+//
+// Returns XST_SUCCESS, XST_INVALID_PARAM or the status of XIic_Start()
+/****************************************************************************/
+int i2c_queue_init(XIic *p_iic, I2C_TimeFunc get_time, u32 ticks_per_us)
+{
+	int Status;
+
+	if ((p_iic == NULL) || (get_time == NULL) || (ticks_per_us == 0))
+		return XST_INVALID_PARAM;
+
+	IicPtr = p_iic;
+	GetTime = get_time;
+	TicksPerUs = ticks_per_us;
+	QueueHead = 0;
+	QueueTail = 0;
+	QueueCount = 0;
+	Phase = I2C_PHASE_IDLE;
+	WriteGuardActive = false;
+	if (GuardTimer >= 0) {
+		TB_cancel(GuardTimer);
+		GuardTimer = -1;
+	}
+	memset(&Stats, 0, sizeof(Stats));
+	StatsStart = GetTime();
+
+	// the controller is left running, transactions are started back to back
+	Status = XIic_Start(IicPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	return XST_SUCCESS;
+}
+
+/*****************************************************************/
+//	Queue a register read.  callback is called when the data is in the
+//	buffer; data must stay valid until then.
+//
+// Parameters
+// reg_addr   - Address of register on MPU-6050
+// length 	  -	Number of bytes to read (registers in subsequent addresses)
+// data       - buffer for the data read
+// callback   - completion callback, may be NULL
+// context    - passed to the callback
+//
+// Returns XST_SUCCESS, XST_INVALID_PARAM or XST_DEVICE_BUSY if the queue is full
+/****************************************************************************/
+int i2c_submit_read(unsigned char reg_addr, unsigned char length,
+      unsigned char *data, I2C_Callback callback, void *context)
+{
+	I2C_Xfer *p_xfer;
+	u32 msr;
+
+	if ((IicPtr == NULL) || (length == 0) || (data == NULL))
+		return XST_INVALID_PARAM;
+
+	msr = i2c_lock();
+	if (QueueCount >= I2C_QUEUE_DEPTH) {
+		Stats.rejected++;
+		i2c_unlock(msr);
+		return XST_DEVICE_BUSY;
+	}
+	p_xfer = &XferQueue[QueueTail];
+	p_xfer->dir = I2C_READ;
+	p_xfer->length = length;
+	p_xfer->rd_data = data;
+	p_xfer->wr_data[0] = reg_addr;
+	p_xfer->callback = callback;
+	p_xfer->context = context;
+	QueueTail = (QueueTail + 1) % I2C_QUEUE_DEPTH;
+	QueueCount++;
+	Stats.submitted++;
+	if (QueueCount > Stats.max_queued)
+		Stats.max_queued = QueueCount;
+
+	if (Phase == I2C_PHASE_IDLE)
+		i2c_start_next();
+	i2c_unlock(msr);
+	return XST_SUCCESS;
+}
+
+/*****************************************************************/
+//	Queue a register write.  The data is copied so the caller's buffer
+//	can be reused as soon as this function returns.
+//
+// Parameters
+// reg_addr   - Address of register on MPU-6050
+// length 	  -	Number of bytes to write (if more than one, automatically
+//              writes to registers in subsequent addresses)
+// data       - data to write
+// callback   - completion callback, may be NULL
+// context    - passed to the callback
+//
+// Returns XST_SUCCESS, XST_INVALID_PARAM or XST_DEVICE_BUSY if the queue is full
+/****************************************************************************/
+int i2c_submit_write(unsigned char reg_addr, unsigned char length,
+      unsigned char const *data, I2C_Callback callback, void *context)
+{
+	I2C_Xfer *p_xfer;
+	u32 msr;
+
+	if ((IicPtr == NULL) || (length > I2C_MAX_WRITE_LEN) || ((length != 0) && (data == NULL)))
+		return XST_INVALID_PARAM;
+
+	msr = i2c_lock();
+	if (QueueCount >= I2C_QUEUE_DEPTH) {
+		Stats.rejected++;
+		i2c_unlock(msr);
+		return XST_DEVICE_BUSY;
+	}
+	p_xfer = &XferQueue[QueueTail];
+	p_xfer->dir = I2C_WRITE;
+	p_xfer->length = length;
+	p_xfer->rd_data = NULL;
+	p_xfer->wr_data[0] = reg_addr;
+	for (int i=0;i<length;i++)
+		p_xfer->wr_data[i+1] = data[i];
+	p_xfer->callback = callback;
+	p_xfer->context = context;
+	QueueTail = (QueueTail + 1) % I2C_QUEUE_DEPTH;
+	QueueCount++;
+	Stats.submitted++;
+	if (QueueCount > Stats.max_queued)
+		Stats.max_queued = QueueCount;
+
+	if (Phase == I2C_PHASE_IDLE)
+		i2c_start_next();
+	i2c_unlock(msr);
+	return XST_SUCCESS;
+}
+
+/*****************************************************************/
+//	Restart the queue if a transaction was held off.  The queue restarts
+//	itself, this is only needed if the time base had no free callback
+//	when the write guard was armed.
+/****************************************************************************/
+void i2c_service(void)
+{
+	u32 msr;
+
+	if (IicPtr == NULL)
+		return;
+
+	msr = i2c_lock();
+	if ((Phase == I2C_PHASE_IDLE) && (QueueCount > 0))
+		i2c_start_next();
+	i2c_unlock(msr);
+}
+
+/*****************************************************************/
+//	Returns the number of transactions waiting or in flight
+/****************************************************************************/
+u32 i2c_queue_depth(void)
+{
+	return QueueCount;
+}
+
+/*****************************************************************/
+//	Returns the time base count and its rate, so that callers can
+//	timestamp data read over the bus
+/****************************************************************************/
+u32 i2c_get_time(void)
+{
+	return (GetTime != NULL) ? GetTime() : 0;
+}
+
+u32 i2c_get_ticks_per_us(void)
+{
+	return TicksPerUs;
+}
+
+/*****************************************************************/
+//	Copy the queue statistics.  Bus utilization is busy_us / window_us.
+//
+// Parameters
+// p_stats - destination for the statistics
+// reset   - start a new statistics window (max_queued and the counters
+//           are cleared)
+/****************************************************************************/
+void i2c_get_stats(p_I2C_Stats p_stats, bool reset)
+{
+	u32 msr;
+	u32 now;
+
+	msr = i2c_lock();
+	now = (GetTime != NULL) ? GetTime() : StatsStart;
+	Stats.queued = QueueCount;
+	if (Phase != I2C_PHASE_IDLE) {
+		// count the part of the transaction in flight that is in this window
+		Stats.busy_us += (now - XferStart) / TicksPerUs;
+		XferStart = now;
+	}
+	*p_stats = Stats;
+	p_stats->window_us = (now - StatsStart) / TicksPerUs;
+	if (reset) {
+		memset(&Stats, 0, sizeof(Stats));
+		Stats.max_queued = QueueCount;
+		StatsStart = now;
+	}
+	i2c_unlock(msr);
+}
+
+/*****************************************************************/
+//	Start the transaction at the head of the queue.  Called with
+//	interrupts disabled or from the IIC interrupt handlers.
+/****************************************************************************/
+static void i2c_start_next(void)
+{
+	I2C_Xfer *p_xfer;
+	int Status;
+	u32 now;
+	u32 elapsed_us;
+
+	if (QueueCount == 0)
+		return;
+
+	// the MPU-6050 needs time after a write before it is accessed again,
+	// the queue is restarted from the time base when the guard expires
+	now = GetTime();
+	if (WriteGuardActive) {
+		if ((now - LastWriteEnd) < (I2C_WRITE_GUARD_US * TicksPerUs)) {
+			if (GuardTimer < 0) {
+				elapsed_us = (now - LastWriteEnd) / TicksPerUs;
+				GuardTimer = TB_call_at(TB_now_us() + I2C_WRITE_GUARD_US - elapsed_us,
+						i2c_guard_expired, NULL);
+			}
+			return;
+		}
+		WriteGuardActive = false;
+	}
+
+	p_xfer = &XferQueue[QueueHead];
+	if (p_xfer->dir == I2C_READ) {
+		// send the register address with a repeated start, the data is read
+		// from SendHandler
+		IicPtr->Options = XII_REPEATED_START_OPTION;
+		Phase = I2C_PHASE_ADDR;
+		Status = XIic_MasterSend(IicPtr, p_xfer->wr_data, 1);
+	}
+	else {
+		IicPtr->Options = 0x0; // Single start op
+		Phase = I2C_PHASE_WRITE;
+		Status = XIic_MasterSend(IicPtr, p_xfer->wr_data, p_xfer->length+1);
+	}
+
+	if (Status == XST_IIC_BUS_BUSY) {
+		// the driver calls StatusHandler with XII_BUS_NOT_BUSY_EVENT when
+		// the bus is free, the transaction is restarted from there
+		Phase = I2C_PHASE_IDLE;
+	}
+	else if (Status != XST_SUCCESS) {
+		Phase = I2C_PHASE_IDLE;
+		i2c_complete(XST_FAILURE);
+	}
+	else {
+		XferStart = now;
+	}
+}
+
+/*****************************************************************/
+//	Retire the transaction at the head of the queue, call its callback
+//	and start the next one
+/****************************************************************************/
+static void i2c_complete(int status)
+{
+	I2C_Xfer *p_xfer;
+	u32 now;
+
+	p_xfer = &XferQueue[QueueHead];
+	now = GetTime();
+	if (Phase != I2C_PHASE_IDLE)
+		Stats.busy_us += (now - XferStart) / TicksPerUs;
+	if (p_xfer->dir == I2C_WRITE) {
+		LastWriteEnd = now;
+		WriteGuardActive = true;
+	}
+	if (status == XST_SUCCESS)
+		Stats.completed++;
+	else
+		Stats.errors++;
+
+	Phase = I2C_PHASE_IDLE;
+	QueueHead = (QueueHead + 1) % I2C_QUEUE_DEPTH;
+	QueueCount--;
+
+	if (p_xfer->callback != NULL)
+		p_xfer->callback(status, p_xfer->context);
+
+	if (Phase == I2C_PHASE_IDLE)
+		i2c_start_next();
+}
+
+/*****************************************************************/
+//	Time base callback at the end of the write guard, runs from the
+//	timer interrupt handler
+/****************************************************************************/
+static void i2c_guard_expired(void *context)
+{
+	GuardTimer = -1;
+	if ((Phase == I2C_PHASE_IDLE) && (QueueCount > 0))
+		i2c_start_next();
+}
+
+/*****************************************************************/
+//	Completion flag for the blocking transfers
+/****************************************************************************/
+static void i2c_blocking_done(int status, void *context)
+{
+	*(volatile int *)context = status;
+}
+
+static int i2c_wait(volatile int *p_done)
+{
+	while (*p_done == XST_DEVICE_BUSY) {
+		i2c_service();
+	}
+	return *p_done;
+}
+
+/*****************************************************************/
+//	 I2C functions to communicate with MPU-6050 motion sensor.
+//		WRITE
+//
+// Queues the write and waits for it to complete.  Interrupts must be
+// enabled; use i2c_submit_write() from an interrupt handler.
+//
+// Parameters
+// slave_addr - Can ignore this, as it already taken care of. Included for portability with DMP code
+// reg_addr   - Address of register on MPU-6050
+// length 	  -	Number of bytes to write (if more than one, automatically
+// writes to registers in subsequent addresses)
+// data - array or pointer to data buffer
+/****************************************************************************/
+int i2c_write(unsigned char slave_addr, unsigned char reg_addr,
+      unsigned char length, unsigned char const *data)
+{
+	int Status;
+	volatile int done = XST_DEVICE_BUSY;
+
+	Status = i2c_submit_write(reg_addr, length, data, i2c_blocking_done, (void *)&done);
+	while (Status == XST_DEVICE_BUSY) {
+		// queue full, wait for a slot
+		i2c_service();
+		Status = i2c_submit_write(reg_addr, length, data, i2c_blocking_done, (void *)&done);
+	}
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	return i2c_wait(&done);
+}
+
+/****************************************************************
+ * I2C functions to communicate with MPU-6050 motion sensor.
+ *  READ
+ *
+ * Queues the read and waits for it to complete.  Interrupts must be
+ * enabled; use i2c_submit_read() from an interrupt handler.
+ *
+// Parameters
+// slave_addr - Can ignore this, as it already taken care of. Included for portability with DMP code
+// reg_addr   - Address of register on MPU-6050
+// length 	  -	Number of bytes to read (if more than one, automatically
+// reads registers in subsequent addresses)
+// data - array or pointer to data buffer
+ *******************************************************************/
+
+int i2c_read(unsigned char slave_addr, unsigned char reg_addr,
+       unsigned char length, unsigned char *data)
+{
+	int Status;
+	volatile int done = XST_DEVICE_BUSY;
+
+	Status = i2c_submit_read(reg_addr, length, data, i2c_blocking_done, (void *)&done);
+	while (Status == XST_DEVICE_BUSY) {
+		// queue full, wait for a slot
+		i2c_service();
+		Status = i2c_submit_read(reg_addr, length, data, i2c_blocking_done, (void *)&done);
+	}
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	return i2c_wait(&done);
+}
+
+
+/*************** INTERRUPT HANDLERS ASSOCIATED WITH IIC *********************/
+
+/*****************************************************************************/
+/**
+* This Send handler is called asynchronously from an interrupt context and
+* indicates that data in the specified buffer has been sent.  For a read the
+* register address has been sent and the data is read next, a write is
+* complete.
+*
+* @param	InstancePtr is a pointer to the IIC driver instance for which
+* 		the handler is being called for.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void SendHandler(XIic *InstancePtr)
+{
+	I2C_Xfer *p_xfer;
+	int Status;
+
+	if (Phase == I2C_PHASE_WRITE) {
+		i2c_complete(XST_SUCCESS);
+	}
+	else if (Phase == I2C_PHASE_ADDR) {
+		p_xfer = &XferQueue[QueueHead];
+		InstancePtr->Options = 0x0; // Single byte read
+		Phase = I2C_PHASE_READ;
+		//read 2 at minimum, known I2C controller / Vivado BUG
+		if (p_xfer->length == 1)
+			Status = XIic_MasterRecv(InstancePtr, ReadTmp, 2);
+		else
+			Status = XIic_MasterRecv(InstancePtr, p_xfer->rd_data, p_xfer->length);
+		if (Status != XST_SUCCESS)
+			i2c_complete(XST_FAILURE);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This Receive handler is called asynchronously from an interrupt context and
+* indicates that data in the specified buffer has been Received.  The read
+* is complete.
+*
+* @param	InstancePtr is a pointer to the IIC driver instance for which
+* 		the handler is being called for.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void ReceiveHandler(XIic *InstancePtr)
+{
+	I2C_Xfer *p_xfer;
+
+	if (Phase == I2C_PHASE_READ) {
+		p_xfer = &XferQueue[QueueHead];
+		if (p_xfer->length == 1)
+			p_xfer->rd_data[0] = ReadTmp[0];
+		i2c_complete(XST_SUCCESS);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This Status handler is called asynchronously from an interrupt
+* context and indicates the events that have occurred.  A lost arbitration
+* or a missing acknowledge fails the transaction in flight, the queue
+* carries on with the next one.
+*
+* @param	InstancePtr is a pointer to the IIC driver instance for which
+*		the handler is being called for.
+* @param	Event indicates the condition that has occurred.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void StatusHandler(XIic *InstancePtr, int Event)
+{
+	if (Event & (XII_ARB_LOST_EVENT | XII_SLAVE_NO_ACK_EVENT)) {
+		if (Phase != I2C_PHASE_IDLE)
+			i2c_complete(XST_FAILURE);
+	}
+	else if (Event & XII_BUS_NOT_BUSY_EVENT) {
+		if (Phase == I2C_PHASE_IDLE)
+			i2c_start_next();
+	}
+}
@@ -0,0 +1,71 @@
+/*
+ * sensor.h
+ *
+ *  Created on: Mar 17, 2017
+ *      Author: Francisco
+ */
+
+#ifndef SRC_SENSOR_H_
+#define SRC_SENSOR_H_
+
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xiic.h"
+
+// I2C transaction queue sizes
+#define I2C_QUEUE_DEPTH			8		// number of transactions that can be queued
+#define I2C_MAX_WRITE_LEN		32		// maximum number of data bytes in one write transaction
+
+// minimum time between the end of a write and the start of the next transaction,
+// timed with a time base callback (timebase.h), so TB_initialize() must be called
+// before the queue is used
+#define I2C_WRITE_GUARD_US		2000
+
+typedef enum {I2C_READ, I2C_WRITE} I2C_Dir;
+
+// completion callback, called from the IIC or time base interrupt handler (or from i2c_service())
+// with the status of the transaction (XST_SUCCESS or XST_FAILURE) and the context
+// pointer that was passed to i2c_submit_read()/i2c_submit_write()
+typedef void (*I2C_Callback)(int status, void *context);
+
+// returns a free running 32-bit timer count, used for the write guard and
+// the bus utilization statistics
+typedef u32 (*I2C_TimeFunc)(void);
+
+typedef struct
+{
+	u32		queued;					// transactions waiting or in flight
+	u32		max_queued;				// high water mark of queued
+	u32		submitted;				// transactions accepted by the queue
+	u32		completed;				// transactions completed successfully
+	u32		errors;					// transactions completed with an error
+	u32		rejected;				// submissions refused because the queue was full
+	u32		busy_us;				// time the bus spent on transactions in this window
+	u32		window_us;				// length of the statistics window, keep it under a timer wrap
+} I2C_Stats, *p_I2C_Stats;
+
+// queue management
+int i2c_queue_init(XIic *p_iic, I2C_TimeFunc get_time, u32 ticks_per_us);
+int i2c_submit_read(unsigned char reg_addr, unsigned char length,
+      unsigned char *data, I2C_Callback callback, void *context);
+int i2c_submit_write(unsigned char reg_addr, unsigned char length,
+      unsigned char const *data, I2C_Callback callback, void *context);
+void i2c_service(void);
+u32 i2c_queue_depth(void);
+u32 i2c_get_time(void);
+u32 i2c_get_ticks_per_us(void);
+void i2c_get_stats(p_I2C_Stats p_stats, bool reset);
+
+// blocking transfers, used by the DMP code
+int i2c_write(unsigned char slave_addr, unsigned char reg_addr,
+      unsigned char length, unsigned char const *data);
+int i2c_read(unsigned char slave_addr, unsigned char reg_addr,
+      unsigned char length, unsigned char *data);
+
+// IIC driver handlers
+void SendHandler(XIic *InstancePtr);
+void ReceiveHandler(XIic *InstancePtr);
+void StatusHandler(XIic *InstancePtr, int Event);
+
+#endif /* SRC_SENSOR_H_ */
@@ -237,12 +237,12 @@ proc create_root_design { parentCell } {
 
   # Create interface ports
   set Pmod_out [ create_bd_intf_port -mode Master -vlnv digilentinc.com:interface:pmod_rtl:1.0 Pmod_out ]
-  set gpio_rtl [ create_bd_intf_port -mode Master -vlnv xilinx.com:interface:gpio_rtl:1.0 gpio_rtl ]
-  set gpio_rtl_0 [ create_bd_intf_port -mode Master -vlnv xilinx.com:interface:gpio_rtl:1.0 gpio_rtl_0 ]
-  set gpio_rtl_1 [ create_bd_intf_port -mode Master -vlnv xilinx.com:interface:gpio_rtl:1.0 gpio_rtl_1 ]
-  set gpio_rtl_2 [ create_bd_intf_port -mode Master -vlnv xilinx.com:interface:gpio_rtl:1.0 gpio_rtl_2 ]
 
   # Create ports
+  set ACL_CSN [ create_bd_port -dir O ACL_CSN ]
+  set ACL_MISO [ create_bd_port -dir I ACL_MISO ]
+  set ACL_MOSI [ create_bd_port -dir O ACL_MOSI ]
+  set ACL_SCLK [ create_bd_port -dir O ACL_SCLK ]
   set RGB1_Blue [ create_bd_port -dir O RGB1_Blue ]
   set RGB1_Green [ create_bd_port -dir O RGB1_Green ]
   set RGB1_Red [ create_bd_port -dir O RGB1_Red ]
@@ -280,6 +280,13 @@ proc create_root_design { parentCell } {
   set uart_rtl_rxd [ create_bd_port -dir I uart_rtl_rxd ]
   set uart_rtl_txd [ create_bd_port -dir O uart_rtl_txd ]
 
+  # Create instance: ADXL362_AXI_0, and set properties
+  set ADXL362_AXI_0 [ create_bd_cell -type ip -vlnv ece.pdx.edu:ece544:ADXL362_AXI:1.0 ADXL362_AXI_0 ]
+  set_property -dict [ list \
+CONFIG.FIFO_DEPTH {64} \
+CONFIG.ODR_SEL {4} \
+ ] $ADXL362_AXI_0
+
   # Create instance: PWM_0, and set properties
   set PWM_0 [ create_bd_cell -type ip -vlnv digilentinc.com:IP:PWM:2.0 PWM_0 ]
   set_property -dict [ list \
@@ -292,31 +299,12 @@ CONFIG.NUM_PWM {4} \
   # Create instance: PmodENC_0, and set properties
   set PmodENC_0 [ create_bd_cell -type ip -vlnv ece.pdx.edu:ece544:PmodENC:1.0 PmodENC_0 ]
 
-  # Create instance: axi_gpio_0, and set properties
-  set axi_gpio_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_gpio:2.0 axi_gpio_0 ]
-  set_property -dict [ list \
-CONFIG.C_ALL_INPUTS {1} \
-CONFIG.C_ALL_INPUTS_2 {1} \
-CONFIG.C_GPIO2_WIDTH {12} \
-CONFIG.C_GPIO_WIDTH {12} \
-CONFIG.C_INTERRUPT_PRESENT {0} \
-CONFIG.C_IS_DUAL {1} \
- ] $axi_gpio_0
-
-  # Create instance: axi_gpio_1, and set properties
-  set axi_gpio_1 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_gpio:2.0 axi_gpio_1 ]
-  set_property -dict [ list \
-CONFIG.C_ALL_INPUTS {1} \
-CONFIG.C_ALL_INPUTS_2 {1} \
-CONFIG.C_GPIO2_WIDTH {12} \
-CONFIG.C_GPIO_WIDTH {12} \
-CONFIG.C_INTERRUPT_PRESENT {0} \
-CONFIG.C_IS_DUAL {1} \
- ] $axi_gpio_1
-
   # Create instance: axi_iic_0, and set properties
   set axi_iic_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_iic:2.0 axi_iic_0 ]
 
+  # Create instance: axi_timer_0, and set properties
+  set axi_timer_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_timer:2.0 axi_timer_0 ]
+
   # Create instance: axi_uartlite_0, and set properties
   set axi_uartlite_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_uartlite:2.0 axi_uartlite_0 ]
   set_property -dict [ list \
@@ -404,7 +392,7 @@ CONFIG.NUM_MI {12} \
   # Create instance: microblaze_0_xlconcat, and set properties
   set microblaze_0_xlconcat [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconcat:2.1 microblaze_0_xlconcat ]
   set_property -dict [ list \
-CONFIG.NUM_PORTS {5} \
+CONFIG.NUM_PORTS {7} \
  ] $microblaze_0_xlconcat
 
   # Create instance: nexys4IO_0, and set properties
@@ -424,18 +412,14 @@ CONFIG.DOUT_WIDTH {1} \
 
   # Create interface connections
   connect_bd_intf_net -intf_net PmodBT2_0_Pmod_out [get_bd_intf_ports Pmod_out] [get_bd_intf_pins PmodBT2_0/Pmod_out]
-  connect_bd_intf_net -intf_net axi_gpio_0_GPIO [get_bd_intf_ports gpio_rtl] [get_bd_intf_pins axi_gpio_0/GPIO]
-  connect_bd_intf_net -intf_net axi_gpio_0_GPIO2 [get_bd_intf_ports gpio_rtl_0] [get_bd_intf_pins axi_gpio_0/GPIO2]
-  connect_bd_intf_net -intf_net axi_gpio_1_GPIO [get_bd_intf_ports gpio_rtl_1] [get_bd_intf_pins axi_gpio_1/GPIO]
-  connect_bd_intf_net -intf_net axi_gpio_1_GPIO2 [get_bd_intf_ports gpio_rtl_2] [get_bd_intf_pins axi_gpio_1/GPIO2]
   connect_bd_intf_net -intf_net microblaze_0_axi_dp [get_bd_intf_pins microblaze_0/M_AXI_DP] [get_bd_intf_pins microblaze_0_axi_periph/S00_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M01_AXI [get_bd_intf_pins microblaze_0_axi_periph/M01_AXI] [get_bd_intf_pins nexys4IO_0/S00_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M02_AXI [get_bd_intf_pins PmodENC_0/S00_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M02_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M03_AXI [get_bd_intf_pins PWM_0/PWM_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M03_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M04_AXI [get_bd_intf_pins axi_iic_0/S_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M04_AXI]
-  connect_bd_intf_net -intf_net microblaze_0_axi_periph_M05_AXI [get_bd_intf_pins axi_gpio_0/S_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M05_AXI]
+  connect_bd_intf_net -intf_net microblaze_0_axi_periph_M05_AXI [get_bd_intf_pins axi_timer_0/S_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M05_AXI]
+  connect_bd_intf_net -intf_net microblaze_0_axi_periph_M06_AXI [get_bd_intf_pins ADXL362_AXI_0/S00_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M06_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M07_AXI [get_bd_intf_pins axi_uartlite_0/S_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M07_AXI]
-  connect_bd_intf_net -intf_net microblaze_0_axi_periph_M08_AXI [get_bd_intf_pins axi_gpio_1/S_AXI] [get_bd_intf_pins microblaze_0_axi_periph/M08_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M09_AXI [get_bd_intf_pins PmodBT2_0/AXI_LITE_UART] [get_bd_intf_pins microblaze_0_axi_periph/M09_AXI]
   connect_bd_intf_net -intf_net microblaze_0_axi_periph_M10_AXI [get_bd_intf_pins PmodBT2_0/AXI_LITE_GPIO] [get_bd_intf_pins microblaze_0_axi_periph/M10_AXI]
   connect_bd_intf_net -intf_net microblaze_0_debug [get_bd_intf_pins mdm_1/MBDEBUG_0] [get_bd_intf_pins microblaze_0/DEBUG]
@@ -445,9 +429,15 @@ CONFIG.DOUT_WIDTH {1} \
   connect_bd_intf_net -intf_net microblaze_0_interrupt [get_bd_intf_pins microblaze_0/INTERRUPT] [get_bd_intf_pins microblaze_0_axi_intc/interrupt]
 
   # Create port connections
+  connect_bd_net -net ACL_MISO_1 [get_bd_ports ACL_MISO] [get_bd_pins ADXL362_AXI_0/ACL_MISO]
+  connect_bd_net -net ADXL362_AXI_0_ACL_CSN [get_bd_ports ACL_CSN] [get_bd_pins ADXL362_AXI_0/ACL_CSN]
+  connect_bd_net -net ADXL362_AXI_0_ACL_MOSI [get_bd_ports ACL_MOSI] [get_bd_pins ADXL362_AXI_0/ACL_MOSI]
+  connect_bd_net -net ADXL362_AXI_0_ACL_SCLK [get_bd_ports ACL_SCLK] [get_bd_pins ADXL362_AXI_0/ACL_SCLK]
+  connect_bd_net -net ADXL362_AXI_0_accel_irq [get_bd_pins ADXL362_AXI_0/accel_irq] [get_bd_pins microblaze_0_xlconcat/In5]
   connect_bd_net -net PWM_0_pwm [get_bd_ports pwm_2] [get_bd_pins PWM_0/pwm]
   connect_bd_net -net PmodBT2_0_BT2_uart_interrupt [get_bd_pins PmodBT2_0/BT2_uart_interrupt] [get_bd_pins microblaze_0_xlconcat/In3]
   connect_bd_net -net axi_iic_0_iic2intc_irpt [get_bd_pins axi_iic_0/iic2intc_irpt] [get_bd_pins microblaze_0_xlconcat/In4]
+  connect_bd_net -net axi_timer_0_interrupt [get_bd_pins axi_timer_0/interrupt] [get_bd_pins microblaze_0_xlconcat/In6]
   connect_bd_net -net axi_iic_0_scl_o [get_bd_ports scl_o] [get_bd_pins axi_iic_0/scl_o]
   connect_bd_net -net axi_iic_0_scl_t [get_bd_ports scl_t] [get_bd_pins axi_iic_0/scl_t]
   connect_bd_net -net axi_iic_0_sda_o [get_bd_ports sda_o] [get_bd_pins axi_iic_0/sda_o]
@@ -466,7 +456,7 @@ CONFIG.DOUT_WIDTH {1} \
   connect_bd_net -net fit_timer_1_Interrupt [get_bd_pins fit_timer_1/Interrupt] [get_bd_pins microblaze_0_xlconcat/In0]
   connect_bd_net -net fit_timer_2_Interrupt [get_bd_pins fit_timer_2/Interrupt] [get_bd_pins microblaze_0_xlconcat/In2]
   connect_bd_net -net mdm_1_debug_sys_rst [get_bd_pins mdm_1/Debug_SYS_Rst] [get_bd_pins rst_clk_wiz_1_100M/mb_debug_sys_rst]
-  connect_bd_net -net microblaze_0_Clk [get_bd_ports clockOut] [get_bd_pins PWM_0/pwm_axi_aclk] [get_bd_pins PmodBT2_0/s_axi_aclk] [get_bd_pins PmodENC_0/s00_axi_aclk] [get_bd_pins axi_gpio_0/s_axi_aclk] [get_bd_pins axi_gpio_1/s_axi_aclk] [get_bd_pins axi_iic_0/s_axi_aclk] [get_bd_pins axi_uartlite_0/s_axi_aclk] [get_bd_pins clk_wiz_1/clk_out1] [get_bd_pins fit_timer_1/Clk] [get_bd_pins fit_timer_2/Clk] [get_bd_pins microblaze_0/Clk] [get_bd_pins microblaze_0_axi_intc/processor_clk] [get_bd_pins microblaze_0_axi_intc/s_axi_aclk] [get_bd_pins microblaze_0_axi_periph/ACLK] [get_bd_pins microblaze_0_axi_periph/M00_ACLK] [get_bd_pins microblaze_0_axi_periph/M01_ACLK] [get_bd_pins microblaze_0_axi_periph/M02_ACLK] [get_bd_pins microblaze_0_axi_periph/M03_ACLK] [get_bd_pins microblaze_0_axi_periph/M04_ACLK] [get_bd_pins microblaze_0_axi_periph/M05_ACLK] [get_bd_pins microblaze_0_axi_periph/M06_ACLK] [get_bd_pins microblaze_0_axi_periph/M07_ACLK] [get_bd_pins microblaze_0_axi_periph/M08_ACLK] [get_bd_pins microblaze_0_axi_periph/M09_ACLK] [get_bd_pins microblaze_0_axi_periph/M10_ACLK] [get_bd_pins microblaze_0_axi_periph/M11_ACLK] [get_bd_pins microblaze_0_axi_periph/S00_ACLK] [get_bd_pins microblaze_0_local_memory/LMB_Clk] [get_bd_pins nexys4IO_0/Clock] [get_bd_pins nexys4IO_0/s00_axi_aclk] [get_bd_pins rst_clk_wiz_1_100M/slowest_sync_clk]
+  connect_bd_net -net microblaze_0_Clk [get_bd_ports clockOut] [get_bd_pins ADXL362_AXI_0/s00_axi_aclk] [get_bd_pins PWM_0/pwm_axi_aclk] [get_bd_pins PmodBT2_0/s_axi_aclk] [get_bd_pins PmodENC_0/s00_axi_aclk] [get_bd_pins axi_iic_0/s_axi_aclk] [get_bd_pins axi_timer_0/s_axi_aclk] [get_bd_pins axi_uartlite_0/s_axi_aclk] [get_bd_pins clk_wiz_1/clk_out1] [get_bd_pins fit_timer_1/Clk] [get_bd_pins fit_timer_2/Clk] [get_bd_pins microblaze_0/Clk] [get_bd_pins microblaze_0_axi_intc/processor_clk] [get_bd_pins microblaze_0_axi_intc/s_axi_aclk] [get_bd_pins microblaze_0_axi_periph/ACLK] [get_bd_pins microblaze_0_axi_periph/M00_ACLK] [get_bd_pins microblaze_0_axi_periph/M01_ACLK] [get_bd_pins microblaze_0_axi_periph/M02_ACLK] [get_bd_pins microblaze_0_axi_periph/M03_ACLK] [get_bd_pins microblaze_0_axi_periph/M04_ACLK] [get_bd_pins microblaze_0_axi_periph/M05_ACLK] [get_bd_pins microblaze_0_axi_periph/M06_ACLK] [get_bd_pins microblaze_0_axi_periph/M07_ACLK] [get_bd_pins microblaze_0_axi_periph/M08_ACLK] [get_bd_pins microblaze_0_axi_periph/M09_ACLK] [get_bd_pins microblaze_0_axi_periph/M10_ACLK] [get_bd_pins microblaze_0_axi_periph/M11_ACLK] [get_bd_pins microblaze_0_axi_periph/S00_ACLK] [get_bd_pins microblaze_0_local_memory/LMB_Clk] [get_bd_pins nexys4IO_0/Clock] [get_bd_pins nexys4IO_0/s00_axi_aclk] [get_bd_pins rst_clk_wiz_1_100M/slowest_sync_clk]
   connect_bd_net -net microblaze_0_intr [get_bd_pins microblaze_0_axi_intc/intr] [get_bd_pins microblaze_0_xlconcat/dout]
   connect_bd_net -net nexys4IO_0_RGB1_Blue [get_bd_ports RGB1_Blue] [get_bd_pins nexys4IO_0/RGB1_Blue]
   connect_bd_net -net nexys4IO_0_RGB1_Green [get_bd_ports RGB1_Green] [get_bd_pins nexys4IO_0/RGB1_Green]
@@ -486,7 +476,7 @@ CONFIG.DOUT_WIDTH {1} \
   connect_bd_net -net rst_clk_wiz_1_100M_bus_struct_reset [get_bd_pins microblaze_0_local_memory/SYS_Rst] [get_bd_pins rst_clk_wiz_1_100M/bus_struct_reset]
   connect_bd_net -net rst_clk_wiz_1_100M_interconnect_aresetn [get_bd_pins microblaze_0_axi_periph/ARESETN] [get_bd_pins rst_clk_wiz_1_100M/interconnect_aresetn]
   connect_bd_net -net rst_clk_wiz_1_100M_mb_reset [get_bd_pins microblaze_0/Reset] [get_bd_pins microblaze_0_axi_intc/processor_rst] [get_bd_pins rst_clk_wiz_1_100M/mb_reset]
-  connect_bd_net -net rst_clk_wiz_1_100M_peripheral_aresetn [get_bd_pins PWM_0/pwm_axi_aresetn] [get_bd_pins PmodBT2_0/s_axi_aresetn] [get_bd_pins PmodENC_0/s00_axi_aresetn] [get_bd_pins axi_gpio_0/s_axi_aresetn] [get_bd_pins axi_gpio_1/s_axi_aresetn] [get_bd_pins axi_iic_0/s_axi_aresetn] [get_bd_pins axi_uartlite_0/s_axi_aresetn] [get_bd_pins microblaze_0_axi_intc/s_axi_aresetn] [get_bd_pins microblaze_0_axi_periph/M00_ARESETN] [get_bd_pins microblaze_0_axi_periph/M01_ARESETN] [get_bd_pins microblaze_0_axi_periph/M02_ARESETN] [get_bd_pins microblaze_0_axi_periph/M03_ARESETN] [get_bd_pins microblaze_0_axi_periph/M04_ARESETN] [get_bd_pins microblaze_0_axi_periph/M05_ARESETN] [get_bd_pins microblaze_0_axi_periph/M06_ARESETN] [get_bd_pins microblaze_0_axi_periph/M07_ARESETN] [get_bd_pins microblaze_0_axi_periph/M08_ARESETN] [get_bd_pins microblaze_0_axi_periph/M09_ARESETN] [get_bd_pins microblaze_0_axi_periph/M10_ARESETN] [get_bd_pins microblaze_0_axi_periph/M11_ARESETN] [get_bd_pins microblaze_0_axi_periph/S00_ARESETN] [get_bd_pins nexys4IO_0/s00_axi_aresetn] [get_bd_pins rst_clk_wiz_1_100M/peripheral_aresetn]
+  connect_bd_net -net rst_clk_wiz_1_100M_peripheral_aresetn [get_bd_pins ADXL362_AXI_0/s00_axi_aresetn] [get_bd_pins PWM_0/pwm_axi_aresetn] [get_bd_pins PmodBT2_0/s_axi_aresetn] [get_bd_pins PmodENC_0/s00_axi_aresetn] [get_bd_pins axi_iic_0/s_axi_aresetn] [get_bd_pins axi_timer_0/s_axi_aresetn] [get_bd_pins axi_uartlite_0/s_axi_aresetn] [get_bd_pins microblaze_0_axi_intc/s_axi_aresetn] [get_bd_pins microblaze_0_axi_periph/M00_ARESETN] [get_bd_pins microblaze_0_axi_periph/M01_ARESETN] [get_bd_pins microblaze_0_axi_periph/M02_ARESETN] [get_bd_pins microblaze_0_axi_periph/M03_ARESETN] [get_bd_pins microblaze_0_axi_periph/M04_ARESETN] [get_bd_pins microblaze_0_axi_periph/M05_ARESETN] [get_bd_pins microblaze_0_axi_periph/M06_ARESETN] [get_bd_pins microblaze_0_axi_periph/M07_ARESETN] [get_bd_pins microblaze_0_axi_periph/M08_ARESETN] [get_bd_pins microblaze_0_axi_periph/M09_ARESETN] [get_bd_pins microblaze_0_axi_periph/M10_ARESETN] [get_bd_pins microblaze_0_axi_periph/M11_ARESETN] [get_bd_pins microblaze_0_axi_periph/S00_ARESETN] [get_bd_pins nexys4IO_0/s00_axi_aresetn] [get_bd_pins rst_clk_wiz_1_100M/peripheral_aresetn]
   connect_bd_net -net rst_clk_wiz_1_100M_peripheral_reset [get_bd_pins fit_timer_1/Rst] [get_bd_pins fit_timer_2/Rst] [get_bd_pins rst_clk_wiz_1_100M/peripheral_reset]
   connect_bd_net -net scl_i_1 [get_bd_ports scl_i] [get_bd_pins axi_iic_0/scl_i]
   connect_bd_net -net sda_i_1 [get_bd_ports sda_i] [get_bd_pins axi_iic_0/sda_i]
@@ -494,13 +484,13 @@ CONFIG.DOUT_WIDTH {1} \
   connect_bd_net -net uart_rtl_rxd_1 [get_bd_ports uart_rtl_rxd] [get_bd_pins axi_uartlite_0/rx]
 
   # Create address segments
+  create_bd_addr_seg -range 0x00010000 -offset 0x44A30000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs ADXL362_AXI_0/S00_AXI/S00_AXI_reg] SEG_ADXL362_AXI_0_S00_AXI_reg
   create_bd_addr_seg -range 0x00010000 -offset 0x44A20000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs PWM_0/PWM_AXI/PWM_AXI_reg] SEG_PWM_0_PWM_AXI_reg
   create_bd_addr_seg -range 0x00002000 -offset 0x00020000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs PmodBT2_0/AXI_LITE_UART/Reg0] SEG_PmodBT2_0_Reg0
   create_bd_addr_seg -range 0x00001000 -offset 0x00030000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs PmodBT2_0/AXI_LITE_GPIO/Reg0] SEG_PmodBT2_0_Reg01
   create_bd_addr_seg -range 0x00010000 -offset 0x44A10000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs PmodENC_0/S00_AXI/S00_AXI_reg] SEG_PmodENC_0_S00_AXI_reg
-  create_bd_addr_seg -range 0x00010000 -offset 0x40000000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_gpio_0/S_AXI/Reg] SEG_axi_gpio_0_Reg
-  create_bd_addr_seg -range 0x00010000 -offset 0x40010000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_gpio_1/S_AXI/Reg] SEG_axi_gpio_1_Reg
   create_bd_addr_seg -range 0x00010000 -offset 0x40800000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_iic_0/S_AXI/Reg] SEG_axi_iic_0_Reg
+  create_bd_addr_seg -range 0x00010000 -offset 0x41C00000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_timer_0/S_AXI/Reg] SEG_axi_timer_0_Reg
   create_bd_addr_seg -range 0x00010000 -offset 0x40600000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_uartlite_0/S_AXI/Reg] SEG_axi_uartlite_0_Reg
   create_bd_addr_seg -range 0x00020000 -offset 0x00000000 [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs microblaze_0_local_memory/dlmb_bram_if_cntlr/SLMB/Mem] SEG_dlmb_bram_if_cntlr_Mem
   create_bd_addr_seg -range 0x00020000 -offset 0x00000000 [get_bd_addr_spaces microblaze_0/Instruction] [get_bd_addr_segs microblaze_0_local_memory/ilmb_bram_if_cntlr/SLMB/Mem] SEG_ilmb_bram_if_cntlr_Mem
@@ -518,7 +508,6 @@ preplace port btnL -pg 1 -y 130 -defaultsOSRD
 preplace port pmodENC_sw -pg 1 -y 1030 -defaultsOSRD
 preplace port pmodENC_A -pg 1 -y 970 -defaultsOSRD
 preplace port pmodENC_B -pg 1 -y 990 -defaultsOSRD
-preplace port gpio_rtl -pg 1 -y 670 -defaultsOSRD
 preplace port scl_o -pg 1 -y 1460 -defaultsOSRD
 preplace port RGB1_Blue -pg 1 -y 100 -defaultsOSRD
 preplace port clock_50MHz -pg 1 -y 1350 -defaultsOSRD
@@ -537,14 +526,11 @@ preplace port en -pg 1 -y 390 -defaultsOSRD
 preplace port RGB1_Red -pg 1 -y 60 -defaultsOSRD
 preplace port uart_rtl_rxd -pg 1 -y 1260 -defaultsOSRD -right
 preplace port sysreset_n -pg 1 -y 1290 -defaultsOSRD
-preplace port gpio_rtl_0 -pg 1 -y 690 -defaultsOSRD
 preplace port RGB2_Green -pg 1 -y 140 -defaultsOSRD
 preplace port btnU -pg 1 -y 820 -defaultsOSRD
 preplace port RGB2_Red -pg 1 -y 120 -defaultsOSRD
-preplace port gpio_rtl_1 -pg 1 -y 790 -defaultsOSRD
 preplace port sda_t -pg 1 -y 1540 -defaultsOSRD
 preplace port scl_i -pg 1 -y 1430 -defaultsOSRD
-preplace port gpio_rtl_2 -pg 1 -y 810 -defaultsOSRD
 preplace port RGB1_Green -pg 1 -y 80 -defaultsOSRD
 preplace port clockOut -pg 1 -y 1190 -defaultsOSRD
 preplace portBus sw -pg 1 -y 950 -defaultsOSRD
@@ -556,10 +542,8 @@ preplace inst axi_iic_0 -pg 1 -lvl 7 -y 1500 -defaultsOSRD
 preplace inst xlslice_0 -pg 1 -lvl 2 -y 1080 -defaultsOSRD
 preplace inst PmodBT2_0 -pg 1 -lvl 7 -y 530 -defaultsOSRD
 preplace inst microblaze_0_axi_periph -pg 1 -lvl 6 -y 480 -defaultsOSRD
-preplace inst axi_gpio_0 -pg 1 -lvl 7 -y 680 -defaultsOSRD
 preplace inst fit_timer_1 -pg 1 -lvl 2 -y 1190 -defaultsOSRD
 preplace inst microblaze_0_xlconcat -pg 1 -lvl 3 -y 1220 -defaultsOSRD
-preplace inst axi_gpio_1 -pg 1 -lvl 7 -y 800 -defaultsOSRD
 preplace inst fit_timer_2 -pg 1 -lvl 2 -y 1290 -defaultsOSRD
 preplace inst PWM_0 -pg 1 -lvl 7 -y 1120 -defaultsOSRD
 preplace inst mdm_1 -pg 1 -lvl 4 -y 1340 -defaultsOSRD
@@ -571,6 +555,7 @@ preplace inst rst_clk_wiz_1_100M -pg 1 -lvl 1 -y 1310 -defaultsOSRD
 preplace inst clk_wiz_1 -pg 1 -lvl 6 -y 1350 -defaultsOSRD
 preplace inst microblaze_0_local_memory -pg 1 -lvl 6 -y 1210 -defaultsOSRD
 preplace inst PmodENC_0 -pg 1 -lvl 7 -y 960 -defaultsOSRD
+preplace inst ADXL362_AXI_0 -pg 1 -lvl 7 -y 1100 -defaultsOSRD
 preplace netloc microblaze_0_axi_periph_M02_AXI 1 6 1 2010
 preplace netloc pmodENC_B_1 1 0 7 NJ 940 NJ 940 NJ 940 NJ 940 NJ 940 NJ 940 NJ
 preplace netloc nexys4IO_0_RGB2_Blue 1 7 2 NJ 160 NJ
@@ -583,17 +568,14 @@ preplace netloc microblaze_0_dlmb_1 1 5 1 N
 preplace netloc microblaze_0_intc_axi 1 3 4 880 120 NJ 120 NJ 120 1930
 preplace netloc scl_i_1 1 0 8 NJ 1440 NJ 1440 NJ 1440 NJ 1440 NJ 1440 NJ 1440 NJ 1630 2390
 preplace netloc rst_clk_wiz_1_100M_mb_reset 1 1 4 NJ 1350 NJ 1310 870 1270 NJ
-preplace netloc axi_gpio_0_GPIO 1 7 2 NJ 670 NJ
 preplace netloc nexys4IO_0_RGB2_Red 1 7 2 NJ 120 NJ
 preplace netloc rst_clk_wiz_1_100M_bus_struct_reset 1 1 5 NJ 1360 NJ 1360 NJ 1280 NJ 1280 1600
-preplace netloc axi_gpio_0_GPIO2 1 7 2 NJ 690 NJ
 preplace netloc nexys4IO_0_RGB1_Green 1 7 2 NJ 80 NJ
 preplace netloc PmodBT2_0_Pmod_out 1 7 2 NJ 520 NJ
 preplace netloc pmodENC_btn_1 1 0 7 NJ 960 NJ 960 NJ 960 NJ 960 NJ 960 NJ 960 NJ
 preplace netloc fit_timer_1_Interrupt 1 2 1 660
 preplace netloc microblaze_0_ilmb_1 1 5 1 N
 preplace netloc btnL_1 1 0 7 NJ 90 NJ 90 NJ 90 NJ 90 NJ 90 NJ 90 NJ
-preplace netloc microblaze_0_axi_periph_M08_AXI 1 6 1 1950
 preplace netloc microblaze_0_interrupt 1 4 1 N
 preplace netloc mdm_1_debug_sys_rst 1 0 5 50 1420 NJ 1420 NJ 1420 NJ 1420 1120
 preplace netloc axi_iic_0_iic2intc_irpt 1 2 6 680 1400 NJ 1400 NJ 1400 NJ 1420 NJ 1370 2450
@@ -603,7 +585,6 @@ preplace netloc nexys4IO_0_seg 1 7 2 NJ 180 NJ
 preplace netloc sw_1 1 0 7 NJ 60 NJ 60 NJ 60 NJ 60 NJ 60 NJ 60 NJ
 preplace netloc ext_reset_in_1 1 0 1 NJ
 preplace netloc btnC_1 1 0 7 NJ 30 NJ 30 NJ 30 NJ 30 NJ 30 NJ 30 NJ
-preplace netloc axi_gpio_1_GPIO2 1 7 2 NJ 810 NJ
 preplace netloc nexys4IO_0_db_btns 1 1 7 470 50 NJ 50 NJ 50 NJ 50 NJ 50 NJ 50 2370
 preplace netloc nexys4IO_0_led 1 7 2 NJ 40 NJ
 preplace netloc nexys4IO_0_RGB1_Blue 1 7 2 NJ 100 NJ
@@ -626,7 +607,6 @@ preplace netloc btnD_1 1 0 7 NJ 80 NJ 80 NJ 80 NJ 80 NJ 80 NJ 80 NJ
 preplace netloc microblaze_0_axi_periph_M04_AXI 1 6 1 1940
 preplace netloc axi_iic_0_scl_o 1 7 2 NJ 1460 NJ
 preplace netloc pmodENC_sw_1 1 0 7 NJ 980 NJ 980 NJ 980 NJ 980 NJ 980 NJ 980 NJ
-preplace netloc axi_gpio_1_GPIO 1 7 2 NJ 790 NJ
 preplace netloc nexys4IO_0_an 1 7 2 NJ 220 NJ
 preplace netloc nexys4IO_0_dp 1 7 2 NJ 200 NJ
 preplace netloc microblaze_0_axi_periph_M07_AXI 1 6 1 1930
@@ -635,7 +615,6 @@ preplace netloc axi_iic_0_sda_o 1 7 2 NJ 1520 NJ
 preplace netloc microblaze_0_intr 1 3 1 860
 preplace netloc uart_rtl_rxd_1 1 7 2 NJ 1260 NJ
 preplace netloc axi_iic_0_scl_t 1 7 2 NJ 1480 NJ
-preplace netloc microblaze_0_axi_periph_M05_AXI 1 6 1 1990
 preplace netloc rst_clk_wiz_1_100M_peripheral_aresetn 1 1 6 NJ 1030 NJ 1030 860 760 NJ 760 1600 110 1970
 preplace netloc fit_timer_2_Interrupt 1 2 1 660
 levelinfo -pg 1 -10 260 570 770 1010 1370 1770 2230 2600 2720 -top -80 -bot 1650
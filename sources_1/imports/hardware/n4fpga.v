@@ -171,10 +171,11 @@ embsys EMBSYS
         .Pmod_out_pin9_i(pmod_out_pin9_i),
         .Pmod_out_pin9_o(pmod_out_pin9_o),
         .Pmod_out_pin9_t(pmod_out_pin9_t),
-        //GPIO 
-        .gpio_rtl_0_tri_i(xout),
-        .gpio_rtl_tri_i(zout),
-        .gpio_rtl_1_tri_i(yout),
+        // ADXL362 accelerometer (SPI)
+        .ACL_MISO(ACL_MISO),
+        .ACL_MOSI(ACL_MOSI),
+        .ACL_SCLK(ACL_SCLK),
+        .ACL_CSN(ACL_CSN),
         
 
         //PWM Out Signal 
@@ -291,19 +292,5 @@ IOBUF i2c_scl_iobuf(
 .O(scl_i),
 .T(scl_t)
 );
-wire [11:0] xout,yout,zout; 
-wire [11:0] magout,tempout; 
-
-ADXL362Ctrl( 
-            .SYSCLK(clockOut),      
-            .RESET(sysreset),      
-            .SCLK(ACL_SCLK),       
-            .MOSI(ACL_MOSI),       
-            .MISO(ACL_MISO),       
-            .SS(ACL_CSN),         
-            .ACCEL_X(xout),    
-            .ACCEL_Y(yout),    
-            .ACCEL_Z(zout)
-);    
 endmodule
 
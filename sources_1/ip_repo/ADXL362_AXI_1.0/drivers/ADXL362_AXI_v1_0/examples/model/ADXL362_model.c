@@ -0,0 +1,309 @@
+/************************************************************************/
+/*																		*/
+/*	ADXL362_model.c	--	Host model of the ADXL362_AXI peripheral		*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	This module models the ADXL362_AXI peripheral on the host, at the	*/
+/*	level of register accesses and of the sets of data the controller	*/
+/*	reads from the ADXL362.  It provides Xil_In32() and Xil_Out32()		*/
+/*	and follows ADXL362_AXI_v1_0_S00_AXI.v and ADXL362Ctrl.vhd:			*/
+/*																		*/
+/*	- the Control Register resets to ODR_SEL and log2(NUM_READS_AVG).	*/
+/*	  A write with Apply set latches the requested output data rate		*/
+/*	  and averaging, limited to 400Hz and NUM_READS_AVG.  They are used	*/
+/*	  when the controller restarts, at the start of the next set of		*/
+/*	  reads, so a set is always divided by the number of reads it was	*/
+/*	  summed from.  FIFO Clear empties the FIFO for as long as it is	*/
+/*	  set.																*/
+/*	- every read, ADXL362Model_Read(), is pushed into the raw sample	*/
+/*	  FIFO with the 1MHz timestamp, or dropped and the overflow flag	*/
+/*	  set when the FIFO is full.  Reading the FIFO Timestamp register	*/
+/*	  removes the oldest sample.										*/
+/*	- the reads are summed, and after 2**avg_log2 of them the average,	*/
+/*	  the sum shifted right, becomes the live sample: the sequence		*/
+/*	  number is incremented and the data ready interrupt is set.		*/
+/*	  Reading the Snapshot Sequence register latches the live sample	*/
+/*	  into the snapshot registers and clears the interrupt.				*/
+/*																		*/
+/*	Each register access advances the time by ADXL362_MODEL_BUS_CLKS	*/
+/*	AXI clocks, so the timestamp counter runs while the driver polls	*/
+/*	it.  The time the ADXL362 takes to reset and produce data is not	*/
+/*	modelled, ADXL362Model_Advance() moves the time on.					*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "ADXL362_model.h"
+#include "xil_io.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/************************** Constant Definitions ***************************/
+#define MDL_REGS			16
+#define MDL_ODR_MAX			5			// 400Hz
+#define MDL_TS_DIV			(ADXL362_MODEL_CLK_HZ / 1000000)
+
+// control register
+#define MDL_ODR_MSK			0x00000007
+#define MDL_AVG_MSK			0x000000F0
+#define MDL_AVG_SHIFT		4
+#define MDL_APPLY_MSK		0x00000100
+#define MDL_FIFOCLR_MSK		0x00000200
+#define MDL_IRQEN_MSK		0x00000400
+
+/************************** Type Definitions *******************************/
+typedef struct {
+	u32 ts;
+	u32 x, y, z;			// 12 bit two's complement, as stored by the controller
+} MDL_Entry;
+
+/************************** Variable Definitions ***************************/
+
+// AXI slave
+static u64		clk;
+static u32		slvReg0;
+static u32		rgSnap[3];			// slv_reg9 - slv_reg11
+static u32		snapSeq;
+static u32		rgLive[4];			// X, Y, Z, temperature of the live sample
+static u32		tsLive;
+static int		fDrdyPending;
+
+// ADXL362Ctrl
+static u32		odrReq, avgReq;		// latched by Apply
+static u32		odrAdxl, avgLog2;	// in use since the last restart
+static int		fCfgPending;
+static int		fSetDone;			// waiting for the next sample rate tick
+static u32		cRead;
+static s32		rgSum[4];
+static int		avgMaxLog2;
+
+static MDL_Entry rgFifo[ADXL362_MODEL_FIFO_DEPTH];
+static int		iFifoWr, iFifoRd, cFifo;
+static int		fFifoOvf;
+
+static int		fVerboseMdl;
+
+/************************** Function Definitions ***************************/
+
+static inline u32 MDL_Timestamp(void)
+{
+	return (u32) (clk / MDL_TS_DIV);
+}
+
+static inline u32 MDL_Pack12(s32 v)
+{
+	return (u32) v & 0xFFF;
+}
+
+// the average of a set, shift_right of the signed sum resized to 12 bits
+static inline u32 MDL_Avg(s32 sum, u32 shift)
+{
+	return MDL_Pack12(sum >> shift);
+}
+
+static void MDL_FifoClear(void)
+{
+	iFifoWr = iFifoRd = cFifo = 0;
+	fFifoOvf = 0;
+}
+
+// the controller restarts from the reset command with the latched configuration
+static void MDL_Restart(void)
+{
+	odrAdxl = odrReq;
+	avgLog2 = avgReq;
+	fCfgPending = 0;
+	cRead = 0;
+	rgSum[0] = rgSum[1] = rgSum[2] = rgSum[3] = 0;
+}
+
+void ADXL362Model_Reset(void)
+{
+	for (avgMaxLog2 = 0; (1 << avgMaxLog2) < ADXL362_MODEL_NUM_READS_AVG; avgMaxLog2++)
+		;
+
+	clk = 0;
+	slvReg0 = (avgMaxLog2 << MDL_AVG_SHIFT) | ADXL362_MODEL_ODR_SEL;
+	rgSnap[0] = rgSnap[1] = rgSnap[2] = 0;
+	snapSeq = 0;
+	rgLive[0] = rgLive[1] = rgLive[2] = rgLive[3] = 0;
+	tsLive = 0;
+	fDrdyPending = 0;
+
+	odrReq = ADXL362_MODEL_ODR_SEL;
+	avgReq = avgMaxLog2;
+	MDL_Restart();
+	fSetDone = 0;
+	MDL_FifoClear();
+}
+
+void ADXL362Model_Advance(u32 usec)
+{
+	clk += (u64) usec * MDL_TS_DIV;
+}
+
+/*
+** One set of data read from the ADXL362, in the state where the controller
+** stores it in the FIFO and adds it to the accumulators.  Returns 1 when it
+** completes an average, i.e. Data_Ready is signalled.
+*/
+int ADXL362Model_Read(s16 x, s16 y, s16 z, s16 tmp)
+{
+	MDL_Entry *pEntry;
+
+	// the first read after a set waits for the sample rate tick, where a
+	// pending configuration restarts the controller
+	if (fSetDone) {
+		fSetDone = 0;
+		if (fCfgPending) {
+			MDL_Restart();
+		}
+	}
+
+	if (slvReg0 & MDL_FIFOCLR_MSK) {
+		MDL_FifoClear();
+	}
+	else if (cFifo == ADXL362_MODEL_FIFO_DEPTH) {
+		fFifoOvf = 1;
+	}
+	else {
+		pEntry = &rgFifo[iFifoWr];
+		pEntry->ts = MDL_Timestamp();
+		pEntry->x = MDL_Pack12(x);
+		pEntry->y = MDL_Pack12(y);
+		pEntry->z = MDL_Pack12(z);
+		iFifoWr = (iFifoWr + 1) % ADXL362_MODEL_FIFO_DEPTH;
+		cFifo++;
+	}
+
+	rgSum[0] += x;
+	rgSum[1] += y;
+	rgSum[2] += z;
+	rgSum[3] += tmp;
+	if (++cRead < (1u << avgLog2)) {
+		return 0;
+	}
+
+	rgLive[0] = MDL_Avg(rgSum[0], avgLog2);
+	rgLive[1] = MDL_Avg(rgSum[1], avgLog2);
+	rgLive[2] = MDL_Avg(rgSum[2], avgLog2);
+	rgLive[3] = MDL_Avg(rgSum[3], avgLog2);
+	tsLive = MDL_Timestamp();
+	snapSeq++;
+	fDrdyPending = 1;
+
+	cRead = 0;
+	rgSum[0] = rgSum[1] = rgSum[2] = rgSum[3] = 0;
+	fSetDone = 1;
+	return 1;
+}
+
+u32 ADXL362Model_Odr(void)
+{
+	return odrAdxl;
+}
+
+u32 ADXL362Model_AvgLog2(void)
+{
+	return avgLog2;
+}
+
+int ADXL362Model_Irq(void)
+{
+	return fDrdyPending && (slvReg0 & MDL_IRQEN_MSK);
+}
+
+void ADXL362Model_SetVerbose(int fVerbose)
+{
+	fVerboseMdl = fVerbose;
+}
+
+static int MDL_Reg(UINTPTR Addr)
+{
+	if ((Addr < ADXL362_MODEL_BASEADDR) || (Addr >= ADXL362_MODEL_BASEADDR + MDL_REGS * 4) || (Addr & 3)) {
+		printf("access outside the ADXL362_AXI registers at 0x%08lx\n", (unsigned long) Addr);
+		exit(2);
+	}
+	clk += ADXL362_MODEL_BUS_CLKS;
+	return (int) (Addr - ADXL362_MODEL_BASEADDR) / 4;
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	MDL_Entry *pEntry = &rgFifo[iFifoRd];
+	int reg = MDL_Reg(Addr);
+	u32 data;
+
+	switch (reg) {
+	case 0:
+		return slvReg0;
+	case 1:
+		return ((u32) fFifoOvf << 16) | (u32) cFifo;
+	case 2:
+		return (pEntry->y << 16) | pEntry->x;
+	case 3:
+		return pEntry->z;
+	case 4:
+		// the FIFO is popped in the same clock period, FIFO Clear wins
+		data = pEntry->ts;
+		if ((cFifo > 0) && !(slvReg0 & MDL_FIFOCLR_MSK)) {
+			iFifoRd = (iFifoRd + 1) % ADXL362_MODEL_FIFO_DEPTH;
+			cFifo--;
+		}
+		return data;
+	case 5:
+		return MDL_Timestamp();
+	case 8:
+		rgSnap[0] = (rgLive[1] << 16) | rgLive[0];
+		rgSnap[1] = (rgLive[3] << 16) | rgLive[2];
+		rgSnap[2] = tsLive;
+		fDrdyPending = 0;
+		return snapSeq;
+	case 9:
+	case 10:
+	case 11:
+		return rgSnap[reg - 9];
+	default:
+		return 0;
+	}
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 odr, avg;
+
+	if (MDL_Reg(Addr) != 0) {
+		return;			// the other registers are read-only
+	}
+
+	slvReg0 = Value;
+	if (Value & MDL_APPLY_MSK) {
+		odr = Value & MDL_ODR_MSK;
+		avg = (Value & MDL_AVG_MSK) >> MDL_AVG_SHIFT;
+		odrReq = (odr > MDL_ODR_MAX) ? MDL_ODR_MAX : odr;
+		avgReq = (avg > (u32) avgMaxLog2) ? (u32) avgMaxLog2 : avg;
+		fCfgPending = 1;
+	}
+	if (Value & MDL_FIFOCLR_MSK) {
+		MDL_FifoClear();
+	}
+}
+
+void xil_printf(const char *ctrl1, ...)
+{
+	va_list args;
+
+	if (fVerboseMdl) {
+		va_start(args, ctrl1);
+		vprintf(ctrl1, args);
+		va_end(args);
+	}
+}
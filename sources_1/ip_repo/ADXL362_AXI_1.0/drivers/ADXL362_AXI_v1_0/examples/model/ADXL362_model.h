@@ -0,0 +1,54 @@
+/************************************************************************/
+/*																		*/
+/* ADXL362_model.h	--	Interface Declarations for ADXL362_model.c		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	This header file contains the declarations of the host model of		*/
+/*	the ADXL362_AXI peripheral.  The model stands in for the registers	*/
+/*	behind Xil_In32()/Xil_Out32(), so the unmodified ADXL362_AXI		*/
+/*	driver runs on the host, and for the ADXL362Ctrl controller behind	*/
+/*	them: the runtime configuration, the averaging, the raw sample		*/
+/*	FIFO and the snapshot registers with the data ready interrupt.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+#ifndef ADXL362_MODEL_H
+#define ADXL362_MODEL_H
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+#include "xil_types.h"
+#include "xparameters.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+#define ADXL362_MODEL_BASEADDR		XPAR_ADXL362_AXI_0_S00_AXI_BASEADDR
+#define ADXL362_MODEL_CLK_HZ		100000000	// AXI clock
+#define ADXL362_MODEL_BUS_CLKS		8			// AXI clocks of one register access
+
+// the parameters of ADXL362_AXI_0 in embsys
+#define ADXL362_MODEL_ODR_SEL		4
+#define ADXL362_MODEL_NUM_READS_AVG	16
+#define ADXL362_MODEL_FIFO_DEPTH	64
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+void ADXL362Model_Reset(void);
+void ADXL362Model_Advance(u32 usec);
+int ADXL362Model_Read(s16 x, s16 y, s16 z, s16 tmp);
+
+u32 ADXL362Model_Odr(void);
+u32 ADXL362Model_AvgLog2(void);
+int ADXL362Model_Irq(void);
+void ADXL362Model_SetVerbose(int fVerbose);
+
+#endif // ADXL362_MODEL_H
@@ -0,0 +1,23 @@
+/************************************************************************/
+/*																		*/
+/* xil_io.h	--	Host stand-in for the Xilinx BSP header					*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Register accesses go to the ADXL362_AXI model.  xil_printf() is		*/
+/*	declared here because the self test calls it without including		*/
+/*	xil_printf.h.														*/
+/*																		*/
+/************************************************************************/
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+u32 Xil_In32(UINTPTR Addr);
+void Xil_Out32(UINTPTR Addr, u32 Value);
+
+void xil_printf(const char *ctrl1, ...);
+
+#endif // XIL_IO_H
@@ -0,0 +1,18 @@
+/************************************************************************/
+/*																		*/
+/* xparameters.h	--	Host stand-in for the generated header			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Address and parameters of the ADXL362_AXI instance in embsys, as	*/
+/*	used by the peripheral model.										*/
+/*																		*/
+/************************************************************************/
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_ADXL362_AXI_0_S00_AXI_BASEADDR		0x44A30000
+#define XPAR_ADXL362_AXI_0_S00_AXI_HIGHADDR		0x44A3FFFF
+
+#endif // XPARAMETERS_H
@@ -0,0 +1,23 @@
+/************************************************************************/
+/*																		*/
+/* xstatus.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The status codes that the ADXL362_AXI driver returns, with the		*/
+/*	values of the BSP.													*/
+/*																		*/
+/************************************************************************/
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+#define XST_NO_DATA					13L
+
+typedef s32 XStatus;
+
+#endif // XSTATUS_H
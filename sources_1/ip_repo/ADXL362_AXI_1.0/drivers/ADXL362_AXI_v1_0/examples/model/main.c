@@ -0,0 +1,324 @@
+/************************************************************************/
+/*																		*/
+/*	main.c	--	ADXL362_AXI driver on the host peripheral model			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Runs the ADXL362_AXI driver, self test included, against the		*/
+/*	peripheral model and checks what it returns against values worked	*/
+/*	out here from the samples fed to the model:							*/
+/*																		*/
+/*	- after reset the driver reads the configuration the controller		*/
+/*	  runs with, 200Hz and 16 reads averaged.							*/
+/*	- the snapshot is the floor of the mean of each set of reads, with	*/
+/*	  the timestamp of the last read, and is only new once.				*/
+/*	- the snapshot registers hold the latched sample while a new one	*/
+/*	  is produced.														*/
+/*	- the data ready interrupt follows the enable and is cleared by		*/
+/*	  reading the snapshot.												*/
+/*	- the FIFO returns every read oldest first, drops the newest when	*/
+/*	  full and flags it until it is cleared.							*/
+/*	- a new configuration takes effect at the start of the next set		*/
+/*	  and is limited to 400Hz and NUM_READS_AVG.						*/
+/*																		*/
+/*	It prints one line for each check and returns 0 when all passed.	*/
+/*	-v prints the self test messages.									*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -Wall -I. -Ibsp -I../../src -o adxl362_model		*/
+/*		main.c ADXL362_model.c ../../src/ADXL362_AXI.c					*/
+/*		../../src/ADXL362_AXI_selftest.c -lm							*/
+/*	./adxl362_model														*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "ADXL362_AXI.h"
+#include "ADXL362_model.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+#define SAMPLE_US		5000		// 200Hz
+#define CNTRL_IRQEN		0x00000400
+#define CNTRL_APPLY		0x00000100
+
+/************************** Type Definitions *******************************/
+typedef struct {
+	s16 x, y, z, tmp;
+	u32 ts;
+} Read;
+
+/************************** Variable Definitions ***************************/
+static ADXL362_AXI adxl;
+static Read rgRead[256];
+static int cRead;
+static u32 rand32 = 12345;
+static int cFail;
+
+/************************** Function Definitions ***************************/
+
+static void Check(int fOk, const char *szWhat)
+{
+	printf("%-68s %s\n", szWhat, fOk ? "ok" : "FAILED");
+	cFail += !fOk;
+}
+
+static s16 Rand12(void)
+{
+	rand32 = rand32 * 1103515245 + 12345;
+	return (s16) ((rand32 >> 16) % 4096) - 2048;
+}
+
+// feeds one read to the model and keeps it, with its timestamp
+static int Feed(s16 x, s16 y, s16 z, s16 tmp)
+{
+	Read *pRead = &rgRead[cRead++ % 256];
+
+	ADXL362Model_Advance(SAMPLE_US);
+	pRead->x = x;
+	pRead->y = y;
+	pRead->z = z;
+	pRead->tmp = tmp;
+	pRead->ts = ADXL362_get_timestamp(&adxl);
+	return ADXL362Model_Read(x, y, z, tmp);
+}
+
+static int FeedRandom(void)
+{
+	return Feed(Rand12(), Rand12(), Rand12(), Rand12());
+}
+
+// the expected average of the last n reads
+static void Average(int n, ADXL362_Snapshot *pSnap)
+{
+	double rgSum[4] = { 0, 0, 0, 0 };
+	int i;
+
+	for (i = cRead - n; i < cRead; i++) {
+		rgSum[0] += rgRead[i % 256].x;
+		rgSum[1] += rgRead[i % 256].y;
+		rgSum[2] += rgRead[i % 256].z;
+		rgSum[3] += rgRead[i % 256].tmp;
+	}
+	pSnap->x = (s16) floor(rgSum[0] / n);
+	pSnap->y = (s16) floor(rgSum[1] / n);
+	pSnap->z = (s16) floor(rgSum[2] / n);
+	pSnap->temp = (s16) floor(rgSum[3] / n);
+}
+
+static int SameData(const ADXL362_Snapshot *pSnap, const ADXL362_Snapshot *pExp)
+{
+	return pSnap->x == pExp->x && pSnap->y == pExp->y && pSnap->z == pExp->z && pSnap->temp == pExp->temp;
+}
+
+// feeds random reads until the model completes an average, returns the reads
+static int FeedSet(void)
+{
+	int n = 1;
+
+	while (!FeedRandom()) {
+		n++;
+	}
+	return n;
+}
+
+static void TestReset(void)
+{
+	Check(ADXL362_initialize(&adxl, ADXL362_MODEL_BASEADDR) == XST_SUCCESS, "initialize and self test");
+	Check(adxl.odr == ADXL362_ODR_200HZ && adxl.avg_log2 == 4, "driver reads 200Hz, 16 reads averaged after reset");
+	Check(ADXL362_mReadReg(adxl.base_address, ADXL362_CNTRL_OFFSET) == 0x44, "self test restores the control register");
+	Check(ADXL362Model_Odr() == ADXL362_ODR_200HZ && ADXL362Model_AvgLog2() == 4, "controller runs with the same configuration");
+}
+
+static void TestAverage(void)
+{
+	ADXL362_Snapshot snap, exp;
+	int n, i, fOk = 1;
+
+	Check(ADXL362_read_snapshot(&adxl, &snap) == XST_NO_DATA, "no snapshot before the first average");
+
+	for (i = 0; i < 20; i++) {
+		n = FeedSet();
+		fOk &= (n == 16);
+		Average(n, &exp);
+		fOk &= (ADXL362_read_snapshot(&adxl, &snap) == XST_SUCCESS);
+		fOk &= SameData(&snap, &exp) && snap.seq == (u32) (i + 1) && snap.timestamp == rgRead[(cRead - 1) % 256].ts;
+		fOk &= (ADXL362_read_snapshot(&adxl, &snap) == XST_NO_DATA) && SameData(&snap, &exp);
+	}
+	Check(fOk, "20 averages of 16 random reads, each new once");
+
+	// the sum is shifted right, the mean is rounded towards minus infinity
+	for (i = 0; i < 15; i++) {
+		Feed(-1, 2047, -2048, 0);
+	}
+	Feed(-2, 2047, -2048, 1);
+	Average(16, &exp);
+	ADXL362_read_snapshot(&adxl, &snap);
+	Check(SameData(&snap, &exp) && snap.x == -2 && snap.y == 2047 && snap.z == -2048 && snap.temp == 0,
+		"averages of negative and full scale reads");
+}
+
+static void TestSnapshot(void)
+{
+	ADXL362_Snapshot snap, exp;
+	u32 seq, xy;
+
+	Average(16, &exp);
+	seq = ADXL362_mReadReg(adxl.base_address, ADXL362_SNAP_SEQ_OFFSET);
+	FeedSet();
+	xy = ADXL362_mReadReg(adxl.base_address, ADXL362_SNAP_XY_OFFSET);
+	Check((xy & 0xFFF) == ((u32) exp.x & 0xFFF) && ((xy >> 16) & 0xFFF) == ((u32) exp.y & 0xFFF),
+		"latched snapshot is kept while a new average is produced");
+
+	adxl.last_seq = seq;
+	Average(16, &exp);
+	Check(ADXL362_read_snapshot(&adxl, &snap) == XST_SUCCESS && snap.seq == seq + 1 && SameData(&snap, &exp),
+		"the next read latches the new average");
+}
+
+static void TestInterrupt(void)
+{
+	ADXL362_Snapshot snap;
+	int fOk = 1;
+
+	ADXL362_enable_interrupt(&adxl, true);
+	fOk &= !ADXL362Model_Irq();
+	FeedSet();
+	fOk &= ADXL362Model_Irq();
+	FeedSet();
+	fOk &= ADXL362Model_Irq();
+	ADXL362_read_snapshot(&adxl, &snap);
+	fOk &= !ADXL362Model_Irq();
+	Check(fOk, "interrupt set by an average, cleared by the snapshot");
+
+	fOk = 1;
+	ADXL362_enable_interrupt(&adxl, false);
+	FeedSet();
+	fOk &= !ADXL362Model_Irq();
+	ADXL362_enable_interrupt(&adxl, true);
+	fOk &= ADXL362Model_Irq();
+	ADXL362_read_snapshot(&adxl, &snap);
+	fOk &= !ADXL362Model_Irq();
+	Check(fOk, "disabled interrupt stays pending until the snapshot is read");
+}
+
+static void TestFifo(void)
+{
+	ADXL362_Sample rgSample[ADXL362_MODEL_FIFO_DEPTH + 8];
+	int i, n, iFirst, fOk;
+
+	Check(ADXL362_clear_fifo(&adxl) == XST_SUCCESS && ADXL362_fifo_count(&adxl) == 0, "clear the FIFO");
+
+	iFirst = cRead;
+	for (i = 0; i < 20; i++) {
+		FeedRandom();
+	}
+	fOk = ADXL362_fifo_count(&adxl) == 20;
+	n = ADXL362_fifo_drain(&adxl, rgSample, 8);
+	n += ADXL362_fifo_drain(&adxl, rgSample + 8, 64);
+	fOk &= (n == 20) && ADXL362_fifo_count(&adxl) == 0 && !ADXL362_fifo_overflowed(&adxl);
+	for (i = 0; i < n; i++) {
+		Read *pRead = &rgRead[(iFirst + i) % 256];
+
+		fOk &= rgSample[i].x == pRead->x && rgSample[i].y == pRead->y && rgSample[i].z == pRead->z;
+		fOk &= rgSample[i].timestamp == pRead->ts;
+		fOk &= (i == 0) || (rgSample[i].timestamp - rgSample[i - 1].timestamp >= SAMPLE_US);
+	}
+	Check(fOk, "20 reads drained in two bursts, oldest first, with timestamps");
+
+	iFirst = cRead;
+	for (i = 0; i < ADXL362_MODEL_FIFO_DEPTH + 6; i++) {
+		FeedRandom();
+	}
+	fOk = ADXL362_fifo_count(&adxl) == ADXL362_MODEL_FIFO_DEPTH && ADXL362_fifo_overflowed(&adxl);
+	n = ADXL362_fifo_drain(&adxl, rgSample, ADXL362_MODEL_FIFO_DEPTH + 8);
+	fOk &= (n == ADXL362_MODEL_FIFO_DEPTH);
+	for (i = 0; i < n; i++) {
+		fOk &= rgSample[i].x == rgRead[(iFirst + i) % 256].x && rgSample[i].timestamp == rgRead[(iFirst + i) % 256].ts;
+	}
+	fOk &= ADXL362_fifo_overflowed(&adxl);
+	Check(fOk, "70 reads into 64 entries keep the oldest and flag the overflow");
+
+	Check(ADXL362_clear_fifo(&adxl) == XST_SUCCESS && !ADXL362_fifo_overflowed(&adxl)
+		&& ADXL362_fifo_count(&adxl) == 0, "clearing the FIFO clears the overflow");
+}
+
+static void TestConfig(void)
+{
+	ADXL362_Snapshot snap, exp;
+	u32 cntrl;
+	int i, n, fOk;
+
+	// start at the beginning of a set
+	FeedSet();
+	ADXL362_enable_interrupt(&adxl, true);
+	ADXL362_read_snapshot(&adxl, &snap);
+
+	// the set in progress finishes with the old averaging
+	for (i = 0; i < 5; i++) {
+		FeedRandom();
+	}
+	fOk = ADXL362_set_config(&adxl, ADXL362_ODR_400HZ, 2) == XST_SUCCESS;
+	cntrl = ADXL362_mReadReg(adxl.base_address, ADXL362_CNTRL_OFFSET);
+	fOk &= cntrl == (CNTRL_IRQEN | (2 << 4) | ADXL362_ODR_400HZ);
+	fOk &= adxl.odr == ADXL362_ODR_400HZ && adxl.avg_log2 == 2;
+	fOk &= ADXL362Model_Odr() == ADXL362_ODR_200HZ;
+	n = 5 + FeedSet();
+	Average(16, &exp);
+	fOk &= (n == 16) && ADXL362_read_snapshot(&adxl, &snap) == XST_SUCCESS && SameData(&snap, &exp);
+	Check(fOk, "set_config keeps the interrupt enable, the set finishes with 16 reads");
+
+	fOk = 1;
+	for (i = 0; i < 10; i++) {
+		n = FeedSet();
+		Average(n, &exp);
+		fOk &= (n == 4) && ADXL362_read_snapshot(&adxl, &snap) == XST_SUCCESS && SameData(&snap, &exp);
+	}
+	fOk &= ADXL362Model_Odr() == ADXL362_ODR_400HZ && ADXL362Model_AvgLog2() == 2;
+	Check(fOk, "next sets run at 400Hz with 4 reads averaged");
+
+	fOk = ADXL362_set_config(&adxl, ADXL362_ODR_400HZ + 1, 0) == XST_FAILURE;
+	fOk &= ADXL362_mReadReg(adxl.base_address, ADXL362_CNTRL_OFFSET) == cntrl;
+	Check(fOk, "set_config rejects an output data rate above 400Hz");
+
+	// the hardware limits what is written to the register directly
+	ADXL362_mWriteReg(adxl.base_address, ADXL362_CNTRL_OFFSET, CNTRL_APPLY | (7 << 4) | 7);
+	ADXL362_mWriteReg(adxl.base_address, ADXL362_CNTRL_OFFSET, (7 << 4) | 7);
+	n = FeedSet();
+	n = FeedSet();
+	Check(n == ADXL362_MODEL_NUM_READS_AVG && ADXL362Model_Odr() == ADXL362_ODR_400HZ,
+		"controller limits the averaging to 16 reads and the rate to 400Hz");
+
+	ADXL362_set_config(&adxl, ADXL362_ODR_12_5HZ, 0);
+	FeedSet();
+	n = FeedSet();
+	ADXL362_read_snapshot(&adxl, &snap);
+	Average(1, &exp);
+	Check(n == 1 && ADXL362Model_Odr() == ADXL362_ODR_12_5HZ && SameData(&snap, &exp),
+		"12.5Hz without averaging returns every read");
+}
+
+int main(int argc, char *argv[])
+{
+	ADXL362Model_SetVerbose(argc > 1 && strcmp(argv[1], "-v") == 0);
+	ADXL362Model_Reset();
+
+	TestReset();
+	TestAverage();
+	TestSnapshot();
+	TestInterrupt();
+	TestFifo();
+	TestConfig();
+
+	printf("%s, %d check%s failed\n", cFail ? "FAILED" : "passed", cFail, cFail == 1 ? "" : "s");
+	return cFail ? 1 : 0;
+}
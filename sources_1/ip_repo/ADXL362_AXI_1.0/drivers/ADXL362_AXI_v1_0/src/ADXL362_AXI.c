@@ -0,0 +1,341 @@
+/** @file ADXL362_AXI.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the driver functions for the ADXL362_AXI custom AXI Slave peripheral.
+* The peripheral controls the ADXL362 accelerometer on the Nexys4DDR.  The application can
+* change the ADXL362 output data rate and the number of reads averaged at runtime and
+* retrieve every raw sample read from the ADXL362, with its timestamp, from a FIFO.
+* The averaged data is read as a tear-free snapshot with a sample sequence number.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     01-Jun-2017	First release of driver
+* 1.01a	     05-Jun-2017	Added ADXL362_read_snapshot()
+* 1.02a	     07-Jun-2017	Added ADXL362_enable_interrupt() and the snapshot timestamp
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "ADXL362_AXI.h"
+
+/************************** Constant Definitions *****************************/
+
+// bit masks for the ADXL362_AXI peripheral
+
+// control register
+#define ADXL362_ODR_MSK			0x00000007
+#define ADXL362_AVG_MSK			0x000000F0
+#define ADXL362_AVG_SHIFT		4
+#define ADXL362_APPLY_MSK		0x00000100
+#define ADXL362_FIFOCLR_MSK		0x00000200
+#define ADXL362_IRQEN_MSK		0x00000400
+
+// status register
+#define ADXL362_FIFOCNT_MSK		0x0000FFFF
+#define ADXL362_FIFOOVF_MSK		0x00010000
+
+// FIFO data registers
+#define ADXL362_X_MSK			0x00000FFF
+#define ADXL362_Y_SHIFT			16
+
+/**************************** Type definitions ******************************/
+
+/***************** Macros (Inline function) Definitions *********************/
+
+// sign extend a 12-bit two's complement value
+#define ADXL362_SEXT12(v)		((int16_t) (((v) & 0x0800) ? ((v) | 0xF000) : ((v) & 0x0FFF)))
+
+/******************** Static variable declarations **************************/
+
+
+/*********************** Private function prototypes ************************/
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the ADXL362_AXI peripheral driver
+*
+* Saves the base address of the ADXL362_AXI registers and runs the selftest.
+* If the self-test passes the function empties the raw sample FIFO.  The
+* ADXL362 keeps the output data rate and averaging selected by the peripheral
+* parameters until ADXL362_set_config() is called.
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+* @param	baseaddr is the base address of the ADXL362_AXI peripheral register set
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+*
+* @note		This function can hang if the peripheral was not created correctly
+* @note		The Base Address of the ADXL362_AXI peripheral registers will be in xparameters.h
+*****************************************************************************/
+uint32_t ADXL362_initialize(p_ADXL362_AXI p_instance, uint32_t baseaddr)
+{
+	uint32_t cntrl;
+
+	// Save the Base Address of the ADXL362_AXI register set so we know where to point the driver
+	p_instance->base_address = baseaddr;
+
+	// Run the driver self-test.
+	if ( XST_SUCCESS == ADXL362_selftest(p_instance->base_address ) )
+	{
+		p_instance->is_ready = true;
+	}
+	else
+	{
+		p_instance->is_ready = false;
+	}
+
+	// if the peripheral is ready remember the configuration and start with an empty FIFO
+	if (p_instance->is_ready)
+	{
+		cntrl = ADXL362_mReadReg(p_instance->base_address, ADXL362_CNTRL_OFFSET);
+		p_instance->odr = cntrl & ADXL362_ODR_MSK;
+		p_instance->avg_log2 = (cntrl & ADXL362_AVG_MSK) >> ADXL362_AVG_SHIFT;
+		p_instance->last_seq = ADXL362_mReadReg(p_instance->base_address, ADXL362_SNAP_SEQ_OFFSET);
+		ADXL362_clear_fifo(p_instance);
+	}
+
+	return (p_instance->is_ready) ? XST_SUCCESS : XST_FAILURE;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Change the ADXL362 output data rate and the number of reads averaged
+*
+* The new configuration is applied at the next sample period: the ADXL362 is
+* reset and reconfigured, which takes a few milliseconds during which no new
+* data is available
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+* @param	odr is the output data rate, ADXL362_ODR_12_5HZ .. ADXL362_ODR_400HZ
+* @param	avg_log2 is the log2 of the number of reads averaged for the averaged
+*			outputs.  The hardware limits it to log2 of the NUM_READS_AVG parameter
+*
+* @return	XST_SUCCESS if the configuration was loaded, XST_FAILURE if odr is out of range
+*
+*****************************************************************************/
+uint32_t ADXL362_set_config(p_ADXL362_AXI p_instance, uint32_t odr, uint32_t avg_log2)
+{
+	uint32_t cntrl;
+
+	if (odr > ADXL362_ODR_400HZ)
+	{
+		return XST_FAILURE;
+	}
+
+	// build the new control state, keeping the interrupt enable
+	cntrl = ADXL362_mReadReg(p_instance->base_address, ADXL362_CNTRL_OFFSET) & ADXL362_IRQEN_MSK;
+	cntrl |= (odr & ADXL362_ODR_MSK) | ((avg_log2 << ADXL362_AVG_SHIFT) & ADXL362_AVG_MSK);
+
+	// kick off the command by writing 1 to	"Apply" bit
+	ADXL362_mWriteReg(p_instance->base_address, ADXL362_CNTRL_OFFSET, (cntrl | ADXL362_APPLY_MSK));
+
+	// end the command by writing 0 to "Apply" bit
+	ADXL362_mWriteReg(p_instance->base_address, ADXL362_CNTRL_OFFSET, cntrl);
+
+	p_instance->odr = odr;
+	p_instance->avg_log2 = (cntrl & ADXL362_AVG_MSK) >> ADXL362_AVG_SHIFT;
+
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Returns the number of samples in the raw sample FIFO
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+*
+* @return	number of samples waiting in the FIFO
+*****************************************************************************/
+uint32_t ADXL362_fifo_count(p_ADXL362_AXI p_instance)
+{
+	uint32_t sts;
+
+	sts = ADXL362_mReadReg(p_instance->base_address, ADXL362_STS_OFFSET);
+
+	return sts & ADXL362_FIFOCNT_MSK;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Reads samples from the raw sample FIFO
+*
+* Reads the FIFO count once and then removes up to max_samples samples from the FIFO,
+* oldest first.  Each sample takes three register reads; the timestamp register is read
+* last because reading it removes the sample from the FIFO
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+* @param	p_samples is a pointer to an array of at least max_samples samples
+* @param	max_samples is the maximum number of samples to read
+*
+* @return	number of samples read
+*****************************************************************************/
+uint32_t ADXL362_fifo_drain(p_ADXL362_AXI p_instance, p_ADXL362_Sample p_samples, uint32_t max_samples)
+{
+	uint32_t count, i;
+	uint32_t xy, z;
+
+	count = ADXL362_fifo_count(p_instance);
+	if (count > max_samples)
+	{
+		count = max_samples;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		xy = ADXL362_mReadReg(p_instance->base_address, ADXL362_FIFO_XY_OFFSET);
+		z = ADXL362_mReadReg(p_instance->base_address, ADXL362_FIFO_Z_OFFSET);
+		p_samples[i].timestamp = ADXL362_mReadReg(p_instance->base_address, ADXL362_FIFO_TS_OFFSET);
+		p_samples[i].x = ADXL362_SEXT12(xy & ADXL362_X_MSK);
+		p_samples[i].y = ADXL362_SEXT12((xy >> ADXL362_Y_SHIFT) & ADXL362_X_MSK);
+		p_samples[i].z = ADXL362_SEXT12(z & ADXL362_X_MSK);
+	}
+
+	return count;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Empties the raw sample FIFO and clears the overflow flag
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+*
+* @return	XST_SUCCESS if the FIFO was emptied, XST_FAILURE otherwise
+*****************************************************************************/
+uint32_t ADXL362_clear_fifo(p_ADXL362_AXI p_instance)
+{
+	uint32_t cntrl;
+
+	// keep the configuration, the "Apply" bit is always 0 between commands
+	cntrl = ADXL362_mReadReg(p_instance->base_address, ADXL362_CNTRL_OFFSET) & ~ADXL362_FIFOCLR_MSK;
+
+	// kick off the command by writing 1 to	"FIFO Clear" bit
+	ADXL362_mWriteReg(p_instance->base_address, ADXL362_CNTRL_OFFSET, (cntrl | ADXL362_FIFOCLR_MSK));
+
+	// end the command by writing 0 to "FIFO Clear" bit
+	ADXL362_mWriteReg(p_instance->base_address, ADXL362_CNTRL_OFFSET, cntrl);
+
+	// a new sample may have been pushed since the FIFO was cleared, but there is
+	// at least one sample period (2.5ms at 400Hz) between samples
+	return (ADXL362_fifo_count(p_instance) <= 1) ? XST_SUCCESS : XST_FAILURE;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Returns true if a sample was dropped because the FIFO was full
+*
+* The flag stays set until ADXL362_clear_fifo() is called
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+*
+* @return	true if the FIFO overflowed, false otherwise
+*****************************************************************************/
+bool ADXL362_fifo_overflowed(p_ADXL362_AXI p_instance)
+{
+	uint32_t sts;
+
+	sts = ADXL362_mReadReg(p_instance->base_address, ADXL362_STS_OFFSET);
+
+	return (0 != (sts & ADXL362_FIFOOVF_MSK)) ? true : false;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Reads the latest averaged sample
+*
+* Reads the snapshot sequence register first, which latches the latest averaged
+* sample in the peripheral, then the latched X/Y and Z/temperature registers.  The
+* three reads always belong to the same sample even if the ADXL362 controller
+* updates its outputs in between.  Reading the sequence register also clears the
+* data ready interrupt
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+* @param	p_snap is a pointer to where the sample is returned
+*
+* @return	XST_SUCCESS if this is a new sample, XST_NO_DATA if the sample was
+*			already returned by the previous call.  The sample is returned in
+*			both cases
+*****************************************************************************/
+uint32_t ADXL362_read_snapshot(p_ADXL362_AXI p_instance, p_ADXL362_Snapshot p_snap)
+{
+	uint32_t xy, zt;
+	uint32_t sts;
+
+	p_snap->seq = ADXL362_mReadReg(p_instance->base_address, ADXL362_SNAP_SEQ_OFFSET);
+	xy = ADXL362_mReadReg(p_instance->base_address, ADXL362_SNAP_XY_OFFSET);
+	zt = ADXL362_mReadReg(p_instance->base_address, ADXL362_SNAP_ZT_OFFSET);
+	p_snap->timestamp = ADXL362_mReadReg(p_instance->base_address, ADXL362_SNAP_TS_OFFSET);
+
+	p_snap->x = ADXL362_SEXT12(xy & ADXL362_X_MSK);
+	p_snap->y = ADXL362_SEXT12((xy >> ADXL362_Y_SHIFT) & ADXL362_X_MSK);
+	p_snap->z = ADXL362_SEXT12(zt & ADXL362_X_MSK);
+	p_snap->temp = ADXL362_SEXT12((zt >> ADXL362_Y_SHIFT) & ADXL362_X_MSK);
+
+	sts = (p_snap->seq != p_instance->last_seq) ? XST_SUCCESS : XST_NO_DATA;
+	p_instance->last_seq = p_snap->seq;
+
+	return sts;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Enables or disables the data ready interrupt
+*
+* The interrupt is a level, set when the ADXL362 controller produces a new
+* averaged sample and cleared by ADXL362_read_snapshot(), so the interrupt
+* handler has to read the snapshot before it returns
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+* @param	enable is true to enable the interrupt, false to disable it
+*
+* @return	XST_SUCCESS
+*****************************************************************************/
+uint32_t ADXL362_enable_interrupt(p_ADXL362_AXI p_instance, bool enable)
+{
+	uint32_t cntrl;
+
+	cntrl = ADXL362_mReadReg(p_instance->base_address, ADXL362_CNTRL_OFFSET);
+	if (enable)
+	{
+		cntrl |= ADXL362_IRQEN_MSK;
+	}
+	else
+	{
+		cntrl &= ~ADXL362_IRQEN_MSK;
+	}
+	ADXL362_mWriteReg(p_instance->base_address, ADXL362_CNTRL_OFFSET, cntrl);
+
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Returns the current value of the peripheral timestamp counter
+*
+* The counter runs at ADXL362_TIMESTAMP_FREQ_HZ and uses the same time base
+* as the sample timestamps
+*
+* @param	p_instance is a pointer to the ADXL362_AXI driver instance
+*
+* @return	current timestamp in microseconds
+*****************************************************************************/
+uint32_t ADXL362_get_timestamp(p_ADXL362_AXI p_instance)
+{
+	return ADXL362_mReadReg(p_instance->base_address, ADXL362_TIMESTAMP_OFFSET);
+}
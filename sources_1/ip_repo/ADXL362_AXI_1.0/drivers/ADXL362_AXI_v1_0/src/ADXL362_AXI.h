@@ -0,0 +1,169 @@
+/** @file ADXL362_AXI.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants and low level function for the ADXL362_AXI custom AXI Slave
+* peripheral driver.  The peripheral controls the ADXL362 accelerometer on the Nexys4DDR over SPI.
+* It lets the application select the ADXL362 output data rate and the number of reads averaged, and
+* stores every raw sample read from the ADXL362 in a FIFO together with a 1MHz timestamp so that
+* samples can be retrieved in bursts instead of polling the averaged value.  The averaged X, Y, Z
+* and temperature data is read as a snapshot tagged with a sample sequence number so the application
+* can tell a new sample from one it has already read.  The peripheral can interrupt the processor
+* when a new averaged sample is available.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     01-Jun-2017	First release of driver
+* 1.01a	     05-Jun-2017	Added the averaged data snapshot
+* 1.02a	     07-Jun-2017	Added the data ready interrupt and the snapshot timestamp
+* </pre>
+*
+******************************************************************************/
+
+#ifndef ADXL362_AXI_H
+#define ADXL362_AXI_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+
+/************* Constant Dclarations *****************/
+// register declarations
+#define ADXL362_S00_AXI_SLV_REG0_OFFSET 0
+#define ADXL362_S00_AXI_SLV_REG1_OFFSET 4
+#define ADXL362_S00_AXI_SLV_REG2_OFFSET 8
+#define ADXL362_S00_AXI_SLV_REG3_OFFSET 12
+#define ADXL362_S00_AXI_SLV_REG4_OFFSET 16
+#define ADXL362_S00_AXI_SLV_REG5_OFFSET 20
+#define ADXL362_S00_AXI_SLV_REG8_OFFSET 32
+#define ADXL362_S00_AXI_SLV_REG9_OFFSET 36
+#define ADXL362_S00_AXI_SLV_REG10_OFFSET 40
+#define ADXL362_S00_AXI_SLV_REG11_OFFSET 44
+
+// canonical register declaration
+#define ADXL362_CNTRL_OFFSET	ADXL362_S00_AXI_SLV_REG0_OFFSET
+#define ADXL362_STS_OFFSET		ADXL362_S00_AXI_SLV_REG1_OFFSET
+#define ADXL362_FIFO_XY_OFFSET	ADXL362_S00_AXI_SLV_REG2_OFFSET
+#define ADXL362_FIFO_Z_OFFSET	ADXL362_S00_AXI_SLV_REG3_OFFSET
+#define ADXL362_FIFO_TS_OFFSET	ADXL362_S00_AXI_SLV_REG4_OFFSET		// reading this register pops the FIFO
+#define ADXL362_TIMESTAMP_OFFSET	ADXL362_S00_AXI_SLV_REG5_OFFSET
+#define ADXL362_SNAP_SEQ_OFFSET	ADXL362_S00_AXI_SLV_REG8_OFFSET		// reading this register latches the snapshot
+#define ADXL362_SNAP_XY_OFFSET	ADXL362_S00_AXI_SLV_REG9_OFFSET
+#define ADXL362_SNAP_ZT_OFFSET	ADXL362_S00_AXI_SLV_REG10_OFFSET
+#define ADXL362_SNAP_TS_OFFSET	ADXL362_S00_AXI_SLV_REG11_OFFSET
+
+// ADXL362 output data rates (ODR field of the ADXL362 Filter Control Register)
+#define ADXL362_ODR_12_5HZ		0
+#define ADXL362_ODR_25HZ		1
+#define ADXL362_ODR_50HZ		2
+#define ADXL362_ODR_100HZ		3
+#define ADXL362_ODR_200HZ		4
+#define ADXL362_ODR_400HZ		5
+
+// the timestamp counter runs at 1MHz
+#define ADXL362_TIMESTAMP_FREQ_HZ	1000000
+
+
+
+/**************************** Type Definitions *****************************/
+typedef struct
+{
+	int16_t		x;					// X acceleration, 12-bit two's complement sign extended
+	int16_t		y;					// Y acceleration
+	int16_t		z;					// Z acceleration
+	uint32_t	timestamp;			// time the sample was read from the ADXL362, in microseconds
+} ADXL362_Sample, *p_ADXL362_Sample;
+
+typedef struct
+{
+	uint32_t	seq;				// sample sequence number, incremented for every averaged sample
+	int16_t		x;					// averaged X acceleration, 12-bit two's complement sign extended
+	int16_t		y;					// averaged Y acceleration
+	int16_t		z;					// averaged Z acceleration
+	int16_t		temp;				// averaged temperature
+	uint32_t	timestamp;			// time the averaged sample became available, in microseconds
+} ADXL362_Snapshot, *p_ADXL362_Snapshot;
+
+typedef struct
+{
+	uint32_t	base_address;		// base address for ADXL362_AXI peripheral registers
+	bool		is_ready;			// ADXL362_AXI driver has been successfully initialized
+	uint32_t	odr;				// output data rate selected
+	uint32_t	avg_log2;			// log2 of the number of reads averaged
+	uint32_t	last_seq;			// sequence number of the last snapshot read
+} ADXL362_AXI, *p_ADXL362_AXI;
+
+/***************** Macros (Inline function) Definitions *********************/
+
+/**
+ *
+ * Write a value to an ADXL362_AXI register. A 32 bit write is performed.
+ * If the component is implemented in a smaller width, only the least
+ * significant data is written.
+ *
+ * @param   BaseAddress is the base address of the ADXL362_AXI device.
+ * @param   RegOffset is the register offset from the base to write to.
+ * @param   Data is the data written to the register.
+ *
+ * @return  None.
+ *
+ * @note
+ * C-style signature:
+ * 	void ADXL362_mWriteReg(u32 BaseAddress, unsigned RegOffset, uint32_t Data)
+ *
+ */
+#define ADXL362_mWriteReg(BaseAddress, RegOffset, Data) \
+  	Xil_Out32((BaseAddress) + (RegOffset), (uint32_t)(Data))
+
+/**
+ *
+ * Read a value from an ADXL362_AXI register. A 32 bit read is performed.
+ * If the component is implemented in a smaller width, only the least
+ * significant data is read from the register. The most significant data
+ * will be read as 0.
+ *
+ * @param   BaseAddress is the base address of the ADXL362_AXI device.
+ * @param   RegOffset is the register offset from the base to write to.
+ *
+ * @return  Data is the data from the register.
+ *
+ * @note
+ * C-style signature:
+ * 	u32 ADXL362_mReadReg(u32 BaseAddress, unsigned RegOffset)
+ *
+ */
+#define ADXL362_mReadReg(BaseAddress, RegOffset) \
+    Xil_In32((BaseAddress) + (RegOffset))
+
+
+/************************** Function Prototypes ****************************/
+
+// self test and initialization functions
+uint32_t ADXL362_selftest(uint32_t baseaddr);
+uint32_t ADXL362_initialize(p_ADXL362_AXI p_instance, uint32_t baseaddr);
+
+// configuration functions
+uint32_t ADXL362_set_config(p_ADXL362_AXI p_instance, uint32_t odr, uint32_t avg_log2);
+
+// raw sample FIFO functions
+uint32_t ADXL362_fifo_count(p_ADXL362_AXI p_instance);
+uint32_t ADXL362_fifo_drain(p_ADXL362_AXI p_instance, p_ADXL362_Sample p_samples, uint32_t max_samples);
+uint32_t ADXL362_clear_fifo(p_ADXL362_AXI p_instance);
+bool ADXL362_fifo_overflowed(p_ADXL362_AXI p_instance);
+
+// averaged data functions
+uint32_t ADXL362_read_snapshot(p_ADXL362_AXI p_instance, p_ADXL362_Snapshot p_snap);
+uint32_t ADXL362_enable_interrupt(p_ADXL362_AXI p_instance, bool enable);
+
+// timestamp functions
+uint32_t ADXL362_get_timestamp(p_ADXL362_AXI p_instance);
+
+#endif // ADXL362_AXI_H
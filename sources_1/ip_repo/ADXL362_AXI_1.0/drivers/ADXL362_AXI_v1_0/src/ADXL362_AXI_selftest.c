@@ -0,0 +1,78 @@
+
+/***************************** Include Files *******************************/
+#include "ADXL362_AXI.h"
+#include "xparameters.h"
+#include "stdio.h"
+#include "xil_io.h"
+
+/************************** Constant Definitions ***************************/
+#define ADXL362_SELFTEST_CNTRL	0x000000A5		// test pattern, no command or interrupt enable bits
+
+/************************** Function Definitions ***************************/
+/**
+ *
+ * Run a self-test on the driver/device. Note this may be a destructive test if
+ * resets of the device are performed.
+ *
+ * If the hardware system is not built correctly, this function may never
+ * return to the caller.
+ *
+ * @param   baseaddr_p is the base address of the ADXL362_AXI instance to be worked on.
+ *
+ * @return
+ *
+ *    - XST_SUCCESS   if all self-test code passed
+ *    - XST_FAILURE   if any self-test code failed
+ *
+ * @note    Caching must be turned off for this function to work.
+ * @note    Self test may fail if data memory and device are not on the same bus.
+ * @note	Checks the control register and that the timestamp counter is running.
+ *			The control register is restored, so it still shows the configuration
+ *			the ADXL362 controller is running with
+ *
+ */
+uint32_t ADXL362_selftest(uint32_t baseaddr)
+{
+	uint32_t ts0, ts1, cntrl, readback;
+
+
+	xil_printf("******************************\n\r");
+	xil_printf("* ADXL362_AXI Peripheral Self Test\n\r");
+	xil_printf("******************************\n\n\r");
+
+	/*
+	 * Write to user logic slave module register(s) and read back
+	 */
+	xil_printf("User logic slave module test...\n\r");
+
+	// register 0 is the only read/write register.  The command bits are not set
+	// so the ADXL362 configuration is not changed, and the register is put back
+	cntrl = ADXL362_mReadReg (baseaddr, ADXL362_CNTRL_OFFSET);
+	ADXL362_mWriteReg (baseaddr, ADXL362_CNTRL_OFFSET, ADXL362_SELFTEST_CNTRL);
+	readback = ADXL362_mReadReg (baseaddr, ADXL362_CNTRL_OFFSET);
+	ADXL362_mWriteReg (baseaddr, ADXL362_CNTRL_OFFSET, cntrl);
+	if (readback != ADXL362_SELFTEST_CNTRL)
+	{
+		xil_printf ("Error reading register value at address %x\n", (int32_t) baseaddr + ADXL362_CNTRL_OFFSET);
+		return XST_FAILURE;
+	}
+
+	xil_printf("   - slave register write/read passed\n\r");
+
+	// the timestamp counter runs at 1MHz, two reads a few bus cycles apart must differ
+	// by a small amount
+	ts0 = ADXL362_mReadReg (baseaddr, ADXL362_TIMESTAMP_OFFSET);
+	do
+	{
+		ts1 = ADXL362_mReadReg (baseaddr, ADXL362_TIMESTAMP_OFFSET);
+	} while (ts1 == ts0);
+	if ((ts1 - ts0) > 10)
+	{
+		xil_printf ("Error timestamp counter skipped from %d to %d\n", ts0, ts1);
+		return XST_FAILURE;
+	}
+
+	xil_printf("   - timestamp counter passed\n\n\r");
+
+	return XST_SUCCESS;
+}
@@ -0,0 +1,179 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: Portland State University
+//
+// Description:
+// ------------
+// This module is the top level for the ADXL362_AXI peripheral.  It wraps the
+// ADXL362 accelerometer controller (ADXL362Ctrl.vhd) and gives the MicroBlaze
+// access to its runtime configuration (output data rate and averaging depth),
+// to its raw sample FIFO and to a snapshot of the averaged X, Y, Z and temperature
+// data through an AXI Lite slave interface.  accel_irq requests an interrupt when
+// a new averaged sample is available.
+//
+// Dependencies:
+// -------------
+// 	This module is dependent on ADXL362Ctrl.vhd (ADXL362 state machines) and
+//	SPI_If.vhd (SPI interface used by ADXL362Ctrl) and makes use of signals
+//	produced in the AXI interface module for the peripheral
+//
+// Revision:
+// ---------
+// 1.0	File Created
+// 1.1	Added the snapshot registers, the averaged data is no longer routed to GPIO
+// 1.2	Added the data ready interrupt
+//
+// Additional Comments:
+// --------------------
+//
+//////////////////////////////////////////////////////////////////////////////////
+`timescale 1 ns / 1 ps
+
+	module ADXL362_AXI_v1_0 #
+	(
+		// Users to add parameters here
+		parameter integer SYSCLK_FREQUENCY_HZ = 100000000,	// AXI clock frequency
+		parameter integer SCLK_FREQUENCY_HZ = 1000000,		// SPI clock frequency
+		parameter integer NUM_READS_AVG = 16,				// maximum number of reads averaged
+		parameter integer UPDATE_FREQUENCY_HZ = 1000,		// rate of the ADXL362 status polling
+		parameter integer ODR_SEL = 4,						// ADXL362 output data rate after reset (200Hz)
+		parameter integer FIFO_DEPTH = 64,					// depth of the raw sample FIFO
+		// User parameters ends
+		// Do not modify the parameters beyond this line
+
+		// Parameters of Axi Slave Bus Interface S00_AXI
+		parameter integer C_S00_AXI_DATA_WIDTH	= 32,
+		parameter integer C_S00_AXI_ADDR_WIDTH	= 6
+	)
+	(
+		// Users to add ports here
+		output wire	ACL_SCLK,					// ADXL362 SPI clock
+		output wire	ACL_MOSI,					// ADXL362 SPI data out
+		input wire	ACL_MISO,					// ADXL362 SPI data in
+		output wire	ACL_CSN,					// ADXL362 SPI slave select
+		output wire	accel_irq,					// data ready interrupt, active high level
+		// User ports ends
+		// Do not modify the ports beyond this line
+
+
+		// Ports of Axi Slave Bus Interface S00_AXI
+		input wire  s00_axi_aclk,
+		input wire  s00_axi_aresetn,
+		input wire [C_S00_AXI_ADDR_WIDTH-1 : 0] s00_axi_awaddr,
+		input wire [2 : 0] s00_axi_awprot,
+		input wire  s00_axi_awvalid,
+		output wire  s00_axi_awready,
+		input wire [C_S00_AXI_DATA_WIDTH-1 : 0] s00_axi_wdata,
+		input wire [(C_S00_AXI_DATA_WIDTH/8)-1 : 0] s00_axi_wstrb,
+		input wire  s00_axi_wvalid,
+		output wire  s00_axi_wready,
+		output wire [1 : 0] s00_axi_bresp,
+		output wire  s00_axi_bvalid,
+		input wire  s00_axi_bready,
+		input wire [C_S00_AXI_ADDR_WIDTH-1 : 0] s00_axi_araddr,
+		input wire [2 : 0] s00_axi_arprot,
+		input wire  s00_axi_arvalid,
+		output wire  s00_axi_arready,
+		output wire [C_S00_AXI_DATA_WIDTH-1 : 0] s00_axi_rdata,
+		output wire [1 : 0] s00_axi_rresp,
+		output wire  s00_axi_rvalid,
+		input wire  s00_axi_rready
+	);
+
+	// declare the interconnect wires
+	wire [2:0] CfgOdr;
+	wire [3:0] CfgAvgLog2;
+	wire CfgLoad;
+	wire FifoRd, FifoClr, FifoOverflow;
+	wire [67:0] FifoDout;
+	wire [15:0] FifoCount;
+	wire [31:0] Timestamp;
+	wire [11:0] AccelX, AccelY, AccelZ, AccelTmp;
+	wire DataReady;
+
+// Instantiation of Axi Bus Interface S00_AXI
+	ADXL362_AXI_v1_0_S00_AXI # (
+		.ODR_SEL(ODR_SEL),
+		.AVG_LOG2($clog2(NUM_READS_AVG)),
+		.C_S_AXI_DATA_WIDTH(C_S00_AXI_DATA_WIDTH),
+		.C_S_AXI_ADDR_WIDTH(C_S00_AXI_ADDR_WIDTH)
+	) ADXL362_AXI_v1_0_S00_AXI_inst (
+		// Peripheral-specific signals (to/from register bits
+		.CfgOdr(CfgOdr),
+		.CfgAvgLog2(CfgAvgLog2),
+		.CfgLoad(CfgLoad),
+		.FifoRd(FifoRd),
+		.FifoClr(FifoClr),
+		.FifoDout(FifoDout),
+		.FifoCount(FifoCount),
+		.FifoOverflow(FifoOverflow),
+		.Timestamp(Timestamp),
+		.AccelX(AccelX),
+		.AccelY(AccelY),
+		.AccelZ(AccelZ),
+		.AccelTmp(AccelTmp),
+		.DataReady(DataReady),
+		.DrdyIrq(accel_irq),
+
+		// AXI Lite Signals
+		.S_AXI_ACLK(s00_axi_aclk),
+		.S_AXI_ARESETN(s00_axi_aresetn),
+		.S_AXI_AWADDR(s00_axi_awaddr),
+		.S_AXI_AWPROT(s00_axi_awprot),
+		.S_AXI_AWVALID(s00_axi_awvalid),
+		.S_AXI_AWREADY(s00_axi_awready),
+		.S_AXI_WDATA(s00_axi_wdata),
+		.S_AXI_WSTRB(s00_axi_wstrb),
+		.S_AXI_WVALID(s00_axi_wvalid),
+		.S_AXI_WREADY(s00_axi_wready),
+		.S_AXI_BRESP(s00_axi_bresp),
+		.S_AXI_BVALID(s00_axi_bvalid),
+		.S_AXI_BREADY(s00_axi_bready),
+		.S_AXI_ARADDR(s00_axi_araddr),
+		.S_AXI_ARPROT(s00_axi_arprot),
+		.S_AXI_ARVALID(s00_axi_arvalid),
+		.S_AXI_ARREADY(s00_axi_arready),
+		.S_AXI_RDATA(s00_axi_rdata),
+		.S_AXI_RRESP(s00_axi_rresp),
+		.S_AXI_RVALID(s00_axi_rvalid),
+		.S_AXI_RREADY(s00_axi_rready)
+	);
+
+
+	// Add user logic here
+
+	// instantiate the ADXL362 controller.  ADXL362Ctrl has an active high reset
+	ADXL362Ctrl #(
+		.SYSCLK_FREQUENCY_HZ(SYSCLK_FREQUENCY_HZ),
+		.SCLK_FREQUENCY_HZ(SCLK_FREQUENCY_HZ),
+		.NUM_READS_AVG(NUM_READS_AVG),
+		.UPDATE_FREQUENCY_HZ(UPDATE_FREQUENCY_HZ),
+		.ODR_SEL(ODR_SEL),
+		.FIFO_DEPTH(FIFO_DEPTH),
+		.TIMESTAMP_FREQUENCY_HZ(1000000)
+	) ADXL362_CTRL
+	(
+		.SYSCLK(s00_axi_aclk),
+		.RESET(~s00_axi_aresetn),
+		.ACCEL_X(AccelX),
+		.ACCEL_Y(AccelY),
+		.ACCEL_Z(AccelZ),
+		.ACCEL_TMP(AccelTmp),
+		.Data_Ready(DataReady),
+		.CFG_ODR(CfgOdr),
+		.CFG_AVG_LOG2(CfgAvgLog2),
+		.CFG_LOAD(CfgLoad),
+		.TIMESTAMP(Timestamp),
+		.FIFO_RD(FifoRd),
+		.FIFO_CLR(FifoClr),
+		.FIFO_DOUT(FifoDout),
+		.FIFO_COUNT(FifoCount),
+		.FIFO_OVERFLOW(FifoOverflow),
+		.SCLK(ACL_SCLK),
+		.MOSI(ACL_MOSI),
+		.MISO(ACL_MISO),
+		.SS(ACL_CSN)
+	);
+
+	// User logic ends
+
+	endmodule
@@ -0,0 +1,525 @@
+//////////////////////////////////////////////////////////////////////////////////
+// Company: Portland State University
+//
+// Description: 
+// ------------
+// This module provides the AXI Slave interface to the ADXL362_AXI peripheral.  It is a 32-bit Slave
+// interface with 16 registers:
+//	slv_reg0 - Control Register (read/write), reset to the ODR_SEL and AVG_LOG2 parameters, the
+//		configuration the ADXL362 controller starts with
+//		[2:0]	ODR select, 0 = 12.5Hz ... 5 = 400Hz
+//		[7:4]	log2 of the number of reads averaged
+//		[8]		Apply - load ODR select and averaging (level, the driver writes 1 then 0)
+//		[9]		FIFO clear (level, the driver writes 1 then 0)
+//		[10]	Data ready interrupt enable
+//	slv_reg1 - Status Register (read-only)
+//		[15:0]	number of samples in the raw sample FIFO
+//		[16]	FIFO overflow, a sample was dropped
+//	slv_reg2 - FIFO X/Y (read-only), oldest sample {4'b0, Y, 4'b0, X}
+//	slv_reg3 - FIFO Z (read-only), oldest sample {20'b0, Z}
+//	slv_reg4 - FIFO Timestamp (read-only), oldest sample.  Reading this register removes the
+//		sample from the FIFO so it has to be read last
+//	slv_reg5 - Timestamp (read-only), current value of the 1MHz timestamp counter
+//	slv_reg6 .. slv_reg7 - *RESERVED* (read-only, read as 0)
+//	slv_reg8 - Snapshot Sequence (read-only), number of averaged samples produced since reset.
+//		Reading this register latches the latest averaged sample into slv_reg9 and slv_reg10,
+//		so the three registers always belong to the same sample
+//	slv_reg9 - Snapshot X/Y (read-only), {4'b0, Y, 4'b0, X} of the latched sample
+//	slv_reg10 - Snapshot Z/Temperature (read-only), {4'b0, TMP, 4'b0, Z} of the latched sample
+//	slv_reg11 - Snapshot Timestamp (read-only), timestamp of the latched sample, taken when the
+//		ADXL362 controller signalled Data_Ready
+//	slv_reg12 .. slv_reg15 - *RESERVED* (read-only, read as 0)
+//
+//	The data ready interrupt is set when a new averaged sample is available and cleared by
+//	reading slv_reg8 (latching the sample).  DrdyIrq is a level, masked by the enable bit
+//
+// Dependencies: 
+// -------------
+// 	While not a "dependency" per se, the code in this module creates the inputs for
+//	the ADXL362 controller (ADXL362Ctrl.vhd)
+// 
+// Revision:
+// ---------
+// 1.0	File Created
+// 1.1	Added the snapshot registers
+// 1.2	Added the snapshot timestamp and the data ready interrupt
+//
+// Additional Comments:
+// --------------------
+// 
+//////////////////////////////////////////////////////////////////////////////////
+`timescale 1 ns / 1 ps
+
+	module ADXL362_AXI_v1_0_S00_AXI #
+	(
+		// Users to add parameters here
+		parameter integer ODR_SEL = 4,		// ADXL362 output data rate after reset
+		parameter integer AVG_LOG2 = 4,		// log2 of the number of reads averaged after reset
+		// User parameters ends
+		// Do not modify the parameters beyond this line
+
+		// Width of S_AXI data bus
+		parameter integer C_S_AXI_DATA_WIDTH	= 32,
+		// Width of S_AXI address bus
+		parameter integer C_S_AXI_ADDR_WIDTH	= 6
+	)
+	(
+		// Users to add ports here
+		
+		// requested ADXL362 output data rate
+		output wire [2:0] CfgOdr,
+		// requested log2 of the number of reads averaged
+		output wire [3:0] CfgAvgLog2,
+		// load the requested configuration
+		output wire	CfgLoad,
+		// remove the oldest sample from the FIFO
+		output wire	FifoRd,
+		// empty the FIFO and clear the overflow flag
+		output wire	FifoClr,
+		// oldest sample in the FIFO {timestamp, Z, Y, X}
+		input wire [67:0] FifoDout,
+		// number of samples in the FIFO
+		input wire [15:0] FifoCount,
+		// FIFO overflow flag
+		input wire	FifoOverflow,
+		// current timestamp
+		input wire [31:0] Timestamp,
+		// averaged acceleration and temperature
+		input wire [11:0] AccelX,
+		input wire [11:0] AccelY,
+		input wire [11:0] AccelZ,
+		input wire [11:0] AccelTmp,
+		// averaged data updated, active for one clock period
+		input wire	DataReady,
+		// data ready interrupt request
+		output wire	DrdyIrq,
+		// User ports ends
+		// Do not modify the ports beyond this line
+
+		// Global Clock Signal
+		input wire  S_AXI_ACLK,
+		// Global Reset Signal. This Signal is Active LOW
+		input wire  S_AXI_ARESETN,
+		// Write address (issued by master, acceped by Slave)
+		input wire [C_S_AXI_ADDR_WIDTH-1 : 0] S_AXI_AWADDR,
+		// Write channel Protection type. This signal indicates the
+    		// privilege and security level of the transaction, and whether
+    		// the transaction is a data access or an instruction access.
+		input wire [2 : 0] S_AXI_AWPROT,
+		// Write address valid. This signal indicates that the master signaling
+    		// valid write address and control information.
+		input wire  S_AXI_AWVALID,
+		// Write address ready. This signal indicates that the slave is ready
+    		// to accept an address and associated control signals.
+		output wire  S_AXI_AWREADY,
+		// Write data (issued by master, acceped by Slave) 
+		input wire [C_S_AXI_DATA_WIDTH-1 : 0] S_AXI_WDATA,
+		// Write strobes. This signal indicates which byte lanes hold
+    		// valid data. There is one write strobe bit for each eight
+    		// bits of the write data bus.    
+		input wire [(C_S_AXI_DATA_WIDTH/8)-1 : 0] S_AXI_WSTRB,
+		// Write valid. This signal indicates that valid write
+    		// data and strobes are available.
+		input wire  S_AXI_WVALID,
+		// Write ready. This signal indicates that the slave
+    		// can accept the write data.
+		output wire  S_AXI_WREADY,
+		// Write response. This signal indicates the status
+    		// of the write transaction.
+		output wire [1 : 0] S_AXI_BRESP,
+		// Write response valid. This signal indicates that the channel
+    		// is signaling a valid write response.
+		output wire  S_AXI_BVALID,
+		// Response ready. This signal indicates that the master
+    		// can accept a write response.
+		input wire  S_AXI_BREADY,
+		// Read address (issued by master, acceped by Slave)
+		input wire [C_S_AXI_ADDR_WIDTH-1 : 0] S_AXI_ARADDR,
+		// Protection type. This signal indicates the privilege
+    		// and security level of the transaction, and whether the
+    		// transaction is a data access or an instruction access.
+		input wire [2 : 0] S_AXI_ARPROT,
+		// Read address valid. This signal indicates that the channel
+    		// is signaling valid read address and control information.
+		input wire  S_AXI_ARVALID,
+		// Read address ready. This signal indicates that the slave is
+    		// ready to accept an address and associated control signals.
+		output wire  S_AXI_ARREADY,
+		// Read data (issued by slave)
+		output wire [C_S_AXI_DATA_WIDTH-1 : 0] S_AXI_RDATA,
+		// Read response. This signal indicates the status of the
+    		// read transfer.
+		output wire [1 : 0] S_AXI_RRESP,
+		// Read valid. This signal indicates that the channel is
+    		// signaling the required read data.
+		output wire  S_AXI_RVALID,
+		// Read ready. This signal indicates that the master can
+    		// accept the read data and response information.
+		input wire  S_AXI_RREADY
+	);
+
+	// AXI4LITE signals
+	reg [C_S_AXI_ADDR_WIDTH-1 : 0] 	axi_awaddr;
+	reg  	axi_awready;
+	reg  	axi_wready;
+	reg [1 : 0] 	axi_bresp;
+	reg  	axi_bvalid;
+	reg [C_S_AXI_ADDR_WIDTH-1 : 0] 	axi_araddr;
+	reg  	axi_arready;
+	reg [C_S_AXI_DATA_WIDTH-1 : 0] 	axi_rdata;
+	reg [1 : 0] 	axi_rresp;
+	reg  	axi_rvalid;
+
+	// Example-specific design signals
+	// local parameter for addressing 32 bit / 64 bit C_S_AXI_DATA_WIDTH
+	// ADDR_LSB is used for addressing 32/64 bit registers/memories
+	// ADDR_LSB = 2 for 32 bits (n downto 2)
+	// ADDR_LSB = 3 for 64 bits (n downto 3)
+	localparam integer ADDR_LSB = (C_S_AXI_DATA_WIDTH/32) + 1;
+	localparam integer OPT_MEM_ADDR_BITS = 3;
+	//----------------------------------------------
+	//-- Signals for user logic register space example
+	//------------------------------------------------
+	//-- Number of Slave Registers 16 (slv_reg6, slv_reg7, slv_reg12 .. slv_reg15 are reserved and not implemented)
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg0;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg1;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg2;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg3;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg4;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg5;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg8;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg9;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg10;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg11;
+	wire	 slv_reg_rden;
+	wire	 slv_reg_wren;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	 reg_data_out;
+	integer	 byte_index;
+
+	// I/O Connections assignments
+
+	assign S_AXI_AWREADY	= axi_awready;
+	assign S_AXI_WREADY	= axi_wready;
+	assign S_AXI_BRESP	= axi_bresp;
+	assign S_AXI_BVALID	= axi_bvalid;
+	assign S_AXI_ARREADY	= axi_arready;
+	assign S_AXI_RDATA	= axi_rdata;
+	assign S_AXI_RRESP	= axi_rresp;
+	assign S_AXI_RVALID	= axi_rvalid;
+	// Implement axi_awready generation
+	// axi_awready is asserted for one S_AXI_ACLK clock cycle when both
+	// S_AXI_AWVALID and S_AXI_WVALID are asserted. axi_awready is
+	// de-asserted when reset is low.
+
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_awready <= 1'b0;
+	    end 
+	  else
+	    begin    
+	      if (~axi_awready && S_AXI_AWVALID && S_AXI_WVALID)
+	        begin
+	          // slave is ready to accept write address when 
+	          // there is a valid write address and write data
+	          // on the write address and data bus. This design 
+	          // expects no outstanding transactions. 
+	          axi_awready <= 1'b1;
+	        end
+	      else           
+	        begin
+	          axi_awready <= 1'b0;
+	        end
+	    end 
+	end       
+
+	// Implement axi_awaddr latching
+	// This process is used to latch the address when both 
+	// S_AXI_AWVALID and S_AXI_WVALID are valid. 
+
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_awaddr <= 0;
+	    end 
+	  else
+	    begin    
+	      if (~axi_awready && S_AXI_AWVALID && S_AXI_WVALID)
+	        begin
+	          // Write Address latching 
+	          axi_awaddr <= S_AXI_AWADDR;
+	        end
+	    end 
+	end       
+
+	// Implement axi_wready generation
+	// axi_wready is asserted for one S_AXI_ACLK clock cycle when both
+	// S_AXI_AWVALID and S_AXI_WVALID are asserted. axi_wready is 
+	// de-asserted when reset is low. 
+
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_wready <= 1'b0;
+	    end 
+	  else
+	    begin    
+	      if (~axi_wready && S_AXI_WVALID && S_AXI_AWVALID)
+	        begin
+	          // slave is ready to accept write data when 
+	          // there is a valid write address and write data
+	          // on the write address and data bus. This design 
+	          // expects no outstanding transactions. 
+	          axi_wready <= 1'b1;
+	        end
+	      else
+	        begin
+	          axi_wready <= 1'b0;
+	        end
+	    end 
+	end       
+
+	// Implement memory mapped register select and write logic generation
+	// The write data is accepted and written to memory mapped registers when
+	// axi_awready, S_AXI_WVALID, axi_wready and S_AXI_WVALID are asserted. Write strobes are used to
+	// select byte enables of slave registers while writing.
+	// These registers are cleared when reset (active low) is applied.
+	// Slave register write enable is asserted when valid address and data are available
+	// and the slave is ready to accept the write address and write data.
+	assign slv_reg_wren = axi_wready && S_AXI_WVALID && axi_awready && S_AXI_AWVALID;
+
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      slv_reg0 <= ((AVG_LOG2 & 4'hF) << 4) | (ODR_SEL & 3'h7);
+	      // slave registers 1 - 11 are read-only
+	    end 
+	  else begin
+	    if (slv_reg_wren)
+	      begin
+	        case ( axi_awaddr[ADDR_LSB+OPT_MEM_ADDR_BITS:ADDR_LSB] )
+	          4'h0:	// slave reg 0 is the Control Register (read/write)
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 0
+	                slv_reg0[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+	              end  
+	          default : begin
+	          		// slave registers 1 - 15 are read-only or reserved
+	                    end
+	        endcase
+	      end
+	  end
+	end    
+
+	// Implement write response logic generation
+	// The write response and response valid signals are asserted by the slave 
+	// when axi_wready, S_AXI_WVALID, axi_wready and S_AXI_WVALID are asserted.  
+	// This marks the acceptance of address and indicates the status of 
+	// write transaction.
+
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_bvalid  <= 0;
+	      axi_bresp   <= 2'b0;
+	    end 
+	  else
+	    begin    
+	      if (axi_awready && S_AXI_AWVALID && ~axi_bvalid && axi_wready && S_AXI_WVALID)
+	        begin
+	          // indicates a valid write response is available
+	          axi_bvalid <= 1'b1;
+	          axi_bresp  <= 2'b0; // 'OKAY' response 
+	        end                   // work error responses in future
+	      else
+	        begin
+	          if (S_AXI_BREADY && axi_bvalid) 
+	            //check if bready is asserted while bvalid is high) 
+	            //(there is a possibility that bready is always asserted high)   
+	            begin
+	              axi_bvalid <= 1'b0; 
+	            end  
+	        end
+	    end
+	end   
+
+	// Implement axi_arready generation
+	// axi_arready is asserted for one S_AXI_ACLK clock cycle when
+	// S_AXI_ARVALID is asserted. axi_awready is 
+	// de-asserted when reset (active low) is asserted. 
+	// The read address is also latched when S_AXI_ARVALID is 
+	// asserted. axi_araddr is reset to zero on reset assertion.
+
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_arready <= 1'b0;
+	      axi_araddr  <= 32'b0;
+	    end 
+	  else
+	    begin    
+	      if (~axi_arready && S_AXI_ARVALID)
+	        begin
+	          // indicates that the slave has acceped the valid read address
+	          axi_arready <= 1'b1;
+	          // Read address latching
+	          axi_araddr  <= S_AXI_ARADDR;
+	        end
+	      else
+	        begin
+	          axi_arready <= 1'b0;
+	        end
+	    end 
+	end       
+
+	// Implement axi_arvalid generation
+	// axi_rvalid is asserted for one S_AXI_ACLK clock cycle when both 
+	// S_AXI_ARVALID and axi_arready are asserted. The slave registers 
+	// data are available on the axi_rdata bus at this instance. The 
+	// assertion of axi_rvalid marks the validity of read data on the 
+	// bus and axi_rresp indicates the status of read transaction.axi_rvalid 
+	// is deasserted on reset (active low). axi_rresp and axi_rdata are 
+	// cleared to zero on reset (active low).  
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_rvalid <= 0;
+	      axi_rresp  <= 0;
+	    end 
+	  else
+	    begin    
+	      if (axi_arready && S_AXI_ARVALID && ~axi_rvalid)
+	        begin
+	          // Valid read data is available at the read data bus
+	          axi_rvalid <= 1'b1;
+	          axi_rresp  <= 2'b0; // 'OKAY' response
+	        end   
+	      else if (axi_rvalid && S_AXI_RREADY)
+	        begin
+	          // Read data is accepted by the master
+	          axi_rvalid <= 1'b0;
+	        end                
+	    end
+	end    
+
+	// Implement memory mapped register select and read logic generation
+	// Slave register read enable is asserted when valid address is available
+	// and the slave is ready to accept the read address.
+	assign slv_reg_rden = axi_arready & S_AXI_ARVALID & ~axi_rvalid;
+	always @(*)
+	begin
+	      // Address decoding for reading registers
+	      case ( axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS:ADDR_LSB] )
+	        4'h0   : reg_data_out <= slv_reg0;
+	        4'h1   : reg_data_out <= slv_reg1;
+	        4'h2   : reg_data_out <= slv_reg2;
+	        4'h3   : reg_data_out <= slv_reg3;
+	        4'h4   : reg_data_out <= slv_reg4;
+	        4'h5   : reg_data_out <= slv_reg5;
+	        4'h8   : reg_data_out <= slv_reg8;
+	        4'h9   : reg_data_out <= slv_reg9;
+	        4'hA   : reg_data_out <= slv_reg10;
+	        4'hB   : reg_data_out <= slv_reg11;
+	        default : reg_data_out <= 0;
+	      endcase
+	end
+
+	// Output register or memory read data
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      axi_rdata  <= 0;
+	    end 
+	  else
+	    begin    
+	      // When there is a valid read address (S_AXI_ARVALID) with 
+	      // acceptance of read address by the slave (axi_arready), 
+	      // output the read dada 
+	      if (slv_reg_rden)
+	        begin
+	          axi_rdata <= reg_data_out;     // register read data
+	        end   
+	    end
+	end    
+
+	// Add user logic here
+	
+	// create the Status, FIFO and Timestamp registers (slave regs 1 - 5)
+	always @* begin
+		slv_reg1 = {15'b000000000000000, FifoOverflow, FifoCount};
+		slv_reg2 = {4'b0000, FifoDout[23:12], 4'b0000, FifoDout[11:0]};
+		slv_reg3 = {20'b00000000000000000000, FifoDout[35:24]};
+		slv_reg4 = FifoDout[67:36];
+		slv_reg5 = Timestamp;
+	end
+	
+	// the FIFO is popped in the same clock period the FIFO Timestamp register is
+	// latched into axi_rdata, so the sample that is read is the one removed
+	assign FifoRd = slv_reg_rden && (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS:ADDR_LSB] == 4'h4);
+	
+	// create the snapshot registers (slave regs 8 - 11).  The live sample is updated
+	// by DataReady; reading the sequence register returns the live sequence number
+	// and copies the live sample into slv_reg9 - slv_reg11 in the same clock period
+	reg [31:0] SnapSeq;
+	reg [47:0] SnapLive;
+	reg [31:0] SnapTsLive;
+	reg DrdyPending;
+	wire SnapLatch = slv_reg_rden && (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS:ADDR_LSB] == 4'h8);
+	
+	always @( posedge S_AXI_ACLK )
+	begin
+	  if ( S_AXI_ARESETN == 1'b0 )
+	    begin
+	      SnapSeq <= 0;
+	      SnapLive <= 0;
+	      SnapTsLive <= 0;
+	      DrdyPending <= 1'b0;
+	      slv_reg9 <= 0;
+	      slv_reg10 <= 0;
+	      slv_reg11 <= 0;
+	    end
+	  else
+	    begin
+	      if (DataReady)
+	        begin
+	          SnapSeq <= SnapSeq + 1;
+	          SnapLive <= {AccelTmp, AccelZ, AccelY, AccelX};
+	          SnapTsLive <= Timestamp;
+	        end
+	      if (SnapLatch)
+	        begin
+	          slv_reg9 <= {4'b0000, SnapLive[23:12], 4'b0000, SnapLive[11:0]};
+	          slv_reg10 <= {4'b0000, SnapLive[47:36], 4'b0000, SnapLive[35:24]};
+	          slv_reg11 <= SnapTsLive;
+	        end
+	      // a new sample wins over the acknowledge, it has not been latched yet
+	      if (DataReady)
+	          DrdyPending <= 1'b1;
+	      else if (SnapLatch)
+	          DrdyPending <= 1'b0;
+	    end
+	end
+	
+	always @* begin
+		slv_reg8 = SnapSeq;
+	end
+	
+	// create the control signals from the Control Register (slv_reg0)
+	assign CfgOdr = slv_reg0[2:0];
+	assign CfgAvgLog2 = slv_reg0[7:4];
+	assign CfgLoad = slv_reg0[8];
+	assign FifoClr = slv_reg0[9];
+	assign DrdyIrq = DrdyPending & slv_reg0[10];
+	// User logic ends
+
+	endmodule
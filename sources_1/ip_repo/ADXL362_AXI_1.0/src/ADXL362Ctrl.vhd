@@ -67,8 +67,20 @@
 --               After that the state machine proceeds to Step 3, in an infinite loop. The state machine restarts from Step 1 only
 --          when the FPGA is reconfigured or the Reset signal is activated.
 --
+--       Runtime configuration: the output data rate (ODR field of the Filter Control Register) and the number of
+--    reads averaged can be changed while running through CFG_ODR, CFG_AVG_LOG2 and CFG_LOAD. CFG_LOAD latches the
+--    requested values; at the next Sample_Rate_Tick the state machine returns to Step 1, so the ADXL362 is reset and
+--    reconfigured with the new ODR and the accumulators restart with the new averaging depth (2**CFG_AVG_LOG2 reads,
+--    at most NUM_READS_AVG). ODR_SEL and NUM_READS_AVG set the values used after reset.
+--
+--       Raw sample FIFO: when FIFO_DEPTH > 0, every set of data read from the ADXL362 (i.e. before averaging) is
+--    pushed into a FIFO together with a TIMESTAMP_FREQUENCY_HZ timestamp, so the consumer can retrieve every sample
+--    instead of one decimated value. FIFO_DOUT always shows the oldest entry, FIFO_RD removes it. When the FIFO is
+--    full the newest sample is dropped and FIFO_OVERFLOW is set until FIFO_CLR is activated.
+--
 -- Revision: 
 -- Revision 0.01 - File Created
+-- Revision 0.02 - Runtime ODR/averaging select, raw sample FIFO with timestamps
 -- Additional Comments: 
 --
 ----------------------------------------------------------------------------------
@@ -91,8 +103,12 @@ generic
 (
    SYSCLK_FREQUENCY_HZ : integer := 100000000;
    SCLK_FREQUENCY_HZ   : integer := 1000000;
-   NUM_READS_AVG       : integer := 16;
-   UPDATE_FREQUENCY_HZ : integer := 1000
+   NUM_READS_AVG       : integer := 16;      -- maximum number of reads averaged, power of two, 1 means no averaging
+   UPDATE_FREQUENCY_HZ : integer := 1000;
+   ODR_SEL             : integer := 4;       -- Filter Control Register ODR field after reset:
+                                             -- 0 = 12.5Hz, 1 = 25Hz, 2 = 50Hz, 3 = 100Hz, 4 = 200Hz, 5 = 400Hz
+   FIFO_DEPTH          : integer := 0;       -- depth of the raw sample FIFO, 0 = no FIFO
+   TIMESTAMP_FREQUENCY_HZ : integer := 1000000
 );
 port
 (
@@ -106,6 +122,19 @@ port
    ACCEL_TMP  : out STD_LOGIC_VECTOR (11 downto 0);
    Data_Ready : out STD_LOGIC;
 
+   -- Runtime configuration signals
+   CFG_ODR       : in STD_LOGIC_VECTOR (2 downto 0);  -- requested ODR field, values above 5 select 400Hz
+   CFG_AVG_LOG2  : in STD_LOGIC_VECTOR (3 downto 0);  -- requested number of reads averaged, as a power of two
+   CFG_LOAD      : in STD_LOGIC;                      -- latch CFG_ODR and CFG_AVG_LOG2 and reconfigure the ADXL362
+
+   -- Raw sample FIFO signals
+   TIMESTAMP     : out STD_LOGIC_VECTOR (31 downto 0); -- free running counter, TIMESTAMP_FREQUENCY_HZ
+   FIFO_RD       : in STD_LOGIC;                      -- remove the oldest entry from the FIFO
+   FIFO_CLR      : in STD_LOGIC;                      -- empty the FIFO and clear FIFO_OVERFLOW
+   FIFO_DOUT     : out STD_LOGIC_VECTOR (67 downto 0); -- oldest entry: timestamp(67:36), Z(35:24), Y(23:12), X(11:0)
+   FIFO_COUNT    : out STD_LOGIC_VECTOR (15 downto 0); -- number of entries in the FIFO
+   FIFO_OVERFLOW : out STD_LOGIC;                     -- a sample was dropped because the FIFO was full
+
    --SPI Interface Signals
    SCLK       : out STD_LOGIC;
    MOSI       : out STD_LOGIC;
@@ -147,6 +176,8 @@ end component;
 
 -- To create the update frequency counter
 constant UPDATE_DIV_RATE : integer := (SYSCLK_FREQUENCY_HZ / UPDATE_FREQUENCY_HZ);
+-- To create the timestamp counter
+constant TIMESTAMP_DIV_RATE : integer := (SYSCLK_FREQUENCY_HZ / TIMESTAMP_FREQUENCY_HZ);
 constant SYS_CLK_PERIOD_PS : integer := ((1000000000 / SYSCLK_FREQUENCY_HZ) * 1000);
 
 --ADXL 362 Read and Write Command
@@ -157,6 +188,12 @@ constant WRITE_CMD : STD_LOGIC_VECTOR (7 downto 0) := X"0A";
 constant READ_STARTING_ADDR : STD_LOGIC_VECTOR (7 downto 0):= X"0E";
 -- Status Register Read will be used to check when new data is available (Bit 0 is 1)
 constant STATUS_REG_ADDR : STD_LOGIC_VECTOR (7 downto 0):= X"0B";
+-- Filter Control Register, its ODR field (bits 2:0) is set from Cfg_Odr_Reg
+constant FILTER_CTL_ADDR : STD_LOGIC_VECTOR (7 downto 0):= X"2C";
+-- Filter Control Register without the ODR field: 2g range, 1/4 Bandwidth
+constant FILTER_CTL_BASE : STD_LOGIC_VECTOR (7 downto 0):= X"10";
+-- Highest valid ODR field value, 400Hz
+constant ODR_SEL_MAX : integer := 5;
 
 -- Number of bytes to write when configuring registers
 constant NUMBYTES_CMD_CONFIG_REG : integer := 3;
@@ -195,10 +232,12 @@ signal HOLD_SS    :  STD_LOGIC; -- Signal that forces SS low in the case of mult
 -- the register data to be written to initialize ADXL362
 type rom_type is array (0 to ((2* NUM_COMMAND_VEC)-1)) of STD_LOGIC_VECTOR (7 downto 0);
 
+-- The Filter Control Register is written before enabling measurement, as recommended by the datasheet.
+-- Its data byte is replaced by Filter_Ctl_Byte when loading Cmd_Reg, see Load_Shift_Cmd_Reg
 constant Cmd_Reg_Data : rom_type := ( X"1F", X"52", -- Soft Reset Register Address and Reset Command
                                       X"1F", X"00", -- Soft Reset Register Address, clear Command
-                                      X"2D", X"02", -- Power Control Register, Enable Measure Command
-                                      X"2C", X"14"  -- Filter Control Register, 2g range, 1/4 Bandwidth, 200HZ Output Data Rate                                      
+                                      FILTER_CTL_ADDR, FILTER_CTL_BASE, -- Filter Control Register, 2g range, 1/4 Bandwidth, ODR from Cfg_Odr_Reg
+                                      X"2D", X"02"  -- Power Control Register, Enable Measure Command
                                      );
 
 --address the reg_data ROM
@@ -327,6 +366,25 @@ signal Reset_Cnt_Num_Reads : STD_LOGIC := '0';
 --Signaling that a number of 16 reads were done
 signal Cnt_Num_Reads_Done : STD_LOGIC := '0';
 
+-- Runtime configuration. Cfg_Odr_Reg and Cfg_Avg_Log2_Req are latched by CFG_LOAD, Cfg_Pending
+-- makes the ADXL 362 Control State Machine restart from the reset command. The averaging depth in use,
+-- Cfg_Avg_Log2 and Num_Reads_Last, is updated only when the state machine restarts, so that a set of
+-- reads is always divided by the number of reads it was summed from.
+signal Cfg_Odr_Reg      : STD_LOGIC_VECTOR (2 downto 0) := std_logic_vector(to_unsigned(ODR_SEL, 3));
+signal Cfg_Avg_Log2_Req : integer range 0 to NUM_READS_BITS := NUM_READS_BITS;
+signal Cfg_Avg_Log2     : integer range 0 to NUM_READS_BITS := NUM_READS_BITS;
+signal Num_Reads_Last   : integer range 0 to (NUM_READS - 1) := (NUM_READS - 1);
+signal Cfg_Pending      : STD_LOGIC := '0';
+-- Filter Control Register data byte
+signal Filter_Ctl_Byte  : STD_LOGIC_VECTOR (7 downto 0);
+
+-- Timestamp counter, incremented at TIMESTAMP_FREQUENCY_HZ
+signal Timestamp_Div : integer range 0 to (TIMESTAMP_DIV_RATE - 1) := 0;
+signal Timestamp_Cnt : unsigned (31 downto 0) := (others => '0');
+
+-- Raw (not averaged) data set, stored in the FIFO: timestamp, Z, Y, X
+signal Raw_Sample : STD_LOGIC_VECTOR (67 downto 0);
+
 -- Summing of incoming data will be stored in these signals
 -- These will be used as accumulators, on two's complement
 signal ACCEL_X_SUM   : STD_LOGIC_VECTOR ((11 + (NUM_READS_BITS)) downto 0) := (others => '0');
@@ -366,6 +424,12 @@ signal StC_Adxl_Ctrl, StN_Adxl_Ctrl : STD_LOGIC_VECTOR (11 downto 0) := stAdxlCt
 --Force User Encoding for the State Machine
 attribute FSM_ENCODING of StC_Adxl_Ctrl: signal is "USER";
 
+-- Divide an accumulator by 2**Shift, the result being the 12-bit average
+function Avg_Of (Sum : STD_LOGIC_VECTOR; Shift : natural) return STD_LOGIC_VECTOR is
+begin
+   return std_logic_vector(resize(shift_right(signed(Sum), Shift), 12));
+end function Avg_Of;
+
 
 begin
 
@@ -440,7 +504,7 @@ Data_Ready_1            <= StC_Adxl_Ctrl(4);  -- To signal external components t
 
 
 -- Load and shift Cmd_Reg according to the active commands
-Load_Shift_Cmd_Reg: process (SYSCLK, Cmd_Reg, Cmd_Reg_Data_Addr, StC_Adxl_Ctrl, Load_Cmd_Reg, Shift_Cmd_Reg)
+Load_Shift_Cmd_Reg: process (SYSCLK, Cmd_Reg, Cmd_Reg_Data_Addr, StC_Adxl_Ctrl, Load_Cmd_Reg, Shift_Cmd_Reg, Filter_Ctl_Byte)
 begin
    if SYSCLK'EVENT AND SYSCLK = '1' then
       if Load_Cmd_Reg = '1' then -- Load with data
@@ -449,7 +513,11 @@ begin
 
                   Cmd_Reg(2) <= WRITE_CMD;
                   Cmd_Reg(1) <= Cmd_Reg_Data (2 * Cmd_Reg_Data_Addr);
-                  Cmd_Reg(0) <= Cmd_Reg_Data ((2 * Cmd_Reg_Data_Addr) + 1);
+                  if Cmd_Reg_Data (2 * Cmd_Reg_Data_Addr) = FILTER_CTL_ADDR then -- the ODR is set at runtime
+                     Cmd_Reg(0) <= Filter_Ctl_Byte;
+                  else
+                     Cmd_Reg(0) <= Cmd_Reg_Data ((2 * Cmd_Reg_Data_Addr) + 1);
+                  end if;
 
          elsif    (StC_Adxl_Ctrl = stAdxlRead_Status) then
 
@@ -594,14 +662,14 @@ Sample_Rate_Tick  <= '1' when Sample_Rate_Div = (UPDATE_DIV_RATE - 1) else '0';
 
 
 -- Create the Cnt_Num_Reads counter, self-blocking
-Count_Num_Reads: process (SYSCLK, Reset_Cnt_Num_Reads, CE_Cnt_Num_Reads, Cnt_Num_Reads)
+Count_Num_Reads: process (SYSCLK, Reset_Cnt_Num_Reads, CE_Cnt_Num_Reads, Cnt_Num_Reads, Num_Reads_Last)
 begin
    if SYSCLK'EVENT AND SYSCLK = '1' then
       if Reset_Cnt_Num_Reads = '1' then
          Cnt_Num_Reads <= 0;
       elsif CE_Cnt_Num_Reads = '1' then
-            if Cnt_Num_Reads = (NUM_READS - 1) then   
-               Cnt_Num_Reads <= (NUM_READS - 1);
+            if Cnt_Num_Reads = Num_Reads_Last then   
+               Cnt_Num_Reads <= Num_Reads_Last;
             else
                Cnt_Num_Reads <= Cnt_Num_Reads + 1;
             end if;
@@ -609,7 +677,63 @@ begin
    end if;
 end process Count_Num_Reads;
 
-Cnt_Num_Reads_Done <= '1' when Cnt_Num_Reads = (NUM_READS - 1) else '0';
+Cnt_Num_Reads_Done <= '1' when Cnt_Num_Reads = Num_Reads_Last else '0';
+
+-- Latch the runtime configuration. The requested ODR is used when the configuration registers are
+-- written, the requested averaging depth when the reset command is sent, both clearing Cfg_Pending
+Latch_Config: process (SYSCLK, RESET, CFG_LOAD, CFG_ODR, CFG_AVG_LOG2, StC_Adxl_Ctrl, Cfg_Avg_Log2_Req)
+begin
+   if SYSCLK'EVENT AND SYSCLK = '1' then
+      if RESET = '1' then
+         Cfg_Odr_Reg <= std_logic_vector(to_unsigned(ODR_SEL, 3));
+         Cfg_Avg_Log2_Req <= NUM_READS_BITS;
+         Cfg_Avg_Log2 <= NUM_READS_BITS;
+         Num_Reads_Last <= NUM_READS - 1;
+         Cfg_Pending <= '0';
+      else
+         if CFG_LOAD = '1' then
+            if to_integer(unsigned(CFG_ODR)) > ODR_SEL_MAX then
+               Cfg_Odr_Reg <= std_logic_vector(to_unsigned(ODR_SEL_MAX, 3));
+            else
+               Cfg_Odr_Reg <= CFG_ODR;
+            end if;
+            if to_integer(unsigned(CFG_AVG_LOG2)) > NUM_READS_BITS then
+               Cfg_Avg_Log2_Req <= NUM_READS_BITS;
+            else
+               Cfg_Avg_Log2_Req <= to_integer(unsigned(CFG_AVG_LOG2));
+            end if;
+            Cfg_Pending <= '1';
+         elsif StC_Adxl_Ctrl = stAdxlSendResetCmd then
+            Cfg_Pending <= '0';
+         end if;
+
+         if StC_Adxl_Ctrl = stAdxlSendResetCmd then
+            Cfg_Avg_Log2 <= Cfg_Avg_Log2_Req;
+            Num_Reads_Last <= to_integer(shift_left(to_unsigned(1, NUM_READS_BITS + 1), Cfg_Avg_Log2_Req)) - 1;
+         end if;
+      end if;
+   end if;
+end process Latch_Config;
+
+Filter_Ctl_Byte <= FILTER_CTL_BASE(7 downto 3) & Cfg_Odr_Reg;
+
+-- Create the timestamp counter
+Count_Timestamp: process (SYSCLK, RESET, Timestamp_Div, Timestamp_Cnt)
+begin
+   if SYSCLK'EVENT AND SYSCLK = '1' then
+      if RESET = '1' then
+         Timestamp_Div <= 0;
+         Timestamp_Cnt <= (others => '0');
+      elsif Timestamp_Div = (TIMESTAMP_DIV_RATE - 1) then
+         Timestamp_Div <= 0;
+         Timestamp_Cnt <= Timestamp_Cnt + 1;
+      else
+         Timestamp_Div <= Timestamp_Div + 1;
+      end if;
+   end if;
+end process Count_Timestamp;
+
+TIMESTAMP <= std_logic_vector(Timestamp_Cnt);
 
 -- Create the Cnt_SS_Inactive counter, also self_blocking
 Count_SS_Inactive: process (SYSCLK, RESET, Reset_Cnt_SS_Inactive, Cnt_SS_Inactive)
@@ -736,7 +860,7 @@ end process Register_StC_Adxl_Ctrl;
 
 -- ADXL 362 Control State Machine Transitions process
 Cmb_StC_Adxl_Ctrl: process (StC_Adxl_Ctrl, Cnt_SS_Inactive_done, SPI_Trans_Done, Sample_Rate_Tick,
-                            Cmd_Reg_Addr_Done, Adxl_Data_Ready, Adxl_Conf_Err, Cnt_Num_Reads_Done)
+                            Cmd_Reg_Addr_Done, Adxl_Data_Ready, Adxl_Conf_Err, Cnt_Num_Reads_Done, Cfg_Pending)
 begin
    StN_Adxl_Ctrl <= StC_Adxl_Ctrl; -- Default: Stay in the current state
    case (StC_Adxl_Ctrl) is
@@ -748,8 +872,12 @@ begin
       when stAdxlConf_Remaining     => if ( Cmd_Reg_Addr_Done = '1' AND SPI_Trans_Done = '1') then -- all of the configuration register data were written
                                              StN_Adxl_Ctrl <= stAdxlWaitSampleRateTick;      -- into the ADXL 362
                                        end if;
-      when stAdxlWaitSampleRateTick => if (Sample_Rate_Tick = '1') then StN_Adxl_Ctrl <= stAdxlRead_Status; end if; -- Read and check the 
-                                                                                                                     --status register
+      when stAdxlWaitSampleRateTick => if (Sample_Rate_Tick = '1') then 
+                                            if (Cfg_Pending = '1') then StN_Adxl_Ctrl <= stAdxlCtrlIdle; -- new configuration requested,
+                                                                                                         -- reset and reconfigure the ADXL 362
+                                            else StN_Adxl_Ctrl <= stAdxlRead_Status; -- Read and check the status register
+                                            end if;
+                                       end if;
       when stAdxlRead_Status        => if SPI_Trans_Done = '1' then 
                                                 if Adxl_Conf_Err = '1' then StN_Adxl_Ctrl <= stAdxlCtrlIdle; -- if error ocurred in configuration, go to the ilde state 
                                                                                                              -- and send reset command again
@@ -778,11 +906,13 @@ end process Cmb_StC_Adxl_Ctrl;
 -- Data_Reg(2) = ZDATA_H,
 -- Data_Reg(1) = TEMP_L,
 -- Data_Reg(0) = TEMP_H
-Sum_Data: process (SYSCLK, RESET, Data_Ready_1, Enable_Sum, Data_Reg, 
+-- The accumulators are also cleared when the state machine restarts, a set of reads interrupted by
+-- a configuration error or a new configuration is discarded
+Sum_Data: process (SYSCLK, RESET, Data_Ready_1, Enable_Sum, Data_Reg, StC_Adxl_Ctrl,
                    ACCEL_X_SUM, ACCEL_Y_SUM, ACCEL_Z_SUM, ACCEL_TMP_SUM)
 begin
     if SYSCLK'EVENT AND SYSCLK = '1' then
-         if (RESET = '1' OR Data_Ready_1 = '1') then
+         if (RESET = '1' OR Data_Ready_1 = '1' OR StC_Adxl_Ctrl = stAdxlCtrlIdle) then
             ACCEL_X_SUM <= (others => '0');
             ACCEL_Y_SUM <= (others => '0');
             ACCEL_Z_SUM <= (others => '0');
@@ -798,7 +928,7 @@ end process Sum_Data;
                   
 -- Register the output data
 Register_Output_Data: process (SYSCLK, RESET, Data_Ready_1, ACCEL_X_SUM, 
-                               ACCEL_Y_SUM, ACCEL_Z_SUM, ACCEL_TMP_SUM)
+                               ACCEL_Y_SUM, ACCEL_Z_SUM, ACCEL_TMP_SUM, Cfg_Avg_Log2)
 begin
     if SYSCLK'EVENT AND SYSCLK = '1' then
          if RESET = '1' then
@@ -806,11 +936,11 @@ begin
             ACCEL_Y <= (others => '0');
             ACCEL_Z <= (others => '0');
             ACCEL_TMP <= (others => '0');
-         elsif Data_Ready_1 = '1' then -- Divide by NUM_READS to create the average and set the output data
-            ACCEL_X <= ACCEL_X_SUM ((11 + (NUM_READS_BITS)) downto (NUM_READS_BITS)); -- 12 bits
-            ACCEL_Y <= ACCEL_Y_SUM ((11 + (NUM_READS_BITS)) downto (NUM_READS_BITS));
-            ACCEL_Z <= ACCEL_Z_SUM ((11 + (NUM_READS_BITS)) downto (NUM_READS_BITS));
-            ACCEL_TMP <= ACCEL_TMP_SUM ((11 + (NUM_READS_BITS)) downto (NUM_READS_BITS));
+         elsif Data_Ready_1 = '1' then -- Divide by the number of reads to create the average and set the output data
+            ACCEL_X <= Avg_Of (ACCEL_X_SUM, Cfg_Avg_Log2); -- 12 bits
+            ACCEL_Y <= Avg_Of (ACCEL_Y_SUM, Cfg_Avg_Log2);
+            ACCEL_Z <= Avg_Of (ACCEL_Z_SUM, Cfg_Avg_Log2);
+            ACCEL_TMP <= Avg_Of (ACCEL_TMP_SUM, Cfg_Avg_Log2);
          end if;
     end if;
 end process Register_Output_Data;
@@ -827,6 +957,90 @@ begin
          end if;
     end if;
 end process Pipe_Data_Ready;
+
+-- Create the raw sample, stored in the FIFO when Enable_Sum is active, i.e. in the same clock period
+-- when it is added to the accumulators. See Sum_Data for the layout of Data_Reg
+Raw_Sample <= std_logic_vector(Timestamp_Cnt) 
+            & Data_Reg(2)(3 downto 0) & Data_Reg(3)  -- Z
+            & Data_Reg(4)(3 downto 0) & Data_Reg(5)  -- Y
+            & Data_Reg(6)(3 downto 0) & Data_Reg(7); -- X
+
+-- Create the raw sample FIFO
+Gen_Sample_Fifo: if FIFO_DEPTH > 0 generate
+
+   type fifo_mem_type is array (0 to (FIFO_DEPTH - 1)) of STD_LOGIC_VECTOR (67 downto 0);
+   signal Fifo_Mem : fifo_mem_type;
+
+   signal Fifo_Wr_Ptr  : integer range 0 to (FIFO_DEPTH - 1) := 0;
+   signal Fifo_Rd_Ptr  : integer range 0 to (FIFO_DEPTH - 1) := 0;
+   signal Fifo_Cnt     : integer range 0 to FIFO_DEPTH := 0;
+   signal Fifo_Ovf     : STD_LOGIC := '0';
+   signal Fifo_Push    : STD_LOGIC; -- a new sample is written, the FIFO is not full
+   signal Fifo_Pop     : STD_LOGIC; -- the oldest sample is removed, the FIFO is not empty
+
+begin
+
+   Fifo_Push <= '1' when Enable_Sum = '1' AND Fifo_Cnt /= FIFO_DEPTH else '0';
+   Fifo_Pop  <= '1' when FIFO_RD = '1' AND Fifo_Cnt /= 0 else '0';
+
+   -- The FIFO memory has no reset, to allow inferring RAM
+   Write_Fifo_Mem: process (SYSCLK, Fifo_Push, Fifo_Wr_Ptr, Raw_Sample)
+   begin
+      if SYSCLK'EVENT AND SYSCLK = '1' then
+         if Fifo_Push = '1' then
+            Fifo_Mem(Fifo_Wr_Ptr) <= Raw_Sample;
+         end if;
+      end if;
+   end process Write_Fifo_Mem;
+
+   Count_Fifo: process (SYSCLK, RESET, FIFO_CLR, Fifo_Push, Fifo_Pop, Enable_Sum,
+                        Fifo_Wr_Ptr, Fifo_Rd_Ptr, Fifo_Cnt)
+   begin
+      if SYSCLK'EVENT AND SYSCLK = '1' then
+         if RESET = '1' OR FIFO_CLR = '1' then
+            Fifo_Wr_Ptr <= 0;
+            Fifo_Rd_Ptr <= 0;
+            Fifo_Cnt <= 0;
+            Fifo_Ovf <= '0';
+         else
+            if Fifo_Push = '1' then
+               if Fifo_Wr_Ptr = (FIFO_DEPTH - 1) then
+                  Fifo_Wr_Ptr <= 0;
+               else
+                  Fifo_Wr_Ptr <= Fifo_Wr_Ptr + 1;
+               end if;
+            elsif Enable_Sum = '1' then -- FIFO full, the sample is dropped
+               Fifo_Ovf <= '1';
+            end if;
+
+            if Fifo_Pop = '1' then
+               if Fifo_Rd_Ptr = (FIFO_DEPTH - 1) then
+                  Fifo_Rd_Ptr <= 0;
+               else
+                  Fifo_Rd_Ptr <= Fifo_Rd_Ptr + 1;
+               end if;
+            end if;
+
+            if Fifo_Push = '1' AND Fifo_Pop = '0' then
+               Fifo_Cnt <= Fifo_Cnt + 1;
+            elsif Fifo_Push = '0' AND Fifo_Pop = '1' then
+               Fifo_Cnt <= Fifo_Cnt - 1;
+            end if;
+         end if;
+      end if;
+   end process Count_Fifo;
+
+   FIFO_DOUT     <= Fifo_Mem(Fifo_Rd_Ptr);
+   FIFO_COUNT    <= std_logic_vector(to_unsigned(Fifo_Cnt, 16));
+   FIFO_OVERFLOW <= Fifo_Ovf;
+
+end generate Gen_Sample_Fifo;
+
+Gen_No_Sample_Fifo: if FIFO_DEPTH = 0 generate
+   FIFO_DOUT     <= (others => '0');
+   FIFO_COUNT    <= (others => '0');
+   FIFO_OVERFLOW <= '0';
+end generate Gen_No_Sample_Fifo;
  
 end Behavioral;
 
@@ -0,0 +1,160 @@
+# Definitional proc to organize widgets for parameters.
+proc init_gui { IPINST } {
+  ipgui::add_param $IPINST -name "Component_Name"
+  #Adding Page
+  set Page_0 [ipgui::add_page $IPINST -name "Page 0"]
+  set C_S00_AXI_DATA_WIDTH [ipgui::add_param $IPINST -name "C_S00_AXI_DATA_WIDTH" -parent ${Page_0} -widget comboBox]
+  set_property tooltip {Width of S_AXI data bus} ${C_S00_AXI_DATA_WIDTH}
+  set C_S00_AXI_ADDR_WIDTH [ipgui::add_param $IPINST -name "C_S00_AXI_ADDR_WIDTH" -parent ${Page_0}]
+  set_property tooltip {Width of S_AXI address bus} ${C_S00_AXI_ADDR_WIDTH}
+  ipgui::add_param $IPINST -name "C_S00_AXI_BASEADDR" -parent ${Page_0}
+  ipgui::add_param $IPINST -name "C_S00_AXI_HIGHADDR" -parent ${Page_0}
+  #Adding Page
+  set ADXL362 [ipgui::add_page $IPINST -name "ADXL362"]
+  set SYSCLK_FREQUENCY_HZ [ipgui::add_param $IPINST -name "SYSCLK_FREQUENCY_HZ" -parent ${ADXL362}]
+  set_property tooltip {AXI clock frequency} ${SYSCLK_FREQUENCY_HZ}
+  set SCLK_FREQUENCY_HZ [ipgui::add_param $IPINST -name "SCLK_FREQUENCY_HZ" -parent ${ADXL362}]
+  set_property tooltip {SPI clock frequency} ${SCLK_FREQUENCY_HZ}
+  set NUM_READS_AVG [ipgui::add_param $IPINST -name "NUM_READS_AVG" -parent ${ADXL362} -widget comboBox]
+  set_property tooltip {Maximum number of reads averaged, a power of two} ${NUM_READS_AVG}
+  set UPDATE_FREQUENCY_HZ [ipgui::add_param $IPINST -name "UPDATE_FREQUENCY_HZ" -parent ${ADXL362}]
+  set_property tooltip {Rate of the ADXL362 status polling} ${UPDATE_FREQUENCY_HZ}
+  set ODR_SEL [ipgui::add_param $IPINST -name "ODR_SEL" -parent ${ADXL362}]
+  set_property tooltip {ADXL362 output data rate after reset, 0 = 12.5Hz ... 5 = 400Hz} ${ODR_SEL}
+  set FIFO_DEPTH [ipgui::add_param $IPINST -name "FIFO_DEPTH" -parent ${ADXL362}]
+  set_property tooltip {Depth of the raw sample FIFO, 0 = no FIFO} ${FIFO_DEPTH}
+
+
+}
+
+proc update_PARAM_VALUE.SYSCLK_FREQUENCY_HZ { PARAM_VALUE.SYSCLK_FREQUENCY_HZ } {
+	# Procedure called to update SYSCLK_FREQUENCY_HZ when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.SYSCLK_FREQUENCY_HZ { PARAM_VALUE.SYSCLK_FREQUENCY_HZ } {
+	# Procedure called to validate SYSCLK_FREQUENCY_HZ
+	return true
+}
+
+proc update_PARAM_VALUE.SCLK_FREQUENCY_HZ { PARAM_VALUE.SCLK_FREQUENCY_HZ } {
+	# Procedure called to update SCLK_FREQUENCY_HZ when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.SCLK_FREQUENCY_HZ { PARAM_VALUE.SCLK_FREQUENCY_HZ } {
+	# Procedure called to validate SCLK_FREQUENCY_HZ
+	return true
+}
+
+proc update_PARAM_VALUE.NUM_READS_AVG { PARAM_VALUE.NUM_READS_AVG } {
+	# Procedure called to update NUM_READS_AVG when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.NUM_READS_AVG { PARAM_VALUE.NUM_READS_AVG } {
+	# Procedure called to validate NUM_READS_AVG
+	return true
+}
+
+proc update_PARAM_VALUE.UPDATE_FREQUENCY_HZ { PARAM_VALUE.UPDATE_FREQUENCY_HZ } {
+	# Procedure called to update UPDATE_FREQUENCY_HZ when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.UPDATE_FREQUENCY_HZ { PARAM_VALUE.UPDATE_FREQUENCY_HZ } {
+	# Procedure called to validate UPDATE_FREQUENCY_HZ
+	return true
+}
+
+proc update_PARAM_VALUE.ODR_SEL { PARAM_VALUE.ODR_SEL } {
+	# Procedure called to update ODR_SEL when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.ODR_SEL { PARAM_VALUE.ODR_SEL } {
+	# Procedure called to validate ODR_SEL
+	return true
+}
+
+proc update_PARAM_VALUE.FIFO_DEPTH { PARAM_VALUE.FIFO_DEPTH } {
+	# Procedure called to update FIFO_DEPTH when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.FIFO_DEPTH { PARAM_VALUE.FIFO_DEPTH } {
+	# Procedure called to validate FIFO_DEPTH
+	return true
+}
+
+proc update_PARAM_VALUE.C_S00_AXI_DATA_WIDTH { PARAM_VALUE.C_S00_AXI_DATA_WIDTH } {
+	# Procedure called to update C_S00_AXI_DATA_WIDTH when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.C_S00_AXI_DATA_WIDTH { PARAM_VALUE.C_S00_AXI_DATA_WIDTH } {
+	# Procedure called to validate C_S00_AXI_DATA_WIDTH
+	return true
+}
+
+proc update_PARAM_VALUE.C_S00_AXI_ADDR_WIDTH { PARAM_VALUE.C_S00_AXI_ADDR_WIDTH } {
+	# Procedure called to update C_S00_AXI_ADDR_WIDTH when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.C_S00_AXI_ADDR_WIDTH { PARAM_VALUE.C_S00_AXI_ADDR_WIDTH } {
+	# Procedure called to validate C_S00_AXI_ADDR_WIDTH
+	return true
+}
+
+proc update_PARAM_VALUE.C_S00_AXI_BASEADDR { PARAM_VALUE.C_S00_AXI_BASEADDR } {
+	# Procedure called to update C_S00_AXI_BASEADDR when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.C_S00_AXI_BASEADDR { PARAM_VALUE.C_S00_AXI_BASEADDR } {
+	# Procedure called to validate C_S00_AXI_BASEADDR
+	return true
+}
+
+proc update_PARAM_VALUE.C_S00_AXI_HIGHADDR { PARAM_VALUE.C_S00_AXI_HIGHADDR } {
+	# Procedure called to update C_S00_AXI_HIGHADDR when any of the dependent parameters in the arguments change
+}
+
+proc validate_PARAM_VALUE.C_S00_AXI_HIGHADDR { PARAM_VALUE.C_S00_AXI_HIGHADDR } {
+	# Procedure called to validate C_S00_AXI_HIGHADDR
+	return true
+}
+
+
+proc update_MODELPARAM_VALUE.C_S00_AXI_DATA_WIDTH { MODELPARAM_VALUE.C_S00_AXI_DATA_WIDTH PARAM_VALUE.C_S00_AXI_DATA_WIDTH } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.C_S00_AXI_DATA_WIDTH}] ${MODELPARAM_VALUE.C_S00_AXI_DATA_WIDTH}
+}
+
+proc update_MODELPARAM_VALUE.C_S00_AXI_ADDR_WIDTH { MODELPARAM_VALUE.C_S00_AXI_ADDR_WIDTH PARAM_VALUE.C_S00_AXI_ADDR_WIDTH } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.C_S00_AXI_ADDR_WIDTH}] ${MODELPARAM_VALUE.C_S00_AXI_ADDR_WIDTH}
+}
+
+proc update_MODELPARAM_VALUE.SYSCLK_FREQUENCY_HZ { MODELPARAM_VALUE.SYSCLK_FREQUENCY_HZ PARAM_VALUE.SYSCLK_FREQUENCY_HZ } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.SYSCLK_FREQUENCY_HZ}] ${MODELPARAM_VALUE.SYSCLK_FREQUENCY_HZ}
+}
+
+proc update_MODELPARAM_VALUE.SCLK_FREQUENCY_HZ { MODELPARAM_VALUE.SCLK_FREQUENCY_HZ PARAM_VALUE.SCLK_FREQUENCY_HZ } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.SCLK_FREQUENCY_HZ}] ${MODELPARAM_VALUE.SCLK_FREQUENCY_HZ}
+}
+
+proc update_MODELPARAM_VALUE.NUM_READS_AVG { MODELPARAM_VALUE.NUM_READS_AVG PARAM_VALUE.NUM_READS_AVG } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.NUM_READS_AVG}] ${MODELPARAM_VALUE.NUM_READS_AVG}
+}
+
+proc update_MODELPARAM_VALUE.UPDATE_FREQUENCY_HZ { MODELPARAM_VALUE.UPDATE_FREQUENCY_HZ PARAM_VALUE.UPDATE_FREQUENCY_HZ } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.UPDATE_FREQUENCY_HZ}] ${MODELPARAM_VALUE.UPDATE_FREQUENCY_HZ}
+}
+
+proc update_MODELPARAM_VALUE.ODR_SEL { MODELPARAM_VALUE.ODR_SEL PARAM_VALUE.ODR_SEL } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.ODR_SEL}] ${MODELPARAM_VALUE.ODR_SEL}
+}
+
+proc update_MODELPARAM_VALUE.FIFO_DEPTH { MODELPARAM_VALUE.FIFO_DEPTH PARAM_VALUE.FIFO_DEPTH } {
+	# Procedure called to set VHDL generic/Verilog parameter value(s) based on TCL parameter value
+	set_property value [get_property value ${PARAM_VALUE.FIFO_DEPTH}] ${MODELPARAM_VALUE.FIFO_DEPTH}
+}
+
@@ -0,0 +1,588 @@
+/************************************************************************/
+/*																		*/
+/*	BT2_emu.c	--	Host model of the PmodBT2 UART						*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	This module lets the PmodBT2 and XUartNs550 drivers run on the		*/
+/*	host.  It provides Xil_In32() and Xil_Out32() and models the		*/
+/*	registers of the AXI UART 16550: the receive and transmit holding	*/
+/*	registers with their 16 byte FIFOs, the interrupt enable, FIFO		*/
+/*	control and line control registers with the divisor latch, the		*/
+/*	line status register and the interrupt identification register.		*/
+/*	The FIFO control register reads back with the divisor latch set,	*/
+/*	as in the Xilinx UART.  The AXI GPIO is two plain registers.		*/
+/*																		*/
+/*	The UART is connected either to a host tty or to a wire in			*/
+/*	virtual time.  With a tty, a byte written to the transmit holding	*/
+/*	register is written to the tty at once, and the receive FIFO is		*/
+/*	filled from the tty when the line status register is read.  When	*/
+/*	the divisor changes the tty is set to the standard rate closest		*/
+/*	to BT2_EMU_CLK_HZ / (16 * divisor), or to a rate that nothing else	*/
+/*	uses if none is within BT2_EMU_MAX_ERROR, so a peer on the other	*/
+/*	side of a pty can tell whether the rates match.						*/
+/*																		*/
+/*	On the wire, BT2Emu_Feed() queues bytes that arrive back to back	*/
+/*	at the rate of the divisor, 10 bits a byte, and the transmit FIFO	*/
+/*	drains at the same rate, as BT2Emu_Run() moves the time along.		*/
+/*	The interrupts are modelled too: receive data at the trigger		*/
+/*	level, the character timeout after 4 character times without a		*/
+/*	byte or a read, and the transmitter holding register empty.  While	*/
+/*	the interrupt is active the handler set with BT2Emu_SetIsr() is		*/
+/*	called, as the interrupt controller would, with no delay.  The		*/
+/*	statistics measure the wait of each byte from its arrival to its	*/
+/*	read from the receive buffer register.								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*	06/18/2017: added the wire in virtual time and the interrupts		*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "BT2_emu.h"
+#include "xil_io.h"
+#include "xil_assert.h"
+#include "xuartns550_l.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+/************************** Constant Definitions ***************************/
+#define EMU_FIFO_DEPTH	XUN_FIFO_SIZE
+#define EMU_UART_REGS	8
+#define EMU_REG(off)	(((off) - XUN_REG_OFFSET) / 4)
+#define EMU_DLAB()		(rgUartReg[EMU_REG(XUN_LCR_OFFSET)] & XUN_LCR_DLAB)
+#define EMU_WIRE_SIZE	65536			// bytes fed and not yet arrived
+#define EMU_MAX_ISR		64				// handler calls in a row before giving up
+
+// interrupt identification
+#define EMU_IIR_NONE	0x01
+#define EMU_IIR_THRE	0x02
+#define EMU_IIR_RDA		0x04
+#define EMU_IIR_TIMEOUT	0x0C
+
+/************************** Variable Definitions ***************************/
+
+// the standard tty rates
+static const struct {
+	u32			baud;
+	speed_t		speed;
+} rgRate[] = {
+	{ 1200, B1200 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+	{ 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+	{ 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 },
+	{ 921600, B921600 },
+};
+
+#define EMU_NUM_RATES	(sizeof(rgRate) / sizeof(rgRate[0]))
+
+static const int rgcbTrigger[4] = { 1, 4, 8, 14 };
+
+// AXI UART 16550
+static u32		rgUartReg[EMU_UART_REGS];
+static u32		fcr;
+static u32		divisor;
+static u32		divisorLine;		// divisor the tty or the wire is set for
+static u8		rgbRxFifo[EMU_FIFO_DEPTH];
+static u64		rgnsRxFifo[EMU_FIFO_DEPTH];	// arrival of each byte
+static int		ibRxFifo;
+static int		cbRxFifo;
+static u32		lsrErrors;			// error bits until the next line status read
+static int		cbTxFifo;
+static int		fThrePending;		// transmitter holding register empty interrupt
+
+// AXI GPIO
+static u32		gpioData;
+static u32		gpioTri;
+
+// tty
+static int		fdTty = -1;
+static u32		baudLine;			// rate of the tty, 0 if not a standard one
+
+// wire
+static u8		rgbWire[EMU_WIRE_SIZE];
+static u32		ibWire;
+static u32		cbWire;
+static u64		nsNow;
+static u64		nsChar;				// a character time
+static u64		nsNextRx;			// arrival of the next byte on the wire
+static u64		nsNextTx;			// end of the byte being sent
+static u64		nsRxActivity;		// last arrival or read, for the timeout
+static BT2Emu_Isr	pfnIsr;
+static void		*pvIsr;
+static int		fInIsr;
+
+static BT2Emu_Stats	stats;
+
+/************************** Function Definitions ***************************/
+
+static int EMU_Wire(void)
+{
+	return fdTty < 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	EMU_SetLine
+**
+**	Description:
+**		Sets the tty or the wire to the rate of the divisor
+*/
+static void EMU_SetLine(void)
+{
+	struct termios tio;
+	u32 baud = (divisor == 0) ? 0 : BT2_EMU_CLK_HZ / (16 * divisor);
+	u32 err;
+	speed_t speed = B50;
+	u32 i;
+
+	divisorLine = divisor;
+	stats.cRateChange++;
+	nsChar = (baud == 0) ? 0 : 10000000000ULL / baud;
+
+	baudLine = 0;
+	for (i = 0; i < EMU_NUM_RATES; i++) {
+		err = (baud > rgRate[i].baud) ? baud - rgRate[i].baud : rgRate[i].baud - baud;
+		if (err * 1000 <= rgRate[i].baud * BT2_EMU_MAX_ERROR) {
+			baudLine = rgRate[i].baud;
+			speed = rgRate[i].speed;
+			break;
+		}
+	}
+
+	if (!EMU_Wire() && (tcgetattr(fdTty, &tio) == 0)) {
+		cfsetispeed(&tio, speed);
+		cfsetospeed(&tio, speed);
+		tcsetattr(fdTty, TCSADRAIN, &tio);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	EMU_FillRx
+**
+**	Description:
+**		Moves what the tty has into the receive FIFO
+*/
+static void EMU_FillRx(void)
+{
+	u8 rgb[EMU_FIFO_DEPTH];
+	int cb, ib;
+
+	if (EMU_Wire() || (cbRxFifo == EMU_FIFO_DEPTH)) {
+		return;
+	}
+	cb = read(fdTty, rgb, EMU_FIFO_DEPTH - cbRxFifo);
+	for (ib = 0; ib < cb; ib++) {
+		rgbRxFifo[(ibRxFifo + cbRxFifo++) % EMU_FIFO_DEPTH] = rgb[ib];
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	EMU_Iir
+**
+**	Return Value:
+**		the interrupt identification, by priority, with the FIFOs
+**		enabled bits
+*/
+static u32 EMU_Iir(void)
+{
+	u32 ier = rgUartReg[EMU_REG(XUN_IER_OFFSET)];
+	u32 fifos = (fcr & XUN_FIFO_ENABLE) ? XUN_INT_ID_FIFOS_ENABLED : 0;
+	int cbTrigger = (fcr & XUN_FIFO_ENABLE) ? rgcbTrigger[(fcr & XUN_FIFO_RX_TRIGGER) >> 6] : 1;
+
+	if (!EMU_Wire()) {
+		return fifos | EMU_IIR_NONE;
+	}
+	if ((ier & XUN_IER_RX_DATA) && (cbRxFifo >= cbTrigger)) {
+		return fifos | EMU_IIR_RDA;
+	}
+	if ((ier & XUN_IER_RX_DATA) && (cbRxFifo > 0) && (nsNow >= nsRxActivity + 4 * nsChar)) {
+		return fifos | EMU_IIR_TIMEOUT;
+	}
+	if ((ier & XUN_IER_TX_EMPTY) && fThrePending) {
+		return fifos | EMU_IIR_THRE;
+	}
+	return fifos | EMU_IIR_NONE;
+}
+
+/* ------------------------------------------------------------ */
+/***	EMU_Interrupt
+**
+**	Description:
+**		Calls the handler while the interrupt is active
+*/
+static void EMU_Interrupt(void)
+{
+	int cIsr = 0;
+
+	if (pfnIsr == NULL || fInIsr) {
+		return;
+	}
+	fInIsr = 1;
+	while ((EMU_Iir() & XUN_INT_ID_MASK) != EMU_IIR_NONE) {
+		if (++cIsr > EMU_MAX_ISR) {
+			stats.cStorm++;
+			break;
+		}
+		stats.cIsr++;
+		pfnIsr(pvIsr);
+	}
+	fInIsr = 0;
+}
+
+static u32 EMU_UartRead(u32 off)
+{
+	u32 reg = EMU_REG(off);
+	u32 data, iir;
+	u64 ns;
+
+	stats.cRegRead++;
+	switch (off) {
+	case XUN_RBR_OFFSET:
+		if (EMU_DLAB()) {
+			return divisor & 0xFF;
+		}
+		if (cbRxFifo == 0) {
+			return 0;
+		}
+		data = rgbRxFifo[ibRxFifo];
+		if (EMU_Wire()) {
+			ns = nsNow - rgnsRxFifo[ibRxFifo];
+			stats.nsLatencySum += ns;
+			if (ns > stats.nsLatencyMax) {
+				stats.nsLatencyMax = ns;
+			}
+			nsRxActivity = nsNow;
+		}
+		ibRxFifo = (ibRxFifo + 1) % EMU_FIFO_DEPTH;
+		cbRxFifo--;
+		stats.cbRx++;
+		return data;
+
+	case XUN_IER_OFFSET:
+		if (EMU_DLAB()) {
+			return divisor >> 8;
+		}
+		return rgUartReg[reg];
+
+	case XUN_IIR_OFFSET:
+		if (EMU_DLAB()) {
+			return fcr;
+		}
+		iir = EMU_Iir();
+		if ((iir & XUN_INT_ID_MASK) == EMU_IIR_THRE) {
+			fThrePending = 0;
+		}
+		return iir;
+
+	case XUN_LSR_OFFSET:
+		EMU_FillRx();
+		data = lsrErrors | ((cbRxFifo > 0) ? XUN_LSR_DATA_READY : 0);
+		if (cbTxFifo == 0) {
+			data |= XUN_LSR_TX_EMPTY | XUN_LSR_TX_BUFFER_EMPTY;
+		}
+		lsrErrors = 0;
+		return data;
+
+	default:
+		return rgUartReg[reg];
+	}
+}
+
+static void EMU_UartWrite(u32 off, u32 data)
+{
+	u32 reg = EMU_REG(off);
+	u8 b = data;
+
+	stats.cRegWrite++;
+	switch (off) {
+	case XUN_THR_OFFSET:
+		if (EMU_DLAB()) {
+			divisor = (divisor & 0xFF00) | (data & 0xFF);
+		}
+		else if (EMU_Wire()) {
+			fThrePending = 0;
+			if (cbTxFifo < EMU_FIFO_DEPTH) {
+				if (cbTxFifo++ == 0) {
+					nsNextTx = nsNow + nsChar;
+				}
+			}
+		}
+		else if (write(fdTty, &b, 1) == 1) {
+			stats.cbTx++;
+		}
+		break;
+
+	case XUN_IER_OFFSET:
+		if (EMU_DLAB()) {
+			divisor = (divisor & 0xFF) | ((data & 0xFF) << 8);
+			break;
+		}
+		// enabling the interrupt with the transmitter empty raises it
+		if ((data & ~rgUartReg[reg] & XUN_IER_TX_EMPTY) && (cbTxFifo == 0)) {
+			fThrePending = 1;
+		}
+		rgUartReg[reg] = data;
+		EMU_Interrupt();
+		break;
+
+	case XUN_FCR_OFFSET:
+		if (data & XUN_FIFO_RX_RESET) {
+			cbRxFifo = 0;
+		}
+		if (data & XUN_FIFO_TX_RESET) {
+			cbTxFifo = 0;
+		}
+		fcr = data & ~(XUN_FIFO_RX_RESET | XUN_FIFO_TX_RESET);
+		break;
+
+	case XUN_LCR_OFFSET:
+		rgUartReg[reg] = data;
+		// the new divisor takes effect when the latch is closed
+		if (!(data & XUN_LCR_DLAB) && (divisor != divisorLine)) {
+			EMU_SetLine();
+		}
+		break;
+
+	default:
+		rgUartReg[reg] = data;
+		break;
+	}
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	if ((Addr >= BT2_EMU_UART_BASEADDR + XUN_REG_OFFSET) &&
+			(Addr < BT2_EMU_UART_BASEADDR + XUN_REG_OFFSET + EMU_UART_REGS * 4)) {
+		return EMU_UartRead(Addr - BT2_EMU_UART_BASEADDR);
+	}
+	if (Addr == BT2_EMU_GPIO_BASEADDR) {
+		return gpioData;
+	}
+	if (Addr == BT2_EMU_GPIO_BASEADDR + 4) {
+		return gpioTri;
+	}
+	return 0;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	if ((Addr >= BT2_EMU_UART_BASEADDR + XUN_REG_OFFSET) &&
+			(Addr < BT2_EMU_UART_BASEADDR + XUN_REG_OFFSET + EMU_UART_REGS * 4)) {
+		EMU_UartWrite(Addr - BT2_EMU_UART_BASEADDR, Value);
+	}
+	else if (Addr == BT2_EMU_GPIO_BASEADDR) {
+		gpioData = Value;
+	}
+	else if (Addr == BT2_EMU_GPIO_BASEADDR + 4) {
+		gpioTri = Value;
+	}
+}
+
+void Xil_Assert(const char *File, s32 Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, (int) Line);
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_Init
+**
+**	Parameters:
+**		szTty		- path of the tty the UART is connected to, or
+**					  NULL for the wire in virtual time
+**
+**	Return Value:
+**		0 if the tty was opened, -1 if not
+**
+**	Description:
+**		Opens the tty, raw and non blocking.  Its rate is set
+**		when the driver sets the divisor
+*/
+int BT2Emu_Init(const char *szTty)
+{
+	struct termios tio;
+
+	memset(rgUartReg, 0, sizeof(rgUartReg));
+	fcr = 0;
+	divisor = 0;
+	divisorLine = 0;
+	cbRxFifo = 0;
+	cbTxFifo = 0;
+	fThrePending = 0;
+	lsrErrors = 0;
+	ibWire = 0;
+	cbWire = 0;
+	nsNow = 0;
+	nsNextRx = 0;
+	nsRxActivity = 0;
+	pfnIsr = NULL;
+	BT2Emu_ResetStats();
+
+	fdTty = -1;
+	if (szTty == NULL) {
+		return 0;
+	}
+	fdTty = open(szTty, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fdTty < 0) {
+		return -1;
+	}
+	if (tcgetattr(fdTty, &tio) == 0) {
+		cfmakeraw(&tio);
+		tcsetattr(fdTty, TCSANOW, &tio);
+	}
+	return 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_SetIsr
+**
+**	Parameters:
+**		pfn			- interrupt handler, NULL for none
+**		pv			- its argument
+**
+**	Description:
+**		Connects the UART interrupt of the wire
+*/
+void BT2Emu_SetIsr(BT2Emu_Isr pfn, void *pv)
+{
+	pfnIsr = pfn;
+	pvIsr = pv;
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_Feed
+**
+**	Parameters:
+**		pb			- bytes
+**		cb			- number of bytes
+**
+**	Return Value:
+**		the number of bytes queued, fewer if the wire is full
+**
+**	Description:
+**		Queues bytes to arrive on the wire, back to back after
+**		those queued before, or from now if the wire is idle
+*/
+u32 BT2Emu_Feed(const u8 *pb, u32 cb)
+{
+	u32 ib;
+
+	if (cbWire == 0 && nsNextRx < nsNow + nsChar) {
+		nsNextRx = nsNow + nsChar;
+	}
+	for (ib = 0; ib < cb && cbWire < EMU_WIRE_SIZE; ib++) {
+		rgbWire[(ibWire + cbWire++) % EMU_WIRE_SIZE] = pb[ib];
+	}
+	return ib;
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_Run
+**
+**	Parameters:
+**		us			- time to run, in microseconds
+**
+**	Description:
+**		Moves the wire along: the bytes arrive in the receive FIFO
+**		and the transmit FIFO drains a character time apart, and
+**		the handler is called whenever the interrupt is active
+*/
+void BT2Emu_Run(u32 us)
+{
+	u64 nsEnd = nsNow + (u64) us * 1000;
+	u64 nsTimeout, nsNext;
+
+	if (!EMU_Wire() || nsChar == 0) {
+		nsNow = nsEnd;
+		return;
+	}
+
+	while (nsNow < nsEnd) {
+		// the next thing that happens
+		nsNext = nsEnd;
+		if (cbWire > 0 && nsNextRx < nsNext) {
+			nsNext = nsNextRx;
+		}
+		if (cbTxFifo > 0 && nsNextTx < nsNext) {
+			nsNext = nsNextTx;
+		}
+		nsTimeout = nsRxActivity + 4 * nsChar;
+		if (cbRxFifo > 0 && nsTimeout > nsNow && nsTimeout < nsNext) {
+			nsNext = nsTimeout;
+		}
+		nsNow = nsNext;
+
+		if (cbWire > 0 && nsNextRx <= nsNow) {
+			if (cbRxFifo < EMU_FIFO_DEPTH) {
+				rgbRxFifo[(ibRxFifo + cbRxFifo) % EMU_FIFO_DEPTH] = rgbWire[ibWire];
+				rgnsRxFifo[(ibRxFifo + cbRxFifo) % EMU_FIFO_DEPTH] = nsNow;
+				cbRxFifo++;
+			}
+			else {
+				lsrErrors |= XUN_LSR_OVERRUN_ERROR;
+				stats.cbOverrun++;
+			}
+			ibWire = (ibWire + 1) % EMU_WIRE_SIZE;
+			cbWire--;
+			nsNextRx += nsChar;
+			nsRxActivity = nsNow;
+		}
+		if (cbTxFifo > 0 && nsNextTx <= nsNow) {
+			stats.cbTx++;
+			if (--cbTxFifo == 0) {
+				fThrePending = 1;
+			}
+			nsNextTx += nsChar;
+		}
+		EMU_Interrupt();
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_Now
+**
+**	Return Value:
+**		the virtual time, in microseconds
+*/
+u32 BT2Emu_Now(void)
+{
+	return nsNow / 1000;
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_Baud
+**
+**	Return Value:
+**		the rate the divisor makes, 0 if it is not set
+*/
+u32 BT2Emu_Baud(void)
+{
+	return (divisorLine == 0) ? 0 : BT2_EMU_CLK_HZ / (16 * divisorLine);
+}
+
+/* ------------------------------------------------------------ */
+/***	BT2Emu_LineBaud
+**
+**	Return Value:
+**		the standard rate the tty is set to, 0 if the divisor is
+**		not close to one
+*/
+u32 BT2Emu_LineBaud(void)
+{
+	return baudLine;
+}
+
+void BT2Emu_GetStats(BT2Emu_Stats *pst)
+{
+	*pst = stats;
+}
+
+void BT2Emu_ResetStats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,61 @@
+/************************************************************************/
+/*																		*/
+/*	BT2_emu.h	--	Host model of the PmodBT2 UART						*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Interface of the model of the AXI UART 16550 and AXI GPIO of the	*/
+/*	PmodBT2 IP.  The UART is connected to a host tty, normally the		*/
+/*	pty of rn42_sim, or to a wire in virtual time with interrupts.		*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*	06/18/2017: added the wire in virtual time and the interrupts		*/
+/*																		*/
+/************************************************************************/
+#ifndef BT2_EMU_H
+#define BT2_EMU_H
+
+#include "xil_types.h"
+#include "xparameters.h"
+
+/* ------------------------------------------------------------ */
+/*					Definitions									*/
+/* ------------------------------------------------------------ */
+#define BT2_EMU_GPIO_BASEADDR	XPAR_PMODBT2_0_AXI_LITE_GPIO_BASEADDR
+#define BT2_EMU_UART_BASEADDR	XPAR_PMODBT2_0_AXI_LITE_UART_BASEADDR
+#define BT2_EMU_CLK_HZ			XPAR_CPU_M_AXI_DP_FREQ_HZ
+#define BT2_EMU_MAX_ERROR		20		// tty rate error accepted, tenths of a percent
+
+typedef struct {
+	u32		cRegRead;			// UART register reads
+	u32		cRegWrite;			// UART register writes
+	u32		cbTx;				// bytes sent
+	u32		cbRx;				// bytes read from the receive buffer register
+	u32		cRateChange;		// divisor changes
+	u32		cIsr;				// interrupt handler calls, on the wire
+	u32		cStorm;				// times the interrupt stayed active
+	u32		cbOverrun;			// bytes lost to a full receive FIFO
+	u64		nsLatencySum;		// waits of the bytes from arrival to read
+	u64		nsLatencyMax;		// longest of them
+} BT2Emu_Stats;
+
+typedef void (*BT2Emu_Isr)(void *pv);
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+int BT2Emu_Init(const char *szTty);
+void BT2Emu_SetIsr(BT2Emu_Isr pfn, void *pv);
+u32 BT2Emu_Feed(const u8 *pb, u32 cb);
+void BT2Emu_Run(u32 us);
+u32 BT2Emu_Now(void);
+u32 BT2Emu_Baud(void);
+u32 BT2Emu_LineBaud(void);
+void BT2Emu_GetStats(BT2Emu_Stats *pst);
+void BT2Emu_ResetStats(void);
+
+#endif // BT2_EMU_H
@@ -0,0 +1,21 @@
+/************************************************************************/
+/*																		*/
+/* xparameters.h	--	Host stand-in for the generated header			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Addresses of the PmodBT2 registers modelled by the UART model and	*/
+/*	the clock of the UART.  There is no interrupt controller, so the	*/
+/*	driver builds with NO_IRPT.											*/
+/*																		*/
+/************************************************************************/
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_CPU_M_AXI_DP_FREQ_HZ				100000000
+
+#define XPAR_PMODBT2_0_AXI_LITE_GPIO_BASEADDR	0x44A20000
+#define XPAR_PMODBT2_0_AXI_LITE_UART_BASEADDR	0x44A30000
+
+#endif // XPARAMETERS_H
@@ -0,0 +1,34 @@
+/************************************************************************/
+/*																		*/
+/* xstatus.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The status codes that the PmodBT2 and XUartNs550 drivers return,	*/
+/*	with the values of the BSP.											*/
+/*																		*/
+/************************************************************************/
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+#define XST_DEVICE_NOT_FOUND		2L
+#define XST_DEVICE_IS_STARTED		5L
+#define XST_DEVICE_IS_STOPPED		6L
+#define XST_INVALID_PARAM			15L
+#define XST_DEVICE_BUSY				21L
+
+#define XST_UART_INIT_ERROR			1101L
+#define XST_UART_START_ERROR		1102L
+#define XST_UART_CONFIG_ERROR		1103L
+#define XST_UART_TEST_FAIL			1104L
+#define XST_UART_BAUD_ERROR			1105L
+#define XST_UART_BAUD_RANGE			1106L
+
+typedef s32 XStatus;
+
+#endif // XSTATUS_H
@@ -0,0 +1,112 @@
+/************************************************************************/
+/*																		*/
+/*	main.c	--	PmodBT2 baud rate negotiation against rn42_sim			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Runs BT2_negotiateBaud() on the host, with the UART model			*/
+/*	connected to the pty of rn42_sim, and prints the rate it ends at,	*/
+/*	how long it took and the UART traffic.  Then it checks that data	*/
+/*	gets through at that rate by sending a line and reading back the	*/
+/*	echo of rn42_sim.  It exits with 0 if the line came back.			*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -I. -Ibsp -I../../src -o rn42_pty main.c			*/
+/*		BT2_emu.c ../../src/PmodBT2.c ../../src/xuartns550.c			*/
+/*		../../src/xuartns550_l.c ../../src/xuartns550_options.c			*/
+/*		../../src/xuartns550_format.c ../../src/xuartns550_stats.c		*/
+/*		../../src/xuartns550_intr.c										*/
+/*	./rn42_sim > pty.txt &												*/
+/*	./rn42_pty $(cat pty.txt) [max rate]								*/
+/*																		*/
+/*	Try rn42_sim -r 230400 to see a refused rate fall back to the		*/
+/*	next one down, rn42_sim -b 57600 for an RN42 left at the rate of	*/
+/*	an earlier run and rn42_sim -f 230400 for an RN42 that is lost		*/
+/*	after it changed to a rate that does not work.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "PmodBT2.h"
+#include "BT2_emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/************************** Constant Definitions ***************************/
+#define ECHO_TIMEOUT_MS		500
+
+/************************** Variable Definitions ***************************/
+static PmodBT2 myDevice;
+static char szEcho[] = "The quick brown fox jumps over the lazy dog\r\n";
+
+/************************** Function Definitions ***************************/
+
+static void DelayUs(u32 usec)
+{
+	usleep(usec);
+}
+
+static u32 NowMs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+int main(int argc, char *argv[])
+{
+	BT2Emu_Stats st;
+	int maxBaud = 230400;
+	int baud, cb = 0, ms;
+	u32 msStart;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: rn42_pty pty [max rate]\n");
+		return 2;
+	}
+	if (argc > 2) {
+		maxBaud = atoi(argv[2]);
+	}
+	if (BT2Emu_Init(argv[1]) != 0) {
+		perror(argv[1]);
+		return 2;
+	}
+
+	BT2_begin(&myDevice, XPAR_PMODBT2_0_AXI_LITE_GPIO_BASEADDR, XPAR_PMODBT2_0_AXI_LITE_UART_BASEADDR);
+	BT2_SetDelay(DelayUs);
+
+	msStart = NowMs();
+	baud = BT2_negotiateBaud(&myDevice, maxBaud);
+	BT2Emu_GetStats(&st);
+	printf("negotiated %d (UART %u, tty %u) in %u ms, %u rate changes, %u bytes sent, %u received\n",
+		baud, BT2Emu_Baud(), BT2Emu_LineBaud(), NowMs() - msStart, st.cRateChange, st.cbTx, st.cbRx);
+
+	// the end of the last reply
+	usleep(10000);
+	while (XUartNs550_Recv(&myDevice.BT2Uart, (u8*) myDevice.recv, sizeof(myDevice.recv)) > 0) {
+	}
+
+	BT2_sendData(&myDevice, szEcho, strlen(szEcho));
+	memset(myDevice.recv, 0, sizeof(myDevice.recv));
+	for (ms = 0; ms < ECHO_TIMEOUT_MS && cb < (int) strlen(szEcho); ms++) {
+		cb += XUartNs550_Recv(&myDevice.BT2Uart, (u8*) myDevice.recv + cb, strlen(szEcho) - cb);
+		usleep(1000);
+	}
+	if (cb != (int) strlen(szEcho) || memcmp(myDevice.recv, szEcho, cb) != 0) {
+		printf("echo failed, %d bytes back\n", cb);
+		return 1;
+	}
+	printf("echo ok at %d\n", myDevice.baud);
+	return 0;
+}
@@ -0,0 +1,277 @@
+/************************************************************************/
+/*																		*/
+/*	rn42_sim.c	--	Host stand-in for the RN42 of the PmodBT2			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Plays the RN42 on a pty, for testing the baud rate negotiation		*/
+/*	of the PmodBT2 driver on the host.  It prints the path of the pty	*/
+/*	and serves it until it is killed.									*/
+/*																		*/
+/*	In data mode the bytes are echoed, as a peer in loopback would,		*/
+/*	and "$$$" enters command mode with "CMD".  In command mode the		*/
+/*	commands end with a carriage return: "---" leaves with "END",		*/
+/*	"U,<rate>,N" answers "AOK" at the old rate and then changes the		*/
+/*	rate and leaves command mode, "SU,<rate>" and "V" are answered and	*/
+/*	anything else is "?".  The RN42 rate codes are 1200, 2400, 4800,	*/
+/*	9600, 19.2, 28.8, 38.4, 57.6, 115K, 230K, 460K and 921K.			*/
+/*																		*/
+/*	A byte only gets through when the other side of the pty is at		*/
+/*	the rate of the RN42 and that rate is not one given with -f.		*/
+/*	Otherwise the byte is lost, and what the RN42 sends is garbled.		*/
+/*	The RN42 answers "ERR" to a "U" command for a rate given with -r.	*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -o rn42_sim rn42_sim.c								*/
+/*	./rn42_sim [-b rate] [-f rate]... [-r rate]...						*/
+/*																		*/
+/*		-b	rate at the start, default 9600								*/
+/*		-f	a rate at which the link does not work						*/
+/*		-r	a rate that the RN42 refuses								*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+/************************** Constant Definitions ***************************/
+#define SIM_MAX_FAIL	8
+#define SIM_LINE_SIZE	64
+
+/************************** Variable Definitions ***************************/
+
+static const struct {
+	int			baud;
+	const char	*szCode;
+	speed_t		speed;
+} rgRate[] = {
+	{ 1200, "1200", B1200 }, { 2400, "2400", B2400 }, { 4800, "4800", B4800 },
+	{ 9600, "9600", B9600 }, { 19200, "19.2", B19200 }, { 28800, "28.8", B0 },
+	{ 38400, "38.4", B38400 }, { 57600, "57.6", B57600 },
+	{ 115200, "115K", B115200 }, { 230400, "230K", B230400 },
+	{ 460800, "460K", B460800 }, { 921600, "921K", B921600 },
+};
+
+#define SIM_NUM_RATES	(sizeof(rgRate) / sizeof(rgRate[0]))
+
+static int		fdMaster;
+static int		fdSlave;			// kept open for the rate of the other side
+static int		iRate;				// index of the rate in rgRate
+static int		rgbaudFail[SIM_MAX_FAIL];
+static int		cFail;
+static int		rgbaudRefuse[SIM_MAX_FAIL];
+static int		cRefuse;
+
+static int		fCommand;			// in command mode
+static int		cDollar;			// '$' in a row in data mode
+static char		szLine[SIM_LINE_SIZE];
+static int		cchLine;
+
+/************************** Function Definitions ***************************/
+
+static int FindRate(int baud)
+{
+	int i;
+
+	for (i = 0; i < (int) SIM_NUM_RATES; i++) {
+		if (rgRate[i].baud == baud) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* ------------------------------------------------------------ */
+/***	LinkOk
+**
+**	Return Value:
+**		nonzero if the other side is at the rate of the RN42
+*/
+static int LinkOk(void)
+{
+	struct termios tio;
+	int i;
+
+	for (i = 0; i < cFail; i++) {
+		if (rgbaudFail[i] == rgRate[iRate].baud) {
+			return 0;
+		}
+	}
+	if (tcgetattr(fdSlave, &tio) != 0) {
+		return 0;
+	}
+	return cfgetospeed(&tio) == rgRate[iRate].speed;
+}
+
+static int Refused(int baud)
+{
+	int i;
+
+	for (i = 0; i < cRefuse; i++) {
+		if (rgbaudRefuse[i] == baud) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void Reply(const char *sz)
+{
+	char rgch[SIM_LINE_SIZE];
+	int cch = strlen(sz);
+	int ich;
+
+	memcpy(rgch, sz, cch);
+	if (!LinkOk()) {
+		for (ich = 0; ich < cch; ich++) {
+			rgch[ich] ^= 0x5A;
+		}
+	}
+	if (write(fdMaster, rgch, cch) != cch) {
+		perror("rn42_sim: write");
+	}
+}
+
+static void Command(void)
+{
+	char szReply[SIM_LINE_SIZE];
+	int i;
+
+	fprintf(stderr, "rn42_sim: \"%s\"\n", szLine);
+	if (strcmp(szLine, "---") == 0) {
+		Reply("END\r\n");
+		fCommand = 0;
+	}
+	else if (strncmp(szLine, "U,", 2) == 0 && strlen(szLine) == 8 && strcmp(szLine + 6, ",N") == 0) {
+		szLine[6] = '\0';
+		for (i = 0; i < (int) SIM_NUM_RATES && strcmp(rgRate[i].szCode, szLine + 2) != 0; i++) {
+		}
+		if (i == (int) SIM_NUM_RATES || Refused(rgRate[i].baud)) {
+			Reply("ERR\r\n");
+			return;
+		}
+		Reply("AOK\r\n");
+		tcdrain(fdMaster);
+		fprintf(stderr, "rn42_sim: %d -> %d\n", rgRate[iRate].baud, rgRate[i].baud);
+		iRate = i;
+		fCommand = 0;
+	}
+	else if (strncmp(szLine, "SU,", 3) == 0) {
+		Reply("AOK\r\n");
+	}
+	else if (strcmp(szLine, "V") == 0) {
+		sprintf(szReply, "Ver 6.15 04/26/2013\r\n(c) Roving Networks\r\n");
+		Reply(szReply);
+	}
+	else {
+		Reply("?\r\n");
+	}
+}
+
+static void Receive(unsigned char b)
+{
+	if (!LinkOk()) {
+		cDollar = 0;
+		cchLine = 0;
+		return;
+	}
+
+	if (!fCommand) {
+		if (b == '$' && ++cDollar == 3) {
+			fprintf(stderr, "rn42_sim: command mode at %d\n", rgRate[iRate].baud);
+			Reply("CMD\r\n");
+			fCommand = 1;
+			cDollar = 0;
+			cchLine = 0;
+			return;
+		}
+		if (b != '$') {
+			cDollar = 0;
+		}
+		if (write(fdMaster, &b, 1) != 1) {
+			perror("rn42_sim: write");
+		}
+		return;
+	}
+
+	if (b == '\r' || b == '\n') {
+		if (cchLine > 0) {
+			szLine[cchLine] = '\0';
+			Command();
+		}
+		cchLine = 0;
+	}
+	else if (cchLine < SIM_LINE_SIZE - 1) {
+		szLine[cchLine++] = b;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct pollfd pfd;
+	struct termios tio;
+	unsigned char rgb[256];
+	int opt, cb, ib;
+
+	iRate = FindRate(9600);
+	while ((opt = getopt(argc, argv, "b:f:r:")) != -1) {
+		if (opt == 'b' && FindRate(atoi(optarg)) >= 0) {
+			iRate = FindRate(atoi(optarg));
+		}
+		else if (opt == 'f' && cFail < SIM_MAX_FAIL) {
+			rgbaudFail[cFail++] = atoi(optarg);
+		}
+		else if (opt == 'r' && cRefuse < SIM_MAX_FAIL) {
+			rgbaudRefuse[cRefuse++] = atoi(optarg);
+		}
+		else {
+			fprintf(stderr, "usage: rn42_sim [-b rate] [-f rate]... [-r rate]...\n");
+			return 1;
+		}
+	}
+
+	fdMaster = posix_openpt(O_RDWR | O_NOCTTY);
+	if (fdMaster < 0 || grantpt(fdMaster) != 0 || unlockpt(fdMaster) != 0) {
+		perror("rn42_sim: pty");
+		return 1;
+	}
+	fdSlave = open(ptsname(fdMaster), O_RDWR | O_NOCTTY);
+	if (fdSlave < 0) {
+		perror("rn42_sim: pty");
+		return 1;
+	}
+	if (tcgetattr(fdSlave, &tio) == 0) {
+		cfmakeraw(&tio);
+		cfsetspeed(&tio, rgRate[iRate].speed);
+		tcsetattr(fdSlave, TCSANOW, &tio);
+	}
+	printf("%s\n", ptsname(fdMaster));
+	fflush(stdout);
+
+	pfd.fd = fdMaster;
+	pfd.events = POLLIN;
+	for (;;) {
+		if (poll(&pfd, 1, -1) < 0) {
+			break;
+		}
+		cb = read(fdMaster, rgb, sizeof(rgb));
+		for (ib = 0; ib < cb; ib++) {
+			Receive(rgb[ib]);
+		}
+	}
+	return 0;
+}
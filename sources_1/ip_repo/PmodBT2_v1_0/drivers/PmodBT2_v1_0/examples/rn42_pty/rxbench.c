@@ -0,0 +1,244 @@
+/************************************************************************/
+/*																		*/
+/*	rxbench.c	--	XUartNs550 receive loop on a register model			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Times XUartNs550_ReceiveBuffer() against the receive loop it had	*/
+/*	before, which updated the statistics for every byte, on a model		*/
+/*	of the receive FIFO and line status register.  The FIFO is filled	*/
+/*	with bursts of 1, 4, 8, 14 and 16 bytes, the trigger levels and		*/
+/*	the depth, and emptied with one call, as the interrupt handler		*/
+/*	does.  Each burst size runs without errors and with a parity		*/
+/*	error every 61 bytes and a break every 97, and the bytes, the		*/
+/*	statistics and the last errors of the two loops must match.			*/
+/*																		*/
+/*	It prints the register reads for each byte, which are AXI			*/
+/*	transactions on the MicroBlaze and the same for both loops, and		*/
+/*	the host CPU cycles for each byte, which are the instructions		*/
+/*	around them.  The model is kept small so it does not hide them.		*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -O2 -I. -Ibsp -I../../src -o rxbench rxbench.c		*/
+/*		../../src/xuartns550.c ../../src/xuartns550_stats.c				*/
+/*	./rxbench															*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "xuartns550.h"
+#include "xuartns550_i.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/************************** Constant Definitions ***************************/
+#define UART_BASE		0x44A30000
+#define BENCH_BYTES		4000000		// bytes received by each run
+#define PARITY_EVERY	61			// a parity error every 61 bytes
+#define BREAK_EVERY		97			// and a break every 97
+#define BENCH_RUNS		5			// runs of each loop, the fastest counts
+
+/************************** Type Definitions *******************************/
+
+typedef unsigned int (*Receive)(XUartNs550 *InstancePtr);
+
+/************************** Variable Definitions ***************************/
+static u8 rgbFifo[XUN_FIFO_SIZE];
+static u8 rglsrFifo[XUN_FIFO_SIZE];	// error bits of each byte in the FIFO
+static int ibFifo, cbFifo, cErrFifo;
+static u32 cRegRead;
+static u8 rgbBuf[2][BENCH_BYTES];
+static const int rgcbBurst[] = { 1, 4, 8, 14, 16 };
+
+/************************** Function Definitions ***************************/
+
+/*
+** The register model, only the receive side.  The parity, framing and
+** break bits are those of the byte at the top of the FIFO, and the FIFO
+** error bit is set while any byte in it has one.
+*/
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 data = 0;
+
+	cRegRead++;
+	if (Addr == UART_BASE + XUN_LSR_OFFSET) {
+		if (cbFifo > 0) {
+			data = XUN_LSR_DATA_READY | rglsrFifo[ibFifo];
+			if (cErrFifo > 0) {
+				data |= XUN_LSR_RX_FIFO_ERROR;
+			}
+		}
+	}
+	else if (Addr == UART_BASE + XUN_RBR_OFFSET && cbFifo > 0) {
+		data = rgbFifo[ibFifo];
+		if (rglsrFifo[ibFifo] != 0) {
+			cErrFifo--;
+		}
+		ibFifo = (ibFifo + 1) % XUN_FIFO_SIZE;
+		cbFifo--;
+	}
+	return data;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	(void) Addr;
+	(void) Value;
+}
+
+void Xil_Assert(const char *File, s32 Line)
+{
+	printf("assert failed at %s:%d\n", File, (int) Line);
+	exit(2);
+}
+
+/*
+** The receive loop before the change, it reads the line status and
+** updates the statistics for every byte.
+*/
+static unsigned int ReceiveBufferRef(XUartNs550 *InstancePtr)
+{
+	u32 LsrRegister;
+	unsigned int ReceivedCount = 0;
+
+	while (ReceivedCount < InstancePtr->ReceiveBuffer.RemainingBytes) {
+		LsrRegister =
+			XUartNs550_GetLineStatusReg(InstancePtr->BaseAddress);
+
+		if (LsrRegister & XUN_LSR_BREAK_INT) {
+			(void)XUartNs550_ReadReg(InstancePtr->BaseAddress,
+							XUN_RBR_OFFSET);
+			XUartNs550_UpdateStats(InstancePtr, (u8)LsrRegister);
+		}
+		else if (LsrRegister & XUN_LSR_DATA_READY) {
+			InstancePtr->ReceiveBuffer.NextBytePtr[ReceivedCount++] =
+			XUartNs550_ReadReg(InstancePtr->BaseAddress,
+						XUN_RBR_OFFSET);
+
+			XUartNs550_UpdateStats(InstancePtr, (u8)LsrRegister);
+		}
+		else {
+			break;
+		}
+	}
+
+	InstancePtr->ReceiveBuffer.NextBytePtr += ReceivedCount;
+	InstancePtr->ReceiveBuffer.RemainingBytes -= ReceivedCount;
+	InstancePtr->Stats.CharactersReceived += ReceivedCount;
+
+	return ReceivedCount;
+}
+
+static u64 Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/*
+** Receives BENCH_BYTES bytes in bursts of cbBurst into pb, and returns
+** the cycles it took, without the filling of the FIFO.  The bytes received
+** are counted here since the 16 bit count in the statistics wraps.
+*/
+static u64 Run(XUartNs550 *pUart, Receive pfn, u8 *pb, int cbBurst, int fErrors, u32 *pcRead, u32 *pcb)
+{
+	u64 cycles = 0, start;
+	u32 ib = 0, cb = 0, i;
+
+	memset(pUart, 0, sizeof(*pUart));
+	pUart->BaseAddress = UART_BASE;
+	pUart->IsReady = XIL_COMPONENT_IS_READY;
+	pUart->ReceiveBuffer.NextBytePtr = pb;
+	pUart->ReceiveBuffer.RequestedBytes = BENCH_BYTES;
+	pUart->ReceiveBuffer.RemainingBytes = BENCH_BYTES;
+	*pcRead = 0;
+
+	while (pUart->ReceiveBuffer.RemainingBytes > 0) {
+		ibFifo = cbFifo = cErrFifo = 0;
+		for (i = 0; i < (u32) cbBurst && ib < BENCH_BYTES; i++, ib++) {
+			rgbFifo[i] = (u8) (ib * 7 + 3);
+			rglsrFifo[i] = 0;
+			if (fErrors && ib % BREAK_EVERY == BREAK_EVERY - 1) {
+				rgbFifo[i] = 0;
+				rglsrFifo[i] = XUN_LSR_BREAK_INT;
+			}
+			else if (fErrors && ib % PARITY_EVERY == PARITY_EVERY - 1) {
+				rglsrFifo[i] = XUN_LSR_PARITY_ERROR;
+			}
+			cErrFifo += (rglsrFifo[i] != 0);
+			cbFifo++;
+		}
+
+		cRegRead = 0;
+		start = Cycles();
+		cb += pfn(pUart);
+		cycles += Cycles() - start;
+		*pcRead += cRegRead;
+
+		// a break byte is dropped, so the buffer ends before the bytes do
+		if (ib >= BENCH_BYTES && cbFifo == 0) {
+			break;
+		}
+	}
+	*pcb = cb;
+	return cycles;
+}
+
+int main(void)
+{
+	XUartNs550 rgUart[2];
+	u64 rgcycles[2], cycles;
+	u32 rgcRead[2], rgcb[2], cb;
+	int iburst, fErrors, irun, fOk = 1, fSame;
+
+	printf("%-6s %5s %12s %12s %12s %12s\n", "burst", "errs",
+		"reads/byte", "cycles/byte", "cycles/byte", "bytes/kcycle");
+	printf("%-6s %5s %12s %12s %12s %12s\n", "", "", "", "before", "after", "after");
+	for (iburst = 0; iburst < (int) (sizeof(rgcbBurst) / sizeof(rgcbBurst[0])); iburst++) {
+		for (fErrors = 0; fErrors < 2; fErrors++) {
+			// the loops take turns and the fastest run of each counts
+			rgcycles[0] = rgcycles[1] = ~(u64) 0;
+			for (irun = 0; irun < BENCH_RUNS; irun++) {
+				cycles = Run(&rgUart[0], ReceiveBufferRef, rgbBuf[0], rgcbBurst[iburst], fErrors, &rgcRead[0], &rgcb[0]);
+				if (cycles < rgcycles[0]) {
+					rgcycles[0] = cycles;
+				}
+				cycles = Run(&rgUart[1], XUartNs550_ReceiveBuffer, rgbBuf[1], rgcbBurst[iburst], fErrors, &rgcRead[1], &rgcb[1]);
+				if (cycles < rgcycles[1]) {
+					rgcycles[1] = cycles;
+				}
+			}
+
+			cb = rgcb[1];
+			fSame = rgcb[0] == rgcb[1] && rgcRead[0] == rgcRead[1]
+				&& memcmp(&rgUart[0].Stats, &rgUart[1].Stats, sizeof(XUartNs550Stats)) == 0
+				&& (rgUart[0].LastErrors & XUN_LSR_ERROR_BREAK) == (rgUart[1].LastErrors & XUN_LSR_ERROR_BREAK)
+				&& memcmp(rgbBuf[0], rgbBuf[1], cb) == 0;
+			fOk &= fSame;
+			printf("%-6d %5s %12.2f %12.2f %12.2f %12.1f  %s\n", rgcbBurst[iburst],
+				fErrors ? "yes" : "no", (double) rgcRead[1] / cb,
+				(double) rgcycles[0] / cb, (double) rgcycles[1] / cb,
+				1000.0 * cb / rgcycles[1], fSame ? "same" : "DIFFERENT");
+		}
+	}
+	return fOk ? 0 : 1;
+}
@@ -0,0 +1,208 @@
+/************************************************************************/
+/*																		*/
+/*	traffic.c	--	PmodBT2 interrupt driven receive on a virtual wire	*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Runs the interrupt driven rings of the PmodBT2 driver on the wire	*/
+/*	of the UART model, with the receive FIFO trigger level fixed at		*/
+/*	1, 4, 8 and 14 bytes and following the traffic, for three kinds		*/
+/*	of traffic: short commands, one long transfer, and commands with	*/
+/*	long transfers among them.  Every command is answered, so the		*/
+/*	transmit ring runs too.  The ring is read every 5 ms, as the		*/
+/*	remote control task does, and the bytes are checked.				*/
+/*																		*/
+/*	For each run it prints the receive interrupts, how many of them		*/
+/*	were timeouts, the trigger level changes, the mean and longest		*/
+/*	wait of a byte in the FIFO as the driver counts it, and as the		*/
+/*	model measures it, in microseconds.									*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -I. -Ibsp -I../../src -o bt2_traffic traffic.c		*/
+/*		BT2_emu.c ../../src/PmodBT2.c ../../src/xuartns550.c			*/
+/*		../../src/xuartns550_l.c ../../src/xuartns550_options.c			*/
+/*		../../src/xuartns550_format.c ../../src/xuartns550_stats.c		*/
+/*		../../src/xuartns550_intr.c										*/
+/*	./bt2_traffic [rate]												*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "PmodBT2.h"
+#include "BT2_emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+#define READ_US			5000		// period of the remote control task
+#define DRAIN_US		50000		// run after the last message
+#define COMMAND_US		20000		// a command every 20 ms
+#define COMMAND_LEN		10
+#define REPLY_LEN		12
+#define MAX_MESSAGES	256
+#define MAX_STREAM		65536
+
+/************************** Type Definitions *******************************/
+
+typedef struct {
+	u32		us;						// when it is sent
+	u32		len;
+} Message;
+
+typedef struct {
+	const char	*szName;
+	Message		rgmsg[MAX_MESSAGES];
+	int			cmsg;
+} Pattern;
+
+/************************** Variable Definitions ***************************/
+static PmodBT2 myDevice;
+static u8 rgbStream[MAX_STREAM];	// bytes sent, in order
+static u8 rgbRead[BT2_RX_RING_SIZE];
+static Pattern rgpat[3];
+static const int rglevel[] = { 1, 4, 8, 14, BT2_TRIGGER_AUTO };
+
+/************************** Function Definitions ***************************/
+
+static void AddMessage(Pattern *ppat, u32 us, u32 len)
+{
+	int i = ppat->cmsg++;
+
+	// in time order
+	while (i > 0 && ppat->rgmsg[i - 1].us > us) {
+		ppat->rgmsg[i] = ppat->rgmsg[i - 1];
+		i--;
+	}
+	ppat->rgmsg[i].us = us;
+	ppat->rgmsg[i].len = len;
+}
+
+static void MakePatterns(void)
+{
+	u32 us;
+
+	rgpat[0].szName = "commands";
+	for (us = 0; us < 2000000; us += COMMAND_US) {
+		AddMessage(&rgpat[0], us, COMMAND_LEN);
+	}
+
+	rgpat[1].szName = "bulk";
+	AddMessage(&rgpat[1], 0, 8192);
+
+	rgpat[2].szName = "mixed";
+	for (us = 0; us < 2000000; us += COMMAND_US) {
+		AddMessage(&rgpat[2], us, COMMAND_LEN);
+	}
+	AddMessage(&rgpat[2], 500000, 1024);
+	AddMessage(&rgpat[2], 1500000, 1024);
+}
+
+static int Run(const Pattern *ppat, int level, int baud)
+{
+	BT2_Stats st;
+	BT2Emu_Stats est;
+	u8 rgbReply[REPLY_LEN];
+	u32 cbSent = 0, cbChecked = 0, cbQueued = 0, usEnd, usNext, usRead = 0, charUs;
+	int imsg = 0, cReplies = 0, cb, i, fOk = 1;
+
+	BT2Emu_Init(NULL);
+	BT2_begin(&myDevice, XPAR_PMODBT2_0_AXI_LITE_GPIO_BASEADDR, XPAR_PMODBT2_0_AXI_LITE_UART_BASEADDR);
+	if (BT2_changeBaud(&myDevice, baud) != XST_SUCCESS) {
+		printf("the UART can not make %d\n", baud);
+		return 0;
+	}
+	BT2Emu_SetIsr((BT2Emu_Isr) XUartNs550_InterruptHandler, &myDevice.BT2Uart);
+	BT2_setTrigger(&myDevice, level);
+	if (BT2_startInterrupts(&myDevice) != XST_SUCCESS) {
+		printf("BT2_startInterrupts failed\n");
+		return 0;
+	}
+	BT2_resetStats(&myDevice);
+	BT2Emu_ResetStats();
+	memset(rgbReply, 'r', sizeof(rgbReply));
+
+	// the messages are queued on the wire back to back
+	for (i = 0, cb = 0; i < ppat->cmsg; i++) {
+		cb += ppat->rgmsg[i].len;
+	}
+	usEnd = ppat->rgmsg[ppat->cmsg - 1].us + (u32) ((u64) cb * 10000000 / baud) + DRAIN_US;
+	while (BT2Emu_Now() < usEnd) {
+		usNext = usRead;
+		if (imsg < ppat->cmsg && ppat->rgmsg[imsg].us < usNext) {
+			usNext = ppat->rgmsg[imsg].us;
+		}
+		BT2Emu_Run(usNext - BT2Emu_Now());
+
+		while (imsg < ppat->cmsg && ppat->rgmsg[imsg].us <= BT2Emu_Now()) {
+			for (i = 0; i < (int) ppat->rgmsg[imsg].len; i++) {
+				rgbStream[(cbSent + i) % MAX_STREAM] = rand();
+			}
+			for (i = 0; i < (int) ppat->rgmsg[imsg].len; i++) {
+				BT2Emu_Feed(&rgbStream[(cbSent + i) % MAX_STREAM], 1);
+			}
+			cbSent += ppat->rgmsg[imsg].len;
+			if (ppat->rgmsg[imsg].len == COMMAND_LEN) {
+				cReplies++;
+			}
+			imsg++;
+		}
+
+		if (BT2Emu_Now() >= usRead) {
+			while ((cb = BT2_readData(&myDevice, rgbRead, sizeof(rgbRead))) > 0) {
+				for (i = 0; i < cb; i++) {
+					if (rgbRead[i] != rgbStream[(cbChecked + i) % MAX_STREAM]) {
+						fOk = 0;
+					}
+				}
+				cbChecked += cb;
+			}
+			for (; cReplies > 0; cReplies--) {
+				if (BT2_queueData(&myDevice, rgbReply, REPLY_LEN) == XST_SUCCESS) {
+					cbQueued += REPLY_LEN;
+				}
+			}
+			usRead += READ_US;
+		}
+	}
+
+	BT2_getStats(&myDevice, &st);
+	BT2Emu_GetStats(&est);
+	charUs = 10000000 / baud;
+	printf("%-9s %4s %6u %6u %5u %8u %8u %8u %8u  %s\n", ppat->szName,
+		(level == BT2_TRIGGER_AUTO) ? "auto" : (level == 1) ? "1" : (level == 4) ? "4" : (level == 8) ? "8" : "14",
+		st.rxInterrupts, st.rxTimeouts, st.triggerChanges,
+		st.rxInterrupts ? st.latencySum * charUs / st.rxInterrupts : 0, st.latencyMax * charUs,
+		est.cbRx ? (u32) (est.nsLatencySum / est.cbRx / 1000) : 0, (u32) (est.nsLatencyMax / 1000),
+		(fOk && cbChecked == cbSent && est.cbTx == cbQueued && est.cStorm == 0 && est.cbOverrun == 0 && st.rxDropped == 0)
+			? "ok" : "FAILED");
+	if (cbChecked != cbSent || est.cbTx != cbQueued || est.cbOverrun != 0 || st.rxDropped != 0) {
+		printf("    received %u of %u, sent %u of %u, overrun %u, dropped %u, storms %u\n",
+			cbChecked, cbSent, est.cbTx, cbQueued, est.cbOverrun, st.rxDropped, est.cStorm);
+	}
+	return fOk && cbChecked == cbSent && est.cbTx == cbQueued;
+}
+
+int main(int argc, char *argv[])
+{
+	int baud = (argc > 1) ? atoi(argv[1]) : 230400;
+	int ipat, ilevel, fOk = 1;
+
+	MakePatterns();
+	printf("%d baud, a byte every %d us\n", baud, 10000000 / baud);
+	printf("%-9s %4s %6s %6s %5s %8s %8s %8s %8s\n", "traffic", "trig", "irqs", "tmo",
+		"chg", "drv mean", "drv max", "emu mean", "emu max");
+	for (ipat = 0; ipat < 3; ipat++) {
+		for (ilevel = 0; ilevel < (int) (sizeof(rglevel) / sizeof(rglevel[0])); ilevel++) {
+			fOk &= Run(&rgpat[ipat], rglevel[ilevel], baud);
+		}
+	}
+	return fOk ? 0 : 1;
+}
@@ -27,6 +27,7 @@
 /*  Revision History:																										*/
 /*																																			*/
 /*	07/19/2016(MikelS): Created 																				*/
+/*	06/18/2017: added the RN42 command mode and baud rate negotiation	*/
 /*																																			*/
 /************************************************************************/
 
@@ -41,9 +42,293 @@ XUartNs550_Config BT2_Config =
 		0,
 		0,
 		PERIPHERAL_CLK,
-		9600
+		BT2_DEFAULT_BAUD
 };
 
+static BT2_DelayFunc BT2_delay = NULL;	// delay set by BT2_SetDelay()
+
+/* The rates of the RN42 UART, fastest first, with the rate as the RN42
+** "U" command takes it.
+*/
+static const struct{
+	int baud;
+	char *code;
+}BT2_Rates[] =
+{
+	{921600,	"921K"},
+	{460800,	"460K"},
+	{230400,	"230K"},
+	{115200,	"115K"},
+	{57600,		"57.6"},
+	{38400,		"38.4"},
+	{19200,		"19.2"},
+	{9600,		"9600"},
+};
+
+#define BT2_NUM_RATES	(sizeof(BT2_Rates) / sizeof(BT2_Rates[0]))
+
+/* The receive FIFO trigger levels, with the length of a burst from which
+** each is used when the level follows the traffic.  At 1 every byte
+** interrupts at once, at 14 a long transfer interrupts once for every 14
+** bytes but the end of a short message waits BT2_TIMEOUT_CHARS character
+** times for the receive timeout.  The level stays at 1 for bursts up to
+** 16 bytes, longer than a remote control command or a parameter request.
+*/
+static const struct{
+	u8 level;
+	u8 reg;
+	u32 burst;
+}BT2_Triggers[] =
+{
+	{1,		XUN_FIFO_TRIGGER_01,	0},
+	{4,		XUN_FIFO_TRIGGER_04,	16},
+	{8,		XUN_FIFO_TRIGGER_08,	32},
+	{14,	XUN_FIFO_TRIGGER_14,	48},
+};
+
+#define BT2_NUM_TRIGGERS	(sizeof(BT2_Triggers) / sizeof(BT2_Triggers[0]))
+
+/* ------------------------------------------------------------ */
+/*  BT2_wait(u32 usec)
+**
+**  Description:
+**    Waits with the delay function set by BT2_SetDelay(), or else
+**    with a loop that assumes a 100 MHz MicroBlaze and about 10
+**    clocks per iteration
+**
+******************************************************************/
+static void BT2_wait(u32 usec)
+{
+	volatile u32 i;
+
+	if (BT2_delay != NULL) {
+		BT2_delay(usec);
+		return;
+	}
+	for (i = 0; i < usec * 10; i++) {
+	}
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_code(int baud)
+**
+**  Description:
+**    The RN42 "U" command rate of a baud rate, NULL if it has none
+**
+******************************************************************/
+static char* BT2_code(int baud)
+{
+	u32 i;
+
+	for (i = 0; i < BT2_NUM_RATES; i++) {
+		if (BT2_Rates[i].baud == baud) {
+			return BT2_Rates[i].code;
+		}
+	}
+	return NULL;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_setRN42Baud(PmodBT2* InstancePtr, int baud)
+**
+**  Description:
+**    Asks the RN42 to change its rate, then changes the UART to it.
+**    The RN42 answers at the old rate, then changes.  The "U" change
+**    lasts until the RN42 is powered off, so a power cycle puts both
+**    back to BT2_DEFAULT_BAUD
+**
+******************************************************************/
+static int BT2_setRN42Baud(PmodBT2* InstancePtr, int baud)
+{
+	char cmd[16];
+
+	if (BT2_enterCommand(InstancePtr) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	strcpy(cmd, "U,");
+	strcat(cmd, BT2_code(baud));
+	strcat(cmd, ",N\r");
+	if (BT2_command(InstancePtr, cmd, "AOK") != XST_SUCCESS) {
+		BT2_exitCommand(InstancePtr);
+		return XST_FAILURE;
+	}
+	BT2_wait(BT2_SWITCH_MS * 1000);
+	return BT2_changeBaud(InstancePtr, baud);
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_findRN42(PmodBT2* InstancePtr, int baud)
+**
+**  Description:
+**    Looks for the RN42 at every rate, and when it answers puts it
+**    back to baud
+**
+******************************************************************/
+static int BT2_findRN42(PmodBT2* InstancePtr, int baud)
+{
+	u32 i;
+
+	for (i = 0; i < BT2_NUM_RATES; i++) {
+		if (BT2_changeBaud(InstancePtr, BT2_Rates[i].baud) != XST_SUCCESS) {
+			continue;
+		}
+		if (BT2_enterCommand(InstancePtr) == XST_SUCCESS) {
+			BT2_exitCommand(InstancePtr);
+			return (BT2_Rates[i].baud == baud) ? XST_SUCCESS : BT2_setRN42Baud(InstancePtr, baud);
+		}
+	}
+	return XST_FAILURE;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_setLevel(PmodBT2* InstancePtr, u8 level)
+**
+**  Description:
+**    Sets the receive FIFO trigger level, in bytes.  Changing the
+**    level does not reset the FIFO
+**
+******************************************************************/
+static void BT2_setLevel(PmodBT2* InstancePtr, u8 level)
+{
+	u32 i;
+
+	if (level == InstancePtr->trigger) {
+		return;
+	}
+	for (i = 0; i < BT2_NUM_TRIGGERS; i++) {
+		if (BT2_Triggers[i].level == level) {
+			if (XUartNs550_SetFifoThreshold(&InstancePtr->BT2Uart, BT2_Triggers[i].reg) == XST_SUCCESS) {
+				InstancePtr->trigger = level;
+				InstancePtr->stats.triggerChanges++;
+			}
+			return;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_armRecv(PmodBT2* InstancePtr)
+**
+**  Description:
+**    Gives the UART driver the free space at rxTail to receive into,
+**    or rxDrop when rxRing is full.  The UART driver moves what the
+**    FIFO has at once, those bytes are returned
+**
+******************************************************************/
+static u32 BT2_armRecv(PmodBT2* InstancePtr)
+{
+	u32 head = InstancePtr->rxHead, tail = InstancePtr->rxTail, len, count;
+
+	//to the end of the ring or the byte before rxHead, whichever is first
+	len = (head > tail) ? head - tail - 1 : BT2_RX_RING_SIZE - tail - (head == 0);
+	InstancePtr->rxDropping = (len == 0);
+	if (InstancePtr->rxDropping) {
+		count = XUartNs550_Recv(&InstancePtr->BT2Uart, InstancePtr->rxDrop, XUN_FIFO_SIZE);
+		InstancePtr->stats.rxDropped += count;
+	}
+	else {
+		count = XUartNs550_Recv(&InstancePtr->BT2Uart, &InstancePtr->rxRing[tail], len);
+		InstancePtr->rxTail = (tail + count) & (BT2_RX_RING_SIZE - 1);
+	}
+	InstancePtr->rxArmed = count;
+	return count;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_startSend(PmodBT2* InstancePtr)
+**
+**  Description:
+**    Gives the UART driver the queued bytes up to the end of txRing.
+**    It sends what fits in the FIFO and the rest from the transmit
+**    interrupt
+**
+******************************************************************/
+static void BT2_startSend(PmodBT2* InstancePtr)
+{
+	u32 head = InstancePtr->txHead, tail = InstancePtr->txTail;
+
+	// before the send, the transmit interrupt can come at once
+	InstancePtr->txBusy = (tail >= head) ? tail - head : BT2_TX_RING_SIZE - head;
+	XUartNs550_Send(&InstancePtr->BT2Uart, &InstancePtr->txRing[head], InstancePtr->txBusy);
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_ringHandler(void *CallBackRef, u32 Event, unsigned int EventData)
+**
+**  Description:
+**    UART driver handler set by BT2_startInterrupts(), called in the
+**    interrupt.  Moves the received bytes into rxRing and arms the
+**    next receive, and starts the next send when one is done.
+**
+**    The UART interrupts when the FIFO reaches the trigger level, or
+**    with fewer bytes after BT2_TIMEOUT_CHARS idle character times.
+**    The wait of the oldest byte in the FIFO is counted in character
+**    times from the bytes that came after it and the timeout.  While
+**    the level follows the traffic it goes up as the burst gets long,
+**    BT2_readData() puts it back to 1 at the next gap
+**
+******************************************************************/
+static void BT2_ringHandler(void *CallBackRef, u32 Event, unsigned int EventData)
+{
+	PmodBT2* InstancePtr = (PmodBT2*) CallBackRef;
+	BT2_Stats* stats = &InstancePtr->stats;
+	u32 count, wait, i;
+
+	if (Event == XUN_EVENT_SENT_DATA) {
+		// the interrupt can come again after the send is done
+		if (InstancePtr->txBusy == 0) {
+			return;
+		}
+		InstancePtr->txHead = (InstancePtr->txHead + InstancePtr->txBusy) & (BT2_TX_RING_SIZE - 1);
+		InstancePtr->txBusy = 0;
+		if (InstancePtr->txHead != InstancePtr->txTail) {
+			BT2_startSend(InstancePtr);
+		}
+		return;
+	}
+	if (Event == XUN_EVENT_MODEM) {
+		return;
+	}
+
+	// the bytes received since the buffer was armed, and those in the FIFO now
+	count = EventData - InstancePtr->rxArmed;
+	if (InstancePtr->rxDropping) {
+		stats->rxDropped += count;
+	}
+	else {
+		InstancePtr->rxTail = (InstancePtr->rxTail + count) & (BT2_RX_RING_SIZE - 1);
+	}
+	count += BT2_armRecv(InstancePtr);
+
+	if (Event == XUN_EVENT_RECV_ERROR) {
+		stats->rxErrors++;
+	}
+	if (count == 0) {
+		return;
+	}
+
+	stats->rxInterrupts++;
+	stats->rxBytes += count;
+	wait = count - 1;
+	if (count < InstancePtr->trigger) {
+		stats->rxTimeouts++;
+		wait += BT2_TIMEOUT_CHARS;
+	}
+	if (wait > stats->latencyMax) {
+		stats->latencyMax = wait;
+	}
+	stats->latencySum += wait;
+
+	InstancePtr->burst += count;
+	if (InstancePtr->triggerFixed == BT2_TRIGGER_AUTO) {
+		for (i = BT2_NUM_TRIGGERS - 1; i > 0 && InstancePtr->burst < BT2_Triggers[i].burst; i--) {
+		}
+		if (BT2_Triggers[i].level > InstancePtr->trigger) {
+			BT2_setLevel(InstancePtr, BT2_Triggers[i].level);
+		}
+	}
+}
+
 /* ------------------------------------------------------------ */
 /*  BT2_begin(PmodBT2* InstancePtr, u32 GPIO_Address, u32 UART_Address)
 **
@@ -66,6 +351,9 @@ void BT2_begin(PmodBT2* InstancePtr, u32 GPIO_Address, u32 UART_Address)
 {
 	InstancePtr->GPIO_addr=GPIO_Address;
 	BT2_Config.BaseAddress=UART_Address;
+	InstancePtr->baud=BT2_Config.DefaultBaudRate;
+	InstancePtr->trigger=1;
+	InstancePtr->triggerFixed=BT2_TRIGGER_AUTO;
 	Xil_Out32(InstancePtr->GPIO_addr+4, 0b11);//Set pins to inputs
 	BT2_UARTInit(&InstancePtr->BT2Uart);
 }
@@ -134,21 +422,443 @@ int BT2_sendData(PmodBT2* InstancePtr, char* sendData, int size)
 **	  baud:			Desired baud rate to set the PmodBT2 to
 **
 **  Return Value:
-**    1 if successful, 0 if invalid baud
+**    XST_SUCCESS if successful, XST_UART_BAUD_ERROR if the UART clock
+**    can not make the rate within BT2_MAX_BAUD_ERROR
 **
 **  Errors:
 **    none
 **
 **  Description:
-**    Changes the baud rate of the PmodBT2
+**    Changes the baud rate of the PmodBT2 UART.  The RN42 is not
+**    told, BT2_negotiateBaud() changes both
 **
 ******************************************************************/
 int BT2_changeBaud(PmodBT2* InstancePtr, int baud){
+	if (BT2_baudError(baud) > BT2_MAX_BAUD_ERROR) {
+		return XST_UART_BAUD_ERROR;
+	}
 	XUartNs550_SetBaud(InstancePtr->BT2Uart.BaseAddress, PERIPHERAL_CLK,baud);
+	InstancePtr->BT2Uart.BaudRate = baud;
+	InstancePtr->baud = baud;
+
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_baudError(int baud)
+**
+**  Parameters:
+**	  baud:			Baud rate
+**
+**  Return Value:
+**    The error of the rate the UART makes for baud, in tenths of a
+**    percent
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    The UART divides PERIPHERAL_CLK by 16 times a whole divisor, so
+**    the fast rates are only close.  At 100 MHz 921600 and 460800 are
+**    3% off, which with the error of the RN42 is too much
+**
+******************************************************************/
+int BT2_baudError(int baud){
+	u32 divisor, target, error;
+
+	divisor = (PERIPHERAL_CLK + (baud * 16UL) / 2) / (baud * 16UL);
+	if (divisor == 0) {
+		return 1000;
+	}
+	target = divisor * baud * 16UL;
+	error = (target > PERIPHERAL_CLK) ? target - PERIPHERAL_CLK : PERIPHERAL_CLK - target;
+	return error / (PERIPHERAL_CLK / 1000);
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_SetDelay(BT2_DelayFunc delay_us)
+**
+**  Parameters:
+**	  delay_us:		Function that waits a number of microseconds, or
+**					NULL for the built in loop
+**
+**  Return Value:
+**    none
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Sets the delay used while waiting for the RN42
+**
+******************************************************************/
+void BT2_SetDelay(BT2_DelayFunc delay_us){
+	BT2_delay = delay_us;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_command(PmodBT2* InstancePtr, char* cmd, char* reply)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**	  cmd:			Command to send, with its carriage return
+**	  reply:		Text the reply must contain
+**
+**  Return Value:
+**    XST_SUCCESS if the reply came within BT2_CMD_TIMEOUT_MS,
+**    XST_FAILURE if not
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Sends a command to the RN42 and waits for its reply.  Anything
+**    received before the command is dropped
+**
+******************************************************************/
+int BT2_command(PmodBT2* InstancePtr, char* cmd, char* reply){
+	char buf[BT2_REPLY_SIZE + 1];
+	u32 len = 0, ms;
+	u8 byte;
+
+	while (XUartNs550_Recv(&InstancePtr->BT2Uart, &byte, 1) > 0) {
+	}
+	BT2_sendData(InstancePtr, cmd, strlen(cmd));
+
+	for (ms = 0; ms < BT2_CMD_TIMEOUT_MS; ms++) {
+		while (XUartNs550_Recv(&InstancePtr->BT2Uart, &byte, 1) > 0) {
+			// keep the end of a long reply
+			if (len == BT2_REPLY_SIZE) {
+				memmove(buf, buf + 1, --len);
+			}
+			buf[len++] = byte;
+			buf[len] = '\0';
+			if (strstr(buf, reply) != NULL) {
+				return XST_SUCCESS;
+			}
+		}
+		BT2_wait(1000);
+	}
+	return XST_FAILURE;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_enterCommand(PmodBT2* InstancePtr)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**
+**  Return Value:
+**    XST_SUCCESS if the RN42 is in command mode, XST_FAILURE if not
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Puts the RN42 in command mode
+**
+******************************************************************/
+int BT2_enterCommand(PmodBT2* InstancePtr){
+	return BT2_command(InstancePtr, "$$$", "CMD");
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_exitCommand(PmodBT2* InstancePtr)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**
+**  Return Value:
+**    XST_SUCCESS if the RN42 left command mode, XST_FAILURE if not
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Puts the RN42 back in data mode
+**
+******************************************************************/
+int BT2_exitCommand(PmodBT2* InstancePtr){
+	return BT2_command(InstancePtr, "---\r", "END");
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_negotiateBaud(PmodBT2* InstancePtr, int maxBaud)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**	  maxBaud:		Fastest rate to try
+**
+**  Return Value:
+**    The rate in use, or 0 if the RN42 was not found, and then the
+**    UART is left at the old rate
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Moves the RN42 and the UART to the fastest rate up to maxBaud
+**    that the UART clock makes closely enough and that works.  An
+**    RN42 that does not answer at the old rate is first looked for
+**    at every rate and put back to the old one, it is still at the
+**    rate of an earlier run if only the processor was reset.  Then
+**    for each rate, fastest first: the RN42 is told the rate in
+**    command mode, the UART changes, and the rate is checked by
+**    entering and leaving command mode again.  When the check fails
+**    the old rate is tried, and if the RN42 is not there either it
+**    is looked for at every rate and put back to the old one.  Then
+**    the next rate down is tried.  Call it while the UART is polled,
+**    before the link is used
+**
+******************************************************************/
+int BT2_negotiateBaud(PmodBT2* InstancePtr, int maxBaud){
+	int old = InstancePtr->baud;
+	u32 i;
+
+	// the RN42 keeps a "U" rate over a reset of the processor
+	if (BT2_enterCommand(InstancePtr) == XST_SUCCESS) {
+		BT2_exitCommand(InstancePtr);
+	}
+	else if (BT2_findRN42(InstancePtr, old) != XST_SUCCESS) {
+		BT2_changeBaud(InstancePtr, old);
+		return 0;
+	}
+
+	for (i = 0; i < BT2_NUM_RATES && BT2_Rates[i].baud > old; i++) {
+		if (BT2_Rates[i].baud > maxBaud || BT2_baudError(BT2_Rates[i].baud) > BT2_MAX_BAUD_ERROR) {
+			continue;
+		}
+
+		if (BT2_setRN42Baud(InstancePtr, BT2_Rates[i].baud) == XST_SUCCESS
+				&& BT2_enterCommand(InstancePtr) == XST_SUCCESS
+				&& BT2_exitCommand(InstancePtr) == XST_SUCCESS) {
+			return InstancePtr->baud;
+		}
+
+		// fall back to the old rate
+		BT2_changeBaud(InstancePtr, old);
+		if (BT2_enterCommand(InstancePtr) == XST_SUCCESS) {
+			BT2_exitCommand(InstancePtr);
+		}
+		else if (BT2_findRN42(InstancePtr, old) != XST_SUCCESS) {
+			BT2_changeBaud(InstancePtr, old);
+			return 0;
+		}
+	}
+	return InstancePtr->baud;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_startInterrupts(PmodBT2* InstancePtr)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**
+**  Return Value:
+**    XST_SUCCESS, or XST_FAILURE if the FIFOs do not work
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Moves the UART to interrupt driven receive and transmit through
+**    rxRing and txRing, read with BT2_readData() and written with
+**    BT2_queueData().  The application connects
+**    XUartNs550_InterruptHandler() with &InstancePtr->BT2Uart to the
+**    UART interrupt, before or after.  The polled functions, and so
+**    BT2_negotiateBaud(), must not be used afterwards
+**
+******************************************************************/
+int BT2_startInterrupts(PmodBT2* InstancePtr){
+	u8 level = InstancePtr->triggerFixed;
+
+	InstancePtr->rxHead = 0;
+	InstancePtr->rxTail = 0;
+	InstancePtr->txHead = 0;
+	InstancePtr->txTail = 0;
+	InstancePtr->txBusy = 0;
+	InstancePtr->burst = 0;
+	InstancePtr->burstRead = 0;
+	BT2_resetStats(InstancePtr);
 
+	XUartNs550_SetHandler(&InstancePtr->BT2Uart, BT2_ringHandler, InstancePtr);
+	InstancePtr->trigger = 0;
+	BT2_setLevel(InstancePtr, (level == BT2_TRIGGER_AUTO) ? 1 : level);
+	if (InstancePtr->trigger == 0) {
+		return XST_FAILURE;
+	}
+
+	// the receive buffer of the last polled receive is gone, arm one first
+	BT2_armRecv(InstancePtr);
+	XUartNs550_SetOptions(&InstancePtr->BT2Uart,
+			XUN_OPTION_FIFOS_ENABLE | XUN_OPTION_DATA_INTR | XUN_OPTION_RXLINE_INTR);
 	return XST_SUCCESS;
 }
 
+/* ------------------------------------------------------------ */
+/*  BT2_readData(PmodBT2* InstancePtr, u8* data, int size)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**	  data:			Where the bytes are copied
+**	  size:			Most bytes to copy
+**
+**  Return Value:
+**    The number of bytes copied
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Takes received bytes from rxRing.  When nothing came since the
+**    last call and the FIFO is empty the burst is over, and while the
+**    trigger level follows the traffic it goes back to 1 so the next
+**    message is not held for the receive timeout.  Call it regularly
+**
+******************************************************************/
+int BT2_readData(PmodBT2* InstancePtr, u8* data, int size){
+	u32 head = InstancePtr->rxHead, tail = InstancePtr->rxTail, ier;
+	int count = 0;
+
+	while (head != tail && count < size) {
+		data[count++] = InstancePtr->rxRing[head];
+		head = (head + 1) & (BT2_RX_RING_SIZE - 1);
+	}
+	InstancePtr->rxHead = head;
+
+	if (InstancePtr->triggerFixed == BT2_TRIGGER_AUTO && InstancePtr->burst != 0) {
+		ier = XUartNs550_ReadReg(InstancePtr->BT2Uart.BaseAddress, XUN_IER_OFFSET);
+		XUartNs550_WriteReg(InstancePtr->BT2Uart.BaseAddress, XUN_IER_OFFSET, 0);
+		if (InstancePtr->burst == InstancePtr->burstRead
+				&& !(XUartNs550_GetLineStatusReg(InstancePtr->BT2Uart.BaseAddress) & XUN_LSR_DATA_READY)) {
+			InstancePtr->burst = 0;
+			BT2_setLevel(InstancePtr, 1);
+		}
+		InstancePtr->burstRead = InstancePtr->burst;
+		XUartNs550_WriteReg(InstancePtr->BT2Uart.BaseAddress, XUN_IER_OFFSET, ier);
+	}
+	return count;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_queueData(PmodBT2* InstancePtr, const u8* data, int size)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**	  data:			Bytes to send
+**	  size:			Number of bytes
+**
+**  Return Value:
+**    XST_SUCCESS, or XST_FAILURE if there is no room for all of them
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Queues the bytes in txRing whole or not at all, so the receiver
+**    never gets part of a message, and starts sending if the UART is
+**    not sending
+**
+******************************************************************/
+int BT2_queueData(PmodBT2* InstancePtr, const u8* data, int size){
+	u32 tail = InstancePtr->txTail;
+	int i;
+
+	if ((u32) size > (BT2_TX_RING_SIZE - 1) - ((tail - InstancePtr->txHead) & (BT2_TX_RING_SIZE - 1))) {
+		return XST_FAILURE;
+	}
+	for (i = 0; i < size; i++) {
+		InstancePtr->txRing[tail] = data[i];
+		tail = (tail + 1) & (BT2_TX_RING_SIZE - 1);
+	}
+	InstancePtr->txTail = tail;
+
+	// the transmit interrupt only starts a send while one is going
+	if (InstancePtr->txBusy == 0) {
+		BT2_startSend(InstancePtr);
+	}
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_setTrigger(PmodBT2* InstancePtr, int level)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**	  level:		Receive FIFO trigger level, 1, 4, 8 or 14 bytes, or
+**					BT2_TRIGGER_AUTO to follow the traffic
+**
+**  Return Value:
+**    XST_SUCCESS, or XST_INVALID_PARAM for another level
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Fixes the trigger level, or lets it follow the traffic, which
+**    it does by default
+**
+******************************************************************/
+int BT2_setTrigger(PmodBT2* InstancePtr, int level){
+	u32 i, ier;
+
+	for (i = 0; i < BT2_NUM_TRIGGERS && BT2_Triggers[i].level != level; i++) {
+	}
+	if (level != BT2_TRIGGER_AUTO && i == BT2_NUM_TRIGGERS) {
+		return XST_INVALID_PARAM;
+	}
+
+	ier = XUartNs550_ReadReg(InstancePtr->BT2Uart.BaseAddress, XUN_IER_OFFSET);
+	XUartNs550_WriteReg(InstancePtr->BT2Uart.BaseAddress, XUN_IER_OFFSET, 0);
+	InstancePtr->triggerFixed = level;
+	InstancePtr->burst = 0;
+	BT2_setLevel(InstancePtr, (level == BT2_TRIGGER_AUTO) ? 1 : level);
+	XUartNs550_WriteReg(InstancePtr->BT2Uart.BaseAddress, XUN_IER_OFFSET, ier);
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_getStats(PmodBT2* InstancePtr, BT2_Stats* statsPtr)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**	  statsPtr:		Where the statistics are copied
+**
+**  Return Value:
+**    none
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Copies the statistics of the interrupt driven receive since
+**    BT2_resetStats().  A character time is 10 bits at the baud rate
+**
+******************************************************************/
+void BT2_getStats(PmodBT2* InstancePtr, BT2_Stats* statsPtr){
+	*statsPtr = InstancePtr->stats;
+}
+
+/* ------------------------------------------------------------ */
+/*  BT2_resetStats(PmodBT2* InstancePtr)
+**
+**  Parameters:
+**	  InstancePtr:	PmodBT2 object to use
+**
+**  Return Value:
+**    none
+**
+**  Errors:
+**    none
+**
+**  Description:
+**    Clears the statistics
+**
+******************************************************************/
+void BT2_resetStats(PmodBT2* InstancePtr){
+	memset(&InstancePtr->stats, 0, sizeof(InstancePtr->stats));
+}
+
 /* ------------------------------------------------------------ */
 /*	BT2_UARTInit(XUartNs550 *UartInstancePtr)
 **
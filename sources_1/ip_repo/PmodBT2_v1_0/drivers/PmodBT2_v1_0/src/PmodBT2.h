@@ -7,6 +7,9 @@
 /*  Revision History:                                       			*/
 /*                                                      				*/
 /*  07/12/2016(TommyK, MikelS): Created                           		*/
+/*  06/18/2017: added the RN42 command mode and baud rate negotiation	*/
+/*  06/18/2017: added the interrupt driven rings with an adaptive		*/
+/*              receive FIFO trigger level								*/
 /*                                                      				*/
 /************************************************************************/
 
@@ -42,6 +45,17 @@
 #define true 1
 #define false 0
 
+#define BT2_DEFAULT_BAUD	9600	// rate of the RN42 UART after power up
+#define BT2_MAX_BAUD_ERROR	20		// largest UART rate error accepted, in tenths of a percent
+#define BT2_CMD_TIMEOUT_MS	500		// wait for a reply in the RN42 command mode
+#define BT2_SWITCH_MS		20		// wait for the RN42 to change its rate
+#define BT2_REPLY_SIZE		32		// longest reply looked at
+
+#define BT2_RX_RING_SIZE	256		// bytes received and not yet read, a power of 2
+#define BT2_TX_RING_SIZE	512		// bytes queued for the UART, a power of 2
+#define BT2_TRIGGER_AUTO	0		// BT2_setTrigger() level that follows the traffic
+#define BT2_TIMEOUT_CHARS	4		// idle character times before the receive timeout
+
 
 /**************************** Type Definitions *****************************/
 /**
@@ -84,6 +98,18 @@
 /************************** Function Prototypes ****************************/
 XStatus PMODBT2_Reg_SelfTest(void * baseaddr_p);
 
+// statistics of the interrupt driven receive, see BT2_getStats()
+typedef struct BT2_Stats{
+  u32 rxInterrupts;			// receive interrupts
+  u32 rxTimeouts;			// of them, with fewer bytes than the trigger level
+  u32 rxBytes;				// bytes received
+  u32 rxDropped;			// bytes lost because rxRing was full
+  u32 rxErrors;				// receive status interrupts
+  u32 triggerChanges;		// changes of the trigger level
+  u32 latencyMax;			// longest wait of a byte in the FIFO, in character times
+  u32 latencySum;			// wait of the oldest byte, summed over the receive interrupts
+}BT2_Stats;
+
 typedef struct PmodBT2{
   u32 GPIO_addr;
 #ifndef NO_IRPT
@@ -93,13 +119,46 @@ typedef struct PmodBT2{
   void (* timeoutHandler)(int bytesSent);
 #endif
   XUartNs550 BT2Uart;
+  int baud;		// rate of the UART
   char recv[600];
+
+  // interrupt driven receive and transmit, see BT2_startInterrupts()
+  u8 rxRing[BT2_RX_RING_SIZE];
+  volatile u32 rxHead;		// next byte to read
+  volatile u32 rxTail;		// next free byte
+  u32 rxArmed;				// bytes of the receive buffer given to the UART driver already in rxRing
+  u8 rxDrop[XUN_FIFO_SIZE];	// receive buffer while rxRing is full
+  u8 rxDropping;			// rxDrop is the receive buffer
+  u8 txRing[BT2_TX_RING_SIZE];
+  volatile u32 txHead;		// next byte to send
+  volatile u32 txTail;		// next free byte
+  volatile u32 txBusy;		// bytes given to the UART driver, 0 if it is not sending
+  u8 trigger;				// receive FIFO trigger level, in bytes
+  u8 triggerFixed;			// level set by BT2_setTrigger(), BT2_TRIGGER_AUTO to follow the traffic
+  volatile u32 burst;		// bytes received since the last gap in the traffic
+  u32 burstRead;			// burst at the last BT2_readData()
+  BT2_Stats stats;
 }PmodBT2;
 
+// delay function used while waiting for the RN42, called with the delay in microseconds
+typedef void (*BT2_DelayFunc)(u32 usec);
+
 void BT2_begin(PmodBT2* InstancePtr, u32 GPIO_Address, u32 UART_Address);
 int BT2_getData(PmodBT2* InstancePtr, int buffersize);
 int BT2_sendData(PmodBT2* InstancePtr, char* sendData, int size);
 int BT2_changeBaud(PmodBT2* InstancePtr, int baud);
+int BT2_baudError(int baud);
+void BT2_SetDelay(BT2_DelayFunc delay_us);
+int BT2_command(PmodBT2* InstancePtr, char* cmd, char* reply);
+int BT2_enterCommand(PmodBT2* InstancePtr);
+int BT2_exitCommand(PmodBT2* InstancePtr);
+int BT2_negotiateBaud(PmodBT2* InstancePtr, int maxBaud);
+int BT2_startInterrupts(PmodBT2* InstancePtr);
+int BT2_readData(PmodBT2* InstancePtr, u8* data, int size);
+int BT2_queueData(PmodBT2* InstancePtr, const u8* data, int size);
+int BT2_setTrigger(PmodBT2* InstancePtr, int level);
+void BT2_getStats(PmodBT2* InstancePtr, BT2_Stats* statsPtr);
+void BT2_resetStats(PmodBT2* InstancePtr);
 int BT2_UARTInit(XUartNs550 *UartInstancePtr);
 int BT2_ReadRTS(PmodBT2* InstancePtr);
 int BT2_ReadCTS(PmodBT2* InstancePtr);
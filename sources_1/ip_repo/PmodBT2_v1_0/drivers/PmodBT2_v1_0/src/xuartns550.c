@@ -66,6 +66,8 @@
 *		      XUartNs550_StubHandler.
 * 3.3	nsk  04/13/15 Fixed Clock Divisor Enhancement.
 *		      (CR 857013)
+* 3.3	     06/18/17 XUartNs550_ReceiveBuffer takes error free bytes with one
+*		      test of the line status and no statistics update each.
 * </pre>
 *
 *****************************************************************************/
@@ -79,6 +81,14 @@
 
 /************************** Constant Definitions ****************************/
 
+/*
+ * The line status bits that must all be clear, but data ready, for a byte to
+ * be received without updating the statistics. The FIFO error bit is set while
+ * any byte in the FIFO has an error, and clears when the last one is read.
+ */
+#define XUN_LSR_RX_STATUS	(XUN_LSR_RX_FIFO_ERROR | XUN_LSR_ERROR_BREAK | \
+				 XUN_LSR_DATA_READY)
+
 /* The following constant defines the amount of error that is allowed for
  * a specified baud rate. This error is the difference between the actual
  * baud rate that will be generated using the specified clock and the
@@ -539,35 +549,49 @@ unsigned int XUartNs550_SendBuffer(XUartNs550 *InstancePtr)
 *
 * @return	The number of bytes received.
 *
-* @note		None.
+* @note		The line status is read once for each byte since the UART
+*		does not tell how many bytes are in the FIFO. The statistics
+*		are only updated for bytes with errors and for the count.
 *
 *****************************************************************************/
 unsigned int XUartNs550_ReceiveBuffer(XUartNs550 *InstancePtr)
 {
 	u32 LsrRegister;
+	u32 BaseAddress = InstancePtr->BaseAddress;
+	u8 *BufferPtr = InstancePtr->ReceiveBuffer.NextBytePtr;
+	unsigned int RemainingBytes = InstancePtr->ReceiveBuffer.RemainingBytes;
 	unsigned int ReceivedCount = 0;
 
 	/*
 	 * Loop until there is not more data buffered by the UART or the
 	 * specified number of bytes is received
 	 */
-	while (ReceivedCount < InstancePtr->ReceiveBuffer.RemainingBytes) {
+	while (ReceivedCount < RemainingBytes) {
 
 		/*
 		 * Read the Line Status Register to determine if there is any
 		 * data in the receiver/FIFO
 		 */
-		LsrRegister =
-			XUartNs550_GetLineStatusReg(InstancePtr->BaseAddress);
+		LsrRegister = XUartNs550_GetLineStatusReg(BaseAddress);
+
+		/*
+		 * If there is data ready and neither it nor any other byte
+		 * in the FIFO has an error, which is nearly always, put it
+		 * into the specified buffer, there are no stats to update
+		 * for it
+		 */
+		if ((LsrRegister & XUN_LSR_RX_STATUS) == XUN_LSR_DATA_READY) {
+			BufferPtr[ReceivedCount++] =
+			XUartNs550_ReadReg(BaseAddress, XUN_RBR_OFFSET);
+		}
 
 		/*
 		 * If there is a break condition then a zero data byte was put
 		 * into the receiver, just read it and dump it and update the
 		 * stats
 		 */
-		if (LsrRegister & XUN_LSR_BREAK_INT) {
-			(void)XUartNs550_ReadReg(InstancePtr->BaseAddress,
-							XUN_RBR_OFFSET);
+		else if (LsrRegister & XUN_LSR_BREAK_INT) {
+			(void)XUartNs550_ReadReg(BaseAddress, XUN_RBR_OFFSET);
 			XUartNs550_UpdateStats(InstancePtr, (u8)LsrRegister);
 		}
 
@@ -577,9 +601,8 @@ unsigned int XUartNs550_ReceiveBuffer(XUartNs550 *InstancePtr)
 		 * reflect any receive errors for the byte
 		 */
 		else if (LsrRegister & XUN_LSR_DATA_READY) {
-			InstancePtr->ReceiveBuffer.NextBytePtr[ReceivedCount++] =
-			XUartNs550_ReadReg(InstancePtr->BaseAddress,
-						XUN_RBR_OFFSET);
+			BufferPtr[ReceivedCount++] =
+			XUartNs550_ReadReg(BaseAddress, XUN_RBR_OFFSET);
 
 			XUartNs550_UpdateStats(InstancePtr, (u8)LsrRegister);
 		}
@@ -0,0 +1,19 @@
+/************************************************************************/
+/*																		*/
+/* xil_io.h	--	Host stand-in for the Xilinx BSP header					*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Register accesses go to the register file of sseg_check.c.			*/
+/*																		*/
+/************************************************************************/
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+u32 Xil_In32(UINTPTR Addr);
+void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#endif // XIL_IO_H
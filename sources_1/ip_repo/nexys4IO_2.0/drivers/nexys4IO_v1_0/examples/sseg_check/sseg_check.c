@@ -0,0 +1,360 @@
+/**
+*
+* @file sseg_check.c
+*
+* @copyright Portland State University, 2017
+*
+* Host check and benchmark of the seven segment conversions in nexys4IO.c.
+* The driver runs unmodified against a register file behind Xil_In32() and
+* Xil_Out32().
+*
+* - bin2bcd() is compared with the repeated subtraction it replaced for
+*   every number from 0 to 99,999,999, the range NX4IO_SSEG_putU32Dec()
+*   shows, split over one thread per core, and for the 32-bit edge cases.
+* - NX4IO_SSEG_putU16Hex() and NX4IO_SSEG_putU32Hex(), which build the
+*   SSEG_DATA registers with hex2sseg(), are compared with the bin2hex()
+*   and NX410_SSEG_setAllDigits() path they replaced, for every 16-bit
+*   value in both banks under several decimal point patterns.
+* - Both conversions are then timed against the old ones, in host CPU
+*   cycles per call, the fastest of BENCH_RUNS runs.  The host has the
+*   multiplier, divider and barrel shifter that the MicroBlaze of this
+*   design is built without, so the compare and subtract steps of the
+*   BCD conversions are counted as well; they are the same on both.
+*
+* Build and run on the host, from this directory:
+*
+*	gcc -std=gnu99 -O2 -Wall -pthread -Ibsp -I../../src -o sseg_check
+*		sseg_check.c ../../src/nexys4IO.c
+*	./sseg_check
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "nexys4IO.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/************************** Constant Definitions ****************************/
+#define NX4IO_BASEADDR		0x44A00000
+#define NUM_REGS			16
+
+#define DEC_MAX				99999999u	// largest number NX4IO_SSEG_putU32Dec() shows
+#define MAX_THREADS			64
+
+#define BENCH_CALLS			1000000		// calls of each timed run
+#define BENCH_RUNS			5			// runs of each conversion, the fastest counts
+
+/**************************** Type Definitions ******************************/
+typedef struct
+{
+	u32			first;			// numbers first to last are checked
+	u32			last;
+	u32			mismatches;
+	u32			first_bad;
+	u64			old_steps;		// compare and subtract steps of the old bin2bcd
+	u32			old_max_steps;
+} bcd_job_t;
+
+/************************** Function Prototypes *****************************/
+// the conversions of nexys4IO.c, which nexys4IO.h does not declare
+void bin2bcd(unsigned long bin, unsigned char *bcd);
+void bin2hex(u32 bin, u8 *hex);
+
+/************************** Variable Definitions ****************************/
+static u32 regs[NUM_REGS];
+static u32 *bench_values;
+
+/************************** Register file ************************************/
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	return regs[((Addr - NX4IO_BASEADDR) >> 2) % NUM_REGS];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	regs[((Addr - NX4IO_BASEADDR) >> 2) % NUM_REGS] = Value;
+}
+
+XStatus NEXYS4IO_Reg_SelfTest(u32 baseaddr)
+{
+	(void) baseaddr;
+	return XST_SUCCESS;
+}
+
+/************************** Reference ****************************************/
+
+// bin2bcd() before the change, repeated subtraction of each power of ten.
+// Returns the compare and subtract steps it took
+static int old_bin2bcd(unsigned long bin, unsigned char *bcd)
+{
+	static const unsigned long pow_ten_tbl[] = {
+		1000000000, 100000000, 10000000, 1000000, 100000,
+		10000, 1000, 100, 10, 1
+	};
+	unsigned char digit;
+	int i, steps = 0;
+
+	for (i = 0; i < 10; i++) {
+		digit = 0;
+		while (bin >= pow_ten_tbl[i]) {
+			bin -= pow_ten_tbl[i];
+			digit++;
+			steps++;
+		}
+		steps++;			// the compare that ends the digit
+		*bcd++ = digit;
+	}
+	return steps;
+}
+
+// NX4IO_SSEG_putU32Hex() before the change
+static void old_putU32Hex(u32 data)
+{
+	u8 cc[8];
+	u8 dplo, dphi;
+
+	dplo = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGLO) >> 24);
+	dphi = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGHI) >> 24);
+	bin2hex(data, cc);
+	NX410_SSEG_setAllDigits(SSEGHI, cc[7], cc[6], cc[5], cc[4], dphi);
+	NX410_SSEG_setAllDigits(SSEGLO, cc[3], cc[2], cc[1], cc[0], dplo);
+}
+
+// NX4IO_SSEG_putU16Hex() before the change
+static void old_putU16Hex(enum _NX4IO_ssegbanks bank, u16 data)
+{
+	u8 cc[8];
+	u8 dp;
+
+	dp = (u8) (NX4IO_SSEG_getSSEG_DATA(bank) >> 24);
+	bin2hex(data, cc);
+	NX410_SSEG_setAllDigits(bank, cc[3], cc[2], cc[1], cc[0], dp);
+}
+
+/************************** Checks *******************************************/
+
+static void *bcd_thread(void *arg)
+{
+	bcd_job_t *job = arg;
+	unsigned char bcd[10], ref[10];
+	u32 n = job->first;
+	int steps;
+
+	for (;;) {
+		bin2bcd(n, bcd);
+		steps = old_bin2bcd(n, ref);
+		job->old_steps += steps;
+		if (steps > job->old_max_steps)
+			job->old_max_steps = steps;
+		if (memcmp(bcd, ref, sizeof(bcd)) != 0) {
+			if (job->mismatches++ == 0)
+				job->first_bad = n;
+		}
+		if (n++ == job->last)
+			break;
+	}
+	return NULL;
+}
+
+// every number 0 to DEC_MAX, split over the cores, then the 32-bit edges
+static u32 check_bcd(u64 *p_old_steps, u32 *p_old_max)
+{
+	static const u32 edges[] = {
+		DEC_MAX + 1, 999999999u, 1000000000u, 1999999999u, 2000000000u,
+		3999999999u, 4000000000u, 4294967294u, 4294967295u
+	};
+	bcd_job_t jobs[MAX_THREADS];
+	pthread_t threads[MAX_THREADS];
+	unsigned char bcd[10], ref[10];
+	u32 mismatches = 0, first_bad = 0, span;
+	long nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	int i;
+
+	if (nthreads < 1)
+		nthreads = 1;
+	if (nthreads > MAX_THREADS)
+		nthreads = MAX_THREADS;
+
+	span = (DEC_MAX + 1) / nthreads;
+	for (i = 0; i < nthreads; i++) {
+		memset(&jobs[i], 0, sizeof(jobs[i]));
+		jobs[i].first = i * span;
+		jobs[i].last = (i == nthreads - 1) ? DEC_MAX : (i + 1) * span - 1;
+		if (pthread_create(&threads[i], NULL, bcd_thread, &jobs[i]) != 0) {
+			bcd_thread(&jobs[i]);
+			threads[i] = 0;
+		}
+	}
+
+	*p_old_steps = 0;
+	*p_old_max = 0;
+	for (i = 0; i < nthreads; i++) {
+		if (threads[i] != 0)
+			pthread_join(threads[i], NULL);
+		if ((jobs[i].mismatches != 0) && (mismatches == 0))
+			first_bad = jobs[i].first_bad;
+		mismatches += jobs[i].mismatches;
+		*p_old_steps += jobs[i].old_steps;
+		if (jobs[i].old_max_steps > *p_old_max)
+			*p_old_max = jobs[i].old_max_steps;
+	}
+
+	for (i = 0; i < (int) (sizeof(edges) / sizeof(edges[0])); i++) {
+		bin2bcd(edges[i], bcd);
+		old_bin2bcd(edges[i], ref);
+		if (memcmp(bcd, ref, sizeof(bcd)) != 0) {
+			if (mismatches++ == 0)
+				first_bad = edges[i];
+		}
+	}
+
+	printf("bin2bcd: %ld threads, 0 to %u and %d edge cases, %u mismatches",
+		nthreads, DEC_MAX, (int) (sizeof(edges) / sizeof(edges[0])), mismatches);
+	if (mismatches != 0)
+		printf(", first at %u", first_bad);
+	printf("\n");
+	return mismatches;
+}
+
+// every 16-bit value in both banks, with the decimal points and the digits
+// the registers held before
+static u32 check_hex(void)
+{
+	static const u32 before[] = { 0x00000000, 0x0F000000, 0x057DF7DF, 0x0A000000 };
+	enum _NX4IO_ssegbanks bank;
+	u32 mismatches = 0, ref_lo, ref_hi, v;
+	int i;
+
+	for (i = 0; i < (int) (sizeof(before) / sizeof(before[0])); i++) {
+		for (v = 0; v <= 0xFFFF; v++) {
+			for (bank = SSEGLO; bank <= SSEGHI; bank++) {
+				NX4IO_SSEG_setSSEG_DATA(bank, before[i]);
+				old_putU16Hex(bank, (u16) v);
+				ref_lo = NX4IO_SSEG_getSSEG_DATA(bank);
+				NX4IO_SSEG_setSSEG_DATA(bank, before[i]);
+				NX4IO_SSEG_putU16Hex(bank, (u16) v);
+				if (NX4IO_SSEG_getSSEG_DATA(bank) != ref_lo)
+					mismatches++;
+			}
+
+			// the same nibbles in both halves, and swapped ones
+			NX4IO_SSEG_setSSEG_DATA(SSEGLO, before[i]);
+			NX4IO_SSEG_setSSEG_DATA(SSEGHI, before[(i + 1) % 4]);
+			old_putU32Hex((v << 16) | (v ^ 0xA5C3));
+			ref_lo = NX4IO_SSEG_getSSEG_DATA(SSEGLO);
+			ref_hi = NX4IO_SSEG_getSSEG_DATA(SSEGHI);
+			NX4IO_SSEG_setSSEG_DATA(SSEGLO, before[i]);
+			NX4IO_SSEG_setSSEG_DATA(SSEGHI, before[(i + 1) % 4]);
+			NX4IO_SSEG_putU32Hex((v << 16) | (v ^ 0xA5C3));
+			if ((NX4IO_SSEG_getSSEG_DATA(SSEGLO) != ref_lo) || (NX4IO_SSEG_getSSEG_DATA(SSEGHI) != ref_hi))
+				mismatches++;
+		}
+	}
+	printf("hex2sseg: all 16-bit values, both banks, %d register patterns, %u mismatches\n",
+		(int) (sizeof(before) / sizeof(before[0])), mismatches);
+	return mismatches;
+}
+
+/************************** Benchmark ****************************************/
+
+static u64 cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+// cycles per call of one conversion, the fastest of BENCH_RUNS runs
+static double bench(int which, u32 *p_sum)
+{
+	unsigned char bcd[10];
+	u64 start, best = ~(u64) 0;
+	u32 sum;
+	int run, i;
+
+	for (run = 0; run < BENCH_RUNS; run++) {
+		sum = 0;
+		start = cycles();
+		for (i = 0; i < BENCH_CALLS; i++) {
+			switch (which) {
+				case 0:
+					old_bin2bcd(bench_values[i], bcd);
+					sum += bcd[2] + bcd[9];
+					break;
+				case 1:
+					bin2bcd(bench_values[i], bcd);
+					sum += bcd[2] + bcd[9];
+					break;
+				case 2:
+					old_putU32Hex(bench_values[i]);
+					sum += regs[NEXYS4IO_SSEGLO_DATA_OFFSET >> 2];
+					break;
+				default:
+					NX4IO_SSEG_putU32Hex(bench_values[i]);
+					sum += regs[NEXYS4IO_SSEGLO_DATA_OFFSET >> 2];
+					break;
+			}
+		}
+		start = cycles() - start;
+		if (start < best)
+			best = start;
+		*p_sum = sum;
+	}
+	return (double) best / BENCH_CALLS;
+}
+
+int main(void)
+{
+	u64 old_steps;
+	u32 old_max, mismatches, seed = 1, sums[4];
+	double rate[4];
+	int i;
+
+	NX4IO_initialize(NX4IO_BASEADDR);
+
+	mismatches = check_bcd(&old_steps, &old_max);
+	mismatches += check_hex();
+
+	bench_values = malloc(BENCH_CALLS * sizeof(u32));
+	if (bench_values == NULL)
+		return 2;
+	for (i = 0; i < BENCH_CALLS; i++) {
+		seed = seed * 1664525 + 1013904223;
+		bench_values[i] = seed % (DEC_MAX + 1);
+	}
+	for (i = 0; i < 4; i++)
+		rate[i] = bench(i, &sums[i]);
+
+	printf("\n%-26s %10s %10s %12s\n", "", "old", "new", "cycles/call");
+	printf("%-26s %10.1f %10d %12s\n", "bin2bcd steps, average", (double) old_steps / (DEC_MAX + 1), 39, "");
+	printf("%-26s %10u %10d %12s\n", "bin2bcd steps, most", old_max, 39, "");
+	printf("%-26s %10.1f %10.1f %11.1fx\n", "bin2bcd cycles/call", rate[0], rate[1], rate[0] / rate[1]);
+	printf("%-26s %10.1f %10.1f %11.1fx\n", "putU32Hex cycles/call", rate[2], rate[3], rate[2] / rate[3]);
+	if ((sums[0] != sums[1]) || (sums[2] != sums[3]))
+		mismatches++;
+
+	free(bench_values);
+	printf("\n%u mismatches\n", mismatches);
+	return (mismatches == 0) ? 0 : 1;
+}
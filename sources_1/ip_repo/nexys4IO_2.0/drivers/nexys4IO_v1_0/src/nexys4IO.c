@@ -16,6 +16,14 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00a	rhk	12/20/14	First release of driver
+* 1.00b	    06/18/17	Keep shadow copies of the output registers.  Reads of the
+*						output registers come from the shadows and writes that
+*						would not change a register are not sent over AXI
+* 1.00c	    06/18/17	bin2bcd() takes a fixed 39 compare and subtract steps
+*						instead of up to 90.  The hex display functions build
+*						the SSEG_DATA registers straight from the nibbles
+* 1.00d	    06/18/17	Added the seven segment number formatter.  A number is
+*						shown with one write to SSEG_VALUE
 * </pre>
 *
 ******************************************************************************/
@@ -24,17 +32,26 @@
 #include "nexys4IO.h"
 
 /************************** Constant Definitions ****************************/
+#define NX4IO_NUM_REGS		10		// registers in the NEXYS4IO register set
 
 /**************************** Type Definitions ******************************/
 
 /***************** Macros (Inline Functions) Definitions ********************/
+// shadow copy of the register at offset
+#define NX4IO_SHADOW(offset)	(NX4IO_Shadow[(offset) >> 2])
 
 /************************** Variable Definitions ****************************/
 u32 NX4IO_BaseAddress;	// Base Address of the NEXYS4IO register set
 
+static u32 NX4IO_Shadow[NX4IO_NUM_REGS];	// last value written to each output register
+static u32 NX4IO_BusWrites;		// register writes sent over AXI
+static u32 NX4IO_BusSaved;		// register writes suppressed because nothing changed
+
 /************************** Function Prototypes *****************************/
 void bin2bcd(unsigned long bin, unsigned char *bcd);
 void bin2hex(u32 bin, u8 *hex);
+static void NX4IO_writeReg(u32 offset, u32 data);
+static u32 hex2sseg(u32 nibbles, u32 sseg_data);
 
 /************************** Driver Functions ********************************/
 
@@ -44,7 +61,9 @@ void bin2hex(u32 bin, u8 *hex);
 /**
 * Initialize the NEXYS4IO peripheral driver
 *
-* Saves the Base address of the NEXYS4IO peripheral and runs the selftest
+* Saves the Base address of the NEXYS4IO peripheral and runs the selftest.
+* Then loads the shadow copies of the output registers from the peripheral
+* so that the shadows match the hardware from here on
 *
 * @param	BaseAddr is the base address of the NEXYS4IO register set
 *
@@ -57,8 +76,60 @@ void bin2hex(u32 bin, u8 *hex);
 *****************************************************************************/
 int NX4IO_initialize(u32 BaseAddr)
 {
+	int sts;
+	u32 offset;
+
 	NX4IO_BaseAddress = BaseAddr;
-	return NEXYS4IO_Reg_SelfTest(NX4IO_BaseAddress);
+	sts = NEXYS4IO_Reg_SelfTest(NX4IO_BaseAddress);
+
+	// the selftest leaves its own values in the registers.  Read them once
+	for (offset = NEXYS4IO_LEDS_DATA_OFFSET; offset <= NEXYS4IO_SSEG_FORMAT_OFFSET; offset += 4)
+	{
+		NX4IO_SHADOW(offset) = NEXYS4IO_mReadReg(NX4IO_BaseAddress, offset);
+	}
+	NX4IO_BusWrites = 0;
+	NX4IO_BusSaved = 0;
+	return sts;
+}
+
+
+/****************************************************************************/
+/**
+* returns the output register bus statistics
+*
+* Returns the number of output register writes that were sent over AXI and
+* the number that were not sent because the register already held the value
+* since initialization or the last call to NX4IO_resetBusStats()
+*
+* @param	p_writes is a pointer to the number of writes sent.  May be NULL
+*
+* @param	p_saved is a pointer to the number of writes suppressed.  May be NULL
+*
+* @return	NONE
+*
+*****************************************************************************/
+void NX4IO_getBusStats(u32 *p_writes, u32 *p_saved)
+{
+	if (p_writes != NULL)
+		*p_writes = NX4IO_BusWrites;
+	if (p_saved != NULL)
+		*p_saved = NX4IO_BusSaved;
+}
+
+
+/****************************************************************************/
+/**
+* clears the output register bus statistics
+*
+* @param	None
+*
+* @return	NONE
+*
+*****************************************************************************/
+void NX4IO_resetBusStats(void)
+{
+	NX4IO_BusWrites = 0;
+	NX4IO_BusSaved = 0;
 }
 
 
@@ -180,7 +251,8 @@ bool NX4IO_isPressed(enum _NX4IO_btns btnslct)
 /**
 * returns the current value LEDS_DATA.
 *
-* Returns the raw value of LEDS_DATA.  No formatting or bit masking is done
+* Returns the raw value of LEDS_DATA from its shadow copy.  No formatting or
+* bit masking is done
 *
 * @param	None
 *
@@ -194,7 +266,7 @@ u32 NX4IO_getLEDS_DATA(void)
 {
 	u32 val;
 
-	val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_LEDS_DATA_OFFSET);
+	val =  NX4IO_SHADOW(NEXYS4IO_LEDS_DATA_OFFSET);
 	return val;
 }
 
@@ -218,7 +290,7 @@ void NX4IO_setLEDs(u32 ledvalue)
 	u32 val;
 
 	val = ledvalue & NEXYS4IO_LEDS_MASK;
-	NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_LEDS_DATA_OFFSET, val);
+	NX4IO_writeReg(NEXYS4IO_LEDS_DATA_OFFSET, val);
 }
 
 
@@ -228,7 +300,8 @@ void NX4IO_setLEDs(u32 ledvalue)
 /**
 * returns the RGB_DATA register for the selected RGB LED
 *
-* Reads and returns the raw value of the selected RGB LED data register
+* Returns the raw value of the selected RGB LED data register from its
+* shadow copy
 *
 * @param	led is used to select which of the RGB LED data registers to read
 *
@@ -245,10 +318,10 @@ u32 NX4IO_RGBLED_getRGB_DATA(enum _NX4IO_rgbleds led)
 	switch (led)
 	{
 		case RGB1:
-			val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_RGB1_DATA_OFFSET);
+			val =  NX4IO_SHADOW(NEXYS4IO_RGB1_DATA_OFFSET);
 			break;
 		case RGB2:
-			val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_RGB2_DATA_OFFSET);
+			val =  NX4IO_SHADOW(NEXYS4IO_RGB2_DATA_OFFSET);
 			break;
 		default:
 			val = 0x00000000;
@@ -262,7 +335,8 @@ u32 NX4IO_RGBLED_getRGB_DATA(enum _NX4IO_rgbleds led)
 /**
 * returns the RGB_CNTRL register for the selected RGB LED
 *
-* Reads and returns the raw value of the selected RGB LED control register
+* Returns the raw value of the selected RGB LED control register from its
+* shadow copy
 *
 * @param	led is used to select which of the RGB LED control registers to read
 *
@@ -279,10 +353,10 @@ u32 NX4IO_RGBLED_getRGB_CNTRL(enum _NX4IO_rgbleds led)
 	switch (led)
 	{
 		case RGB1:
-			val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_RGB1_CNTRL_OFFSET);
+			val =  NX4IO_SHADOW(NEXYS4IO_RGB1_CNTRL_OFFSET);
 			break;
 		case RGB2:
-			val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_RGB2_CNTRL_OFFSET);
+			val =  NX4IO_SHADOW(NEXYS4IO_RGB2_CNTRL_OFFSET);
 			break;
 		default:
 			val = 0x00000000;
@@ -316,10 +390,10 @@ void NX4IO_RGBLED_setRGB_DATA(enum _NX4IO_rgbleds led, u32 data)
 	switch (led)
 	{
 		case RGB1:
-			NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_RGB1_DATA_OFFSET, val);
+			NX4IO_writeReg(NEXYS4IO_RGB1_DATA_OFFSET, val);
 			break;
 		case RGB2:
-			NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_RGB2_DATA_OFFSET, val);
+			NX4IO_writeReg(NEXYS4IO_RGB2_DATA_OFFSET, val);
 			break;
 		default:
 			// Do not write to an illegal register
@@ -353,10 +427,10 @@ void NX4IO_RGBLED_setRGB_CNTRL(enum _NX4IO_rgbleds led, u32 cntrl)
 	switch (led)
 	{
 		case RGB1:
-			NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_RGB1_CNTRL_OFFSET, val);
+			NX4IO_writeReg(NEXYS4IO_RGB1_CNTRL_OFFSET, val);
 			break;
 		case RGB2:
-			NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_RGB2_CNTRL_OFFSET, val);
+			NX4IO_writeReg(NEXYS4IO_RGB2_CNTRL_OFFSET, val);
 			break;
 		default:
 			// Do not write to an illegal register
@@ -374,7 +448,8 @@ void NX4IO_RGBLED_setRGB_CNTRL(enum _NX4IO_rgbleds led, u32 cntrl)
 * an 8-bit unsigned number.
 *
 * Momentarily disables the R, G, and B channels then changes the values and re-enables
-* the channels that were previously enabled.
+* the channels that were previously enabled.  Does nothing if the duty cycles are
+* unchanged.
 *
 * @param	led is used to select which of the RGB LED data registers to read
 *
@@ -402,6 +477,11 @@ void NX4IO_RGBLED_setDutyCycle(enum _NX4IO_rgbleds led, u8 redDC, u8 greenDC, u8
 	val = ((redDC << 16) & NEXYS4IO_RGB_REDDC_MASK) | ((greenDC << 8) & NEXYS4IO_RGB_GREENDC_MASK)
 			| ((blueDC << 0) & NEXYS4IO_RGB_BLUEDC_MASK);
 
+	// nothing to do if the duty cycles have not changed.  This also saves
+	// turning the channels off and on again
+	if (val == NX4IO_RGBLED_getRGB_DATA(led))
+		return;
+
 	// change the duty cycles and restart the channels that were enabled
 	NX4IO_RGBLED_setRGB_CNTRL(led, 0x00000000);
 	NX4IO_RGBLED_setRGB_DATA(led, val);
@@ -453,7 +533,8 @@ void NX4IO_RGBLED_setChnlEn(enum _NX4IO_rgbleds led, bool en_red, bool en_green,
 /**
 * returns the SSEG_DATA register for the selected bank of digits
 *
-* Reads and returns the raw value of the selected SSEG_DATA data register.
+* Returns the raw value of the selected SSEG_DATA data register from its
+* shadow copy.
 * The Nexys4 board has two 4-digit seven segment display banks.  SSEGLO
 * includes digits 3-0 (rightmost digits).  SSEGHI includes digits 7-4
 * (leftmost digits)
@@ -473,10 +554,10 @@ u32 NX4IO_SSEG_getSSEG_DATA(enum _NX4IO_ssegbanks bank)
 	switch (bank)
 	{
 		case SSEGLO:
-			val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_SSEGLO_DATA_OFFSET);
+			val =  NX4IO_SHADOW(NEXYS4IO_SSEGLO_DATA_OFFSET);
 			break;
 		case SSEGHI:
-			val =  NEXYS4IO_mReadReg(NX4IO_BaseAddress, NEXYS4IO_SSEGHI_DATA_OFFSET);
+			val =  NX4IO_SHADOW(NEXYS4IO_SSEGHI_DATA_OFFSET);
 			break;
 		default:
 			val = 0x00000000;
@@ -515,10 +596,10 @@ void NX4IO_SSEG_setSSEG_DATA(enum _NX4IO_ssegbanks bank, u32 data)
 	switch (bank)
 	{
 		case SSEGLO:
-			NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_SSEGLO_DATA_OFFSET, val);
+			NX4IO_writeReg(NEXYS4IO_SSEGLO_DATA_OFFSET, val);
 			break;
 		case SSEGHI:
-			NEXYS4IO_mWriteReg(NX4IO_BaseAddress, NEXYS4IO_SSEGHI_DATA_OFFSET, val);
+			NX4IO_writeReg(NEXYS4IO_SSEGHI_DATA_OFFSET, val);
 			break;
 		default:
 			// Do not write to an illegal register
@@ -827,20 +908,14 @@ int NX410_SSEG_setAllDigits(enum _NX4IO_ssegbanks bank, u8 dig3, u8 dig2, u8 dig
 *****************************************************************************/
 int NX4IO_SSEG_putU16Hex(enum _NX4IO_ssegbanks bank, u16 data)
 {
-	u8 cc[8];		// character codes for each of the nibbles in data
-	u8 dp;			// current decimal points.  We don't want to change them
-
-	// convert data to hex and display it on all the selected bank of digits
-	bin2hex((u32) data, cc);
+	// display data in hex on the selected bank, keeping its decimal points
 	switch (bank)
 	{
 		case SSEGLO:
-			dp = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGLO)  >> 24);
-			NX410_SSEG_setAllDigits(SSEGLO, cc[3], cc[2], cc[1], cc[0], dp);
+			NX4IO_SSEG_setSSEG_DATA(SSEGLO, hex2sseg(data, NX4IO_SSEG_getSSEG_DATA(SSEGLO)));
 			break;
 		case SSEGHI:
-			dp = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGHI)  >> 24);
-			NX410_SSEG_setAllDigits(SSEGHI, cc[7], cc[6], cc[5], cc[4], dp);
+			NX4IO_SSEG_setSSEG_DATA(SSEGHI, hex2sseg(data, NX4IO_SSEG_getSSEG_DATA(SSEGHI)));
 			break;
 		default:
 			// Invalid bank.  Operation failed
@@ -876,17 +951,9 @@ int NX4IO_SSEG_putU16Hex(enum _NX4IO_ssegbanks bank, u16 data)
 *****************************************************************************/
 int NX4IO_SSEG_putU32Hex(u32 data)
 {
-	u8 cc[8];		// character codes for each of the nibbles in data
-	u8 dplo, dphi;	// current decimal points
-
-	// get the existing current decimal points.  We don't want to change them
-	dplo = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGLO)  >> 24);
-	dphi = (u8) (NX4IO_SSEG_getSSEG_DATA(SSEGHI)  >> 24);
-
-	// convert data to hex and display it on all 8 digits of the display
-	bin2hex(data, cc);
-	NX410_SSEG_setAllDigits(SSEGHI, cc[7], cc[6], cc[5], cc[4], dphi);
-	NX410_SSEG_setAllDigits(SSEGLO, cc[3], cc[2], cc[1], cc[0], dplo);
+	// display data in hex on all 8 digits, keeping the decimal points
+	NX4IO_SSEG_setSSEG_DATA(SSEGHI, hex2sseg(data >> 16, NX4IO_SSEG_getSSEG_DATA(SSEGHI)));
+	NX4IO_SSEG_setSSEG_DATA(SSEGLO, hex2sseg(data & 0xFFFF, NX4IO_SSEG_getSSEG_DATA(SSEGLO)));
 
 	return XST_SUCCESS;
 }
@@ -969,6 +1036,84 @@ int NX4IO_SSEG_putU32Dec(u32 data, bool trim)
 
 }
 
+/****************************************************************************/
+/**
+* enables the seven segment number formatter
+*
+* Sets up the number formatter in the peripheral and shows its number on all
+* 8 digits instead of the SSEG_DATA digits.  After this each number is shown
+* with one register write by NX4IO_SSEG_putValue().  The peripheral converts
+* the number to digits, blanks the leading zeros and places the minus sign
+* and the decimal point.  A number that does not fit is shown as 8 dashes
+*
+* @param	fmt is FMT_UDEC (unsigned decimal), FMT_SDEC (signed decimal) or
+*			FMT_HEX
+*
+* @param	places is the number of decimal places (0 to 7) for a decimal
+*			number, which is then shown as value / 10^places.  Ignored for hex
+*
+* @param	trim is a boolean.  If true, leading 0's are converted to blanks
+*
+* @return	XST_SUCCESS if the format was set.  XST_FAILURE if a parameter
+*			was invalid
+*
+* @note		The SSEG_DATA decimal points are still shown, ORed with the
+*			fixed point one
+*
+*****************************************************************************/
+int NX4IO_SSEG_setFormat(enum _NX4IO_ssegfmts fmt, u8 places, bool trim)
+{
+	u32 val;
+
+	if ((fmt > FMT_HEX) || (places > 7))
+	{
+		return XST_FAILURE;
+	}
+
+	val = NEXYS4IO_SSEG_FMT_EN_MASK | (fmt & NEXYS4IO_SSEG_FMT_MODE_MASK)
+			| ((places << 4) & NEXYS4IO_SSEG_FMT_PLACES_MASK);
+	if (trim)
+		val |= NEXYS4IO_SSEG_FMT_TRIM_MASK;
+	NX4IO_writeReg(NEXYS4IO_SSEG_FORMAT_OFFSET, val);
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* disables the seven segment number formatter
+*
+* The display shows the SSEG_DATA digits again
+*
+* @param	None
+*
+* @return	NONE
+*
+*****************************************************************************/
+void NX4IO_SSEG_clearFormat(void)
+{
+	NX4IO_writeReg(NEXYS4IO_SSEG_FORMAT_OFFSET, 0x00000000);
+}
+
+
+/****************************************************************************/
+/**
+* shows a number with the seven segment number formatter
+*
+* Writes the number to SSEG_VALUE.  The format is set by NX4IO_SSEG_setFormat()
+*
+* @param	value is the number to show.  Cast a signed number to u32
+*
+* @return	NONE
+*
+* @note		Has no visible effect until the formatter is enabled
+*
+*****************************************************************************/
+void NX4IO_SSEG_putValue(u32 value)
+{
+	NX4IO_writeReg(NEXYS4IO_SSEG_VALUE_OFFSET, value);
+}
+
 /************************** END OF DRIVER FUNCTIONS **************************/
 
 /************************** Helper Functions ********************************/
@@ -987,39 +1132,53 @@ int NX4IO_SSEG_putU32Dec(u32 data, bool trim)
 * @return	NONE
 *
 * @note
-*	Source:  http://www.keil.com/forum/14621/
+*	Each decimal digit is built from its 8, 4, 2 and 1 weights, largest first,
+*	with one compare and subtract per weight.  That is 39 steps for every
+*	number (the 10^9 digit is at most 4 so it has no 8 weight) where repeated
+*	subtraction of the power of ten took up to 90.  The MicroBlaze has no
+*	hardware multiplier, divider or barrel shifter so this beats dividing by
+*	10 or multiplying by its reciprocal, and double dabble's shifts.
 */
 
 void bin2bcd(unsigned long bin, unsigned char *bcd)
 {
-	#define DIM(a)  (sizeof(a) / sizeof(a[0]))
-
-    static const unsigned long pow_ten_tbl[] = {
-        1000000000,
-        100000000,
-        10000000,
-        1000000,
-        100000,
-        10000,
-        1000,
-        100,
-        10,
-        1
-    };
-    unsigned long pow_ten;
-    unsigned char digit;
-    unsigned char i;
-
-    for (i = 0; i != DIM(pow_ten_tbl); i++) {
-        digit = 0;
-        pow_ten = pow_ten_tbl[i];
-
-        while (bin >= pow_ten) {
-            bin -= pow_ten;
-            digit++;
-        }
-        *bcd++ = digit;
-    }
+	// weights, largest first
+	static const u32 weight_tbl[39] = {
+		4000000000u, 2000000000u, 1000000000u,
+		800000000, 400000000, 200000000, 100000000,
+		80000000, 40000000, 20000000, 10000000,
+		8000000, 4000000, 2000000, 1000000,
+		800000, 400000, 200000, 100000,
+		80000, 40000, 20000, 10000,
+		8000, 4000, 2000, 1000,
+		800, 400, 200, 100,
+		80, 40, 20, 10,
+		8, 4, 2, 1
+	};
+	const u32 *p_weight = weight_tbl;
+	u32 num = (u32) bin;
+	u8 digit;
+	int i;
+
+	// the 10^9 digit has weights 4, 2 and 1
+	digit = 0;
+	if (num >= p_weight[0]) { num -= p_weight[0]; digit += 4; }
+	if (num >= p_weight[1]) { num -= p_weight[1]; digit += 2; }
+	if (num >= p_weight[2]) { num -= p_weight[2]; digit += 1; }
+	*bcd++ = digit;
+	p_weight += 3;
+
+	// the other digits have weights 8, 4, 2 and 1
+	for (i = 0; i < 9; i++)
+	{
+		digit = 0;
+		if (num >= p_weight[0]) { num -= p_weight[0]; digit += 8; }
+		if (num >= p_weight[1]) { num -= p_weight[1]; digit += 4; }
+		if (num >= p_weight[2]) { num -= p_weight[2]; digit += 2; }
+		if (num >= p_weight[3]) { num -= p_weight[3]; digit += 1; }
+		*bcd++ = digit;
+		p_weight += 4;
+	}
 }
 
 
@@ -1052,3 +1211,52 @@ void bin2hex(u32 bin, u8 *hex)
 		bin = bin >> 4;
 	}
 }
+
+
+/**
+* Writes an output register unless it already holds the value
+*
+* Compares the value with the shadow copy of the register.  If they differ
+* the shadow is updated and the register is written over AXI, otherwise the
+* write is counted as saved and nothing is sent
+*
+* @param	offset is the offset of the register in the NEXYS4IO register set
+*
+* @param	data is the value to write
+*
+* @return	NONE
+*/
+static void NX4IO_writeReg(u32 offset, u32 data)
+{
+	if (NX4IO_SHADOW(offset) == data)
+	{
+		NX4IO_BusSaved++;
+		return;
+	}
+	NX4IO_SHADOW(offset) = data;
+	NEXYS4IO_mWriteReg(NX4IO_BaseAddress, offset, data);
+	NX4IO_BusWrites++;
+}
+
+
+/**
+* Builds an SSEG_DATA register value that shows 4 hex digits
+*
+* Spreads the 4 nibbles of the number into the 6-bit digit fields of the
+* SSEG_DATA register in one step.  The hex digits map directly to character
+* codes so no bin2hex() buffer is needed
+*
+* @param	nibbles holds the digits to display in its low 16 bits.  Bits[15:12]
+*			go to the leftmost digit of the bank
+*
+* @param	sseg_data is the current value of the register.  Its decimal points
+*			are kept
+*
+* @return	the new SSEG_DATA register value
+*/
+static u32 hex2sseg(u32 nibbles, u32 sseg_data)
+{
+	return (sseg_data & NEXYS4IO_SSEG_DECPTS_MASK)
+			| ((nibbles & 0xF000) << 6) | ((nibbles & 0x0F00) << 4)
+			| ((nibbles & 0x00F0) << 2) | (nibbles & 0x000F);
+}
@@ -16,6 +16,8 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00a	rhk	12/20/14	First release of driver
+* 1.00b	    06/18/17	Added the output register bus statistics and the seven
+*						segment number formatter
 * </pre>
 *
 ******************************************************************************/
@@ -66,6 +68,12 @@
 #define NEXYS4IO_SSEG_DECPT2_MASK	0x04000000
 #define NEXYS4IO_SSEG_DECPT1_MASK	0x02000000
 #define NEXYS4IO_SSEG_DECPT0_MASK	0x01000000	
+
+// Masks for the Seven Segment number formatter (SSEG_FORMAT register)
+#define NEXYS4IO_SSEG_FMT_EN_MASK		0x80000000
+#define NEXYS4IO_SSEG_FMT_TRIM_MASK		0x00000100
+#define NEXYS4IO_SSEG_FMT_PLACES_MASK	0x00000070
+#define NEXYS4IO_SSEG_FMT_MODE_MASK		0x00000003
 	
 
 /* @} */
@@ -101,6 +109,9 @@ enum _NX410_decpts {
 	DP_0 = 0x0, DP_1 = 0x01, DP_2 = 0x04, DP_3 = 0x8, DP_ALL = 0xF, DP_NONE = 0x0
 };
 
+// Seven Segment number formatter modes
+enum _NX4IO_ssegfmts {FMT_UDEC = 0, FMT_SDEC = 1, FMT_HEX = 2};
+
 /***************** Macros (Inline Functions) Definitions ********************/
 
 
@@ -108,6 +119,8 @@ enum _NX410_decpts {
 
 // Initialization functions
 int NX4IO_initialize(u32 BaseAddr);
+void NX4IO_getBusStats(u32 *p_writes, u32 *p_saved);
+void NX4IO_resetBusStats(void);
 
 // Buttons and switch functions
 u32 NX4IO_getBTNSW_IN(void);
@@ -141,4 +154,8 @@ int NX4IO_SSEG_putU16Hex(enum _NX4IO_ssegbanks bank, u16 data);
 int NX4IO_SSEG_putU32Hex(u32 data);
 int NX4IO_SSEG_putU32Dec(u32 data, bool trim);
 
+int NX4IO_SSEG_setFormat(enum _NX4IO_ssegfmts fmt, u8 places, bool trim);
+void NX4IO_SSEG_clearFormat(void);
+void NX4IO_SSEG_putValue(u32 value);
+
 #endif // NEXYS4IO_H
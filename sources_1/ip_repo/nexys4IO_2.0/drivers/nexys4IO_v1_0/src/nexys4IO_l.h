@@ -16,6 +16,7 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00a	rhk	12/20/14	First release of driver
+* 1.00b	    06/18/17	Added the seven segment number formatter registers
 * </pre>
 *
 ******************************************************************************/
@@ -43,8 +44,8 @@
 #define NEXYS4IO_RGB2_CNTRL_OFFSET 20
 #define NEXYS4IO_SSEGLO_DATA_OFFSET 24
 #define NEXYS4IO_SSEGHI_DATA_OFFSET 28
-#define NEXYS4IO_RSVD00_OFFSET 32
-#define NEXYS4IO_RSVD01_OFFSET 36
+#define NEXYS4IO_SSEG_VALUE_OFFSET 32
+#define NEXYS4IO_SSEG_FORMAT_OFFSET 36
 #define NEXYS4IO_RSVD02_OFFSET 40
 #define NEXYS4IO_RSVD03_OFFSET 44
 #define NEXYS4IO_RSVD04_OFFSET 48
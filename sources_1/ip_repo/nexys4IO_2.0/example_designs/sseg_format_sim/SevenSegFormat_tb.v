@@ -0,0 +1,104 @@
+// SevenSegFormat_tb.v - self checking testbench for the 7-segment number formatter
+//
+// Copyright Portland State University, 2017
+//
+// Revision History:
+// -----------------
+// Jun-2017				Created this testbench
+//
+// Description:
+// ------------
+// Drives SevenSegFormat (in sevensegment.v) with the vectors written by the
+// host model, sseg_format_model.c, and compares the digit codes and decimal
+// points with the ones the model expects.  Each vector is written with the
+// formatter enabled, then checked 40 clocks later.  The pass-through to the
+// SSEG_DATA digits is checked with the formatter disabled.
+//
+// Generate the vectors before running the simulation:
+//
+//	gcc -std=gnu99 -Wall -o sseg_format_model sseg_format_model.c
+//	./sseg_format_model sseg_format_vectors.hex
+//
+// run_tb.sh does both and runs the simulation with Icarus Verilog or xsim.
+//
+///////////////////////////////////////////////////////////////////////////
+`timescale 1 ns / 1 ps
+
+module SevenSegFormat_tb;
+
+	localparam integer	MAX_VECTORS = 16384;
+
+	reg					clk = 1'b0;
+	reg					resetn = 1'b0;
+	reg			[31:0]	value = 32'd0;
+	reg			[31:0]	format = 32'd0;
+	reg			[39:0]	d_in = 40'd0;
+	reg			[7:0]	dp_in = 8'd0;
+	wire		[39:0]	d_out;
+	wire		[7:0]	dp_out;
+
+	// {value, format, dp, digit codes}
+	reg			[111:0]	vectors [0:MAX_VECTORS-1];
+	reg			[111:0]	vec;
+	integer				n, errors;
+
+	SevenSegFormat
+	#(
+		.RESET_POLARITY_LOW(1)
+	) DUT
+	(
+		.clk(clk),
+		.reset(resetn),
+		.value(value),
+		.format(format),
+		.d_in(d_in),
+		.dp_in(dp_in),
+		.d_out(d_out),
+		.dp_out(dp_out)
+	);
+
+	always #5 clk = ~clk;
+
+	initial begin
+		errors = 0;
+		$readmemh("sseg_format_vectors.hex", vectors);
+
+		repeat (4) @(posedge clk);
+		resetn <= 1'b1;
+		repeat (40) @(posedge clk);
+
+		// formatter disabled, the SSEG_DATA digits go straight through
+		d_in <= 40'h12345_6789A;
+		dp_in <= 8'hA5;
+		@(posedge clk);
+		#1;
+		if (d_out !== 40'h12345_6789A || dp_out !== 8'hA5) begin
+			$display("pass through: got %h %h", d_out, dp_out);
+			errors = errors + 1;
+		end
+		dp_in <= 8'h00;
+
+		// formatter enabled
+		for (n = 0; n < MAX_VECTORS && ^vectors[n] !== 1'bx; n = n + 1) begin
+			vec = vectors[n];
+			value <= vec[111:80];
+			format <= vec[79:48];
+			repeat (40) @(posedge clk);
+			#1;
+			if (d_out !== vec[39:0] || dp_out !== vec[47:40]) begin
+				if (errors < 20)
+					$display("%h %h: got %h %h, expected %h %h", vec[111:80], vec[79:48],
+							dp_out, d_out, vec[47:40], vec[39:0]);
+				errors = errors + 1;
+			end
+		end
+
+		$display("%0d vectors, %0d errors", n, errors);
+		if (errors == 0)
+			$display("PASSED");
+		else
+			$display("FAILED");
+		$finish;
+	end
+
+endmodule  // SevenSegFormat_tb
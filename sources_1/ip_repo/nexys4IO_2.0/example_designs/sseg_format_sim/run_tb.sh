@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# run_tb.sh - runs the self checking testbench of the seven segment number formatter
+#
+# Copyright Portland State University, 2017
+#
+# Builds the host model, writes the test vectors with it and simulates
+# SevenSegFormat_tb.v with Icarus Verilog, or with the Vivado simulator if
+# Icarus is not installed.  The simulation output goes to sim.log.  Exits 0
+# when the testbench prints PASSED, 1 when it fails and 2 when there is no
+# simulator.
+#
+# Run from any directory:
+#
+#	sh run_tb.sh
+#
+###########################################################################
+
+set -e
+cd "$(dirname "$0")"
+
+gcc -std=gnu99 -Wall -o sseg_format_model sseg_format_model.c
+./sseg_format_model sseg_format_vectors.hex
+
+if command -v iverilog >/dev/null 2>&1; then
+	iverilog -g2005 -s SevenSegFormat_tb -o SevenSegFormat_tb.vvp \
+		SevenSegFormat_tb.v ../../src/sevensegment.v
+	vvp -n SevenSegFormat_tb.vvp > sim.log
+elif command -v xvlog >/dev/null 2>&1; then
+	xvlog SevenSegFormat_tb.v ../../src/sevensegment.v
+	xelab -debug off -s SevenSegFormat_tb_sim SevenSegFormat_tb
+	xsim SevenSegFormat_tb_sim -R > sim.log
+else
+	echo "no Verilog simulator found, install Icarus Verilog or source the Vivado settings"
+	exit 2
+fi
+
+cat sim.log
+grep -q "PASSED" sim.log || exit 1
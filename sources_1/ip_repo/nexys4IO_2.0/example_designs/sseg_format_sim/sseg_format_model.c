@@ -0,0 +1,262 @@
+/**
+*
+* @file sseg_format_model.c
+*
+* @copyright Portland State University, 2017
+*
+* Host model of the SevenSegFormat number formatter in sevensegment.v.
+* The model follows the RTL step for step: the BCD digits, the leading
+* zero blanking, the minus sign, the fixed point and the overflow check.
+* It is checked against a reference that prints the same numbers with
+* sprintf(), and writes the test vectors read by SevenSegFormat_tb.v.
+*
+* Build and run on the host, from this directory:
+*
+*	gcc -std=gnu99 -Wall -o sseg_format_model sseg_format_model.c
+*	./sseg_format_model sseg_format_vectors.hex
+*
+* Each line of the vector file holds the value, the format and the expected
+* {dp_out, d_out} in hex.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************** Constant Definitions ****************************/
+#define FMT_EN			0x80000000u
+#define FMT_TRIM		0x00000100u
+#define FMT_UDEC		0
+#define FMT_SDEC		1
+#define FMT_HEX			2
+
+#define CODE_MINUS		22
+#define CODE_BLANK		23
+
+#define NUM_RANDOM		3000
+
+/**************************** Type Definitions ******************************/
+typedef struct
+{
+	uint8_t		d[8];		// digit codes, d[0] is the rightmost digit
+	uint8_t		dp;			// decimal points
+} sseg_t;
+
+/************************** Model ********************************************/
+
+// what SevenSegFormat shows for value in format
+static sseg_t sseg_format(uint32_t value, uint32_t format)
+{
+	sseg_t		out;
+	int			hex = (format >> 1) & 1;
+	int			places = (format >> 4) & 7;
+	int			trim = (format & FMT_TRIM) != 0;
+	int			neg = ((format & 3) == FMT_SDEC) && (value & 0x80000000u);
+	uint32_t	mag = neg ? -value : value;
+	uint8_t		bcd[10];	// what double dabble leaves in bcd, bcd[0] least significant
+	int			keep, lead, msd, i;
+
+	for (i = 0; i < 10; i++)
+	{
+		bcd[i] = mag % 10;
+		mag /= 10;
+	}
+
+	keep = hex ? 0 : places;
+	for (i = 0; i < 8; i++)
+	{
+		out.d[i] = hex ? (value >> (i * 4)) & 0xF : bcd[i];
+	}
+
+	lead = trim;
+	msd = 7;
+	for (i = 7; i > 0; i--)
+	{
+		if (lead && (out.d[i] == 0) && (i > keep))
+		{
+			out.d[i] = CODE_BLANK;
+			msd = i - 1;
+		}
+		else
+		{
+			lead = 0;
+		}
+	}
+
+	if (neg)
+	{
+		out.d[(msd == 7) ? 7 : msd + 1] = CODE_MINUS;
+	}
+
+	out.dp = (hex || places == 0) ? 0 : 1 << places;
+
+	if (!hex && (bcd[9] || bcd[8] || (neg && bcd[7])))
+	{
+		memset(out.d, CODE_MINUS, sizeof(out.d));
+		out.dp = 0;
+	}
+	return out;
+}
+
+/************************** Reference ****************************************/
+
+// the display as text, 8 characters with a '.' after a digit whose point is lit
+static void sseg_text(const sseg_t *p, char *text)
+{
+	int i;
+
+	for (i = 7; i >= 0; i--)
+	{
+		if (p->d[i] < 16)
+			*text++ = "0123456789ABCDEF"[p->d[i]];
+		else if (p->d[i] == CODE_MINUS)
+			*text++ = '-';
+		else
+			*text++ = ' ';
+		if (p->dp & (1 << i))
+			*text++ = '.';
+	}
+	*text = '\0';
+}
+
+// the same text printed by the C library
+static void ref_text(uint32_t value, uint32_t format, char *text)
+{
+	char		num[24], out[24];
+	int			places = (format >> 4) & 7;
+	int			trim = (format & FMT_TRIM) != 0;
+	int			neg = ((format & 3) == FMT_SDEC) && (value & 0x80000000u);
+	uint64_t	mag = neg ? (uint64_t) -(int64_t) (int32_t) value : value;
+	int			len, i, o = 0;
+
+	if (format & 2)
+	{
+		if (trim)
+			sprintf(num, "%8X", value);
+		else
+			sprintf(num, "%08X", value);
+		strcpy(text, num);
+		return;
+	}
+
+	// digits, at least places + 1 of them, or 8 if not trimmed.  The minus
+	// sign goes in front, or replaces the top digit if that is a 0 and
+	// there is no room
+	len = sprintf(num, "%0*llu", trim ? places + 1 : 8, (unsigned long long) mag);
+	if (neg && len < 8)
+	{
+		memmove(num + 1, num, len + 1);
+		num[0] = '-';
+		len++;
+	}
+	else if (neg && num[0] == '0')
+	{
+		num[0] = '-';
+	}
+	else if (neg || len > 8)
+	{
+		strcpy(text, "--------");
+		return;
+	}
+	for (i = 0; i < 8 - len; i++)
+		out[o++] = ' ';
+	for (i = 0; i < len; i++)
+	{
+		out[o++] = num[i];
+		if (places != 0 && i == len - 1 - places)
+			out[o++] = '.';
+	}
+	out[o] = '\0';
+
+	strcpy(text, out);
+}
+
+/************************** Main *********************************************/
+
+static uint32_t rnd_state = 0x12345678;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+	return rnd_state;
+}
+
+int main(int argc, char *argv[])
+{
+	static const uint32_t edge[] = {
+		0, 1, 5, 9, 10, 99, 100, 12345, 9999999, 10000000, 99999999, 100000000,
+		0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, (uint32_t) -1, (uint32_t) -5,
+		(uint32_t) -9999999, (uint32_t) -10000000, 0x0000ABCD, 0xDEADBEEF
+	};
+	FILE		*fp = NULL;
+	sseg_t		s;
+	char		got[24], want[24];
+	uint32_t	value, format;
+	int			n = 0, bad = 0, mode, places, trim, i, j;
+
+	if (argc > 1 && (fp = fopen(argv[1], "w")) == NULL)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	for (i = 0; i < (int) (sizeof(edge) / sizeof(edge[0])) + NUM_RANDOM; i++)
+	{
+		if (i < (int) (sizeof(edge) / sizeof(edge[0])))
+			value = edge[i];
+		else
+			value = rnd() >> (rnd() % 32);
+
+		for (j = 0; j < 3 * 8 * 2; j++)
+		{
+			mode = j % 3;
+			places = (j / 3) % 8;
+			trim = j / 24;
+			format = FMT_EN | (trim ? FMT_TRIM : 0) | (places << 4) | mode;
+
+			s = sseg_format(value, format);
+			sseg_text(&s, got);
+			ref_text(value, format, want);
+			if (strcmp(got, want) != 0)
+			{
+				if (bad++ < 20)
+					printf("%08X %08X: model \"%s\" reference \"%s\"\n", value, format, got, want);
+			}
+
+			// the edge cases in every format, a few formats of the random ones
+			if (fp != NULL && (i < (int) (sizeof(edge) / sizeof(edge[0])) || (j % 16) == (i % 16)))
+			{
+				fprintf(fp, "%08X%08X%02X", value, format, s.dp);
+				for (places = 7; places >= 0; places -= 4)
+				{
+					// 4 digit codes, 20 bits, per 5 hex characters
+					fprintf(fp, "%05X", (s.d[places] << 15) | (s.d[places - 1] << 10)
+							| (s.d[places - 2] << 5) | s.d[places - 3]);
+				}
+				fprintf(fp, "\n");
+				n++;
+			}
+		}
+	}
+
+	if (fp != NULL)
+	{
+		fclose(fp);
+		printf("%d vectors written\n", n);
+	}
+	printf("%d mismatches\n", bad);
+	return bad != 0;
+}
@@ -558,6 +558,9 @@
      wire [4:0] dig4, dig5, dig6, dig7;
      // decimal point inputs for 7-segment display digits.
      wire [7:0] decpts;
+     // 7-segment digits and decimal points after the number formatter
+     wire [39:0] fmt_digs;
+     wire [7:0] fmt_decpts;
      // RGB LED PWM channel inputs
      wire [7:0] rgb1_reddc, rgb1_greendc, rgb1_bluedc;
      wire [7:0] rgb2_reddc, rgb2_greendc, rgb2_bluedc;
@@ -605,6 +608,23 @@
      // 7-segment decimal point
      assign decpts = {slv_reg7[27:24], slv_reg6[27:24]};
     
+     // 7-segment number formatter.  slv_reg8 is the number and slv_reg9 the
+     // format.  The digits above are shown when the formatter is not enabled
+     SevenSegFormat
+     #(
+         .RESET_POLARITY_LOW(1)
+     ) SSF
+     (
+         .clk(S_AXI_ACLK),
+         .reset(S_AXI_ARESETN),
+         .value(slv_reg8),
+         .format(slv_reg9),
+         .d_in({dig7, dig6, dig5, dig4, dig3, dig2, dig1, dig0}),
+         .dp_in(decpts),
+         .d_out(fmt_digs),
+         .dp_out(fmt_decpts)
+     );
+    
      // 7-segment display outputs
      assign an = an_int;
      assign dp = seg_int[7];
@@ -632,15 +652,15 @@
      ) SSB
      (
          // inputs for control signals
-         .d0(dig0),
-         .d1(dig1),
-         .d2(dig2),
-         .d3(dig3),
-         .d4(dig4),
-         .d5(dig5),
-         .d6(dig6),
-         .d7(dig7),
-         .dp(decpts),
+         .d0(fmt_digs[4:0]),
+         .d1(fmt_digs[9:5]),
+         .d2(fmt_digs[14:10]),
+         .d3(fmt_digs[19:15]),
+         .d4(fmt_digs[24:20]),
+         .d5(fmt_digs[29:25]),
+         .d6(fmt_digs[34:30]),
+         .d7(fmt_digs[39:35]),
+         .dp(fmt_decpts),
      
          // outputs to seven segment display
          .seg(seg_int),            
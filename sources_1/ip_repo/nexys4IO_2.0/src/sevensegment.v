@@ -11,6 +11,8 @@
 // Dec-2014		RK		Cleaned up the formatting.  No functional changes
 // Mar-2014		CZ		Formatted this module for the Digilent Nexys 4
 // Aug-2014		RK		Parameterized module.  Modified for Vivado and Nexys4
+// Jun-2017				Added SevenSegFormat, which converts a binary number to
+//						digit codes in hardware
 //
 // Description:
 // ------------
@@ -270,4 +272,164 @@ always @ (posedge clk) begin
 end
 
 endmodule  // Digit 7-segment decoder
-	
+
+
+// Binary to 7-segment digit code formatter
+//
+// Converts a 32-bit number to the eight digit codes for the display so that
+// software can show a number with one register write.  The format input
+// selects the conversion:
+//
+//   format[31]		1 = show the formatted number, 0 = pass d_in and dp_in through
+//   format[8]		1 = blank leading zeros
+//   format[6:4]	decimal places.  Lights the decimal point to the right of that
+//					digit, 0 is none.  Zeros up to that digit are never blanked
+//   format[1:0]	0 = unsigned decimal, 1 = signed decimal, 2 and 3 = hex
+//
+// Decimal numbers are converted by shift and add-3 (double dabble), one bit
+// per clock, so a new value is shown 34 clocks after it is written.  A minus
+// sign (segment g) is shown to the left of the most significant digit of a
+// negative number.  Numbers that do not fit in eight digits (including the
+// minus sign) show all segment g's.  The decimal points in dp_in are ORed
+// with the fixed point one.
+module SevenSegFormat
+#(
+	parameter integer	RESET_POLARITY_LOW		= 1
+)
+(
+	input				clk,
+	input				reset,
+
+	input		[31:0]	value,				// number to display
+	input		[31:0]	format,				// format control, see above
+	input		[39:0]	d_in,				// digit codes from the SSEG_DATA registers, {d7, ..., d0}
+	input		[7:0]	dp_in,				// decimal points from the SSEG_DATA registers
+
+	output		[39:0]	d_out,				// digit codes to the display
+	output		[7:0]	dp_out				// decimal points to the display
+);
+
+	localparam	[4:0]	CODE_MINUS = 5'd22;	// segment g
+	localparam	[4:0]	CODE_BLANK = 5'd23;
+
+	// reset - asserted low (S_AXI_ARESETN)
+	wire reset_in = RESET_POLARITY_LOW ? ~reset : reset;
+
+	// conversion state
+	reg			[31:0]	value_q;			// value being shown
+	reg			[8:0]	format_q;			// format[8:0] being shown
+	reg					dirty;				// convert even if nothing changed, after reset
+	reg					busy;				// conversion in progress
+	reg			[5:0]	count;				// bits left to shift
+	reg					neg;				// value is negative
+	reg			[31:0]	bin;				// binary bits not yet shifted into bcd
+	reg			[39:0]	bcd;				// BCD digits, 10 of them
+
+	// formatted digits
+	reg			[39:0]	d_fmt;
+	reg			[7:0]	dp_fmt;
+	reg			[39:0]	d_next;
+	reg			[7:0]	dp_next;
+
+	wire				signed_dec = (format[1:0] == 2'b01);
+	wire				start = ~busy & (dirty | (value != value_q) | (format[8:0] != format_q));
+
+	// add 3 to every BCD digit that is 5 or more, before the shift
+	function [39:0] dabble;
+		input	[39:0]	b;
+		integer			i;
+		begin
+			for (i = 0; i < 10; i = i + 1)
+				dabble[i*4 +: 4] = (b[i*4 +: 4] >= 4'd5) ? b[i*4 +: 4] + 4'd3 : b[i*4 +: 4];
+		end
+	endfunction
+
+	// conversion
+	always @ (posedge clk) begin
+		if (reset_in) begin
+			value_q <= 32'd0;
+			format_q <= 9'd0;
+			dirty <= 1'b1;
+			busy <= 1'b0;
+			count <= 6'd0;
+			neg <= 1'b0;
+			bin <= 32'd0;
+			bcd <= 40'd0;
+			d_fmt <= {8{CODE_BLANK}};
+			dp_fmt <= 8'd0;
+		end
+		else if (start) begin
+			value_q <= value;
+			format_q <= format[8:0];
+			dirty <= 1'b0;
+			busy <= 1'b1;
+			count <= 6'd32;
+			neg <= signed_dec & value[31];
+			bin <= (signed_dec & value[31]) ? -value : value;
+			bcd <= 40'd0;
+		end
+		else if (busy) begin
+			if (count != 6'd0) begin
+				{bcd, bin} <= {dabble(bcd), bin} << 1;
+				count <= count - 1'b1;
+			end
+			else begin
+				busy <= 1'b0;
+				d_fmt <= d_next;
+				dp_fmt <= dp_next;
+			end
+		end
+	end  // conversion
+
+	// digit codes for the converted number
+	reg			[3:0]	nibble;
+	reg			[2:0]	keep;				// digits at or below this one are never blanked
+	reg					lead;				// still in the leading zeros
+	reg			[3:0]	msd;				// most significant digit shown
+	integer				i;
+
+	always @ (*) begin
+		keep = format_q[1] ? 3'd0 : format_q[6:4];
+
+		// digits, hex straight from the value
+		for (i = 0; i < 8; i = i + 1) begin
+			nibble = format_q[1] ? value_q[i*4 +: 4] : bcd[i*4 +: 4];
+			d_next[i*5 +: 5] = {1'b0, nibble};
+		end
+
+		// blank the leading zeros
+		lead = format_q[8];
+		msd = 4'd7;
+		for (i = 7; i > 0; i = i - 1) begin
+			if (lead && (d_next[i*5 +: 5] == 5'd0) && (i > keep)) begin
+				d_next[i*5 +: 5] = CODE_BLANK;
+				msd = i - 1;
+			end
+			else begin
+				lead = 1'b0;
+			end
+		end
+
+		// the minus sign goes left of the most significant digit.  The top digit
+		// is 0 if the number fits so it can always go there
+		if (neg) begin
+			if (msd == 4'd7)
+				d_next[35 +: 5] = CODE_MINUS;
+			else
+				d_next[(msd+1)*5 +: 5] = CODE_MINUS;
+		end
+
+		// fixed point
+		dp_next = (format_q[1] || format_q[6:4] == 3'd0) ? 8'd0 : (8'd1 << format_q[6:4]);
+
+		// overflow
+		if (~format_q[1] && ((bcd[39:32] != 8'd0) || (neg && bcd[31:28] != 4'd0))) begin
+			d_next = {8{CODE_MINUS}};
+			dp_next = 8'd0;
+		end
+	end  // digit codes
+
+	assign d_out = format[31] ? d_fmt : d_in;
+	assign dp_out = format[31] ? (dp_fmt | dp_in) : dp_in;
+
+endmodule  // SevenSegFormat
@@ -0,0 +1,665 @@
+/************************************************************************/
+/*																		*/
+/*	OLEDrgb_emu.c	--	Host emulator of the PmodOLEDrgb				*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	This module emulates the PmodOLEDrgb on the host, so display code	*/
+/*	can be looked at and measured without the board.  It provides		*/
+/*	Xil_In32() and Xil_Out32() and models the registers that the XSpi	*/
+/*	driver uses: the 16 byte transmit and receive FIFOs, the control,	*/
+/*	status and slave select registers and the interrupt registers.		*/
+/*	A byte is shifted out as soon as the master transaction inhibit		*/
+/*	bit is clear, so both the polled and the interrupt driven paths		*/
+/*	of XSpi_Transfer() run; the interrupt driven one completes when		*/
+/*	XSpi_InterruptHandler() is called, ex: from OLEDrgb_AsyncPoll().	*/
+/*																		*/
+/*	Each byte is handed to an SSD1331 model with the D/C line of the	*/
+/*	GPIO.  The model keeps the 96x64 RGB565 display RAM and decodes		*/
+/*	the command set used by PmodOLEDrgb.c: column and row address		*/
+/*	windows with pixel data, line, rectangle, copy, dim and clear.		*/
+/*	The setup commands are parsed for their length and ignored.  The	*/
+/*	colors of the drawing commands are read the way OLEDrgb_Extract*	*/
+/*	FromRGB() packs them, 5/6/5 bits.  Dim is modelled as half of the	*/
+/*	brightness.															*/
+/*																		*/
+/*	The statistics count the bytes of each kind and the time the		*/
+/*	driver waited in uwait(); OLEDrgbEmu_BusTimeUs() turns the bytes	*/
+/*	into SPI time at the configured SCK frequency.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "OLEDrgb_emu.h"
+#include "xil_io.h"
+#include "xil_assert.h"
+#include "xspi_l.h"
+#include <stdio.h>
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+#define EMU_WIDTH		96
+#define EMU_HEIGHT		64
+#define EMU_FIFO_DEPTH	16
+#define EMU_SPI_REGS	(0x80 / 4)
+
+#define EMU_GPIO_DC		0x01		// D/C, high for display RAM data
+#define EMU_GPIO_VCCEN	0x04		// panel supply
+#define EMU_GPIO_PMODEN	0x08		// Pmod supply
+
+/************************** Variable Definitions ***************************/
+
+// AXI Quad SPI
+static u32		rgSpiReg[EMU_SPI_REGS];
+static u8		rgbTxFifo[EMU_FIFO_DEPTH];
+static int		cbTxFifo;
+static int		cbRxFifo;
+
+// AXI GPIO
+static u32		gpioData;
+static u32		gpioTri;
+
+// SSD1331
+static uint16_t	rgwRam[EMU_HEIGHT][EMU_WIDTH];
+static u8		rgbCmd[40];
+static int		cbCmd;				// command bytes received
+static int		cbCmdLen;			// length of the command being received
+static int		colStart, colEnd, rowStart, rowEnd;
+static int		colCur, rowCur;
+static u8		bPixelHigh;			// first byte of a pixel
+static int		fPixelHalf;
+static int		fFill;				// rectangles are filled
+static int		fDisplayOn;
+
+static u32		sckHzBus = OLEDRGB_EMU_SCK_HZ;
+static OLEDrgbEmu_Stats stats;
+
+/************************** Function Definitions ***************************/
+
+/* ------------------------------------------------------------ */
+/*				SSD1331 model									*/
+/* ------------------------------------------------------------ */
+
+// bytes of a command, the command byte included
+static int EMU_CmdLen(u8 cmd)
+{
+	switch (cmd) {
+	case 0x15: case 0x75:					// column, row address
+		return 3;
+	case 0x21:								// draw line
+		return 8;
+	case 0x22:								// draw rectangle
+		return 11;
+	case 0x23:								// copy
+		return 7;
+	case 0x24: case 0x25:					// dim, clear
+		return 5;
+	case 0x26:								// fill enable
+		return 2;
+	case 0x27:								// scrolling setup
+		return 6;
+	case 0xAB:								// dim mode setting
+		return 6;
+	case 0xB8:								// gray scale table
+		return 33;
+	case 0x81: case 0x82: case 0x83: case 0x87:
+	case 0x8A: case 0x8B: case 0x8C:
+	case 0xA0: case 0xA1: case 0xA2: case 0xA8: case 0xAD:
+	case 0xB0: case 0xB1: case 0xB3: case 0xBB: case 0xBE:
+	case 0xFD:
+		return 2;
+	case 0x2E: case 0x2F:
+	case 0xA4: case 0xA5: case 0xA6: case 0xA7:
+	case 0xAC: case 0xAE: case 0xAF: case 0xB9:
+		return 1;
+	default:
+		stats.cUnknown++;
+		return 1;
+	}
+}
+
+static inline uint16_t EMU_Color(const u8 *pb)
+{
+	return ((pb[0] & 0x1F) << 11) | ((pb[1] & 0x3F) << 5) | (pb[2] & 0x1F);
+}
+
+static inline void EMU_Plot(int c, int r, uint16_t w)
+{
+	if ((c >= 0) && (c < EMU_WIDTH) && (r >= 0) && (r < EMU_HEIGHT)) {
+		rgwRam[r][c] = w;
+	}
+}
+
+static void EMU_Line(int c1, int r1, int c2, int r2, uint16_t w)
+{
+	int dc = (c2 > c1) ? c2 - c1 : c1 - c2;
+	int dr = (r2 > r1) ? r1 - r2 : r2 - r1;
+	int sc = (c1 < c2) ? 1 : -1;
+	int sr = (r1 < r2) ? 1 : -1;
+	int err = dc + dr, e2;
+
+	while (1) {
+		EMU_Plot(c1, r1, w);
+		if ((c1 == c2) && (r1 == r2)) {
+			break;
+		}
+		e2 = 2 * err;
+		if (e2 >= dr) {
+			err += dr;
+			c1 += sc;
+		}
+		if (e2 <= dc) {
+			err += dc;
+			r1 += sr;
+		}
+	}
+}
+
+static void EMU_Rect(int c1, int r1, int c2, int r2, uint16_t wLine, uint16_t wFill)
+{
+	int c, r;
+
+	if (fFill) {
+		for (r = r1 + 1; r < r2; r++) {
+			for (c = c1 + 1; c < c2; c++) {
+				EMU_Plot(c, r, wFill);
+			}
+		}
+	}
+	EMU_Line(c1, r1, c2, r1, wLine);
+	EMU_Line(c1, r2, c2, r2, wLine);
+	EMU_Line(c1, r1, c1, r2, wLine);
+	EMU_Line(c2, r1, c2, r2, wLine);
+}
+
+static void EMU_Copy(int c1, int r1, int c2, int r2, int c3, int r3)
+{
+	static uint16_t rgwTmp[EMU_HEIGHT][EMU_WIDTH];
+	int c, r;
+
+	memcpy(rgwTmp, rgwRam, sizeof(rgwRam));
+	for (r = r1; r <= r2; r++) {
+		for (c = c1; c <= c2; c++) {
+			if ((c < EMU_WIDTH) && (r < EMU_HEIGHT)) {
+				EMU_Plot(c3 + c - c1, r3 + r - r1, rgwTmp[r][c]);
+			}
+		}
+	}
+}
+
+static void EMU_Dim(int c1, int r1, int c2, int r2)
+{
+	uint16_t w;
+	int c, r;
+
+	for (r = r1; (r <= r2) && (r < EMU_HEIGHT); r++) {
+		for (c = c1; (c <= c2) && (c < EMU_WIDTH); c++) {
+			w = rgwRam[r][c];
+			rgwRam[r][c] = (w >> 1) & 0x7BEF;
+		}
+	}
+}
+
+static void EMU_Clear(int c1, int r1, int c2, int r2)
+{
+	int c, r;
+
+	for (r = r1; (r <= r2) && (r < EMU_HEIGHT); r++) {
+		for (c = c1; (c <= c2) && (c < EMU_WIDTH); c++) {
+			rgwRam[r][c] = 0;
+		}
+	}
+}
+
+static void EMU_Execute(void)
+{
+	const u8 *pb = rgbCmd;
+
+	switch (pb[0]) {
+	case 0x15:
+		colStart = (pb[1] < EMU_WIDTH) ? pb[1] : EMU_WIDTH - 1;
+		colEnd = (pb[2] < EMU_WIDTH) ? pb[2] : EMU_WIDTH - 1;
+		colCur = colStart;
+		stats.cWindows++;
+		break;
+	case 0x75:
+		rowStart = (pb[1] < EMU_HEIGHT) ? pb[1] : EMU_HEIGHT - 1;
+		rowEnd = (pb[2] < EMU_HEIGHT) ? pb[2] : EMU_HEIGHT - 1;
+		rowCur = rowStart;
+		stats.cWindows++;
+		break;
+	case 0x21:
+		EMU_Line(pb[1], pb[2], pb[3], pb[4], EMU_Color(&pb[5]));
+		stats.cAccel++;
+		break;
+	case 0x22:
+		EMU_Rect(pb[1], pb[2], pb[3], pb[4], EMU_Color(&pb[5]), EMU_Color(&pb[8]));
+		stats.cAccel++;
+		break;
+	case 0x23:
+		EMU_Copy(pb[1], pb[2], pb[3], pb[4], pb[5], pb[6]);
+		stats.cAccel++;
+		break;
+	case 0x24:
+		EMU_Dim(pb[1], pb[2], pb[3], pb[4]);
+		stats.cAccel++;
+		break;
+	case 0x25:
+		EMU_Clear(pb[1], pb[2], pb[3], pb[4]);
+		stats.cAccel++;
+		break;
+	case 0x26:
+		fFill = pb[1] & 0x01;
+		break;
+	case 0xAE:
+		fDisplayOn = 0;
+		break;
+	case 0xAF:
+		fDisplayOn = 1;
+		break;
+	}
+}
+
+static void EMU_Byte(u8 b)
+{
+	if (gpioData & EMU_GPIO_DC) {
+		// display RAM data, two bytes per pixel, high byte first
+		stats.cbData++;
+		if (!fPixelHalf) {
+			bPixelHigh = b;
+			fPixelHalf = 1;
+			return;
+		}
+		fPixelHalf = 0;
+		rgwRam[rowCur][colCur] = (bPixelHigh << 8) | b;
+		if (++colCur > colEnd) {
+			colCur = colStart;
+			if (++rowCur > rowEnd) {
+				rowCur = rowStart;
+			}
+		}
+		return;
+	}
+
+	stats.cbCmd++;
+	fPixelHalf = 0;
+	if (cbCmd == 0) {
+		cbCmdLen = EMU_CmdLen(b);
+	}
+	rgbCmd[cbCmd++] = b;
+	if (cbCmd == cbCmdLen) {
+		EMU_Execute();
+		cbCmd = 0;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/*				AXI Quad SPI model								*/
+/* ------------------------------------------------------------ */
+
+static void EMU_SpiReset(void)
+{
+	memset(rgSpiReg, 0, sizeof(rgSpiReg));
+	rgSpiReg[XSP_CR_OFFSET / 4] = XSP_CR_TRANS_INHIBIT_MASK | XSP_CR_MANUAL_SS_MASK;
+	rgSpiReg[XSP_SSR_OFFSET / 4] = 0xFFFFFFFF;
+	cbTxFifo = 0;
+	cbRxFifo = 0;
+}
+
+// shift out the transmit FIFO if the master is allowed to
+static void EMU_SpiShift(void)
+{
+	u32 cr = rgSpiReg[XSP_CR_OFFSET / 4];
+	int i;
+
+	if (!(cr & XSP_CR_ENABLE_MASK) || (cr & XSP_CR_TRANS_INHIBIT_MASK) || (cbTxFifo == 0)) {
+		return;
+	}
+	for (i = 0; i < cbTxFifo; i++) {
+		EMU_Byte(rgbTxFifo[i]);
+		if (cbRxFifo < EMU_FIFO_DEPTH) {
+			cbRxFifo++;
+		}
+		else {
+			rgSpiReg[XSP_IISR_OFFSET / 4] |= XSP_INTR_RX_OVERRUN_MASK;
+		}
+	}
+	cbTxFifo = 0;
+	rgSpiReg[XSP_IISR_OFFSET / 4] |= XSP_INTR_TX_EMPTY_MASK;
+}
+
+static u32 EMU_SpiRead(u32 offset)
+{
+	u32 sr;
+
+	switch (offset) {
+	case XSP_SR_OFFSET:
+		sr = 0;
+		if (cbRxFifo == 0) {
+			sr |= XSP_SR_RX_EMPTY_MASK;
+		}
+		if (cbRxFifo == EMU_FIFO_DEPTH) {
+			sr |= XSP_SR_RX_FULL_MASK;
+		}
+		if (cbTxFifo == 0) {
+			sr |= XSP_SR_TX_EMPTY_MASK;
+		}
+		if (cbTxFifo == EMU_FIFO_DEPTH) {
+			sr |= XSP_SR_TX_FULL_MASK;
+		}
+		return sr;
+	case XSP_DRR_OFFSET:
+		// the display has no data out, every received byte is 0
+		if (cbRxFifo != 0) {
+			cbRxFifo--;
+		}
+		return 0;
+	case XSP_TFO_OFFSET:
+		return (cbTxFifo != 0) ? cbTxFifo - 1 : 0;
+	case XSP_RFO_OFFSET:
+		return (cbRxFifo != 0) ? cbRxFifo - 1 : 0;
+	default:
+		return (offset < sizeof(rgSpiReg)) ? rgSpiReg[offset / 4] : 0;
+	}
+}
+
+static void EMU_SpiWrite(u32 offset, u32 value)
+{
+	switch (offset) {
+	case XSP_SRR_OFFSET:
+		if (value == XSP_SRR_RESET_MASK) {
+			EMU_SpiReset();
+		}
+		break;
+	case XSP_CR_OFFSET:
+		if (value & XSP_CR_TXFIFO_RESET_MASK) {
+			cbTxFifo = 0;
+		}
+		if (value & XSP_CR_RXFIFO_RESET_MASK) {
+			cbRxFifo = 0;
+		}
+		rgSpiReg[XSP_CR_OFFSET / 4] = value & ~(XSP_CR_TXFIFO_RESET_MASK | XSP_CR_RXFIFO_RESET_MASK);
+		EMU_SpiShift();
+		break;
+	case XSP_DTR_OFFSET:
+		if (cbTxFifo < EMU_FIFO_DEPTH) {
+			rgbTxFifo[cbTxFifo++] = value;
+		}
+		EMU_SpiShift();
+		break;
+	case XSP_SSR_OFFSET:
+		// count the selects of the display
+		if (!(value & 0x01) && (rgSpiReg[XSP_SSR_OFFSET / 4] & 0x01)) {
+			stats.cTransfers++;
+		}
+		rgSpiReg[XSP_SSR_OFFSET / 4] = value;
+		break;
+	case XSP_IISR_OFFSET:
+		// toggle on write
+		rgSpiReg[XSP_IISR_OFFSET / 4] &= ~value;
+		break;
+	default:
+		if (offset < sizeof(rgSpiReg)) {
+			rgSpiReg[offset / 4] = value;
+		}
+		break;
+	}
+}
+
+/* ------------------------------------------------------------ */
+/*				BSP functions									*/
+/* ------------------------------------------------------------ */
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	if ((Addr >= OLEDRGB_EMU_SPI_BASEADDR) && (Addr < OLEDRGB_EMU_SPI_BASEADDR + 0x80)) {
+		return EMU_SpiRead(Addr - OLEDRGB_EMU_SPI_BASEADDR);
+	}
+	if (Addr == OLEDRGB_EMU_GPIO_BASEADDR) {
+		return gpioData;
+	}
+	if (Addr == OLEDRGB_EMU_GPIO_BASEADDR + 4) {
+		return gpioTri;
+	}
+	return 0;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	if ((Addr >= OLEDRGB_EMU_SPI_BASEADDR) && (Addr < OLEDRGB_EMU_SPI_BASEADDR + 0x80)) {
+		EMU_SpiWrite(Addr - OLEDRGB_EMU_SPI_BASEADDR, Value);
+	}
+	else if (Addr == OLEDRGB_EMU_GPIO_BASEADDR) {
+		gpioData = Value;
+	}
+	else if (Addr == OLEDRGB_EMU_GPIO_BASEADDR + 4) {
+		gpioTri = Value;
+	}
+}
+
+void Xil_Assert(const char *File, s32 Line)
+{
+	fprintf(stderr, "assert %s:%d\n", File, (int) Line);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_Init
+**
+**	Parameters:
+**		sckHz		- SPI clock used for the bus time, 0 for
+**					  OLEDRGB_EMU_SCK_HZ
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Resets the registers, the display RAM and the statistics.
+**		Call it before OLEDrgb_begin().
+*/
+void OLEDrgbEmu_Init(u32 sckHz)
+{
+	EMU_SpiReset();
+	gpioData = 0;
+	gpioTri = 0xFFFFFFFF;
+
+	memset(rgwRam, 0, sizeof(rgwRam));
+	cbCmd = 0;
+	colStart = 0;
+	colEnd = EMU_WIDTH - 1;
+	rowStart = 0;
+	rowEnd = EMU_HEIGHT - 1;
+	colCur = 0;
+	rowCur = 0;
+	fPixelHalf = 0;
+	fFill = 0;
+	fDisplayOn = 0;
+
+	sckHzBus = (sckHz != 0) ? sckHz : OLEDRGB_EMU_SCK_HZ;
+	OLEDrgbEmu_ResetStats();
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_Delay
+**
+**	Parameters:
+**		usec		- delay in microseconds
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Delay function for OLEDrgb_SetDelay().  It returns at once
+**		and adds the delay to the statistics.
+*/
+void OLEDrgbEmu_Delay(u32 usec)
+{
+	stats.usWait += usec;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_GetPixel
+**
+**	Parameters:
+**		c			- column
+**		r			- row
+**
+**	Return Value:
+**		RGB565 color of the display RAM, 0 outside of the display
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads a pixel of the virtual panel.
+*/
+uint16_t OLEDrgbEmu_GetPixel(int c, int r)
+{
+	if ((c < 0) || (c >= EMU_WIDTH) || (r < 0) || (r >= EMU_HEIGHT)) {
+		return 0;
+	}
+	return rgwRam[r][c];
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_IsOn
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		nonzero if the panel would show the display RAM
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		The panel is on after the display on command, with the
+**		panel and Pmod supplies enabled.
+*/
+int OLEDrgbEmu_IsOn(void)
+{
+	return fDisplayOn && (gpioData & EMU_GPIO_VCCEN) && (gpioData & EMU_GPIO_PMODEN);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_SavePPM
+**
+**	Parameters:
+**		szPath		- file to write
+**		scale		- size of a display pixel in the image, 1 or more
+**
+**	Return Value:
+**		0, or -1 if the file can not be written
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Writes the display RAM as a binary PPM image.  Convert it
+**		with any image tool, ex: "convert frame.ppm frame.png".
+*/
+int OLEDrgbEmu_SavePPM(const char *szPath, int scale)
+{
+	FILE *pf;
+	uint16_t w;
+	u8 rgb[3];
+	int c, r, sx, sy;
+
+	if (scale < 1) {
+		scale = 1;
+	}
+	pf = fopen(szPath, "wb");
+	if (pf == NULL) {
+		return -1;
+	}
+
+	fprintf(pf, "P6\n%d %d\n255\n", EMU_WIDTH * scale, EMU_HEIGHT * scale);
+	for (r = 0; r < EMU_HEIGHT; r++) {
+		for (sy = 0; sy < scale; sy++) {
+			for (c = 0; c < EMU_WIDTH; c++) {
+				w = rgwRam[r][c];
+				rgb[0] = ((w >> 11) & 0x1F) * 255 / 31;
+				rgb[1] = ((w >> 5) & 0x3F) * 255 / 63;
+				rgb[2] = (w & 0x1F) * 255 / 31;
+				for (sx = 0; sx < scale; sx++) {
+					fwrite(rgb, 1, 3, pf);
+				}
+			}
+		}
+	}
+
+	return (fclose(pf) == 0) ? 0 : -1;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_GetStats
+**
+**	Parameters:
+**		pStats		- set to the statistics since the last reset
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads the statistics, ex: at the end of a frame.
+*/
+void OLEDrgbEmu_GetStats(OLEDrgbEmu_Stats *pStats)
+{
+	*pStats = stats;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_ResetStats
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Clears the statistics, ex: at the start of a frame.
+*/
+void OLEDrgbEmu_ResetStats(void)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgbEmu_BusTimeUs
+**
+**	Parameters:
+**		pStats		- statistics of a frame
+**
+**	Return Value:
+**		time to shift the bytes of the frame, in microseconds
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Eight SCK periods per byte.  The time the driver spends
+**		between bytes and in uwait() is not included.
+*/
+u32 OLEDrgbEmu_BusTimeUs(const OLEDrgbEmu_Stats *pStats)
+{
+	return (u32) (((u64) (pStats->cbCmd + pStats->cbData) * 8 * 1000000) / sckHzBus);
+}
@@ -0,0 +1,64 @@
+/************************************************************************/
+/*																		*/
+/* OLEDrgb_emu.h	--	Interface Declarations for OLEDrgb_emu.c		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	This header file contains the declarations of the host emulator	*/
+/*	of the PmodOLEDrgb.  The emulator stands in for the registers of	*/
+/*	the AXI Quad SPI and AXI GPIO behind Xil_In32()/Xil_Out32(), so		*/
+/*	the unmodified XSpi and PmodOLEDrgb drivers run on the host, and	*/
+/*	decodes the bytes they shift out into a virtual 96x64 SSD1331		*/
+/*	panel.																*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+#ifndef OLEDRGB_EMU_H
+#define OLEDRGB_EMU_H
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+#include "xil_types.h"
+#include "xparameters.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+#define OLEDRGB_EMU_GPIO_BASEADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR
+#define OLEDRGB_EMU_SPI_BASEADDR	XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_BASEADDR
+#define OLEDRGB_EMU_SCK_HZ			6250000		// 100 MHz AXI clock / C_SCK_RATIO of 16
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+typedef struct{
+	u32	cTransfers;		// slave select assertions, one per XSpi_Transfer()
+	u32	cbCmd;			// bytes sent with D/C low
+	u32	cbData;			// bytes sent with D/C high, two per pixel
+	u32	cWindows;		// column or row address commands
+	u32	cAccel;			// line, rectangle, copy, dim and clear commands
+	u32	cUnknown;		// command bytes the emulator does not know
+	u32	usWait;			// time the driver asked uwait() for
+}OLEDrgbEmu_Stats;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+void OLEDrgbEmu_Init(u32 sckHz);
+void OLEDrgbEmu_Delay(u32 usec);
+
+uint16_t OLEDrgbEmu_GetPixel(int c, int r);
+int OLEDrgbEmu_IsOn(void);
+int OLEDrgbEmu_SavePPM(const char *szPath, int scale);
+
+void OLEDrgbEmu_GetStats(OLEDrgbEmu_Stats *pStats);
+void OLEDrgbEmu_ResetStats(void);
+u32 OLEDrgbEmu_BusTimeUs(const OLEDrgbEmu_Stats *pStats);
+
+#endif // OLEDRGB_EMU_H
@@ -0,0 +1,47 @@
+/************************************************************************/
+/*																		*/
+/* xil_assert.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The asserts report the file and line like the BSP ones and then		*/
+/*	return from the function.											*/
+/*																		*/
+/************************************************************************/
+#ifndef XIL_ASSERT_H
+#define XIL_ASSERT_H
+
+#include "xil_types.h"
+
+void Xil_Assert(const char *File, s32 Line);
+
+#define Xil_AssertVoid(Expression)					\
+	do {											\
+		if (!(Expression)) {						\
+			Xil_Assert(__FILE__, __LINE__);			\
+			return;									\
+		}											\
+	} while (0)
+
+#define Xil_AssertNonvoid(Expression)				\
+	do {											\
+		if (!(Expression)) {						\
+			Xil_Assert(__FILE__, __LINE__);			\
+			return 0;								\
+		}											\
+	} while (0)
+
+#define Xil_AssertVoidAlways()						\
+	do {											\
+		Xil_Assert(__FILE__, __LINE__);				\
+		return;										\
+	} while (0)
+
+#define Xil_AssertNonvoidAlways()					\
+	do {											\
+		Xil_Assert(__FILE__, __LINE__);				\
+		return 0;									\
+	} while (0)
+
+#endif // XIL_ASSERT_H
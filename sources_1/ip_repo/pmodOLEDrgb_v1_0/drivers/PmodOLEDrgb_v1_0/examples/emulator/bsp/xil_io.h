@@ -0,0 +1,20 @@
+/************************************************************************/
+/*																		*/
+/* xil_io.h	--	Host stand-in for the Xilinx BSP header					*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Register accesses go to the display emulator, which models the		*/
+/*	AXI Quad SPI and the AXI GPIO of the PmodOLEDrgb IP.				*/
+/*																		*/
+/************************************************************************/
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+u32 Xil_In32(UINTPTR Addr);
+void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#endif // XIL_IO_H
@@ -0,0 +1,18 @@
+/************************************************************************/
+/*																		*/
+/* xparameters.h	--	Host stand-in for the generated header			*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	Addresses of the PmodOLEDrgb registers modelled by the display		*/
+/*	emulator.															*/
+/*																		*/
+/************************************************************************/
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR	0x44A00000
+#define XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_BASEADDR	0x44A10000
+
+#endif // XPARAMETERS_H
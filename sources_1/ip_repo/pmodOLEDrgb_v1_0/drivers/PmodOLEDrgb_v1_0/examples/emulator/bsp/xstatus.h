@@ -0,0 +1,40 @@
+/************************************************************************/
+/*																		*/
+/* xstatus.h	--	Host stand-in for the Xilinx BSP header				*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	The status codes that the PmodOLEDrgb and XSpi drivers return,		*/
+/*	with the values of the BSP.											*/
+/*																		*/
+/************************************************************************/
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS					0L
+#define XST_FAILURE					1L
+#define XST_DEVICE_NOT_FOUND		2L
+#define XST_DEVICE_IS_STARTED		5L
+#define XST_DEVICE_IS_STOPPED		6L
+#define XST_INVALID_PARAM			15L
+#define XST_DEVICE_BUSY				21L
+
+#define XST_SPI_MODE_FAULT			1151
+#define XST_SPI_TRANSFER_DONE		1152
+#define XST_SPI_TRANSMIT_UNDERRUN	1153
+#define XST_SPI_RECEIVE_OVERRUN		1154
+#define XST_SPI_NO_SLAVE			1155
+#define XST_SPI_TOO_MANY_SLAVES		1156
+#define XST_SPI_NOT_MASTER			1157
+#define XST_SPI_SLAVE_ONLY			1158
+#define XST_SPI_SLAVE_MODE_FAULT	1159
+#define XST_SPI_SLAVE_MODE			1160
+#define XST_SPI_RECEIVE_NOT_EMPTY	1161
+#define XST_SPI_COMMAND_ERROR		1162
+
+typedef s32 XStatus;
+
+#endif // XSTATUS_H
@@ -0,0 +1,211 @@
+/************************************************************************/
+/*																		*/
+/*	fbbench.c	--	SPI cost of text drawn directly and through the FB	*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Runs the same text updates on the emulator twice, once with			*/
+/*	OLEDrgb_PutString() straight to the display and once with			*/
+/*	OLEDrgb_FB_PutString() and one OLEDrgb_FB_Flush() per frame, and	*/
+/*	prints for each the SPI selects, the bytes on the bus, the bus		*/
+/*	time at 6.25 MHz SCK and the time the driver asked uwait() for.		*/
+/*	The panel of the last frame must be the same both ways.				*/
+/*																		*/
+/*	The updates are the ones a status screen makes:						*/
+/*																		*/
+/*	- dashboard: four lines of a label and a number, all redrawn		*/
+/*	  every frame, where one number counts up and the others change		*/
+/*	  now and then														*/
+/*	- static: a full screen of text redrawn with no change				*/
+/*	- new text: a full screen of text that changes completely every		*/
+/*	  frame, the worst case for the framebuffer							*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -I. -Ibsp -I../../src -o fbbench fbbench.c			*/
+/*		OLEDrgb_emu.c ../../src/PmodOLEDrgb.c							*/
+/*		../../src/PmodOLEDrgb_fb.c ../../src/PmodOLEDrgb_async.c		*/
+/*		../../src/xspi.c ../../src/xspi_options.c						*/
+/*	./fbbench															*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "PmodOLEDrgb.h"
+#include "PmodOLEDrgb_fb.h"
+#include "OLEDrgb_emu.h"
+#include <stdio.h>
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+#define BENCH_COLS		12			// 8x8 characters on the 96x64 panel
+#define BENCH_ROWS		8
+
+/************************** Type Definitions *******************************/
+
+// draws frame iframe, with PutString() directly or through the framebuffer
+typedef void (*Frame)(int iframe, void (*pfnPut)(int xch, int ych, char *sz));
+
+typedef struct {
+	const char	*szName;
+	Frame		pfnFrame;
+	int			cframe;
+} Workload;
+
+/************************** Variable Definitions ***************************/
+static PmodOLEDrgb oledrgb;
+static OLEDrgb_FB fb;
+static uint16_t rgwPanel[OLEDRGB_HEIGHT][OLEDRGB_WIDTH];
+
+/************************** Function Definitions ***************************/
+
+static void PutDirect(int xch, int ych, char *sz)
+{
+	OLEDrgb_SetCursor(&oledrgb, xch, ych);
+	OLEDrgb_PutString(&oledrgb, sz);
+}
+
+static void PutFB(int xch, int ych, char *sz)
+{
+	OLEDrgb_SetCursor(&oledrgb, xch, ych);
+	OLEDrgb_FB_PutString(&fb, sz);
+}
+
+static void FrameDashboard(int iframe, void (*pfnPut)(int xch, int ych, char *sz))
+{
+	char sz[32];
+
+	snprintf(sz, sizeof(sz), "Yaw  %6d", 1000 + iframe);
+	pfnPut(0, 0, sz);
+	snprintf(sz, sizeof(sz), "Freq %6d", 40 + iframe / 10);
+	pfnPut(0, 2, sz);
+	snprintf(sz, sizeof(sz), "Duty %6d", 128 + iframe / 25);
+	pfnPut(0, 4, sz);
+	snprintf(sz, sizeof(sz), "Kp   %6d", 3);
+	pfnPut(0, 6, sz);
+}
+
+static void FrameStatic(int iframe, void (*pfnPut)(int xch, int ych, char *sz))
+{
+	char sz[32];
+	int ych;
+
+	(void) iframe;
+	for (ych = 0; ych < BENCH_ROWS; ych++) {
+		snprintf(sz, sizeof(sz), "Line %d text", ych);
+		pfnPut(0, ych, sz);
+	}
+}
+
+static void FrameNewText(int iframe, void (*pfnPut)(int xch, int ych, char *sz))
+{
+	char sz[32];
+	int ych, ich;
+
+	for (ych = 0; ych < BENCH_ROWS; ych++) {
+		for (ich = 0; ich < BENCH_COLS; ich++) {
+			sz[ich] = (char) ('!' + (iframe * 7 + ych * BENCH_COLS + ich) % 94);
+		}
+		sz[BENCH_COLS] = '\0';
+		pfnPut(0, ych, sz);
+	}
+}
+
+static const Workload rgwork[] = {
+	{ "dashboard",	FrameDashboard,	100 },
+	{ "static",		FrameStatic,	10 },
+	{ "new text",	FrameNewText,	10 },
+};
+
+/*
+** Runs the frames of a workload from a black panel, with or without the
+** framebuffer, and returns the statistics of the frames.
+*/
+static void Run(const Workload *pwork, int fFB, OLEDrgbEmu_Stats *pst)
+{
+	int iframe;
+
+	OLEDrgb_Clear(&oledrgb);
+	OLEDrgb_FB_Init(&fb, &oledrgb);
+	OLEDrgbEmu_ResetStats();
+	for (iframe = 0; iframe < pwork->cframe; iframe++) {
+		pwork->pfnFrame(iframe, fFB ? PutFB : PutDirect);
+		if (fFB) {
+			OLEDrgb_FB_Flush(&fb);
+		}
+	}
+	OLEDrgbEmu_GetStats(pst);
+}
+
+static void SavePanel(void)
+{
+	int c, r;
+
+	for (r = 0; r < OLEDRGB_HEIGHT; r++) {
+		for (c = 0; c < OLEDRGB_WIDTH; c++) {
+			rgwPanel[r][c] = OLEDrgbEmu_GetPixel(c, r);
+		}
+	}
+}
+
+// pixels where the panel differs from the saved one
+static int ComparePanel(void)
+{
+	int c, r, cDiff = 0;
+
+	for (r = 0; r < OLEDRGB_HEIGHT; r++) {
+		for (c = 0; c < OLEDRGB_WIDTH; c++) {
+			if (OLEDrgbEmu_GetPixel(c, r) != rgwPanel[r][c]) {
+				cDiff++;
+			}
+		}
+	}
+	return cDiff;
+}
+
+static void PrintStats(const char *szName, const char *szPath, int cframe, const OLEDrgbEmu_Stats *pst)
+{
+	printf("%-10s %-6s %8.1f %10.1f %9.1f %9.1f %9.1f\n", szName, szPath,
+		(double) pst->cTransfers / cframe, (double) (pst->cbCmd + pst->cbData) / cframe,
+		(double) OLEDrgbEmu_BusTimeUs(pst) / cframe, (double) pst->usWait / cframe,
+		(double) (OLEDrgbEmu_BusTimeUs(pst) + pst->usWait) / cframe);
+}
+
+int main(void)
+{
+	OLEDrgbEmu_Stats stDirect, stFB;
+	u32 cbDirect, cbFB, usDirect, usFB;
+	int iwork, cDiff, cerr = 0;
+
+	OLEDrgbEmu_Init(0);
+	OLEDrgb_SetDelay(OLEDrgbEmu_Delay);
+	OLEDrgb_begin(&oledrgb, XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR, XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_BASEADDR);
+
+	printf("per frame                selects      bytes    bus_us   wait_us  total_us\n");
+	for (iwork = 0; iwork < (int) (sizeof(rgwork) / sizeof(rgwork[0])); iwork++) {
+		Run(&rgwork[iwork], 0, &stDirect);
+		SavePanel();
+		Run(&rgwork[iwork], 1, &stFB);
+		cDiff = ComparePanel();
+
+		PrintStats(rgwork[iwork].szName, "direct", rgwork[iwork].cframe, &stDirect);
+		PrintStats("", "fb", rgwork[iwork].cframe, &stFB);
+
+		cbDirect = stDirect.cbCmd + stDirect.cbData;
+		cbFB = stFB.cbCmd + stFB.cbData;
+		usDirect = OLEDrgbEmu_BusTimeUs(&stDirect) + stDirect.usWait;
+		usFB = OLEDrgbEmu_BusTimeUs(&stFB) + stFB.usWait;
+		printf("%-17s %.1fx fewer bytes, %.1fx less time, %d pixels differ\n\n", "",
+			(double) cbDirect / (cbFB ? cbFB : 1), (double) usDirect / (usFB ? usFB : 1), cDiff);
+		if (cDiff != 0) {
+			cerr++;
+		}
+	}
+	return (cerr == 0) ? 0 : 1;
+}
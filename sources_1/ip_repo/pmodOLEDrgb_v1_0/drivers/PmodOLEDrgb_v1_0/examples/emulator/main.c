@@ -0,0 +1,147 @@
+/************************************************************************/
+/*																		*/
+/*	main.c	--	PmodOLEDrgb driver on the host display emulator			*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	Runs a few frames of the driver on the emulator.  For each frame	*/
+/*	it prints the SPI selects, command and data bytes, windows,			*/
+/*	drawing commands, bus time and the time spent in uwait(), and		*/
+/*	writes the panel to frame<n>.ppm.  The framebuffer frames are also	*/
+/*	compared with the panel pixel by pixel.								*/
+/*																		*/
+/*	Build and run on the host, from this directory:						*/
+/*																		*/
+/*	gcc -std=gnu99 -I. -Ibsp -I../../src -o oled_emu main.c				*/
+/*		OLEDrgb_emu.c ../../src/PmodOLEDrgb.c							*/
+/*		../../src/PmodOLEDrgb_fb.c ../../src/PmodOLEDrgb_async.c		*/
+/*		../../src/xspi.c ../../src/xspi_options.c						*/
+/*	./oled_emu															*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/18/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "PmodOLEDrgb.h"
+#include "PmodOLEDrgb_fb.h"
+#include "OLEDrgb_emu.h"
+#include <stdio.h>
+
+/************************** Variable Definitions ***************************/
+static PmodOLEDrgb oledrgb;
+static OLEDrgb_FB fb;
+static uint16_t rgwBitmap[OLEDRGB_HEIGHT * OLEDRGB_WIDTH];
+static int iFrame;
+
+/************************** Function Definitions ***************************/
+
+static void FrameBegin(void)
+{
+	OLEDrgbEmu_ResetStats();
+}
+
+static void FrameEnd(const char *szName)
+{
+	OLEDrgbEmu_Stats st;
+	char szPath[32];
+
+	OLEDrgbEmu_GetStats(&st);
+	printf("%-10s %6u %8u %8u %7u %6u %8u %8u\n", szName, st.cTransfers, st.cbCmd,
+		st.cbData, st.cWindows, st.cAccel, OLEDrgbEmu_BusTimeUs(&st), st.usWait);
+
+	sprintf(szPath, "frame%d.ppm", iFrame++);
+	if (OLEDrgbEmu_SavePPM(szPath, 4) != 0) {
+		printf("can not write %s\n", szPath);
+	}
+}
+
+// pixels where the panel differs from the framebuffer
+static int CompareFB(void)
+{
+	int c, r, cDiff = 0;
+
+	for (r = 0; r < OLEDRGB_HEIGHT; r++) {
+		for (c = 0; c < OLEDRGB_WIDTH; c++) {
+			if (OLEDrgbEmu_GetPixel(c, r) != OLEDrgb_FB_GetPixel(&fb, c, r)) {
+				cDiff++;
+			}
+		}
+	}
+	return cDiff;
+}
+
+int main(void)
+{
+	int c, r, cDiff;
+
+	OLEDrgbEmu_Init(0);
+	OLEDrgb_SetDelay(OLEDrgbEmu_Delay);
+
+	printf("frame      selects cmd_bytes data_bytes windows accel   bus_us  wait_us\n");
+
+	FrameBegin();
+	OLEDrgb_begin(&oledrgb, XPAR_PMODOLEDRGB_0_AXI_LITE_GPIO_BASEADDR, XPAR_PMODOLEDRGB_0_AXI_LITE_SPI_BASEADDR);
+	FrameEnd("begin");
+
+	// text straight to the display
+	FrameBegin();
+	OLEDrgb_SetCursor(&oledrgb, 2, 1);
+	OLEDrgb_PutString(&oledrgb, "Digilent");
+	OLEDrgb_SetFontColor(&oledrgb, OLEDrgb_BuildRGB(0, 0, 255));
+	OLEDrgb_SetCursor(&oledrgb, 4, 4);
+	OLEDrgb_PutString(&oledrgb, "OledRGB");
+	FrameEnd("text");
+
+	// the display's own drawing commands
+	FrameBegin();
+	OLEDrgb_Clear(&oledrgb);
+	OLEDrgb_DrawRectangle(&oledrgb, 4, 4, 44, 28, OLEDrgb_BuildRGB(255, 255, 255), true, OLEDrgb_BuildRGB(255, 0, 0));
+	OLEDrgb_DrawLine(&oledrgb, 0, 63, 95, 32, OLEDrgb_BuildRGB(0, 255, 0));
+	OLEDrgb_Copy(&oledrgb, 4, 4, 44, 28, 50, 4);
+	OLEDrgb_Dim(&oledrgb, 50, 4, 90, 28);
+	FrameEnd("accel");
+
+	// a full screen bitmap
+	for (r = 0; r < OLEDRGB_HEIGHT; r++) {
+		for (c = 0; c < OLEDRGB_WIDTH; c++) {
+			rgwBitmap[r * OLEDRGB_WIDTH + c] = OLEDrgb_BuildRGB(c * 255 / 95, r * 255 / 63, 128);
+		}
+	}
+	FrameBegin();
+	OLEDrgb_DrawBitmap(&oledrgb, 0, 0, OLEDRGB_WIDTH - 1, OLEDRGB_HEIGHT - 1, (uint8_t *) rgwBitmap);
+	FrameEnd("bitmap");
+
+	// the same drawing through the framebuffer
+	FrameBegin();
+	OLEDrgb_Clear(&oledrgb);
+	OLEDrgb_FB_Init(&fb, &oledrgb);
+	OLEDrgb_SetFontColor(&oledrgb, OLEDrgb_BuildRGB(0, 255, 0));
+	OLEDrgb_SetCursor(&oledrgb, 2, 1);
+	OLEDrgb_FB_PutString(&fb, "Digilent");
+	OLEDrgb_FB_FillRect(&fb, 4, 24, 44, 40, OLEDrgb_BuildRGB(255, 0, 0));
+	OLEDrgb_FB_DrawLine(&fb, 0, 63, 95, 32, OLEDrgb_BuildRGB(0, 255, 0));
+	OLEDrgb_FB_Flush(&fb);
+	cDiff = CompareFB();
+	FrameEnd("fb");
+	printf("fb: %d pixels differ\n", cDiff);
+
+	// a small change, queued and sent by polling
+	OLEDrgb_AsyncInit(&oledrgb);
+	FrameBegin();
+	OLEDrgb_SetCursor(&oledrgb, 2, 1);
+	OLEDrgb_FB_PutString(&fb, "Digital ");
+	OLEDrgb_FB_FlushAsync(&fb, NULL, NULL);
+	while (OLEDrgb_AsyncBusy(&oledrgb)) {
+		OLEDrgb_AsyncPoll(&oledrgb);
+	}
+	cDiff = CompareFB();
+	FrameEnd("fb-async");
+	printf("fb-async: %d pixels differ\n", cDiff);
+
+	return 0;
+}
@@ -35,6 +35,12 @@
 /*  04/19/2015(TommyK): Adapted for use with Microblaze/Zynq .c designs */
 /*  06/15/2016(AndrewH): fixed uwait delays							*/
 /* 	06/16/2016(AndrewH): fixed OLEDrgb_DrawRectangle()					*/
+/*	06/10/2017: uwait can use a delay function set by the application	*/
+/*	06/12/2017: added OLEDrgb_beginAsync() and OLEDrgb_DevInitStep()	*/
+/*	06/14/2017: OLEDrgb_PutString() draws a line at a time with		*/
+/*				OLEDrgb_DrawGlyphRun(), no wait per character			*/
+/*	06/15/2017: expanded glyph cache, glyphs are sent high byte first	*/
+/*	06/16/2017: synchronous transfers wait for the asynchronous queue	*/
 /*																		*/
 /************************************************************************/
 
@@ -47,6 +53,25 @@
 /************************** Function Definitions ***************************/
 
 u8 num_devices=0;
+static OLEDrgb_DelayFunc uwait_delay = NULL;	// precise delay set by OLEDrgb_SetDelay()
+
+/* Expanded glyph cache, shared by all of the displays.  An entry is
+** keyed by the address of the glyph in its font table and the two
+** colors, so changing fonts needs no invalidation.
+*/
+typedef struct{
+	const uint8_t *	pbFont;			// glyph in the font table, NULL if the entry is free
+	uint16_t	fontColor;
+	uint16_t	bkColor;
+	u32			lastUse;			// cache clock at the last hit, for LRU replacement
+	uint8_t		rgbBmp[OLEDRGB_GLYPHBYTES];
+}OLEDrgb_GlyphEntry;
+
+static OLEDrgb_GlyphEntry rgGlyphCache[OLEDRGB_GLYPH_CACHE_SIZE];
+static u32 glyphCacheClock = 0;
+static u32 glyphCacheHits = 0;
+static u32 glyphCacheMisses = 0;
+static const uint8_t rgbBlankGlyph[OLEDRGB_CHARBYTES] = {0};
 XSpi_Config XSpi_OLEDrgb =
 {
 	0,
@@ -80,6 +105,31 @@ XSpi_Config XSpi_OLEDrgb =
 **		Initialize the OLED display controller and turn the display on.
 */
 void OLEDrgb_begin(PmodOLEDrgb* InstancePtr, u32 GPIO_Address, u32 SPI_Address)
+{
+	OLEDrgb_beginAsync(InstancePtr, GPIO_Address, SPI_Address);
+	OLEDrgb_DevInit(InstancePtr);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_beginAsync
+**
+**	Parameters:
+**		InstancePtr		- PmodOLEDrgb object to start
+**		GPIO_Address	- XPAR base address of OLEDrgb GPIO interface
+**		SPI_Address		- XPAR base address of OLEDrgb SPI interface
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Initialize the driver and the host interface but not the display
+**		controller.  Call OLEDrgb_DevInitStep() until it returns 0 to
+**		initialize the display controller and turn the display on.
+*/
+void OLEDrgb_beginAsync(PmodOLEDrgb* InstancePtr, u32 GPIO_Address, u32 SPI_Address)
 {
 	int	ib;
 	InstancePtr->GPIO_addr=GPIO_Address;
@@ -99,9 +149,10 @@ void OLEDrgb_begin(PmodOLEDrgb* InstancePtr, u32 GPIO_Address, u32 SPI_Address)
 
 	OLEDrgb_SetCurrentFontTable(InstancePtr, (uint8_t*)rgbOledRgbFont0);
 	OLEDrgb_SetCurrentUserFontTable(InstancePtr, InstancePtr->rgbOledrgbFontUser);
+	InstancePtr->fAsync = false;
 	OLEDrgb_SPIInit(&InstancePtr->OLEDSpi);
 	OLEDrgb_HostInit(InstancePtr);
-	OLEDrgb_DevInit(InstancePtr);
+	InstancePtr->initStep = 0;
 }
 /* ------------------------------------------------------------ */
 /***	OLEDrgb_end(void)
@@ -290,6 +341,35 @@ void OLEDrgb_Clear(PmodOLEDrgb* InstancePtr)
 **		The number of pixels in the array should match the surrounding rectangle.
 */
 void OLEDrgb_DrawBitmap(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t *pBmp)
+{
+	OLEDrgb_DrawBitmapRun(InstancePtr, c1, r1, c2, r2, pBmp);
+	uwait(5000);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_DrawBitmapRun
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object to draw to
+**		c1		- the horizontal coordinate of the upper left corner
+**		r1		- the vertical coordinate of the upper left corner
+**		c2		- the horizontal coordinate of the lower right corner
+**		r2		- the vertical coordinate of the lower right corner
+**		pBmp	- pixels, two bytes each, high byte first
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Same as OLEDrgb_DrawBitmap() without the wait at the end.
+**		The SPI transfer is polled, so the bitmap has reached the
+**		display when this returns and the next drawing call can
+**		follow right away.
+*/
+void OLEDrgb_DrawBitmapRun(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t *pBmp)
 {
 	uint8_t cmds[6];
 	//set column start and end
@@ -303,7 +383,6 @@ void OLEDrgb_DrawBitmap(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_
 	cmds[5] = r2;					// Set the finishing row coordinates
 
 	OLEDrgb_WriteSPI(InstancePtr, cmds, 6, pBmp, (((c2 - c1 + 1)  * (r2 - r1 + 1)) << 1));
-	uwait(5000);
 }
 
 /****************************************************************************/
@@ -318,13 +397,21 @@ void OLEDrgb_DrawBitmap(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_
 * @return	*NONE*
 *
 * @note
-* This emulation assumes that the microblaze is running @ 100MHz and takes 15 clocks
-* per iteration - this is probably totally bogus but it's a start.
+* If the application has set a delay function with OLEDrgb_SetDelay() the delay is
+* handed to it.  Otherwise this emulation assumes that the microblaze is running @ 100MHz
+* and takes 15 clocks per iteration - this is probably totally bogus but it's a start.
 *
 *****************************************************************************/
 void uwait(u32 ms)
 {
 	volatile u32 i, j;
+
+	if (uwait_delay != NULL)
+	{
+		uwait_delay(ms);
+		return;
+	}
+
 	u32 us =ms*1000;
 	for (i = 0; i < us; i++)
 	{
@@ -333,6 +420,24 @@ void uwait(u32 ms)
 	return;
 }
 
+/****************************************************************************/
+/**
+* set the delay function used by uwait()
+*
+* Lets the application replace the calibrated delay loop with a timer based delay
+* (ex: TB_delay_us()) so the display delays do not depend on the CPU speed.
+*
+* @param	delay_us is the delay function, called with the delay in microseconds.
+*			NULL restores the delay loop
+*
+* @return	*NONE*
+*
+*****************************************************************************/
+void OLEDrgb_SetDelay(OLEDrgb_DelayFunc delay_us)
+{
+	uwait_delay = delay_us;
+}
+
 /* ------------------------------------------------------------ */
 /***	OLEDrgb_SetCursor
 **
@@ -426,6 +531,7 @@ int OLEDrgb_DefUserChar(PmodOLEDrgb* InstancePtr, char ch, uint8_t * pbDef)
 		{
 			*pb++ = *pbDef++;
 		}
+		OLEDrgb_InvalidateGlyphCache();
 		return 1;
 	}
 	else
@@ -456,42 +562,243 @@ int OLEDrgb_DefUserChar(PmodOLEDrgb* InstancePtr, char ch, uint8_t * pbDef)
 */
 void OLEDrgb_DrawGlyph(PmodOLEDrgb* InstancePtr, char ch)
 {
-	uint8_t *	pbFont;
-	int	ibx, iby, iw, x, y;
-	uint16_t rgwCharBmp[OLEDRGB_CHARBYTES << 4];
+	uint8_t *	pbBmp;
+	int	x, y;
 
-	if ((ch & 0x80) != 0) {
+	pbBmp = OLEDrgb_GetGlyphBmp(InstancePtr, ch);
+	if (pbBmp == NULL) {
+		return;
+	}
+
+	x = InstancePtr->xchOledCur*InstancePtr->dxcoOledrgbFontCur;
+	y = InstancePtr->ychOledCur*InstancePtr->dycoOledrgbFontCur;
+
+	OLEDrgb_DrawBitmap(InstancePtr, x, y, x + OLEDRGB_CHARBYTES - 1, y  + 7, pbBmp);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_DrawGlyphRun
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object to draw to
+**		pch		- characters to draw
+**		cch		- number of characters
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Renders a run of characters from the current character
+**		cursor location towards the end of the line.  The glyphs
+**		are expanded side by side into one bitmap that is sent
+**		with a single address window and no delay, instead of one
+**		window, one transfer and one 5 ms wait per character.
+**		The run is clipped at the end of the line and the cursor
+**		is not moved.  Characters with the high bit set are drawn
+**		as background.
+*/
+void OLEDrgb_DrawGlyphRun(PmodOLEDrgb* InstancePtr, char * pch, int cch)
+{
+	static uint8_t	rgbRunBmp[OLEDRGB_WIDTH * OLEDRGB_CHARBYTES * 2];	// one text line
+	uint8_t *	pbBmp;
+	int	ich, iby, dx, dy, x, y;
+
+	dx = InstancePtr->dxcoOledrgbFontCur;
+	dy = InstancePtr->dycoOledrgbFontCur;
+	if (cch > InstancePtr->xchOledrgbMax - InstancePtr->xchOledCur) {
+		cch = InstancePtr->xchOledrgbMax - InstancePtr->xchOledCur;
+	}
+	if (cch <= 0) {
 		return;
 	}
 
+	for (ich = 0; ich < cch; ich++) {
+		pbBmp = OLEDrgb_GetGlyphBmp(InstancePtr, pch[ich]);
+		if (pbBmp == NULL) {
+			pbBmp = OLEDrgb_LookupGlyph(rgbBlankGlyph, InstancePtr->m_FontColor, InstancePtr->m_FontBkColor);
+		}
+
+		// bitmap rows span the whole run
+		for (iby = 0; iby < dy; iby++) {
+			memcpy(rgbRunBmp + ((iby * cch * dx) + (ich * dx)) * 2, pbBmp + iby * dx * 2, dx * 2);
+		}
+	}
+
+	x = InstancePtr->xchOledCur*dx;
+	y = InstancePtr->ychOledCur*dy;
+	OLEDrgb_DrawBitmapRun(InstancePtr, x, y, x + cch*dx - 1, y + dy - 1, rgbRunBmp);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_ExpandGlyph
+**
+**	Parameters:
+**		pbFont		- glyph in a font table, one byte per column
+**		fontColor	- color of the glyph pixels
+**		bkColor		- color of the background pixels
+**		pbBmp		- OLEDRGB_GLYPHBYTES bytes of bitmap to fill
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Expands a glyph into an 8x8 bitmap, row by row, two bytes
+**		per pixel with the high byte first.  The pixel color is
+**		selected with a mask made from the font bit instead of a
+**		branch.
+*/
+static void OLEDrgb_ExpandGlyph(const uint8_t *pbFont, uint16_t fontColor, uint16_t bkColor, uint8_t *pbBmp)
+{
+	uint16_t	diff = fontColor ^ bkColor;
+	uint16_t	w;
+	int	ibx, iby;
+
+	for (iby = 0; iby < 8; iby++) {
+		for (ibx = 0; ibx < OLEDRGB_CHARBYTES; ibx++) {
+			w = bkColor ^ (diff & -((pbFont[ibx] >> iby) & 1));
+			*pbBmp++ = w >> 8;
+			*pbBmp++ = w;
+		}
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_LookupGlyph
+**
+**	Parameters:
+**		pbFont		- glyph in a font table
+**		fontColor	- color of the glyph pixels
+**		bkColor		- color of the background pixels
+**
+**	Return Value:
+**		the expanded glyph, OLEDRGB_GLYPHBYTES bytes
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the glyph from the cache, or expands it into the
+**		least recently used entry.  The bitmap stays valid until
+**		OLEDRGB_GLYPH_CACHE_SIZE other glyphs have been looked up.
+*/
+uint8_t * OLEDrgb_LookupGlyph(const uint8_t *pbFont, uint16_t fontColor, uint16_t bkColor)
+{
+	OLEDrgb_GlyphEntry *	pEntry;
+	OLEDrgb_GlyphEntry *	pVictim;
+	int	ie;
+
+	glyphCacheClock++;
+	pVictim = &rgGlyphCache[0];
+	for (ie = 0; ie < OLEDRGB_GLYPH_CACHE_SIZE; ie++) {
+		pEntry = &rgGlyphCache[ie];
+		if ((pEntry->pbFont == pbFont) && (pEntry->fontColor == fontColor) && (pEntry->bkColor == bkColor)) {
+			pEntry->lastUse = glyphCacheClock;
+			glyphCacheHits++;
+			return pEntry->rgbBmp;
+		}
+		if ((pVictim->pbFont != NULL) &&
+			((pEntry->pbFont == NULL) || (pEntry->lastUse < pVictim->lastUse))) {
+			pVictim = pEntry;
+		}
+	}
+
+	glyphCacheMisses++;
+	OLEDrgb_ExpandGlyph(pbFont, fontColor, bkColor, pVictim->rgbBmp);
+	pVictim->pbFont = pbFont;
+	pVictim->fontColor = fontColor;
+	pVictim->bkColor = bkColor;
+	pVictim->lastUse = glyphCacheClock;
+	return pVictim->rgbBmp;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_GetGlyphBmp
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**		ch			- character code
+**
+**	Return Value:
+**		the expanded glyph in the current font and font colors,
+**		NULL if the character has the high bit set
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Looks the character up in the user or the current font
+**		table and returns it from the glyph cache.
+*/
+uint8_t * OLEDrgb_GetGlyphBmp(PmodOLEDrgb* InstancePtr, char ch)
+{
+	const uint8_t *	pbFont;
+
+	if ((ch & 0x80) != 0) {
+		return NULL;
+	}
+
 	if (ch < OLEDRGB_USERCHAR_MAX) {
 		pbFont = InstancePtr->pbOledrgbFontUser + ch*OLEDRGB_CHARBYTES;
 	}
-	else if ((ch & 0x80) == 0) {
+	else {
 		pbFont = InstancePtr->pbOledrgbFontCur + (ch - OLEDRGB_USERCHAR_MAX) * OLEDRGB_CHARBYTES;
 	}
+	return OLEDrgb_LookupGlyph(pbFont, InstancePtr->m_FontColor, InstancePtr->m_FontBkColor);
+}
 
-	iw = 0;
-	for(iby = 0; iby < InstancePtr->dycoOledrgbFontCur; iby++)
-	{
-		for (ibx = 0; ibx < InstancePtr->dxcoOledrgbFontCur; ibx++) {
-			if(pbFont[ibx] & (1 << iby))
-			{
-				// point in glyph
-				rgwCharBmp[iw] = InstancePtr->m_FontColor;
-			}
-			else
-			{
-				// background
-				rgwCharBmp[iw] = InstancePtr->m_FontBkColor;
-			}
-			iw++;
-		}
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_InvalidateGlyphCache
+**
+**	Parameters:
+**		none
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Empties the glyph cache.  Needed when a font table is
+**		changed in place; OLEDrgb_DefUserChar() calls it.
+*/
+void OLEDrgb_InvalidateGlyphCache(void)
+{
+	int	ie;
+
+	for (ie = 0; ie < OLEDRGB_GLYPH_CACHE_SIZE; ie++) {
+		rgGlyphCache[ie].pbFont = NULL;
 	}
-	x = InstancePtr->xchOledCur*InstancePtr->dxcoOledrgbFontCur;
-	y = InstancePtr->ychOledCur*InstancePtr->dycoOledrgbFontCur;
+}
 
-	OLEDrgb_DrawBitmap(InstancePtr, x, y, x + OLEDRGB_CHARBYTES - 1, y  + 7, (u8*)rgwCharBmp);
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_GetGlyphCacheStats
+**
+**	Parameters:
+**		pcHit		- receives the number of cache hits
+**		pcMiss		- receives the number of glyphs expanded
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Returns the glyph cache counters and clears them.
+*/
+void OLEDrgb_GetGlyphCacheStats(u32 *pcHit, u32 *pcMiss)
+{
+	*pcHit = glyphCacheHits;
+	*pcMiss = glyphCacheMisses;
+	glyphCacheHits = 0;
+	glyphCacheMisses = 0;
 }
 
 /* ------------------------------------------------------------ */
@@ -536,10 +843,21 @@ void OLEDrgb_PutChar(PmodOLEDrgb* InstancePtr, char ch)
 */
 void OLEDrgb_PutString(PmodOLEDrgb* InstancePtr, char * sz)
 {
+	int cch;
+
 	while (*sz != '\0') {
-		OLEDrgb_DrawGlyph(InstancePtr, *sz);
-		OLEDrgb_AdvanceCursor(InstancePtr);
-		sz += 1;
+		/* Draw the part of the string that fits on the current line
+		** as one run, then continue on the next line.
+		*/
+		cch = 0;
+		while ((sz[cch] != '\0') && (cch < InstancePtr->xchOledrgbMax - InstancePtr->xchOledCur)) {
+			cch++;
+		}
+		OLEDrgb_DrawGlyphRun(InstancePtr, sz, cch);
+		sz += cch;
+		while (cch-- > 0) {
+			OLEDrgb_AdvanceCursor(InstancePtr);
+		}
 	}
 }
 
@@ -943,100 +1261,141 @@ void OLEDrgb_HostTerm(PmodOLEDrgb* InstancePtr)
 **
 **	Description:
 **		Initializes the OLEDrgb display controller and turn the display on.
-**
+**		Waits with uwait() between the steps of OLEDrgb_DevInitStep().
 **
 */
 void OLEDrgb_DevInit(PmodOLEDrgb* InstancePtr)
+{
+	u32 delay;
+
+	InstancePtr->initStep = 0;
+	while ((delay = OLEDrgb_DevInitStep(InstancePtr)) != 0)
 	{
+		uwait(delay);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_DevInitStep
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object to initialize
+**
+**	Return Value:
+**		microseconds to wait before the next call, 0 when the
+**		display is on
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Runs the next step of the display controller initialization.
+**		The steps are separated by the power up and reset delays of
+**		the display, so the caller can do other work during the delays
+**		instead of waiting in uwait().  OLEDrgb_beginAsync() starts the
+**		sequence from the first step.
+*/
+u32 OLEDrgb_DevInitStep(PmodOLEDrgb* InstancePtr)
+{
 	u8 cmds[39];
 
+	switch (InstancePtr->initStep++)
+	{
+	case 0:
+		/*Bring PmodEn HIGH*/
+		Xil_Out32(InstancePtr->GPIO_addr,0b1010);
+		return 20000;//Delay for 20ms
+
+	case 1:
+		/*Assert Reset*/
+		Xil_Out32(InstancePtr->GPIO_addr,0b1000);
+		return 1000;
+
+	case 2:
+		Xil_Out32(InstancePtr->GPIO_addr,0b1010);
+		return 2000;
+
+	case 3:
+		/* command un-lock*/
+		cmds[0]=0xFD;
+		cmds[1]=0x12;
+		/* 5. Univision Initialization Steps*/
+		// 5a) Set Display Off
+		cmds[2]=CMD_DISPLAYOFF;
+		// 5b) Set Remap and Data Format
+		cmds[3]=CMD_SETREMAP;
+		cmds[4]=0x72;
+		// 5c) Set Display Start Line
+		cmds[5]=CMD_SETDISPLAYSTARTLINE;
+		cmds[6]=0x00;//start line is set at upper left corner
+		// 5d) Set Display Offset
+		cmds[7]=CMD_SETDISPLAYOFFSET;
+		cmds[8]=0x00;//no offset
+		// 5e)
+		cmds[9]=CMD_NORMALDISPLAY;
+		// 5f) Set Multiplex Ratio
+		cmds[10]=CMD_SETMULTIPLEXRATIO;
+		cmds[11]=0x3F;//64MUX
+		// 5g)Set Master Configuration
+		cmds[12]=CMD_SETMASTERCONFIGURE;
+		cmds[13]=0x8E;
+		// 5h)Set Power Saving Mode
+		cmds[14]=CMD_POWERSAVEMODE;
+		cmds[15]=0x0B;
+		// 5i) Set Phase Length
+		cmds[16]=CMD_PHASEPERIODADJUSTMENT;
+		cmds[17]=0x31;//phase 2 = 14 DCLKs, phase 1 = 15 DCLKS
+		// 5j) Send Clock Divide Ratio and Oscillator Frequency
+		cmds[18]=CMD_DISPLAYCLOCKDIV;
+		cmds[19]=0xF0;//mid high oscillator frequency, DCLK = FpbCllk/2
+		// 5k) Set Second Pre-charge Speed of Color A
+		cmds[20]=CMD_SETPRECHARGESPEEDA;
+		cmds[21]=0x64;
+		// 5l) Set Set Second Pre-charge Speed of Color B
+		cmds[22]=CMD_SETPRECHARGESPEEDB;
+		cmds[23]=0x78;
+		// 5m) Set Second Pre-charge Speed of Color C
+		cmds[24]=CMD_SETPRECHARGESPEEDC;
+		cmds[25]=0x64;
+		// 5n) Set Pre-Charge Voltage
+		cmds[26]=CMD_SETPRECHARGEVOLTAGE;
+		cmds[27]=0x3A;// Pre-charge voltage =...Vcc
+		// 50) Set VCOMH Deselect Level
+		cmds[28]=CMD_SETVVOLTAGE;
+		cmds[29]=0x3E;// Vcomh = ...*Vcc
+		// 5p) Set Master Current
+		cmds[30]=CMD_MASTERCURRENTCONTROL;
+		cmds[31]=0x06;
+		// 5q) Set Contrast for Color A
+		cmds[32]=CMD_SETCONTRASTA;
+		cmds[33]=0x91;
+		// 5r) Set Contrast for Color B
+		cmds[34]=CMD_SETCONTRASTB;
+		cmds[35]=0x50;
+		// 5s) Set Contrast for Color C
+		cmds[36]=CMD_SETCONTRASTC;
+		cmds[37]=0x7D;
+		//disable scrolling
+		cmds[38]=CMD_DEACTIVESCROLLING;
+
+		OLEDrgb_WriteSPI(InstancePtr, cmds, 39, NULL, 0);
+
+		// 5u) Clear Screen
+		OLEDrgb_Clear(InstancePtr);
+		/* Turn on VCC and wait for it to become stable*/
+		Xil_Out32(InstancePtr->GPIO_addr,0b1110);
+		return 25000;
 
-	/*Bring PmodEn HIGH*/
-	Xil_Out32(InstancePtr->GPIO_addr,0b1010);
-	uwait(20000);//Delay for 20us
-
-	/*Assert Reset*/
-	Xil_Out32(InstancePtr->GPIO_addr,0b1000);
-	uwait(1000);
-	Xil_Out32(InstancePtr->GPIO_addr,0b1010);
-	uwait(2000);
-
-	/* command un-lock*/
-	cmds[0]=0xFD;
-	cmds[1]=0x12;
-	/* 5. Univision Initialization Steps*/
-	// 5a) Set Display Off
-	cmds[2]=CMD_DISPLAYOFF;
-	// 5b) Set Remap and Data Format
-	cmds[3]=CMD_SETREMAP;
-	cmds[4]=0x72;
-	// 5c) Set Display Start Line
-	cmds[5]=CMD_SETDISPLAYSTARTLINE;
-	cmds[6]=0x00;//start line is set at upper left corner
-	// 5d) Set Display Offset
-	cmds[7]=CMD_SETDISPLAYOFFSET;
-	cmds[8]=0x00;//no offset
-	// 5e)
-	cmds[9]=CMD_NORMALDISPLAY;
-	// 5f) Set Multiplex Ratio
-	cmds[10]=CMD_SETMULTIPLEXRATIO;
-	cmds[11]=0x3F;//64MUX
-	// 5g)Set Master Configuration
-	cmds[12]=CMD_SETMASTERCONFIGURE;
-	cmds[13]=0x8E;
-	// 5h)Set Power Saving Mode
-	cmds[14]=CMD_POWERSAVEMODE;
-	cmds[15]=0x0B;
-	// 5i) Set Phase Length
-	cmds[16]=CMD_PHASEPERIODADJUSTMENT;
-	cmds[17]=0x31;//phase 2 = 14 DCLKs, phase 1 = 15 DCLKS
-	// 5j) Send Clock Divide Ratio and Oscillator Frequency
-	cmds[18]=CMD_DISPLAYCLOCKDIV;
-	cmds[19]=0xF0;//mid high oscillator frequency, DCLK = FpbCllk/2
-	// 5k) Set Second Pre-charge Speed of Color A
-	cmds[20]=CMD_SETPRECHARGESPEEDA;
-	cmds[21]=0x64;
-	// 5l) Set Set Second Pre-charge Speed of Color B
-	cmds[22]=CMD_SETPRECHARGESPEEDB;
-	cmds[23]=0x78;
-	// 5m) Set Second Pre-charge Speed of Color C
-	cmds[24]=CMD_SETPRECHARGESPEEDC;
-	cmds[25]=0x64;
-	// 5n) Set Pre-Charge Voltage
-	cmds[26]=CMD_SETPRECHARGEVOLTAGE;
-	cmds[27]=0x3A;// Pre-charge voltage =...Vcc
-	// 50) Set VCOMH Deselect Level
-	cmds[28]=CMD_SETVVOLTAGE;
-	cmds[29]=0x3E;// Vcomh = ...*Vcc
-	// 5p) Set Master Current
-	cmds[30]=CMD_MASTERCURRENTCONTROL;
-	cmds[31]=0x06;
-	// 5q) Set Contrast for Color A
-	cmds[32]=CMD_SETCONTRASTA;
-	cmds[33]=0x91;
-	// 5r) Set Contrast for Color B
-	cmds[34]=CMD_SETCONTRASTB;
-	cmds[35]=0x50;
-	// 5s) Set Contrast for Color C
-	cmds[36]=CMD_SETCONTRASTC;
-	cmds[37]=0x7D;
-	//disable scrolling
-	cmds[38]=CMD_DEACTIVESCROLLING;
-
-	OLEDrgb_WriteSPI(InstancePtr, cmds, 39, NULL, 0);
-
-	// 5u) Clear Screen
-	OLEDrgb_Clear(InstancePtr);
-	/* Turn on VCC and wait for it to become stable*/
-	Xil_Out32(InstancePtr->GPIO_addr,0b1110);
-
-	uwait(25000);
-
-	/* Send Display On command*/
-	OLEDrgb_WriteSPICommand(InstancePtr, CMD_DISPLAYON);
-
-	uwait(100000);
+	case 4:
+		/* Send Display On command*/
+		OLEDrgb_WriteSPICommand(InstancePtr, CMD_DISPLAYON);
+		return 100000;
 
+	default:
+		/* The display is on */
+		InstancePtr->initStep = 5;
+		return 0;
+	}
 }
 
 /* ------------------------------------------------------------ */
@@ -1122,6 +1481,7 @@ int OLEDrgb_SPIInit(XSpi *SpiInstancePtr){
 */
 void OLEDrgb_WriteSPICommand(PmodOLEDrgb* InstancePtr, uint8_t cmd)
 {
+	OLEDrgb_AsyncWait(InstancePtr);
 	XSpi_Transfer(&InstancePtr->OLEDSpi, &cmd, NULL, 1);
 }
 
@@ -1142,12 +1502,14 @@ void OLEDrgb_WriteSPICommand(PmodOLEDrgb* InstancePtr, uint8_t cmd)
 **		none
 **
 **	Description:
-**		Writes a series of commands followed by data over SPI
+**		Writes a series of commands followed by data over SPI,
+**		after the queued asynchronous transfers
 **
 **
 */
 void OLEDrgb_WriteSPI(PmodOLEDrgb* InstancePtr, uint8_t *pCmd, int nCmd, uint8_t *pData, int nData)
 {
+	OLEDrgb_AsyncWait(InstancePtr);
 	XSpi_Transfer(&InstancePtr->OLEDSpi, pCmd, 0, nCmd);
 	if (nData!= 0){
 		Xil_Out32(InstancePtr->GPIO_addr,0b1111);
@@ -66,6 +66,10 @@
 #define OLEDRGB_CHARBYTES      				8      //number of bytes in a glyph
 #define	OLEDRGB_USERCHAR_MAX				0x20	//number of character defs in user font table
 #define OLEDRGB_CHARBYTES_USER  			(OLEDRGB_USERCHAR_MAX*OLEDRGB_CHARBYTES)  //number of bytes in user font table
+#define OLEDRGB_GLYPHBYTES					(OLEDRGB_CHARBYTES*8*2)	//number of bytes in an expanded 8x8 glyph
+#define OLEDRGB_GLYPH_CACHE_SIZE			16		//number of expanded glyphs kept
+#define OLEDRGB_ASYNC_QUEUE					8		//number of queued asynchronous transfers
+#define OLEDRGB_ASYNC_MAXCMD				16		//command bytes per asynchronous transfer, a filled rectangle takes 13
 
 #define CMD_DRAWLINE                       0x21
 #define CMD_DRAWRECTANGLE                  0x22
@@ -173,6 +177,21 @@
 XStatus PMODOLEDRGB_Reg_SelfTest(void * baseaddr_p);
 
 
+// called when an asynchronous transfer has been sent, from the SPI interrupt
+// handler or from OLEDrgb_AsyncPoll(); status is XST_SUCCESS or the XSpi error
+typedef void (*OLEDrgb_AsyncDone)(void *pRef, int status);
+
+typedef struct{
+	uint8_t		rgbCmd[OLEDRGB_ASYNC_MAXCMD];	// command phase, copied when queued
+	uint8_t		nCmd;
+	uint8_t *	pData;			// data phase, must stay valid until the transfer is done
+	u32			cbRow;			// data bytes per row, 0 for no data phase
+	u32			cRows;
+	u32			cbStride;		// bytes from one row to the next in pData
+	OLEDrgb_AsyncDone pfnDone;
+	void *		pRef;
+}OLEDrgb_AsyncReq;
+
 typedef struct{
 	u32 GPIO_addr;
 	XSpi OLEDSpi;
@@ -188,23 +207,46 @@ typedef struct{
 
 	int	xchOledrgbMax;
 	int	ychOledrgbMax;
+
+	u8	initStep;		// next step of OLEDrgb_DevInitStep()
+
+	// asynchronous transfer queue, see PmodOLEDrgb_async.c
+	OLEDrgb_AsyncReq	rgAsyncReq[OLEDRGB_ASYNC_QUEUE];
+	volatile u8	iAsyncHead;		// transfer in progress
+	volatile u8	iAsyncTail;		// next free entry
+	volatile u8	asyncPhase;
+	u32			asyncRow;		// row of the data phase in progress
+	bool		fAsync;			// OLEDrgb_AsyncInit() was called
+	u32			cAsyncDone;		// transfers completed
+	u32			cAsyncErrors;	// transfers that ended with an SPI error
 }PmodOLEDrgb;
 
+// delay function used by uwait(), called with the delay in microseconds
+typedef void (*OLEDrgb_DelayFunc)(u32 usec);
+
 
 void OLEDrgb_begin(PmodOLEDrgb* InstancePtr, u32 GPIO_Address, u32 SPI_Address);
+void OLEDrgb_beginAsync(PmodOLEDrgb* InstancePtr, u32 GPIO_Address, u32 SPI_Address);
 void OLEDrgb_end(PmodOLEDrgb* InstancePtr);
 void uwait(u32 ms);
+void OLEDrgb_SetDelay(OLEDrgb_DelayFunc delay_us);
 
 void OLEDrgb_DrawPixel(PmodOLEDrgb* InstancePtr, uint8_t c, uint8_t r, uint16_t pixelColor);
 void OLEDrgb_DrawLine(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t lineColor);
 void OLEDrgb_DrawRectangle(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t lineColor, bool bFill, uint16_t fillColor);
 void OLEDrgb_Clear(PmodOLEDrgb* InstancePtr);
 void OLEDrgb_DrawBitmap(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t *pBmp);
+void OLEDrgb_DrawBitmapRun(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t *pBmp);
 
 void OLEDrgb_SetCursor(PmodOLEDrgb* InstancePtr, int xch, int ych);
 void OLEDrgb_GetCursor(PmodOLEDrgb* InstancePtr, int *pxch, int* pych);
 int OLEDrgb_DefUserChar(PmodOLEDrgb* InstancePtr, char ch, uint8_t * pbDef);
 void OLEDrgb_DrawGlyph(PmodOLEDrgb* InstancePtr, char ch);
+void OLEDrgb_DrawGlyphRun(PmodOLEDrgb* InstancePtr, char * pch, int cch);
+uint8_t * OLEDrgb_LookupGlyph(const uint8_t *pbFont, uint16_t fontColor, uint16_t bkColor);
+uint8_t * OLEDrgb_GetGlyphBmp(PmodOLEDrgb* InstancePtr, char ch);
+void OLEDrgb_InvalidateGlyphCache(void);
+void OLEDrgb_GetGlyphCacheStats(u32 *pcHit, u32 *pcMiss);
 void OLEDrgb_PutChar(PmodOLEDrgb* InstancePtr, char ch);
 void OLEDrgb_PutString(PmodOLEDrgb* InstancePtr, char * sz);
 void OLEDrgb_SetFontColor(PmodOLEDrgb* InstancePtr, uint16_t fontColor);
@@ -221,11 +263,21 @@ void OLEDrgb_Dim(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, u
 void OLEDrgb_HostInit(PmodOLEDrgb* InstancePtr);
 void OLEDrgb_HostTerm(PmodOLEDrgb* InstancePtr);
 void OLEDrgb_DevInit(PmodOLEDrgb* InstancePtr);
+u32 OLEDrgb_DevInitStep(PmodOLEDrgb* InstancePtr);
 void OLEDrgb_DevTerm(PmodOLEDrgb* InstancePtr);
 
 int OLEDrgb_SPIInit(XSpi *SpiInstancePtr);
 void OLEDrgb_WriteSPICommand(PmodOLEDrgb* InstancePtr, uint8_t cmd);
 void OLEDrgb_WriteSPI(PmodOLEDrgb* InstancePtr, uint8_t *pCmd, int nCmd, uint8_t *pData, int nData);
+
+int OLEDrgb_AsyncInit(PmodOLEDrgb* InstancePtr);
+int OLEDrgb_AsyncWrite(PmodOLEDrgb* InstancePtr, uint8_t *pCmd, int nCmd, uint8_t *pData, u32 cbRow, u32 cRows, u32 cbStride, OLEDrgb_AsyncDone pfnDone, void *pRef);
+int OLEDrgb_AsyncDrawBitmap(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t *pBmp, OLEDrgb_AsyncDone pfnDone, void *pRef);
+bool OLEDrgb_AsyncBusy(PmodOLEDrgb* InstancePtr);
+int OLEDrgb_AsyncFree(PmodOLEDrgb* InstancePtr);
+void OLEDrgb_AsyncPoll(PmodOLEDrgb* InstancePtr);
+void OLEDrgb_AsyncWait(PmodOLEDrgb* InstancePtr);
+
 uint16_t OLEDrgb_BuildHSV(uint8_t hue, uint8_t sat, uint8_t val);
 uint16_t OLEDrgb_BuildRGB(uint8_t R,uint8_t G,uint8_t B);
 
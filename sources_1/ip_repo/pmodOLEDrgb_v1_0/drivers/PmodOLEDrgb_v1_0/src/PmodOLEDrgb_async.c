@@ -0,0 +1,419 @@
+/************************************************************************/
+/*																		*/
+/*	PmodOLEDrgb_async.c	--	Queued SPI transfers for the PmodOLEDrgb	*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	This module sends display transfers without waiting for them.  A	*/
+/*	transfer is a command phase and an optional data phase made of		*/
+/*	rows, so a window of a framebuffer goes out without a copy.			*/
+/*	Transfers are queued and run one after the other by the XSpi		*/
+/*	status handler: the end of the command phase raises D/C and			*/
+/*	starts the data phase, the end of the last row lowers D/C, calls	*/
+/*	the completion callback and starts the next transfer.				*/
+/*																		*/
+/*	The XSpi global interrupt is enabled only while the queue is		*/
+/*	running, so the synchronous drawing functions keep using polled		*/
+/*	transfers; they wait for the queue to drain first.					*/
+/*																		*/
+/*	XSpi_InterruptHandler() moves the queue along.  Connect it to the	*/
+/*	interrupt controller when the SPI interrupt is wired, or call		*/
+/*	OLEDrgb_AsyncPoll() from an idle loop when it is not.  Do not do	*/
+/*	both.																*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/16/2017: created													*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "PmodOLEDrgb.h"
+#include <string.h>
+
+/************************** Constant Definitions ***************************/
+
+// asyncPhase
+#define ASYNC_IDLE		0
+#define ASYNC_CMD		1
+#define ASYNC_DATA		2
+
+/************************** Function Definitions ***************************/
+
+static void OLEDrgb_AsyncStatusHandler(void *CallBackRef, u32 StatusEvent, unsigned int ByteCount);
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncData
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**
+**	Return Value:
+**		XST_SUCCESS or the XSpi_Transfer() error
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts sending the current row of the data phase.
+*/
+static int OLEDrgb_AsyncData(PmodOLEDrgb* InstancePtr)
+{
+	OLEDrgb_AsyncReq *pReq = &InstancePtr->rgAsyncReq[InstancePtr->iAsyncHead];
+
+	InstancePtr->asyncPhase = ASYNC_DATA;
+	return XSpi_Transfer(&InstancePtr->OLEDSpi, pReq->pData + InstancePtr->asyncRow * pReq->cbStride,
+		NULL, pReq->cbRow);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncStart
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Starts the transfer at the head of the queue, or stops the
+**		queue if it is empty.  A transfer that can not be started
+**		is completed with the error and the next one is tried.
+*/
+static void OLEDrgb_AsyncStart(PmodOLEDrgb* InstancePtr)
+{
+	OLEDrgb_AsyncReq *pReq;
+	int status;
+
+	while (InstancePtr->iAsyncHead != InstancePtr->iAsyncTail) {
+		pReq = &InstancePtr->rgAsyncReq[InstancePtr->iAsyncHead];
+		InstancePtr->asyncRow = 0;
+		XSpi_IntrGlobalEnable(&InstancePtr->OLEDSpi);
+
+		if (pReq->nCmd != 0) {
+			InstancePtr->asyncPhase = ASYNC_CMD;
+			status = XSpi_Transfer(&InstancePtr->OLEDSpi, pReq->rgbCmd, NULL, pReq->nCmd);
+		}
+		else {
+			Xil_Out32(InstancePtr->GPIO_addr, 0b1111);
+			status = OLEDrgb_AsyncData(InstancePtr);
+		}
+		if (status == XST_SUCCESS) {
+			return;
+		}
+
+		Xil_Out32(InstancePtr->GPIO_addr, 0b1110);
+		InstancePtr->cAsyncErrors++;
+		InstancePtr->iAsyncHead = (InstancePtr->iAsyncHead + 1) % OLEDRGB_ASYNC_QUEUE;
+		if (pReq->pfnDone != NULL) {
+			pReq->pfnDone(pReq->pRef, status);
+		}
+	}
+
+	InstancePtr->asyncPhase = ASYNC_IDLE;
+	XSpi_IntrGlobalDisable(&InstancePtr->OLEDSpi);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncStatusHandler
+**
+**	Parameters:
+**		CallBackRef	- PmodOLEDrgb object
+**		StatusEvent	- XSpi event
+**		ByteCount	- bytes transferred
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		XSpi status handler, runs in the SPI interrupt handler.
+**		Chains the phases of the transfer in progress and starts
+**		the next transfer when it is done.
+*/
+static void OLEDrgb_AsyncStatusHandler(void *CallBackRef, u32 StatusEvent, unsigned int ByteCount)
+{
+	PmodOLEDrgb* InstancePtr = (PmodOLEDrgb*) CallBackRef;
+	OLEDrgb_AsyncReq *pReq;
+	int status = XST_SUCCESS;
+
+	if (InstancePtr->asyncPhase == ASYNC_IDLE) {
+		return;
+	}
+	pReq = &InstancePtr->rgAsyncReq[InstancePtr->iAsyncHead];
+
+	if (StatusEvent == XST_SPI_TRANSFER_DONE) {
+		if (InstancePtr->asyncPhase == ASYNC_CMD) {
+			if (pReq->cbRow != 0) {
+				Xil_Out32(InstancePtr->GPIO_addr, 0b1111);
+				status = OLEDrgb_AsyncData(InstancePtr);
+				if (status == XST_SUCCESS) {
+					return;
+				}
+			}
+		}
+		else if (++InstancePtr->asyncRow < pReq->cRows) {
+			status = OLEDrgb_AsyncData(InstancePtr);
+			if (status == XST_SUCCESS) {
+				return;
+			}
+		}
+	}
+	else if ((StatusEvent == XST_SPI_RECEIVE_NOT_EMPTY) || (StatusEvent == XST_SPI_SLAVE_MODE)) {
+		// not a transfer event
+		return;
+	}
+	else {
+		status = StatusEvent;
+	}
+
+	// transfer done or failed
+	Xil_Out32(InstancePtr->GPIO_addr, 0b1110);
+	if (status == XST_SUCCESS) {
+		InstancePtr->cAsyncDone++;
+	}
+	else {
+		InstancePtr->cAsyncErrors++;
+	}
+	InstancePtr->iAsyncHead = (InstancePtr->iAsyncHead + 1) % OLEDRGB_ASYNC_QUEUE;
+	if (pReq->pfnDone != NULL) {
+		pReq->pfnDone(pReq->pRef, status);
+	}
+	OLEDrgb_AsyncStart(InstancePtr);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncInit
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object, after OLEDrgb_begin()
+**
+**	Return Value:
+**		XST_SUCCESS
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Empties the transfer queue and installs the XSpi status
+**		handler that runs it.
+*/
+int OLEDrgb_AsyncInit(PmodOLEDrgb* InstancePtr)
+{
+	InstancePtr->iAsyncHead = 0;
+	InstancePtr->iAsyncTail = 0;
+	InstancePtr->asyncPhase = ASYNC_IDLE;
+	InstancePtr->cAsyncDone = 0;
+	InstancePtr->cAsyncErrors = 0;
+	XSpi_SetStatusHandler(&InstancePtr->OLEDSpi, InstancePtr, OLEDrgb_AsyncStatusHandler);
+	InstancePtr->fAsync = true;
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncWrite
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**		pCmd		- command bytes, copied
+**		nCmd		- number of command bytes, up to OLEDRGB_ASYNC_MAXCMD
+**		pData		- first data row, NULL for no data phase
+**		cbRow		- data bytes per row
+**		cRows		- number of rows
+**		cbStride	- bytes from the start of a row to the next one
+**		pfnDone		- completion callback, can be NULL
+**		pRef		- passed to the callback
+**
+**	Return Value:
+**		XST_SUCCESS, XST_DEVICE_BUSY if the queue is full or
+**		XST_INVALID_PARAM
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Queues a transfer and returns without waiting.  The data
+**		is sent from pData when the transfer runs, so it must not
+**		be released before the callback, but it can still change.
+**		Rows that follow each other in memory are sent as one.
+*/
+int OLEDrgb_AsyncWrite(PmodOLEDrgb* InstancePtr, uint8_t *pCmd, int nCmd, uint8_t *pData, u32 cbRow, u32 cRows, u32 cbStride, OLEDrgb_AsyncDone pfnDone, void *pRef)
+{
+	OLEDrgb_AsyncReq *pReq;
+	u8 iNext;
+
+	if (!InstancePtr->fAsync || (nCmd < 0) || (nCmd > OLEDRGB_ASYNC_MAXCMD)) {
+		return XST_INVALID_PARAM;
+	}
+	if ((pData == NULL) || (cRows == 0)) {
+		cbRow = 0;
+	}
+	if ((nCmd == 0) && (cbRow == 0)) {
+		return XST_INVALID_PARAM;
+	}
+
+	iNext = (InstancePtr->iAsyncTail + 1) % OLEDRGB_ASYNC_QUEUE;
+	if (iNext == InstancePtr->iAsyncHead) {
+		return XST_DEVICE_BUSY;
+	}
+
+	pReq = &InstancePtr->rgAsyncReq[InstancePtr->iAsyncTail];
+	memcpy(pReq->rgbCmd, pCmd, nCmd);
+	pReq->nCmd = nCmd;
+	pReq->pData = pData;
+	if ((cbStride == cbRow) && (cbRow != 0)) {
+		pReq->cbRow = cbRow * cRows;
+		pReq->cRows = 1;
+	}
+	else {
+		pReq->cbRow = cbRow;
+		pReq->cRows = cRows;
+	}
+	pReq->cbStride = cbStride;
+	pReq->pfnDone = pfnDone;
+	pReq->pRef = pRef;
+
+	// the handler only runs while a transfer is in progress, so it can
+	// not stop the queue between the two lines below
+	InstancePtr->iAsyncTail = iNext;
+	if (InstancePtr->asyncPhase == ASYNC_IDLE) {
+		OLEDrgb_AsyncStart(InstancePtr);
+	}
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncDrawBitmap
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**		c1, r1		- upper left corner
+**		c2, r2		- lower right corner
+**		pBmp		- pixels, two bytes each, high byte first
+**		pfnDone		- completion callback, can be NULL
+**		pRef		- passed to the callback
+**
+**	Return Value:
+**		see OLEDrgb_AsyncWrite()
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Queues OLEDrgb_DrawBitmapRun().
+*/
+int OLEDrgb_AsyncDrawBitmap(PmodOLEDrgb* InstancePtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint8_t *pBmp, OLEDrgb_AsyncDone pfnDone, void *pRef)
+{
+	uint8_t cmds[6];
+	u32 cb;
+
+	cmds[0] = CMD_SETCOLUMNADDRESS;
+	cmds[1] = c1;
+	cmds[2] = c2;
+	cmds[3] = CMD_SETROWADDRESS;
+	cmds[4] = r1;
+	cmds[5] = r2;
+
+	cb = ((c2 - c1 + 1) * (r2 - r1 + 1)) << 1;
+	return OLEDrgb_AsyncWrite(InstancePtr, cmds, 6, pBmp, cb, 1, cb, pfnDone, pRef);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncBusy
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**
+**	Return Value:
+**		true while transfers are queued or in progress
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Checks the transfer queue.
+*/
+bool OLEDrgb_AsyncBusy(PmodOLEDrgb* InstancePtr)
+{
+	return InstancePtr->fAsync && (InstancePtr->asyncPhase != ASYNC_IDLE);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncFree
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**
+**	Return Value:
+**		number of transfers that can still be queued
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Lets a caller queue a group of transfers only if all of
+**		them fit.
+*/
+int OLEDrgb_AsyncFree(PmodOLEDrgb* InstancePtr)
+{
+	return (OLEDRGB_ASYNC_QUEUE - 1) -
+		((InstancePtr->iAsyncTail + OLEDRGB_ASYNC_QUEUE - InstancePtr->iAsyncHead) % OLEDRGB_ASYNC_QUEUE);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncPoll
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Runs the XSpi interrupt handler if the SPI interrupt is
+**		pending.  For systems where the SPI interrupt does not
+**		reach the interrupt controller; call it from an idle loop.
+**		Returns at once if nothing has happened.
+*/
+void OLEDrgb_AsyncPoll(PmodOLEDrgb* InstancePtr)
+{
+	if (!OLEDrgb_AsyncBusy(InstancePtr) || !InstancePtr->OLEDSpi.IsBusy) {
+		return;
+	}
+	if (XSpi_IntrGetStatus(&InstancePtr->OLEDSpi) & XSpi_IntrGetEnabled(&InstancePtr->OLEDSpi)) {
+		XSpi_InterruptHandler(&InstancePtr->OLEDSpi);
+	}
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_AsyncWait
+**
+**	Parameters:
+**		InstancePtr - PmodOLEDrgb object
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Waits until the transfer queue is empty.  The synchronous
+**		drawing functions call it before they use the SPI.
+*/
+void OLEDrgb_AsyncWait(PmodOLEDrgb* InstancePtr)
+{
+	while (OLEDrgb_AsyncBusy(InstancePtr)) {
+		OLEDrgb_AsyncPoll(InstancePtr);
+	}
+}
@@ -0,0 +1,747 @@
+/************************************************************************/
+/*																		*/
+/*	PmodOLEDrgb_fb.c	--	Framebuffer for the PmodOLEDrgb display		*/
+/*																		*/
+/************************************************************************/
+/*  Module Description: 												*/
+/*																		*/
+/*	This module contains a framebuffer for the PmodOLEDrgb display.		*/
+/*	The drawing functions write to a 96x64 RGB565 copy of the display	*/
+/*	in memory and remember the bounding box of the pixels that really	*/
+/*	changed.  OLEDrgb_FB_Flush() sends every dirty rectangle as one		*/
+/*	column/row address window followed by its pixels in a single data	*/
+/*	phase; the display advances through the window by itself.			*/
+/*																		*/
+/*	Drawing a pixel directly costs 8 SPI bytes and a glyph 134 bytes	*/
+/*	and a 5 ms wait.  Through the framebuffer a redraw that changes		*/
+/*	nothing costs nothing, and a changed region costs 6 bytes plus		*/
+/*	2 bytes per pixel with no wait.										*/
+/*																		*/
+/*	The dirty list is short.  A new rectangle is merged with one that	*/
+/*	overlaps or nearly touches it, and when the list is full it is		*/
+/*	merged with the rectangle it grows the least.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/13/2017: created													*/
+/*	06/15/2017: glyphs come from the expanded glyph cache				*/
+/*	06/16/2017: added OLEDrgb_FB_FlushAsync()							*/
+/*	06/17/2017: added OLEDrgb_FB_FillRectHw()							*/
+/*																		*/
+/************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "PmodOLEDrgb_fb.h"
+#include <string.h>
+
+/************************** Type Definitions *******************************/
+
+// bounding box of the pixels changed by one drawing call
+typedef struct{
+	int	c1, r1, c2, r2;
+}OLEDrgb_Box;
+
+/************************** Function Definitions ***************************/
+
+/* ------------------------------------------------------------ */
+/*				Local helpers									*/
+/* ------------------------------------------------------------ */
+
+// RGB565 color to SPI byte order, the display takes the high byte first
+static inline uint16_t FB_ToWire(uint16_t color)
+{
+	uint8_t *pb;
+	uint16_t w;
+
+	pb = (uint8_t *) &w;
+	pb[0] = color >> 8;
+	pb[1] = color;
+	return w;
+}
+
+static inline uint16_t FB_FromWire(uint16_t w)
+{
+	uint8_t *pb = (uint8_t *) &w;
+
+	return (pb[0] << 8) | pb[1];
+}
+
+static inline int FB_Area(const OLEDrgb_Rect *pRect)
+{
+	return (pRect->c2 - pRect->c1 + 1) * (pRect->r2 - pRect->r1 + 1);
+}
+
+static void FB_Union(OLEDrgb_Rect *pDst, const OLEDrgb_Rect *pSrc)
+{
+	if (pSrc->c1 < pDst->c1) pDst->c1 = pSrc->c1;
+	if (pSrc->r1 < pDst->r1) pDst->r1 = pSrc->r1;
+	if (pSrc->c2 > pDst->c2) pDst->c2 = pSrc->c2;
+	if (pSrc->r2 > pDst->r2) pDst->r2 = pSrc->r2;
+}
+
+static void FB_RemoveDirty(OLEDrgb_FB* FbPtr, int i)
+{
+	FbPtr->cDirty--;
+	FbPtr->rgDirty[i] = FbPtr->rgDirty[FbPtr->cDirty];
+}
+
+static void FB_AddDirty(OLEDrgb_FB* FbPtr, OLEDrgb_Rect rect)
+{
+	OLEDrgb_Rect u;
+	int i, iBest, growth, bestGrowth;
+
+	// merge with every rectangle that the union does not make much larger
+	i = 0;
+	while (i < FbPtr->cDirty) {
+		u = FbPtr->rgDirty[i];
+		FB_Union(&u, &rect);
+		if (FB_Area(&u) <= FB_Area(&FbPtr->rgDirty[i]) + FB_Area(&rect) + OLEDRGB_FB_MERGE_SLACK) {
+			rect = u;
+			FB_RemoveDirty(FbPtr, i);
+			i = 0;
+		}
+		else {
+			i++;
+		}
+	}
+
+	// list full, merge with the rectangle that grows the least
+	if (FbPtr->cDirty == OLEDRGB_FB_MAX_DIRTY) {
+		iBest = 0;
+		bestGrowth = OLEDRGB_WIDTH * OLEDRGB_HEIGHT + 1;
+		for (i = 0; i < FbPtr->cDirty; i++) {
+			u = FbPtr->rgDirty[i];
+			FB_Union(&u, &rect);
+			growth = FB_Area(&u) - FB_Area(&FbPtr->rgDirty[i]);
+			if (growth < bestGrowth) {
+				bestGrowth = growth;
+				iBest = i;
+			}
+		}
+		FB_Union(&rect, &FbPtr->rgDirty[iBest]);
+		FB_RemoveDirty(FbPtr, iBest);
+		FB_AddDirty(FbPtr, rect);
+		return;
+	}
+
+	FbPtr->rgDirty[FbPtr->cDirty++] = rect;
+}
+
+static inline void FB_BoxInit(OLEDrgb_Box *pBox)
+{
+	pBox->c1 = OLEDRGB_WIDTH;
+	pBox->r1 = OLEDRGB_HEIGHT;
+	pBox->c2 = -1;
+	pBox->r2 = -1;
+}
+
+// write one pixel (already in SPI byte order), grow the box if it changed
+static inline void FB_Set(OLEDrgb_FB* FbPtr, int c, int r, uint16_t w, OLEDrgb_Box *pBox)
+{
+	if (FbPtr->rgwPixels[r][c] == w) {
+		return;
+	}
+	FbPtr->rgwPixels[r][c] = w;
+	if (c < pBox->c1) pBox->c1 = c;
+	if (c > pBox->c2) pBox->c2 = c;
+	if (r < pBox->r1) pBox->r1 = r;
+	if (r > pBox->r2) pBox->r2 = r;
+}
+
+static void FB_BoxDone(OLEDrgb_FB* FbPtr, const OLEDrgb_Box *pBox)
+{
+	OLEDrgb_Rect rect;
+
+	if (pBox->c2 < 0) {
+		return;
+	}
+	rect.c1 = pBox->c1;
+	rect.r1 = pBox->r1;
+	rect.c2 = pBox->c2;
+	rect.r2 = pBox->r2;
+	FB_AddDirty(FbPtr, rect);
+}
+
+// clip a rectangle to the display, false if nothing is left
+static bool FB_Clip(uint8_t *pc1, uint8_t *pr1, uint8_t *pc2, uint8_t *pr2)
+{
+	uint8_t t;
+
+	if (*pc1 > *pc2) {
+		t = *pc1; *pc1 = *pc2; *pc2 = t;
+	}
+	if (*pr1 > *pr2) {
+		t = *pr1; *pr1 = *pr2; *pr2 = t;
+	}
+	if ((*pc1 >= OLEDRGB_WIDTH) || (*pr1 >= OLEDRGB_HEIGHT)) {
+		return false;
+	}
+	if (*pc2 >= OLEDRGB_WIDTH) {
+		*pc2 = OLEDRGB_WIDTH - 1;
+	}
+	if (*pr2 >= OLEDRGB_HEIGHT) {
+		*pr2 = OLEDRGB_HEIGHT - 1;
+	}
+	return true;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_Init
+**
+**	Parameters:
+**		FbPtr		- framebuffer to initialize
+**		InstancePtr	- PmodOLEDrgb object the framebuffer is flushed to
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Clears the framebuffer to black and the dirty list.  The
+**		display is assumed to be black as well, as it is after
+**		OLEDrgb_begin() or OLEDrgb_Clear().
+*/
+void OLEDrgb_FB_Init(OLEDrgb_FB* FbPtr, PmodOLEDrgb* InstancePtr)
+{
+	FbPtr->pOled = InstancePtr;
+	memset(FbPtr->rgwPixels, 0, sizeof(FbPtr->rgwPixels));
+	FbPtr->cDirty = 0;
+	FbPtr->cFlush = 0;
+	FbPtr->cbFlush = 0;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_Invalidate
+**
+**	Parameters:
+**		FbPtr		- framebuffer
+**		c1, r1		- first corner of the region
+**		c2, r2		- opposite corner of the region
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Marks a region as dirty whether or not it changed, ex: after
+**		the display was drawn to directly.
+*/
+void OLEDrgb_FB_Invalidate(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2)
+{
+	OLEDrgb_Rect rect;
+
+	if (!FB_Clip(&c1, &r1, &c2, &r2)) {
+		return;
+	}
+	rect.c1 = c1;
+	rect.r1 = r1;
+	rect.c2 = c2;
+	rect.r2 = r2;
+	FB_AddDirty(FbPtr, rect);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_Flush
+**
+**	Parameters:
+**		FbPtr		- framebuffer to flush
+**
+**	Return Value:
+**		number of SPI bytes sent
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Sends the dirty rectangles to the display and clears the
+**		dirty list.  Each rectangle costs one 6 byte address window
+**		and one data phase; the rows of the rectangle are sent back
+**		to back straight from the framebuffer while D/C stays high.
+*/
+u32 OLEDrgb_FB_Flush(OLEDrgb_FB* FbPtr)
+{
+	PmodOLEDrgb* InstancePtr = FbPtr->pOled;
+	OLEDrgb_Rect *pRect;
+	uint8_t cmds[6];
+	int i, r, cbRow;
+	u32 cb = 0;
+
+	OLEDrgb_AsyncWait(InstancePtr);
+	for (i = 0; i < FbPtr->cDirty; i++) {
+		pRect = &FbPtr->rgDirty[i];
+
+		cmds[0] = CMD_SETCOLUMNADDRESS;
+		cmds[1] = pRect->c1;
+		cmds[2] = pRect->c2;
+		cmds[3] = CMD_SETROWADDRESS;
+		cmds[4] = pRect->r1;
+		cmds[5] = pRect->r2;
+		XSpi_Transfer(&InstancePtr->OLEDSpi, cmds, 0, 6);
+
+		cbRow = (pRect->c2 - pRect->c1 + 1) << 1;
+		Xil_Out32(InstancePtr->GPIO_addr, 0b1111);
+		if (cbRow == (OLEDRGB_WIDTH << 1)) {
+			// full width rows are contiguous
+			XSpi_Transfer(&InstancePtr->OLEDSpi, (uint8_t *) FbPtr->rgwPixels[pRect->r1], 0,
+				cbRow * (pRect->r2 - pRect->r1 + 1));
+		}
+		else {
+			for (r = pRect->r1; r <= pRect->r2; r++) {
+				XSpi_Transfer(&InstancePtr->OLEDSpi, (uint8_t *) &FbPtr->rgwPixels[r][pRect->c1], 0, cbRow);
+			}
+		}
+		Xil_Out32(InstancePtr->GPIO_addr, 0b1110);
+
+		cb += 6 + cbRow * (pRect->r2 - pRect->r1 + 1);
+	}
+
+	if (FbPtr->cDirty != 0) {
+		FbPtr->cFlush++;
+		FbPtr->cbFlush += cb;
+	}
+	FbPtr->cDirty = 0;
+	return cb;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_FlushAsync
+**
+**	Parameters:
+**		FbPtr		- framebuffer to flush
+**		pfnDone		- called when the last rectangle has been sent,
+**					  can be NULL
+**		pRef		- passed to the callback
+**
+**	Return Value:
+**		XST_SUCCESS, or XST_DEVICE_BUSY if the transfer queue
+**		can not take all of the dirty rectangles
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Queues the dirty rectangles on the asynchronous transfer
+**		queue and clears the dirty list, without waiting.  The
+**		rows are sent from the framebuffer as the queue runs, so
+**		drawing before the callback only shows up earlier.  If
+**		nothing is dirty the callback is not called.  When the
+**		queue is busy the dirty list is kept for the next try.
+*/
+int OLEDrgb_FB_FlushAsync(OLEDrgb_FB* FbPtr, OLEDrgb_AsyncDone pfnDone, void *pRef)
+{
+	PmodOLEDrgb* InstancePtr = FbPtr->pOled;
+	OLEDrgb_Rect *pRect;
+	uint8_t cmds[6];
+	int i, status, cbRow;
+	u32 cb = 0;
+
+	if (FbPtr->cDirty == 0) {
+		return XST_SUCCESS;
+	}
+	if (OLEDrgb_AsyncFree(InstancePtr) < FbPtr->cDirty) {
+		return XST_DEVICE_BUSY;
+	}
+
+	for (i = 0; i < FbPtr->cDirty; i++) {
+		pRect = &FbPtr->rgDirty[i];
+
+		cmds[0] = CMD_SETCOLUMNADDRESS;
+		cmds[1] = pRect->c1;
+		cmds[2] = pRect->c2;
+		cmds[3] = CMD_SETROWADDRESS;
+		cmds[4] = pRect->r1;
+		cmds[5] = pRect->r2;
+
+		cbRow = (pRect->c2 - pRect->c1 + 1) << 1;
+		status = OLEDrgb_AsyncWrite(InstancePtr, cmds, 6, (uint8_t *) &FbPtr->rgwPixels[pRect->r1][pRect->c1],
+			cbRow, pRect->r2 - pRect->r1 + 1, sizeof(FbPtr->rgwPixels[0]),
+			(i == FbPtr->cDirty - 1) ? pfnDone : NULL, pRef);
+		if (status != XST_SUCCESS) {
+			return status;
+		}
+
+		cb += 6 + cbRow * (pRect->r2 - pRect->r1 + 1);
+	}
+
+	FbPtr->cFlush++;
+	FbPtr->cbFlush += cb;
+	FbPtr->cDirty = 0;
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_GetPixel
+**
+**	Parameters:
+**		FbPtr		- framebuffer
+**		c			- column
+**		r			- row
+**
+**	Return Value:
+**		RGB565 color of the pixel, 0 outside of the display
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Reads a pixel back from the framebuffer.
+*/
+uint16_t OLEDrgb_FB_GetPixel(OLEDrgb_FB* FbPtr, uint8_t c, uint8_t r)
+{
+	if ((c >= OLEDRGB_WIDTH) || (r >= OLEDRGB_HEIGHT)) {
+		return 0;
+	}
+	return FB_FromWire(FbPtr->rgwPixels[r][c]);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_DrawPixel
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		c			- column
+**		r			- row
+**		pixelColor	- RGB565 color
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Draws a pixel, pixels outside of the display are ignored.
+*/
+void OLEDrgb_FB_DrawPixel(OLEDrgb_FB* FbPtr, uint8_t c, uint8_t r, uint16_t pixelColor)
+{
+	OLEDrgb_Box box;
+
+	if ((c >= OLEDRGB_WIDTH) || (r >= OLEDRGB_HEIGHT)) {
+		return;
+	}
+	FB_BoxInit(&box);
+	FB_Set(FbPtr, c, r, FB_ToWire(pixelColor), &box);
+	FB_BoxDone(FbPtr, &box);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_DrawLine
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		c1, r1		- start of the line
+**		c2, r2		- end of the line
+**		lineColor	- RGB565 color
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Draws a line with the Bresenham algorithm, the part of the
+**		line outside of the display is ignored.
+*/
+void OLEDrgb_FB_DrawLine(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t lineColor)
+{
+	OLEDrgb_Box box;
+	uint16_t w = FB_ToWire(lineColor);
+	int dc, dr, sc, sr, err, e2;
+	int c = c1, r = r1;
+
+	dc = (c2 > c1) ? (c2 - c1) : (c1 - c2);
+	dr = (r2 > r1) ? (r1 - r2) : (r2 - r1);
+	sc = (c1 < c2) ? 1 : -1;
+	sr = (r1 < r2) ? 1 : -1;
+	err = dc + dr;
+
+	FB_BoxInit(&box);
+	while (1) {
+		if ((c < OLEDRGB_WIDTH) && (r < OLEDRGB_HEIGHT)) {
+			FB_Set(FbPtr, c, r, w, &box);
+		}
+		if ((c == c2) && (r == r2)) {
+			break;
+		}
+		e2 = 2 * err;
+		if (e2 >= dr) {
+			err += dr;
+			c += sc;
+		}
+		if (e2 <= dc) {
+			err += dc;
+			r += sr;
+		}
+	}
+	FB_BoxDone(FbPtr, &box);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_FillRect
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		c1, r1		- first corner
+**		c2, r2		- opposite corner
+**		fillColor	- RGB565 color
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills a rectangle, corners included.
+*/
+void OLEDrgb_FB_FillRect(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t fillColor)
+{
+	OLEDrgb_Box box;
+	uint16_t w = FB_ToWire(fillColor);
+	int c, r;
+
+	if (!FB_Clip(&c1, &r1, &c2, &r2)) {
+		return;
+	}
+	FB_BoxInit(&box);
+	for (r = r1; r <= r2; r++) {
+		for (c = c1; c <= c2; c++) {
+			FB_Set(FbPtr, c, r, w, &box);
+		}
+	}
+	FB_BoxDone(FbPtr, &box);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_FillRectHw
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		c1, r1		- top left corner
+**		c2, r2		- bottom right corner
+**		fillColor	- RGB565 color
+**
+**	Return Value:
+**		XST_SUCCESS, or XST_DEVICE_BUSY if the transfer queue is full
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills a rectangle with the display's own rectangle command
+**		instead of sending its pixels: 13 SPI bytes whatever the
+**		size.  The framebuffer is filled to match and the dirty
+**		rectangles inside the filled one are dropped.  The command
+**		is queued when the asynchronous queue is in use.  The display
+**		needs a few hundred microseconds to finish a large fill, so
+**		flush on a later frame instead of right after.
+*/
+int OLEDrgb_FB_FillRectHw(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t fillColor)
+{
+	PmodOLEDrgb* InstancePtr = FbPtr->pOled;
+	OLEDrgb_Rect *pRect;
+	uint8_t cmds[13];
+	uint16_t w = FB_ToWire(fillColor);
+	int c, r, i, status;
+
+	if (!FB_Clip(&c1, &r1, &c2, &r2)) {
+		return XST_SUCCESS;
+	}
+
+	cmds[0] = CMD_FILLWINDOW;
+	cmds[1] = ENABLE_FILL;
+	cmds[2] = CMD_DRAWRECTANGLE;
+	cmds[3] = c1;
+	cmds[4] = r1;
+	cmds[5] = c2;
+	cmds[6] = r2;
+	cmds[7] = cmds[10] = OLEDrgb_ExtractRFromRGB(fillColor);
+	cmds[8] = cmds[11] = OLEDrgb_ExtractGFromRGB(fillColor);
+	cmds[9] = cmds[12] = OLEDrgb_ExtractBFromRGB(fillColor);
+
+	if (InstancePtr->fAsync) {
+		status = OLEDrgb_AsyncWrite(InstancePtr, cmds, 13, NULL, 0, 0, 0, NULL, NULL);
+		if (status != XST_SUCCESS) {
+			return status;
+		}
+	}
+	else {
+		OLEDrgb_WriteSPI(InstancePtr, cmds, 13, NULL, 0);
+	}
+
+	for (r = r1; r <= r2; r++) {
+		for (c = c1; c <= c2; c++) {
+			FbPtr->rgwPixels[r][c] = w;
+		}
+	}
+
+	// the display already shows what these would send
+	i = 0;
+	while (i < FbPtr->cDirty) {
+		pRect = &FbPtr->rgDirty[i];
+		if ((pRect->c1 >= c1) && (pRect->r1 >= r1) && (pRect->c2 <= c2) && (pRect->r2 <= r2)) {
+			FB_RemoveDirty(FbPtr, i);
+		}
+		else {
+			i++;
+		}
+	}
+	return XST_SUCCESS;
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_Clear
+**
+**	Parameters:
+**		FbPtr		- framebuffer to clear
+**		color		- RGB565 color
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Fills the whole framebuffer with one color.
+*/
+void OLEDrgb_FB_Clear(OLEDrgb_FB* FbPtr, uint16_t color)
+{
+	OLEDrgb_FB_FillRect(FbPtr, 0, 0, OLEDRGB_WIDTH - 1, OLEDRGB_HEIGHT - 1, color);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_DrawBitmap
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		c1, r1		- top left corner
+**		c2, r2		- bottom right corner
+**		pBmp		- RGB565 pixels, row by row, (c2-c1+1)*(r2-r1+1) of them
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Copies a bitmap to the framebuffer, the part outside of the
+**		display is ignored.
+*/
+void OLEDrgb_FB_DrawBitmap(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const uint16_t *pBmp)
+{
+	OLEDrgb_Box box;
+	int c, r, cw;
+
+	if ((c1 > c2) || (r1 > r2)) {
+		return;
+	}
+	cw = c2 - c1 + 1;
+	FB_BoxInit(&box);
+	for (r = r1; (r <= r2) && (r < OLEDRGB_HEIGHT); r++) {
+		for (c = c1; (c <= c2) && (c < OLEDRGB_WIDTH); c++) {
+			FB_Set(FbPtr, c, r, FB_ToWire(pBmp[(r - r1) * cw + (c - c1)]), &box);
+		}
+	}
+	FB_BoxDone(FbPtr, &box);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_DrawGlyph
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		ch			- character code of character to draw
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Renders the character at the character cursor of the
+**		PmodOLEDrgb object, with its font and font colors.  The
+**		cursor does not move.
+*/
+void OLEDrgb_FB_DrawGlyph(OLEDrgb_FB* FbPtr, char ch)
+{
+	PmodOLEDrgb* InstancePtr = FbPtr->pOled;
+	OLEDrgb_Box box;
+	uint8_t *pbBmp;
+	uint16_t w;
+	int ibx, iby, x, y;
+
+	pbBmp = OLEDrgb_GetGlyphBmp(InstancePtr, ch);
+	if (pbBmp == NULL) {
+		return;
+	}
+
+	x = InstancePtr->xchOledCur*InstancePtr->dxcoOledrgbFontCur;
+	y = InstancePtr->ychOledCur*InstancePtr->dycoOledrgbFontCur;
+
+	// the cached glyph is already in SPI byte order
+	FB_BoxInit(&box);
+	for (iby = 0; (iby < 8) && (y + iby < OLEDRGB_HEIGHT); iby++) {
+		for (ibx = 0; (ibx < OLEDRGB_CHARBYTES) && (x + ibx < OLEDRGB_WIDTH); ibx++) {
+			memcpy(&w, pbBmp + (iby * OLEDRGB_CHARBYTES + ibx) * 2, 2);
+			FB_Set(FbPtr, x + ibx, y + iby, w, &box);
+		}
+	}
+	FB_BoxDone(FbPtr, &box);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_PutChar
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		ch			- character to write
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Renders the character at the character cursor and advances
+**		the cursor.
+*/
+void OLEDrgb_FB_PutChar(OLEDrgb_FB* FbPtr, char ch)
+{
+	OLEDrgb_FB_DrawGlyph(FbPtr, ch);
+	OLEDrgb_AdvanceCursor(FbPtr->pOled);
+}
+
+/* ------------------------------------------------------------ */
+/***	OLEDrgb_FB_PutString
+**
+**	Parameters:
+**		FbPtr		- framebuffer to draw to
+**		sz			- pointer to the null terminated string
+**
+**	Return Value:
+**		none
+**
+**	Errors:
+**		none
+**
+**	Description:
+**		Renders the string from the character cursor and advances
+**		the cursor past it.
+*/
+void OLEDrgb_FB_PutString(OLEDrgb_FB* FbPtr, char * sz)
+{
+	while (*sz != '\0') {
+		OLEDrgb_FB_PutChar(FbPtr, *sz);
+		sz += 1;
+	}
+}
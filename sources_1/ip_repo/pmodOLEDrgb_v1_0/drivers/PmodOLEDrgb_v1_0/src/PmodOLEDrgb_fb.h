@@ -0,0 +1,73 @@
+/************************************************************************/
+/*																		*/
+/* PmodOLEDrgb_fb.h	--	Interface Declarations for PmodOLEDrgb_fb.c		*/
+/*																		*/
+/************************************************************************/
+/*  File Description:													*/
+/*																		*/
+/*	This header file contains the declarations of the framebuffer for	*/
+/*	the PmodOLEDrgb display.  Drawing goes to a copy of the display		*/
+/*	in memory, only the pixels that change are marked as dirty, and		*/
+/*	OLEDrgb_FB_Flush() sends each dirty rectangle to the display as		*/
+/*	one address window and one burst of pixel data.						*/
+/*																		*/
+/************************************************************************/
+/*  Revision History:													*/
+/*																		*/
+/*	06/13/2017: created													*/
+/*	06/16/2017: added OLEDrgb_FB_FlushAsync()							*/
+/*	06/17/2017: added OLEDrgb_FB_FillRectHw()							*/
+/*																		*/
+/************************************************************************/
+#ifndef PMODOLEDRGB_FB_H
+#define PMODOLEDRGB_FB_H
+
+/* ------------------------------------------------------------ */
+/*					Include File Definitions					*/
+/* ------------------------------------------------------------ */
+#include "PmodOLEDrgb.h"
+
+/* ------------------------------------------------------------ */
+/*					Miscellaneous Declarations					*/
+/* ------------------------------------------------------------ */
+#define OLEDRGB_FB_MAX_DIRTY	4	// dirty rectangles kept before they are merged
+#define OLEDRGB_FB_MERGE_SLACK	16	// clean pixels a merge may resend to save a window
+
+/* ------------------------------------------------------------ */
+/*					Object Class Declarations					*/
+/* ------------------------------------------------------------ */
+typedef struct{
+	uint8_t	c1, r1, c2, r2;		// inclusive corners
+}OLEDrgb_Rect;
+
+typedef struct{
+	PmodOLEDrgb* pOled;
+	// pixels in SPI byte order (high byte first), so a row goes out as it is
+	uint16_t	rgwPixels[OLEDRGB_HEIGHT][OLEDRGB_WIDTH];
+	OLEDrgb_Rect rgDirty[OLEDRGB_FB_MAX_DIRTY];
+	int			cDirty;
+
+	u32			cFlush;			// flushes that sent something
+	u32			cbFlush;		// SPI bytes sent by the flushes
+}OLEDrgb_FB;
+
+/* ------------------------------------------------------------ */
+/*					Procedure Declarations						*/
+/* ------------------------------------------------------------ */
+void OLEDrgb_FB_Init(OLEDrgb_FB* FbPtr, PmodOLEDrgb* InstancePtr);
+void OLEDrgb_FB_Invalidate(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2);
+u32 OLEDrgb_FB_Flush(OLEDrgb_FB* FbPtr);
+int OLEDrgb_FB_FlushAsync(OLEDrgb_FB* FbPtr, OLEDrgb_AsyncDone pfnDone, void *pRef);
+
+uint16_t OLEDrgb_FB_GetPixel(OLEDrgb_FB* FbPtr, uint8_t c, uint8_t r);
+void OLEDrgb_FB_DrawPixel(OLEDrgb_FB* FbPtr, uint8_t c, uint8_t r, uint16_t pixelColor);
+void OLEDrgb_FB_DrawLine(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t lineColor);
+void OLEDrgb_FB_FillRect(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t fillColor);
+int OLEDrgb_FB_FillRectHw(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, uint16_t fillColor);
+void OLEDrgb_FB_Clear(OLEDrgb_FB* FbPtr, uint16_t color);
+void OLEDrgb_FB_DrawBitmap(OLEDrgb_FB* FbPtr, uint8_t c1, uint8_t r1, uint8_t c2, uint8_t r2, const uint16_t *pBmp);
+void OLEDrgb_FB_DrawGlyph(OLEDrgb_FB* FbPtr, char ch);
+void OLEDrgb_FB_PutChar(OLEDrgb_FB* FbPtr, char ch);
+void OLEDrgb_FB_PutString(OLEDrgb_FB* FbPtr, char * sz);
+
+#endif // PMODOLEDRGB_FB_H
@@ -0,0 +1,496 @@
+/** @file timebase.c
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This file contains the common time base.  It replaces the calibrated spin loops that were
+* used for delays: those burned the CPU for the whole delay and their timing changed with
+* the cache and compiler settings.
+*
+* Counter 0 of the AXI timer counts up at the AXI clock and interrupts when it wraps; the
+* wraps are counted to extend it to 64 bits.  Counter 1 counts down from the time left to
+* the earliest pending callback and interrupts once when it reaches 0.  Both counters share
+* the timer interrupt, TB_InterruptHandler() must be connected to it.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     10-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include "timebase.h"
+#include "xtmrctr_l.h"
+#include "mb_interface.h"
+#include "xil_printf.h"
+
+/************************** Constant Definitions *****************************/
+#define TB_FREE_COUNTER		0			// free running time counter
+#define TB_DEADLINE_COUNTER	1			// one-shot deadline counter
+
+#define TB_MSR_IE_MASK		0x02		// MicroBlaze interrupt enable bit
+
+/**************************** Type definitions ******************************/
+typedef struct
+{
+	bool		active;
+	u32			deadline_us;
+	TB_Callback	callback;
+	void		*context;
+} TB_Timer;
+
+/******************** Static variable declarations **************************/
+static uint32_t		TbBaseAddr = 0;
+static u32			TbTicksPerUs = 1;
+static volatile u32	TbWraps = 0;			// upper 32 bits of the time
+static TB_IdleHook	TbIdleHook = NULL;
+static TB_Timer		TbTimers[TB_MAX_CALLBACKS];
+static volatile u32	TbSelftestFired;		// time the self-test callback ran
+
+/*********************** Private function prototypes ************************/
+static u32 tb_lock(void);
+static void tb_unlock(u32 msr);
+static void tb_count_wrap(void);
+static void tb_program_deadline(void);
+static void tb_selftest_callback(void *context);
+
+/************************** Public functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Initialize the time base
+*
+* Starts counter 0 free running from 0 and stops counter 1.  No callbacks are pending.
+*
+* @param	baseaddr is the base address of the AXI timer
+* @param	clock_freq_hz is the AXI timer clock frequency, a multiple of 1MHz
+*
+* @return
+* 		- XST_SUCCESS	Initialization was successful.
+* 		- XST_INVALID_PARAM	The clock is not a multiple of 1MHz
+*
+* @note		Connect TB_InterruptHandler() to the timer interrupt before callbacks are used
+*****************************************************************************/
+uint32_t TB_initialize(uint32_t baseaddr, uint32_t clock_freq_hz)
+{
+	if ((clock_freq_hz < 1000000) || ((clock_freq_hz % 1000000) != 0))
+		return XST_INVALID_PARAM;
+
+	TbBaseAddr = baseaddr;
+	TbTicksPerUs = clock_freq_hz / 1000000;
+	TbWraps = 0;
+	for (int i = 0; i < TB_MAX_CALLBACKS; i++)
+		TbTimers[i].active = false;
+
+	// stop the deadline counter
+	XTmrCtr_SetControlStatusReg(TbBaseAddr, TB_DEADLINE_COUNTER, XTC_CSR_INT_OCCURED_MASK);
+
+	// counter 0 counts up from 0 and interrupts when it wraps
+	XTmrCtr_SetLoadReg(TbBaseAddr, TB_FREE_COUNTER, 0);
+	XTmrCtr_LoadTimerCounterReg(TbBaseAddr, TB_FREE_COUNTER);
+	XTmrCtr_SetControlStatusReg(TbBaseAddr, TB_FREE_COUNTER,
+		XTC_CSR_ENABLE_TMR_MASK | XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_INT_OCCURED_MASK);
+
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Time base interrupt handler
+*
+* Counts wraps of the free running counter and runs every callback whose deadline
+* has passed, then starts the deadline counter for the next one.
+*
+* @param	p_unused is not used
+*
+* @return	*NONE*
+*****************************************************************************/
+void TB_InterruptHandler(void *p_unused)
+{
+	u32 csr;
+	u32 now;
+	TB_Callback callback;
+	void *context;
+
+	tb_count_wrap();
+
+	csr = XTmrCtr_GetControlStatusReg(TbBaseAddr, TB_DEADLINE_COUNTER);
+	if (csr & XTC_CSR_INT_OCCURED_MASK)
+	{
+		// stop the one-shot and clear its interrupt
+		XTmrCtr_SetControlStatusReg(TbBaseAddr, TB_DEADLINE_COUNTER, XTC_CSR_INT_OCCURED_MASK);
+	}
+
+	// a callback may schedule another one, so rescan after each call
+	now = TB_now_us();
+	for (int i = 0; i < TB_MAX_CALLBACKS; i++)
+	{
+		if (TbTimers[i].active && ((int32_t) (TbTimers[i].deadline_us - now) <= 0))
+		{
+			callback = TbTimers[i].callback;
+			context = TbTimers[i].context;
+			TbTimers[i].active = false;
+			callback(context);
+			now = TB_now_us();
+			i = -1;
+		}
+	}
+	tb_program_deadline();
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the time in AXI timer ticks
+*
+* @return	64-bit count of AXI timer clocks since TB_initialize()
+*****************************************************************************/
+u64 TB_now_ticks(void)
+{
+	u32 msr;
+	u32 lo;
+	u64 ticks;
+
+	msr = tb_lock();
+	tb_count_wrap();
+	lo = XTmrCtr_GetTimerCounterReg(TbBaseAddr, TB_FREE_COUNTER);
+	// the counter may have wrapped after tb_count_wrap() looked
+	if (XTmrCtr_GetControlStatusReg(TbBaseAddr, TB_FREE_COUNTER) & XTC_CSR_INT_OCCURED_MASK)
+	{
+		tb_count_wrap();
+		lo = XTmrCtr_GetTimerCounterReg(TbBaseAddr, TB_FREE_COUNTER);
+	}
+	ticks = ((u64) TbWraps << 32) | lo;
+	tb_unlock(msr);
+	return ticks;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the low 32 bits of the time in AXI timer ticks
+*
+* @return	free running count of AXI timer clocks, wraps every 2^32 clocks
+*
+* @note		Cheaper than TB_now_ticks(), for measuring intervals shorter than a wrap
+*****************************************************************************/
+u32 TB_get_ticks(void)
+{
+	return XTmrCtr_GetTimerCounterReg(TbBaseAddr, TB_FREE_COUNTER);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the number of AXI timer ticks in a microsecond
+*
+* @return	ticks per microsecond
+*****************************************************************************/
+u32 TB_ticks_per_us(void)
+{
+	return TbTicksPerUs;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Get the time in microseconds
+*
+* @return	microseconds since TB_initialize(), wraps every 2^32 microseconds
+*
+* @note		Compare times with (int32_t) (a - b) so that the wrap is handled
+*****************************************************************************/
+u32 TB_now_us(void)
+{
+	return (u32) (TB_now_ticks() / TbTicksPerUs);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Set the function called while TB_sleep_until() waits
+*
+* @param	hook is the idle function, NULL for none
+*
+* @return	*NONE*
+*****************************************************************************/
+void TB_set_idle_hook(TB_IdleHook hook)
+{
+	TbIdleHook = hook;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Wait until a deadline
+*
+* The idle hook is called while the deadline has not been reached, and interrupts
+* are serviced, so background work continues during the wait.
+*
+* @param	deadline_us is the time to wait for, from TB_now_us()
+*
+* @return	*NONE*
+*****************************************************************************/
+void TB_sleep_until(u32 deadline_us)
+{
+	while ((int32_t) (deadline_us - TB_now_us()) > 0)
+	{
+		if (TbIdleHook != NULL)
+			TbIdleHook();
+	}
+}
+
+
+/****************************************************************************/
+/**
+* @brief Wait for a number of microseconds
+*
+* @param	usec is the delay in microseconds
+*
+* @return	*NONE*
+*****************************************************************************/
+void TB_delay_us(u32 usec)
+{
+	TB_sleep_until(TB_now_us() + usec);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Call a function at a deadline
+*
+* The callback is run from TB_InterruptHandler() once the deadline has passed.  A
+* deadline that has already passed runs the callback at the next timer interrupt.
+*
+* @param	deadline_us is the time to call the function at, from TB_now_us()
+* @param	callback is the function to call
+* @param	context is passed to the callback
+*
+* @return	handle for TB_cancel(), -XST_INVALID_PARAM if callback is NULL, or
+*			-XST_DEVICE_BUSY if TB_MAX_CALLBACKS callbacks are already pending
+*****************************************************************************/
+int TB_call_at(u32 deadline_us, TB_Callback callback, void *context)
+{
+	u32 msr;
+	int handle = -XST_DEVICE_BUSY;
+
+	if (callback == NULL)
+		return -XST_INVALID_PARAM;
+
+	msr = tb_lock();
+	for (int i = 0; i < TB_MAX_CALLBACKS; i++)
+	{
+		if (!TbTimers[i].active)
+		{
+			TbTimers[i].deadline_us = deadline_us;
+			TbTimers[i].callback = callback;
+			TbTimers[i].context = context;
+			TbTimers[i].active = true;
+			handle = i;
+			break;
+		}
+	}
+	if (handle >= 0)
+		tb_program_deadline();
+	tb_unlock(msr);
+	return handle;
+}
+
+
+/****************************************************************************/
+/**
+* @brief Cancel a pending callback
+*
+* @param	handle is the value returned by TB_call_at()
+*
+* @return	*NONE*
+*****************************************************************************/
+void TB_cancel(int handle)
+{
+	u32 msr;
+
+	if ((handle < 0) || (handle >= TB_MAX_CALLBACKS))
+		return;
+
+	msr = tb_lock();
+	TbTimers[handle].active = false;
+	tb_program_deadline();
+	tb_unlock(msr);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Run a self-test on the time base
+*
+* Checks that the free running counter advances, then measures the error of
+* TB_delay_us() for delays from 10us to 10ms and the lateness of a deadline
+* callback, and prints them.
+*
+* @return
+*    - XST_SUCCESS   if every error is within TB_SELFTEST_MAX_ERR_US
+*    - XST_FAILURE   otherwise
+*
+* @note		Interrupts must be enabled for the callback to be checked, the
+*			callback check is skipped if they are not
+*****************************************************************************/
+uint32_t TB_selftest(void)
+{
+	static const u32 delays_us[] = {10, 100, 1000, 10000};
+	uint32_t status = XST_SUCCESS;
+	u32 t0, t1;
+	int32_t err;
+	int handle;
+
+	xil_printf("******************************\n\r");
+	xil_printf("* Time base Self Test\n\r");
+	xil_printf("******************************\n\n\r");
+
+	t0 = TB_get_ticks();
+	t1 = TB_get_ticks();
+	if (t0 == t1)
+	{
+		xil_printf("Error timer counter is not running\n\r");
+		return XST_FAILURE;
+	}
+
+	for (int i = 0; i < (int) (sizeof(delays_us) / sizeof(delays_us[0])); i++)
+	{
+		t0 = TB_now_us();
+		TB_delay_us(delays_us[i]);
+		t1 = TB_now_us();
+		err = (int32_t) (t1 - t0 - delays_us[i]);
+		xil_printf("   - delay %6d us error %d us\n\r", delays_us[i], err);
+		if ((err < 0) || (err > TB_SELFTEST_MAX_ERR_US))
+			status = XST_FAILURE;
+	}
+
+	if (mfmsr() & TB_MSR_IE_MASK)
+	{
+		TbSelftestFired = 0;
+		t0 = TB_now_us() + 1000;
+		handle = TB_call_at(t0, tb_selftest_callback, NULL);
+		if (handle < 0)
+		{
+			xil_printf("Error no free callback\n\r");
+			return XST_FAILURE;
+		}
+		TB_sleep_until(t0 + 2 * TB_SELFTEST_MAX_ERR_US);
+		if (TbSelftestFired == 0)
+		{
+			xil_printf("Error callback did not run\n\r");
+			TB_cancel(handle);
+			return XST_FAILURE;
+		}
+		err = (int32_t) (TbSelftestFired - t0);
+		xil_printf("   - callback late by %d us\n\r", err);
+		if ((err < 0) || (err > TB_SELFTEST_MAX_ERR_US))
+			status = XST_FAILURE;
+	}
+	else
+	{
+		xil_printf("   - interrupts disabled, callback not checked\n\r");
+	}
+
+	xil_printf("\n\r");
+	return status;
+}
+
+
+/************************** Private functions ********************************/
+
+/****************************************************************************/
+/**
+* @brief Disable interrupts, returning the previous MSR so they can be restored
+*****************************************************************************/
+static u32 tb_lock(void)
+{
+	u32 msr = mfmsr();
+	microblaze_disable_interrupts();
+	return msr;
+}
+
+static void tb_unlock(u32 msr)
+{
+	if (msr & TB_MSR_IE_MASK)
+		microblaze_enable_interrupts();
+}
+
+
+/****************************************************************************/
+/**
+* @brief Count a wrap of the free running counter if one is pending
+*
+* @note		Called with interrupts disabled or from the interrupt handler
+*****************************************************************************/
+static void tb_count_wrap(void)
+{
+	u32 csr = XTmrCtr_GetControlStatusReg(TbBaseAddr, TB_FREE_COUNTER);
+
+	if (csr & XTC_CSR_INT_OCCURED_MASK)
+	{
+		// writing the interrupt bit back clears it
+		XTmrCtr_SetControlStatusReg(TbBaseAddr, TB_FREE_COUNTER, csr);
+		TbWraps++;
+	}
+}
+
+
+/****************************************************************************/
+/**
+* @brief Start the deadline counter for the earliest pending callback
+*
+* Deadlines further away than the counter can reach are approached in steps.
+*
+* @note		Called with interrupts disabled or from the interrupt handler
+*****************************************************************************/
+static void tb_program_deadline(void)
+{
+	bool pending = false;
+	u32 now = TB_now_us();
+	int32_t wait_us = 0;
+	int32_t left;
+	u32 ticks;
+
+	for (int i = 0; i < TB_MAX_CALLBACKS; i++)
+	{
+		if (TbTimers[i].active)
+		{
+			left = (int32_t) (TbTimers[i].deadline_us - now);
+			if (!pending || (left < wait_us))
+				wait_us = left;
+			pending = true;
+		}
+	}
+
+	// stop the counter and clear a stale interrupt
+	XTmrCtr_SetControlStatusReg(TbBaseAddr, TB_DEADLINE_COUNTER, XTC_CSR_INT_OCCURED_MASK);
+	if (!pending)
+		return;
+
+	if (wait_us < 1)
+		wait_us = 1;
+	if ((u32) wait_us > (0xFFFFFFFF / TbTicksPerUs))
+		wait_us = 0xFFFFFFFF / TbTicksPerUs;
+	ticks = (u32) wait_us * TbTicksPerUs;
+
+	XTmrCtr_SetLoadReg(TbBaseAddr, TB_DEADLINE_COUNTER, ticks);
+	XTmrCtr_LoadTimerCounterReg(TbBaseAddr, TB_DEADLINE_COUNTER);
+	XTmrCtr_SetControlStatusReg(TbBaseAddr, TB_DEADLINE_COUNTER,
+		XTC_CSR_ENABLE_TMR_MASK | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_DOWN_COUNT_MASK);
+}
+
+
+/****************************************************************************/
+/**
+* @brief Deadline callback used by TB_selftest(), records when it ran
+*****************************************************************************/
+static void tb_selftest_callback(void *context)
+{
+	TbSelftestFired = TB_now_us();
+}
@@ -0,0 +1,71 @@
+/** @file timebase.h
+*
+* @copyright Portland State University, 2017
+*
+* @brief
+* This header file contains the constants and function prototypes for the common time base.
+* The time base runs on the two counters of an AXI timer: counter 0 counts up freely at the
+* AXI clock and is extended to 64 bits in software; counter 1 is a one-shot that interrupts
+* at the next callback deadline.  It provides the current time, sleeps to a deadline that
+* hand the CPU to an idle hook while they wait, and callbacks at a deadline run from the
+* timer interrupt.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     10-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+
+/****************** Include Files ********************/
+#include "stdint.h"
+#include "stdbool.h"
+#include "xil_types.h"
+#include "xstatus.h"
+
+/************* Constant Declarations *****************/
+#define TB_MAX_CALLBACKS		8			// number of pending deadline callbacks
+
+// delay error limit used by TB_selftest()
+#define TB_SELFTEST_MAX_ERR_US	20
+
+
+/**************************** Type Definitions *****************************/
+
+// called from the timer interrupt handler with the context passed to TB_call_at()
+typedef void (*TB_Callback)(void *context);
+
+// called repeatedly while TB_sleep_until() waits
+typedef void (*TB_IdleHook)(void);
+
+
+/************************** Function Prototypes ****************************/
+
+// initialization and self test
+uint32_t TB_initialize(uint32_t baseaddr, uint32_t clock_freq_hz);
+uint32_t TB_selftest(void);
+void TB_InterruptHandler(void *p_unused);
+
+// time
+u64 TB_now_ticks(void);
+u32 TB_get_ticks(void);
+u32 TB_ticks_per_us(void);
+u32 TB_now_us(void);
+
+// delays
+void TB_set_idle_hook(TB_IdleHook hook);
+void TB_sleep_until(u32 deadline_us);
+void TB_delay_us(u32 usec);
+
+// deadline callbacks
+int TB_call_at(u32 deadline_us, TB_Callback callback, void *context);
+void TB_cancel(int handle);
+
+#endif // TIMEBASE_H
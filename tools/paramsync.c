@@ -0,0 +1,538 @@
+/**
+*
+* @file paramsync.c
+*
+* @copyright Portland State University, 2017
+*
+* Ground station tool for the parameter link (plink.h).  It talks to the
+* aircraft over the serial port of the RN42 Bluetooth connection and reads,
+* writes, dumps and syncs the tuning parameters.
+*
+* The frame format, the message types and the image format come from
+* plink.h and param.h, and the CRC is PARAM_crc32() from param.c, so the
+* tool is built with the flight sources.  bsp/ stands in for the Xilinx
+* BSP headers they include.
+*
+* Build and run on the host, from this directory:
+*
+*	gcc -std=gnu99 -Wall -Ibsp -I.. -o paramsync paramsync.c ../param.c
+*	./paramsync [-b baud] port dump > params.txt
+*	./paramsync [-b baud] port get name
+*	./paramsync [-b baud] port set name value
+*	./paramsync [-b baud] port sync params.txt
+*	./paramsync [-b baud] port reset
+*
+* The parameter file has one "name value" per line, and # starts a comment;
+* the output of dump is a parameter file.  sync dumps the table, then sends
+* the values in the file that differ from the aircraft's in one image, which
+* the aircraft applies whole or not at all.  For the 12 parameters of the
+* flight software that is about 400 bytes on the link, under half a second
+* at 9600 baud and a few tens of milliseconds at 115200 baud.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.00a	     18-Jun-2017	First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *******************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include "plink.h"
+#include "param.h"
+
+/************************** Constant Definitions ****************************/
+#define REPLY_TIMEOUT_MS	300			// wait for a reply before asking again
+#define MAX_TRIES			4			// requests sent before giving up
+
+/**************************** Type Definitions ******************************/
+typedef struct
+{
+	uint16_t	id;
+	uint8_t		type;
+	uint32_t	value;			// the s32 or float, as sent
+	float		min;
+	float		max;
+	char		name[PLINK_NAME_MAX + 1];
+	int			set;			// the parameter file has a value for it
+	uint32_t	new_value;		// that value
+} param_t;
+
+/************************** Variable Definitions ****************************/
+static int			fd = -1;
+static param_t		params[PARAM_MAX_PARAMS];
+static int			num_params = 0;
+static uint8_t		next_seq = 0;
+
+/************************** Link *********************************************/
+
+static double now_ms(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint8_t *put16(uint8_t *p, uint32_t data)
+{
+	*p++ = data;
+	*p++ = data >> 8;
+	return p;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t data)
+{
+	p = put16(p, data);
+	return put16(p, data >> 16);
+}
+
+static int open_port(const char *path, int baud)
+{
+	static const struct { int baud; speed_t speed; } speeds[] = {
+		{9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600},
+		{115200, B115200}, {230400, B230400}, {460800, B460800}, {921600, B921600}
+	};
+	struct termios tio;
+	int i;
+
+	fd = open(path, O_RDWR | O_NOCTTY);
+	if (fd < 0)
+	{
+		perror(path);
+		return -1;
+	}
+	if (tcgetattr(fd, &tio) == 0)
+	{
+		cfmakeraw(&tio);
+		for (i = 0; i < (int) (sizeof(speeds) / sizeof(speeds[0])); i++)
+		{
+			if (speeds[i].baud == baud)
+			{
+				cfsetispeed(&tio, speeds[i].speed);
+				cfsetospeed(&tio, speeds[i].speed);
+			}
+		}
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+	tcflush(fd, TCIFLUSH);
+	return 0;
+}
+
+static void send_frame(uint8_t type, uint8_t seq, const uint8_t *payload, int len)
+{
+	uint8_t frame[PLINK_MAX_BODY + PLINK_OVERHEAD];
+
+	frame[0] = PLINK_SOF;
+	frame[1] = len + 2;
+	frame[2] = type;
+	frame[3] = seq;
+	memcpy(&frame[4], payload, len);
+	put32(&frame[4 + len], PARAM_crc32(0, &frame[1], len + 3));
+	if (write(fd, frame, len + PLINK_OVERHEAD) != len + PLINK_OVERHEAD)
+		perror("write");
+}
+
+// the next good frame, the body in body, its length returned, or -1 on a timeout
+static int read_frame(uint8_t *body, int timeout_ms)
+{
+	static int state = 0, len, count;
+	static uint8_t crc[4];
+	struct pollfd pfd = {fd, POLLIN, 0};
+	double end = now_ms() + timeout_ms;
+	uint8_t buf;
+	int wait;
+
+	while ((wait = (int) (end - now_ms())) > 0)
+	{
+		if (poll(&pfd, 1, wait) <= 0 || read(fd, &buf, 1) != 1)
+			continue;
+		switch (state)
+		{
+			case 0:
+				if (buf == PLINK_SOF)
+					state = 1;
+				break;
+			case 1:
+				len = buf;
+				count = 0;
+				state = (len >= 2) ? 2 : 0;
+				break;
+			case 2:
+				body[count++] = buf;
+				if (count == len)
+				{
+					count = 0;
+					state = 3;
+				}
+				break;
+			case 3:
+				crc[count++] = buf;
+				if (count < 4)
+					break;
+				state = 0;
+				buf = len;
+				if (PARAM_crc32(PARAM_crc32(0, &buf, 1), body, len) == get32(crc))
+					return len;
+				break;
+		}
+	}
+	return -1;
+}
+
+// sends a request until its reply comes, the reply body is returned in body
+static int request(uint8_t type, const uint8_t *payload, int len, uint8_t *body)
+{
+	uint8_t seq = next_seq++;
+	int tries, n;
+
+	for (tries = 0; tries < MAX_TRIES; tries++)
+	{
+		send_frame(type, seq, payload, len);
+		while ((n = read_frame(body, REPLY_TIMEOUT_MS)) >= 0)
+		{
+			if (body[1] == seq && body[0] != PLINK_DUMP_DATA)
+				return n;
+		}
+	}
+	fprintf(stderr, "no reply\n");
+	return -1;
+}
+
+/************************** Parameters ***************************************/
+
+static void value_text(const param_t *p, uint32_t value, char *text)
+{
+	float f;
+	int digits;
+
+	if (p->type == PARAM_INT)
+	{
+		sprintf(text, "%d", (int32_t) value);
+		return;
+	}
+	// the fewest digits that read back as the same float
+	memcpy(&f, &value, sizeof(f));
+	for (digits = 6; digits < 9; digits++)
+	{
+		sprintf(text, "%.*g", digits, f);
+		if (strtof(text, NULL) == f)
+			return;
+	}
+	sprintf(text, "%.9g", f);
+}
+
+// the text as a value of the parameter, 0 if it is not a number or is out of range
+static int text_value(const param_t *p, const char *text, uint32_t *p_value)
+{
+	char *end;
+	double d = strtod(text, &end);
+	int32_t i;
+	float f;
+
+	if (end == text || *end != '\0' || !(d >= p->min && d <= p->max))
+		return 0;
+	if (p->type == PARAM_INT)
+	{
+		i = (int32_t) (d >= 0 ? d + 0.5 : d - 0.5);
+		memcpy(p_value, &i, sizeof(i));
+	}
+	else
+	{
+		f = d;
+		memcpy(p_value, &f, sizeof(f));
+	}
+	return 1;
+}
+
+static param_t *find_param(const char *name)
+{
+	int i;
+
+	for (i = 0; i < num_params; i++)
+	{
+		if (strcmp(params[i].name, name) == 0)
+			return &params[i];
+	}
+	fprintf(stderr, "no parameter %s\n", name);
+	return NULL;
+}
+
+// reads the whole table with one windowed dump
+static int dump(void)
+{
+	uint8_t body[PLINK_MAX_BODY], ack, window = PLINK_MAX_WINDOW, *p, *end;
+	int n, name_len, tries = 0, expected = 0, last = 0;
+	param_t *q;
+
+	num_params = 0;
+	send_frame(PLINK_DUMP, next_seq++, &window, 1);
+	while (!last)
+	{
+		n = read_frame(body, REPLY_TIMEOUT_MS);
+		if (n < 0)
+		{
+			// nothing at all: the request was lost.  Else the aircraft sends again
+			// from the first frame not acknowledged, help it with the acknowledgment
+			if (++tries > MAX_TRIES * 2)
+			{
+				fprintf(stderr, "dump timed out\n");
+				return -1;
+			}
+			if (expected == 0)
+			{
+				send_frame(PLINK_DUMP, next_seq++, &window, 1);
+			}
+			else
+			{
+				ack = expected;
+				send_frame(PLINK_ACK, next_seq++, &ack, 1);
+			}
+			continue;
+		}
+		if (body[0] != PLINK_DUMP_DATA)
+			continue;
+		if (body[1] != expected)
+		{
+			// a frame sent again, or one after a lost frame
+			ack = expected;
+			send_frame(PLINK_ACK, next_seq++, &ack, 1);
+			continue;
+		}
+
+		tries = 0;
+		last = body[2] & PLINK_DUMP_LAST;
+		for (p = &body[3], end = &body[n]; p + PLINK_ENTRY_SIZE <= end && num_params < PARAM_MAX_PARAMS; )
+		{
+			q = &params[num_params++];
+			q->id = p[0] | (p[1] << 8);
+			q->type = p[2];
+			q->value = get32(p + 3);
+			memcpy(&q->min, p + 7, 4);
+			memcpy(&q->max, p + 11, 4);
+			name_len = (p[15] < PLINK_NAME_MAX) ? p[15] : PLINK_NAME_MAX;
+			memcpy(q->name, p + PLINK_ENTRY_SIZE, name_len);
+			q->name[name_len] = '\0';
+			q->set = 0;
+			p += PLINK_ENTRY_SIZE + p[15];
+		}
+		ack = ++expected;
+		send_frame(PLINK_ACK, next_seq++, &ack, 1);
+	}
+	return 0;
+}
+
+static void print_params(void)
+{
+	char text[32], min[32], max[32];
+	uint32_t raw;
+	int i;
+
+	for (i = 0; i < num_params; i++)
+	{
+		value_text(&params[i], params[i].value, text);
+		if (params[i].type == PARAM_INT)
+		{
+			sprintf(min, "%d", (int) params[i].min);
+			sprintf(max, "%d", (int) params[i].max);
+		}
+		else
+		{
+			memcpy(&raw, &params[i].min, 4);
+			value_text(&params[i], raw, min);
+			memcpy(&raw, &params[i].max, 4);
+			value_text(&params[i], raw, max);
+		}
+		printf("%-16s %-12s # id %u, %s, %s to %s\n", params[i].name, text, params[i].id,
+				params[i].type == PARAM_INT ? "int" : "float", min, max);
+	}
+}
+
+static int read_file(const char *path)
+{
+	char line[256], name[64], text[64];
+	FILE *fp = fopen(path, "r");
+	int line_no = 0, bad = 0;
+	param_t *p;
+
+	if (fp == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), fp) != NULL)
+	{
+		line_no++;
+		if (strchr(line, '#') != NULL)
+			*strchr(line, '#') = '\0';
+		if (sscanf(line, "%63s %63s", name, text) != 2)
+			continue;
+		if ((p = find_param(name)) == NULL)
+		{
+			bad++;
+			continue;
+		}
+		if (!text_value(p, text, &p->new_value))
+		{
+			fprintf(stderr, "%s:%d: %s %s is not a number from %g to %g\n", path, line_no,
+					name, text, p->min, p->max);
+			bad++;
+			continue;
+		}
+		p->set = 1;
+	}
+	fclose(fp);
+	return bad ? -1 : 0;
+}
+
+// sends the parameters from the file that differ in one image
+static int sync_params(void)
+{
+	uint8_t image[PARAM_IMAGE_SIZE(PARAM_MAX_PARAMS)], body[PLINK_MAX_BODY], *p = &image[PARAM_HEADER_SIZE];
+	int i, n, count = 0;
+
+	// the table is in ID order, so the image is too
+	for (i = 0; i < num_params; i++)
+	{
+		if (params[i].set && params[i].new_value != params[i].value)
+		{
+			p = put16(p, params[i].id);
+			p = put32(p, params[i].new_value);
+			count++;
+		}
+	}
+	if (count == 0)
+	{
+		printf("in sync\n");
+		return 0;
+	}
+
+	put16(image, PARAM_IMAGE_MAGIC);
+	image[2] = PARAM_IMAGE_VERSION;
+	image[3] = count;
+	p = put32(p, PARAM_crc32(0, image, p - image));
+
+	n = request(PLINK_LOAD, image, p - image, body);
+	if (n < 0)
+		return -1;
+	if (body[0] != PLINK_OK)
+	{
+		fprintf(stderr, "the aircraft refused the parameters, error %d\n", body[3]);
+		return -1;
+	}
+	printf("%d parameters set\n", count);
+	return 0;
+}
+
+static int get_set(const char *name, const char *text)
+{
+	uint8_t payload[6], body[PLINK_MAX_BODY], *p;
+	param_t *q = find_param(name);
+	uint32_t value;
+	char out[32];
+	int n;
+
+	if (q == NULL)
+		return -1;
+	p = put16(payload, q->id);
+	if (text != NULL)
+	{
+		if (!text_value(q, text, &value))
+		{
+			fprintf(stderr, "%s is not a number from %g to %g\n", text, q->min, q->max);
+			return -1;
+		}
+		p = put32(p, value);
+	}
+
+	n = request(text != NULL ? PLINK_SET : PLINK_GET, payload, p - payload, body);
+	if (n < 0)
+		return -1;
+	if (body[0] != PLINK_VALUE)
+	{
+		fprintf(stderr, "the aircraft refused, error %d\n", body[3]);
+		return -1;
+	}
+	value_text(q, get32(&body[5]), out);
+	printf("%s %s\n", q->name, out);
+	return 0;
+}
+
+/************************** Main *********************************************/
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: paramsync [-b baud] port dump | get name | set name value"
+			" | sync file | reset\n");
+	exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t body[PLINK_MAX_BODY];
+	const char *cmd;
+	double start;
+	int baud = 9600, arg = 1, sts = 0;
+	if (arg + 1 < argc && strcmp(argv[arg], "-b") == 0)
+	{
+		baud = atoi(argv[arg + 1]);
+		arg += 2;
+	}
+	if (arg + 2 > argc)
+		usage();
+	if (open_port(argv[arg], baud) != 0)
+		return 1;
+	cmd = argv[arg + 1];
+	arg += 2;
+
+	start = now_ms();
+	if (strcmp(cmd, "reset") == 0)
+	{
+		sts = request(PLINK_RESET, NULL, 0, body) < 0 || body[0] != PLINK_OK;
+	}
+	else if (dump() != 0)
+	{
+		sts = 1;
+	}
+	else if (strcmp(cmd, "dump") == 0)
+	{
+		print_params();
+	}
+	else if (strcmp(cmd, "get") == 0 && arg + 1 == argc)
+	{
+		sts = get_set(argv[arg], NULL) != 0;
+	}
+	else if (strcmp(cmd, "set") == 0 && arg + 2 == argc)
+	{
+		sts = get_set(argv[arg], argv[arg + 1]) != 0;
+	}
+	else if (strcmp(cmd, "sync") == 0 && arg + 1 == argc)
+	{
+		sts = read_file(argv[arg]) != 0 || sync_params() != 0;
+	}
+	else
+	{
+		usage();
+	}
+
+	fprintf(stderr, "%s took %.0f ms\n", cmd, now_ms() - start);
+	close(fd);
+	return sts;
+}